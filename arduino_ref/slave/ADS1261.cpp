@@ -1,6 +1,6 @@
 
 #include "Arduino.h"
-#include "ads1261.h"
+#include "ADS1261.h"
 #include <SPI.h>
 
 #define ADS_SCK 6
@@ -18,6 +18,7 @@ void ADS1261::begin() {
     SPI.begin(ADS_SCK, ADS_MISO, ADS_MOSI);
     SPI.setFrequency(8000000);  // 8MHz max for ADS1261
     SPI.setDataMode(SPI_MODE1);
+    _bus.attach(SPI, -1, -1);  // CS tied low; DRDY is handled by the interrupt flag below
 }
 
 void ADS1261::attachDrdyInterrupt(void (*isr)(void)) {
@@ -45,8 +46,6 @@ int32_t ADS1261::readChannel(uint8_t pos, uint8_t neg) {
 }
 
 int32_t ADS1261::readConversionData() {
-    ThreeBytesTo24Bit value;
-    
     // Wait for DRDY interrupt flag (CRITICAL for 40kSPS multiplexing)
     if (_drdyPin >= 0) {
         unsigned long currentMicros = micros();
@@ -58,16 +57,10 @@ int32_t ADS1261::readConversionData() {
     }
     // Note: At 40kSPS SINC1, conversion = 25µs. Total overhead ~100µs for SPI
     
-    writeCommand(ADS1261_COMMAND_RDATA);
-    value.bytes[2] = SPI.transfer(0x00);
-    value.bytes[1] = SPI.transfer(0x00);
-    value.bytes[0] = SPI.transfer(0x00);
-    int32_t signedValue = value.value;
-
-    if (signedValue & 0x800000) {
-        signedValue = signedValue - 0x1000000;
-    }
-    
+    // RDATA command and the 3 data bytes in one transfer
+    int32_t signedValue = 0;
+    _dev.read_data(signedValue);
+
     // Continuous mode - no STOP command
     // CS pin hardwired to ground - no digitalWrite needed
     return signedValue;
@@ -135,10 +128,8 @@ uint8_t ADS1261::sendCommand(uint8_t add) {
 }
 
 uint8_t ADS1261::writeRegister(uint8_t reg_add, uint8_t reg_val) {
-    uint8_t reg = ADS1261_COMMAND_WREG | reg_add;
-    SPI.transfer(reg);
-    byte echo_byte = SPI.transfer(reg_val);
-    return echo_byte;
+    // Skipped when the device already holds reg_val (e.g. PGA in readChannel)
+    return _dev.write_register(reg_add, reg_val) == ads1261::Result::ok ? reg_val : 0;
 }
 
 ChannelData ADS1261::readFourChannel()
@@ -232,15 +223,14 @@ float ADS1261::get_units()
 }
 
 uint8_t ADS1261::readRegister(uint8_t reg_add) {
-    uint8_t reg_val = ADS1261_COMMAND_PREG | reg_add;
-    SPI.transfer(reg_val);
-    byte echo_byte = SPI.transfer(0x00);
-    byte reg_data = SPI.transfer(0x00);
+    uint8_t reg_data = 0;
+    _dev.read_register(reg_add, reg_data);
     return reg_data;
 }
 
 uint8_t ADS1261::writeCommand(uint8_t command_add) {
-    SPI.transfer(command_add);
-    byte echo_byte = SPI.transfer(0x00);
-    return echo_byte;
+    if (command_add == ADS1261_COMMAND_RESET) {
+        return _dev.reset() == ads1261::Result::ok ? command_add : 0;
+    }
+    return _dev.command(command_add) == ads1261::Result::ok ? command_add : 0;
 }
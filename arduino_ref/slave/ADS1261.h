@@ -7,6 +7,10 @@
 #define ADS1261_H
 
 #include <Arduino.h>
+// Shared header-only driver from components/ads1261 (on the include path via build.ps1);
+// included ahead of the register macros below, which reuse some of its field names
+#include "ads1261.hpp"
+#include "ads1261_transport.hpp"
 
 // Structure to hold 4-channel data
 struct ChannelData {
@@ -502,6 +506,10 @@ private:
     ADS1261_INPMUX_Type inp;
     ADS1261_PGA_Type pga;
 
+    // Register, command and RDATA framing go through the shared driver
+    ads1261::ArduinoSpiTransport _bus;
+    ads1261::Device<ads1261::ArduinoSpiTransport> _dev{_bus};
+
 public:
   void setDrdyPin(int pin) { _drdyPin = pin; _dataReady = false; }
   void setDataReady() { _dataReady = true; }
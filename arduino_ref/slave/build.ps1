@@ -5,11 +5,14 @@ Write-Host "╔═════════════════════
 Write-Host "║  ZPlate - Build & Upload              ║" -ForegroundColor Cyan
 Write-Host "╚═══════════════════════════════════════╝" -ForegroundColor Cyan
 
+# ADS1261.cpp uses the shared header-only driver in components/ads1261
+$driverInclude = "compiler.cpp.extra_flags=-I`"$PSScriptRoot\..\..\components\ads1261`""
+
 Write-Host "`n[1/3] Cleaning previous build..." -ForegroundColor Yellow
-arduino-cli compile --clean --fqbn esp32:esp32:esp32c6:CDCOnBoot=cdc . | Out-Null
+arduino-cli compile --clean --fqbn esp32:esp32:esp32c6:CDCOnBoot=cdc --build-property $driverInclude . | Out-Null
 
 Write-Host "[2/3] Compiling WiFi streaming firmware..." -ForegroundColor Yellow
-$compileOutput = arduino-cli compile --fqbn esp32:esp32:esp32c6:CDCOnBoot=cdc . 2>&1
+$compileOutput = arduino-cli compile --fqbn esp32:esp32:esp32c6:CDCOnBoot=cdc --build-property $driverInclude . 2>&1
 if ($LASTEXITCODE -ne 0) {
     Write-Host "✗ Compilation failed!" -ForegroundColor Red
     Write-Host $compileOutput
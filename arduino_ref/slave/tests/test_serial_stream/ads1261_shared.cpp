@@ -0,0 +1,5 @@
+// Builds the slave sketch's ADS1261 class instead of a local copy. Compile with
+// the slave sketch and the shared driver on the include path:
+//   arduino-cli compile --fqbn esp32:esp32:esp32c6:CDCOnBoot=cdc --build-property
+//     "compiler.cpp.extra_flags=-Id:\github\ads1261\arduino_ref\slave -Id:\github\ads1261\components\ads1261" .
+#include "ADS1261.cpp"
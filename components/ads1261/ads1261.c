@@ -1,25 +1,18 @@
 /* ADS1261 driver - clean implementation */
 #include "ads1261.h"
+#include "ads1261_timing.h"
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/semphr.h"
 #include "esp_timer.h"
-#include <machine/endian.h>
+#include "esp_rom_sys.h"
+#include <string.h>
 
 static const char *TAG = "ADS1261";
 static volatile int s_drdy_isr_count = 0;
 
-/* ADS1261 Commands */
-#define ADS1261_CMD_RESET       0x06
-#define ADS1261_CMD_START       0x08
-#define ADS1261_CMD_STOP        0x0A
-#define ADS1261_CMD_RDATA       0x12
-#define ADS1261_CMD_RREG        0x20
-#define ADS1261_CMD_WREG        0x40
-
 #define ADS1261_TIMEOUT_MS      1000
 
 /* Software SPI pin definitions - matching main.c */
@@ -31,6 +24,75 @@ static volatile int s_drdy_isr_count = 0;
 // Declare the ISR function once without IRAM_ATTR here to avoid conflicts
 static void ads1261_drdy_isr(void *arg);
 
+/*
+ * Clock one complete command frame (CS low .. CS high) through tx_buf/rx_buf
+ * in a single polling transaction. Per-byte transactions cost a full driver
+ * round-trip each, which at 40 kSPS exceeds the conversion period itself.
+ */
+static esp_err_t ads1261_xfer(ads1261_t *device, size_t len)
+{
+    spi_transaction_t t = {
+        .length = len * 8,
+        .tx_buffer = device->tx_buf,
+        .rx_buffer = device->rx_buf,
+    };
+
+    return spi_device_polling_transmit(device->spi_handle, &t);
+}
+
+/* Count STATUS conditions as they appear, not on every frame they stay latched */
+static void ads1261_track_status(ads1261_t *device, uint8_t status)
+{
+    uint8_t raised = status & ~device->last_status;
+
+    if (raised & ADS1261_STATUS_CRCERR) {
+        device->integrity.cmd_crc_errors++;
+        ESP_LOGW(TAG, "Device reported a command CRC error (STATUS=0x%02X)", status);
+    }
+    if (raised & ADS1261_STATUS_ALARMS) {
+        device->integrity.alarms++;
+        ESP_LOGW(TAG, "Input alarm raised (STATUS=0x%02X)", status);
+    }
+    device->last_status = status;
+}
+
+/*
+ * Decode and check the response payload of a RREG/RDATA frame received with
+ * the given MODE3 framing, counting the outcome in device->integrity.
+ */
+static esp_err_t ads1261_parse(ads1261_t *device, uint8_t mode3, ads1261_op_t op,
+                               const uint8_t *rx, int32_t *value, uint8_t *status)
+{
+    ads1261_frame_check_t check = ads1261_frame_check(mode3, op, rx, value, status);
+
+    if (check == ADS1261_FRAME_UNCHECKED) {
+        return ESP_OK;
+    }
+    device->integrity.checked++;
+
+    if (check == ADS1261_FRAME_CRC_ERROR) {
+        device->integrity.crc_errors++;
+        ESP_LOGD(TAG, "Response CRC mismatch (op %d)", op);
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (ads1261_has_status(mode3, op)) {
+        ads1261_track_status(device, *status);
+    }
+    if (check == ADS1261_FRAME_STALE) {
+        device->integrity.stale_reads++;
+        return ESP_ERR_NOT_FINISHED;
+    }
+    return ESP_OK;
+}
+
+/* Send a two-byte command (opcode + arbitrary byte, echoed by the device) */
+static esp_err_t ads1261_command(ads1261_t *device, uint8_t cmd)
+{
+    size_t len = ads1261_frame(device->shadow.mode3.reg, device->tx_buf, ADS1261_OP_COMMAND, cmd, 0x00);
+    ads1261_shadow_command(device->shadow.raw, &device->shadow_valid, cmd);
+    return ads1261_xfer(device, len);
+}
+
 esp_err_t ads1261_init(ads1261_t *device, spi_host_device_t host, int cs_pin, int drdy_pin)
 {
     ESP_LOGI(TAG, "=== ADS1261 INIT STARTING ===");
@@ -42,7 +104,13 @@ esp_err_t ads1261_init(ads1261_t *device, spi_host_device_t host, int cs_pin, in
     device->cs_pin = cs_pin;
     device->drdy_pin = drdy_pin;
     device->spi_handle = NULL;
-    device->drdy_sem = NULL;
+    device->drdy_task = NULL;
+    device->drdy_irq = false;
+    device->shadow_valid = 0;
+    device->shadow_skips = 0;
+    device->shadow.mode3.reg = 0x00;
+    device->last_status = 0;
+    memset(&device->integrity, 0, sizeof(device->integrity));
 
     // Test: Configure test GPIO to see if GPIO matrix is working
     gpio_config_t test_cfg = {
@@ -73,29 +141,16 @@ esp_err_t ads1261_init(ads1261_t *device, spi_host_device_t host, int cs_pin, in
         gpio_config(&gpio_cfg);
     }
 
-    if (cs_pin >= 0) {
-        gpio_config_t cs_cfg = {
-            .pin_bit_mask = (1ULL << cs_pin),
-            .mode = GPIO_MODE_OUTPUT,
-            .pull_up_en = GPIO_PULLUP_DISABLE,
-            .pull_down_en = GPIO_PULLDOWN_DISABLE,
-            .intr_type = GPIO_INTR_DISABLE,
-        };
-        gpio_config(&cs_cfg);
-        gpio_set_level(cs_pin, 1);  // Start with CS high
-    }
-    
-    // Determine if we're using hardware CS (managed by SPI driver) or manual GPIO CS
-    // When cs_pin = -1, CS is tied to ground and we let the SPI driver handle it (no manual control)
-    // When cs_pin >= 0, we use that GPIO for manual CS control
-    device->use_hw_cs = false;  /* Manual CS control */
+    // CS is either tied to ground (cs_pin = -1) or driven by the SPI peripheral for
+    // each transaction, so a queued frame never needs a GPIO toggle between transfers
+    device->use_hw_cs = (cs_pin >= 0);
 
     /* Add device to SPI bus */
     spi_device_interface_config_t dev_cfg = {
         .mode = 1,  /* SPI Mode 1: CPOL=0, CPHA=1 */
         .clock_speed_hz = 8 * 1000 * 1000,  /* 8 MHz */
-        .spics_io_num = -1,  /* Manual CS via GPIO */
-        .queue_size = 3,
+        .spics_io_num = cs_pin,  /* Hardware CS (or -1 when tied to ground) */
+        .queue_size = ADS1261_QUEUE_DEPTH,
     };
 
     esp_err_t err = spi_bus_add_device(host, &dev_cfg, &device->spi_handle);
@@ -109,12 +164,7 @@ esp_err_t ads1261_init(ads1261_t *device, spi_host_device_t host, int cs_pin, in
 
     /* Send RESET command - matching Arduino timing (no delays) */
     ESP_LOGI(TAG, "Sending RESET command (0x06)...");
-    uint8_t reset_cmd = ADS1261_CMD_RESET;
-    spi_transaction_t reset_t = {
-        .length = 8,
-        .tx_buffer = &reset_cmd,
-    };
-    spi_device_polling_transmit(device->spi_handle, &reset_t);
+    ads1261_command(device, ADS1261_CMD_RESET);
     
     /* Small delay for device to complete reset */
     esp_rom_delay_us(10000);  // 10ms delay - matching Arduino
@@ -147,7 +197,8 @@ esp_err_t ads1261_init(ads1261_t *device, spi_host_device_t host, int cs_pin, in
     }
     
     /* Set data rate to 40ksps with SINC5 filter (only filter supported at 40kSPS per datasheet) */
-    uint8_t mode0_reg = (ADS1261_REG_MODE0_FILTER_SINC5 << 5) | ADS1261_DR_40000_SPS;  // 40ksps, SINC5
+    ads1261_mode0_reg_t mode0 = { .bits = { .filter = ADS1261_REG_MODE0_FILTER_SINC5, .dr = ADS1261_DR_40000_SPS } };
+    uint8_t mode0_reg = mode0.reg;
     esp_err_t mode0_ret = ads1261_write_register(device, ADS1261_REG_MODE0, mode0_reg);
     if (mode0_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set MODE0 register: %s", esp_err_to_name(mode0_ret));
@@ -184,27 +235,21 @@ esp_err_t ads1261_init(ads1261_t *device, spi_host_device_t host, int cs_pin, in
     if (ads1261_read_register(device, ADS1261_REG_MODE3, &final_mode3) == ESP_OK) {
         if (((final_mode3 >> 4) & 1) == 0) {  // SPITIM=0, meaning DRDY mode
             if (drdy_pin >= 0) {
-                device->drdy_sem = xSemaphoreCreateBinary();
-                if (device->drdy_sem == NULL) {
-                    ESP_LOGW(TAG, "Failed to create DRDY semaphore; falling back to polling");
+                esp_err_t isr_ret = gpio_install_isr_service(0);
+                if (isr_ret != ESP_OK && isr_ret != ESP_ERR_INVALID_STATE) {
+                    ESP_LOGW(TAG, "gpio_install_isr_service failed: %s", esp_err_to_name(isr_ret));
+                }
+                esp_err_t intr_ret = gpio_set_intr_type(drdy_pin, GPIO_INTR_NEGEDGE);
+                if (intr_ret != ESP_OK) {
+                    ESP_LOGW(TAG, "gpio_set_intr_type failed: %s", esp_err_to_name(intr_ret));
+                }
+                esp_err_t add_ret = gpio_isr_handler_add(drdy_pin, ads1261_drdy_isr, device);
+                if (add_ret != ESP_OK) {
+                    ESP_LOGW(TAG, "gpio_isr_handler_add failed: %s — falling back to polling", esp_err_to_name(add_ret));
                 } else {
-                    esp_err_t isr_ret = gpio_install_isr_service(0);
-                    if (isr_ret != ESP_OK && isr_ret != ESP_ERR_INVALID_STATE) {
-                        ESP_LOGW(TAG, "gpio_install_isr_service failed: %s", esp_err_to_name(isr_ret));
-                    }
-                    esp_err_t intr_ret = gpio_set_intr_type(drdy_pin, GPIO_INTR_NEGEDGE);
-                    if (intr_ret != ESP_OK) {
-                        ESP_LOGW(TAG, "gpio_set_intr_type failed: %s", esp_err_to_name(intr_ret));
-                    }
-                    esp_err_t add_ret = gpio_isr_handler_add(drdy_pin, ads1261_drdy_isr, device);
-                    if (add_ret != ESP_OK) {
-                        ESP_LOGW(TAG, "gpio_isr_handler_add failed: %s — falling back to polling", esp_err_to_name(add_ret));
-                        vSemaphoreDelete((SemaphoreHandle_t)device->drdy_sem);
-                        device->drdy_sem = NULL;
-                    } else {
-                        ESP_LOGI(TAG, "DRDY ISR installed on GPIO %d", drdy_pin);
-                        use_status_polling = false;  // Successfully set up interrupt
-                    }
+                    ESP_LOGI(TAG, "DRDY ISR installed on GPIO %d", drdy_pin);
+                    device->drdy_irq = true;
+                    use_status_polling = false;  // Successfully set up interrupt
                 }
             }
         }
@@ -215,8 +260,8 @@ esp_err_t ads1261_init(ads1261_t *device, spi_host_device_t host, int cs_pin, in
     }
 
     /* In Standalone DOUT mode, conversion is continuous - no START command needed */
-    /* But we'll add a small delay to allow first conversion to complete */
-    esp_rom_delay_us(50000);  // 50ms for first conversion to complete
+    /* Wait out the first conversion of the configured filter/data rate */
+    esp_rom_delay_us(ads1261_device_settle_time_us(device));
     
     ESP_LOGI(TAG, "ADS1261 initialized successfully in Standalone DOUT mode");
     return ESP_OK;
@@ -227,50 +272,100 @@ static void IRAM_ATTR ads1261_drdy_isr(void *arg)
 {
     ads1261_t *dev = (ads1261_t *)arg;
     if (!dev) return;
-    if (dev->drdy_sem) {
+    s_drdy_isr_count++;
+    dev->drdy_flag = true;
+
+    /* Notify the task that armed the wait directly - no semaphore object involved */
+    TaskHandle_t task = (TaskHandle_t)dev->drdy_task;
+    if (task) {
         BaseType_t awakened = pdFALSE;
-        xSemaphoreGiveFromISR((SemaphoreHandle_t)dev->drdy_sem, &awakened);
-        s_drdy_isr_count++;
+        vTaskNotifyGiveFromISR(task, &awakened);
         portYIELD_FROM_ISR(awakened);
     }
 }
 
-esp_err_t ads1261_write_register(ads1261_t *device, uint8_t reg, uint8_t value)
+void ads1261_drdy_arm(ads1261_t *device)
 {
-    if (!device) return ESP_ERR_INVALID_ARG;
+    if (!device || !device->drdy_irq) return;
 
-    uint8_t cmd = ADS1261_CMD_WREG | (reg & 0x1F);
+    device->drdy_task = xTaskGetCurrentTaskHandle();
+    /* Drop edges from conversions that completed before this point */
+    ulTaskNotifyTake(pdTRUE, 0);
+    device->drdy_flag = false;
+}
 
-    if (!device->use_hw_cs && device->cs_pin >= 0) {
-        gpio_set_level(device->cs_pin, 0);  /* CS low */
-    }
+/* STATUS.DRDY (bit 2) is set on conversion completion and cleared by reading the data */
+static esp_err_t ads1261_poll_status_drdy(ads1261_t *device, int64_t deadline_us)
+{
+    do {
+        uint8_t status = 0;
+        esp_err_t ret = ads1261_read_register(device, ADS1261_REG_STATUS, &status);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (status & ADS1261_STATUS_DRDY) {
+            return ESP_OK;
+        }
+    } while (esp_timer_get_time() < deadline_us);
 
-    /* Write register using individual byte transfers (like Arduino) */
-    spi_transaction_t t1 = {
-        .length = 8,
-        .tx_buffer = &cmd,
-    };
-    esp_err_t ret = spi_device_polling_transmit(device->spi_handle, &t1);
-    if (ret != ESP_OK) {
-        goto cleanup;
+    return ESP_ERR_TIMEOUT;
+}
+
+esp_err_t ads1261_wait_drdy(ads1261_t *device, uint32_t timeout_ms)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    esp_err_t ret;
+
+    if (device->drdy_irq) {
+        TickType_t ticks = pdMS_TO_TICKS(timeout_ms);
+        TickType_t start = xTaskGetTickCount();
+        ticks = ticks > 0 ? ticks : 1;
+        /* The notification may come from another device sharing this task */
+        while (!device->drdy_flag) {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= ticks || ulTaskNotifyTake(pdTRUE, ticks - elapsed) == 0) {
+                break;
+            }
+        }
+        if (device->drdy_flag) {
+            device->drdy_flag = false;
+            return ESP_OK;
+        }
+        /* Edge missed or pin not wired: one STATUS read settles it */
+        ret = ads1261_poll_status_drdy(device, 0);
+    } else {
+        ret = ads1261_poll_status_drdy(device, deadline_us);
     }
-    
-    spi_transaction_t t2 = {
-        .length = 8,
-        .tx_buffer = &value,
-    };
-    ret = spi_device_polling_transmit(device->spi_handle, &t2);
-    if (ret != ESP_OK) {
-        goto cleanup;
+
+    if (ret == ESP_ERR_TIMEOUT) {
+        device->drdy_timeouts++;
     }
+    return ret;
+}
+
+esp_err_t ads1261_write_register(ads1261_t *device, uint8_t reg, uint8_t value)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
 
-cleanup:
-    if (!device->use_hw_cs && device->cs_pin >= 0) {
-        gpio_set_level(device->cs_pin, 1);  /* CS high */
+    if (ads1261_shadow_matches(device->shadow.raw, device->shadow_valid, reg, value)) {
+        device->shadow_skips++;
+        return ESP_OK;
     }
-    
-    ESP_LOGI(TAG, "WriteReg 0x%02X: value=0x%02X", reg, value);
 
+    /* WREG frame: [opcode|reg, data] */
+    size_t len = ads1261_frame(device->shadow.mode3.reg, device->tx_buf, ADS1261_OP_WREG,
+                               ADS1261_CMD_WREG | (reg & 0x1F), value);
+    esp_err_t ret = ads1261_xfer(device, len);
+
+    ESP_LOGD(TAG, "WriteReg 0x%02X: value=0x%02X", reg, value);
+
+    if (ret == ESP_OK) {
+        ads1261_shadow_store(device->shadow.raw, &device->shadow_valid, reg, value);
+    } else {
+        ads1261_shadow_forget(&device->shadow_valid, reg);
+    }
     return ret;
 }
 
@@ -278,91 +373,196 @@ esp_err_t ads1261_read_register(ads1261_t *device, uint8_t reg, uint8_t *value)
 {
     if (!device || !value) return ESP_ERR_INVALID_ARG;
 
-    uint8_t cmd = ADS1261_CMD_RREG | (reg & 0x1F);
-
-    if (!device->use_hw_cs && device->cs_pin >= 0) {
-        gpio_set_level(device->cs_pin, 0);  /* CS low */
-    }
-
-    /* Read register using individual byte transfers (like Arduino) */
-    spi_transaction_t t1 = {
-        .length = 8,
-        .tx_buffer = &cmd,
-    };
-    esp_err_t ret = spi_device_polling_transmit(device->spi_handle, &t1);
+    /* RREG frame: [opcode|reg, arbitrary (echo), 00] -> data in byte 3 */
+    uint8_t mode3 = device->shadow.mode3.reg;
+    size_t len = ads1261_frame(mode3, device->tx_buf, ADS1261_OP_RREG, ADS1261_CMD_RREG | (reg & 0x1F), 0x00);
+    esp_err_t ret = ads1261_xfer(device, len);
     if (ret != ESP_OK) {
-        goto cleanup;
+        return ret;
     }
-    
-    /* Dummy byte */
-    uint8_t dummy = 0x00;
-    spi_transaction_t t2 = {
-        .length = 8,
-        .tx_buffer = &dummy,
-    };
-    ret = spi_device_polling_transmit(device->spi_handle, &t2);
+
+    int32_t data;
+    uint8_t status;
+    ret = ads1261_parse(device, mode3, ADS1261_OP_RREG, device->rx_buf, &data, &status);
     if (ret != ESP_OK) {
-        goto cleanup;
+        return ret;
     }
-    
-    /* Read data byte */
-    uint8_t rx_buf[1] = {0};
-    spi_transaction_t t3 = {
-        .length = 8,
-        .rx_buffer = rx_buf,
-    };
-    ret = spi_device_polling_transmit(device->spi_handle, &t3);
-    if (ret != ESP_OK) {
-        goto cleanup;
+    *value = (uint8_t)data;
+    ads1261_shadow_store(device->shadow.raw, &device->shadow_valid, reg, *value);
+    return ESP_OK;
+}
+
+esp_err_t ads1261_get_register(ads1261_t *device, uint8_t reg, uint8_t *value)
+{
+    if (!device || !value || reg >= ADS1261_NUM_REGS) return ESP_ERR_INVALID_ARG;
+
+    if (ads1261_shadow_known(device->shadow_valid, reg)) {
+        *value = device->shadow.raw[reg];
+        return ESP_OK;
     }
-    
-    *value = rx_buf[0];
+    return ads1261_read_register(device, reg, value);
+}
+
+esp_err_t ads1261_snapshot(ads1261_t *device, ads1261_regs_t *regs, uint32_t *mismatch)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
 
-cleanup:
-    if (!device->use_hw_cs && device->cs_pin >= 0) {
-        gpio_set_level(device->cs_pin, 1);  /* CS high */
+    uint32_t diff = 0;
+    for (uint8_t reg = 0; reg < ADS1261_NUM_REGS; reg++) {
+        bool known = ads1261_shadow_known(device->shadow_valid, reg);
+        uint8_t expected = device->shadow.raw[reg];
+        uint8_t value = 0;
+
+        esp_err_t ret = ads1261_read_register(device, reg, &value);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (known && value != expected) {
+            ESP_LOGW(TAG, "Shadow mismatch reg 0x%02X: shadow=0x%02X device=0x%02X", reg, expected, value);
+            diff |= (1u << reg);
+        }
     }
 
+    if (regs) *regs = device->shadow;
+    if (mismatch) *mismatch = diff;
+    return ESP_OK;
+}
+
+esp_err_t ads1261_set_integrity(ads1261_t *device, bool status_byte, bool crc)
+{
+    ads1261_mode3_reg_t mode3;
+    esp_err_t ret = ads1261_get_register(device, ADS1261_REG_MODE3, &mode3.reg);
+    if (ret != ESP_OK) return ret;
+
+    mode3.bits.statenb = status_byte;
+    mode3.bits.crcenb = crc;
+    ret = ads1261_write_register(device, ADS1261_REG_MODE3, mode3.reg);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Read framing: STATUS %s, CRC %s", status_byte ? "on" : "off", crc ? "on" : "off");
+    }
     return ret;
 }
 
 esp_err_t ads1261_set_mux(ads1261_t *device, uint8_t muxp, uint8_t muxn)
 {
-    uint8_t inpmux = ((muxp & 0x0F) << 4) | (muxn & 0x0F);
-    return ads1261_write_register(device, ADS1261_REG_INPMUX, inpmux);
+    ads1261_inpmux_reg_t inpmux = { .bits = { .muxn = muxn & 0x0F, .muxp = muxp & 0x0F } };
+    return ads1261_write_register(device, ADS1261_REG_INPMUX, inpmux.reg);
 }
 
 esp_err_t ads1261_set_pga(ads1261_t *device, uint8_t gain)
 {
-    return ads1261_write_register(device, ADS1261_REG_PGA, ((gain & 0x07) << 4) | 0x01);
+    ads1261_pga_reg_t pga;
+    esp_err_t ret = ads1261_get_register(device, ADS1261_REG_PGA, &pga.reg);
+    if (ret != ESP_OK) return ret;
+
+    pga.bits.gain = gain & 0x07;
+    return ads1261_write_register(device, ADS1261_REG_PGA, pga.reg);
 }
 
 esp_err_t ads1261_set_datarate(ads1261_t *device, uint8_t datarate)
 {
-    /* Data rate is set in MODE0 register bits [3:0] */
-    return ads1261_write_register(device, ADS1261_REG_MODE0, datarate & 0x1F);
+    ads1261_mode0_reg_t mode0;
+    esp_err_t ret = ads1261_get_register(device, ADS1261_REG_MODE0, &mode0.reg);
+    if (ret != ESP_OK) return ret;
+
+    mode0.bits.dr = datarate & 0x1F;
+    return ads1261_write_register(device, ADS1261_REG_MODE0, mode0.reg);
 }
 
 esp_err_t ads1261_set_ref(ads1261_t *device, uint8_t refsel)
 {
-    return ads1261_write_register(device, ADS1261_REG_REF, ((refsel & 0x03) << 5));
+    ads1261_ref_reg_t ref;
+    esp_err_t ret = ads1261_get_register(device, ADS1261_REG_REF, &ref.reg);
+    if (ret != ESP_OK) return ret;
+
+    /* RMUXP: 0 = internal, 1 = AVDD, 2 = AIN0, 3 = AIN2; RMUXN: 0 = internal, 1 = AVSS, 2 = AIN1, 3 = AIN3 */
+    switch (refsel) {
+    case ADS1261_REFSEL_INT:  ref.bits.rmuxp = 0; ref.bits.rmuxn = 0; ref.bits.refenb = 1; break;
+    case ADS1261_REFSEL_EXT1: ref.bits.rmuxp = 2; ref.bits.rmuxn = 2; break;
+    case ADS1261_REFSEL_EXT2: ref.bits.rmuxp = 3; ref.bits.rmuxn = 3; break;
+    case ADS1261_REFSEL_AVDD: ref.bits.rmuxp = 1; ref.bits.rmuxn = 1; break;
+    default: return ESP_ERR_INVALID_ARG;
+    }
+    return ads1261_write_register(device, ADS1261_REG_REF, ref.reg);
 }
 
 esp_err_t ads1261_start_conversion(ads1261_t *device)
 {
     if (!device) return ESP_ERR_INVALID_ARG;
-    if (!device->use_hw_cs && device->cs_pin >= 0) gpio_set_level(device->cs_pin, 0);
-    esp_rom_delay_us(10);  /* More precise delay */
+    return ads1261_command(device, ADS1261_CMD_START);
+}
 
-    uint8_t cmd = ADS1261_CMD_START;
-    spi_transaction_t t = {
-        .length = 8,
-        .tx_buffer = &cmd,
-    };
-    esp_err_t ret = spi_device_transmit(device->spi_handle, &t);
+/* OFCAL0..2 / FSCAL0..2 hold 24-bit values least significant byte first */
+static void ads1261_calibration_bytes(int32_t ofcal, uint32_t fscal, uint8_t bytes[6])
+{
+    for (int i = 0; i < 3; i++) {
+        bytes[i] = (uint8_t)((uint32_t)ofcal >> (8 * i));
+        bytes[3 + i] = (uint8_t)(fscal >> (8 * i));
+    }
+}
 
-    esp_rom_delay_us(10);  /* More precise delay */
-    if (!device->use_hw_cs && device->cs_pin >= 0) gpio_set_level(device->cs_pin, 1);
+static bool ads1261_calibration_valid(int32_t ofcal, uint32_t fscal)
+{
+    return ofcal >= ADS1261_OFCAL_MIN && ofcal <= ADS1261_OFCAL_MAX && fscal <= ADS1261_FSCAL_MAX;
+}
+
+esp_err_t ads1261_set_calibration(ads1261_t *device, int32_t ofcal, uint32_t fscal)
+{
+    if (!device || !ads1261_calibration_valid(ofcal, fscal)) return ESP_ERR_INVALID_ARG;
+
+    uint8_t bytes[6];
+    ads1261_calibration_bytes(ofcal, fscal, bytes);
+    for (int i = 0; i < 6; i++) {
+        esp_err_t ret = ads1261_write_register(device, ADS1261_REG_OFCAL0 + i, bytes[i]);
+        if (ret != ESP_OK) return ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ads1261_get_calibration(ads1261_t *device, int32_t *ofcal, uint32_t *fscal)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+
+    uint8_t bytes[6];
+    for (int i = 0; i < 6; i++) {
+        esp_err_t ret = ads1261_get_register(device, ADS1261_REG_OFCAL0 + i, &bytes[i]);
+        if (ret != ESP_OK) return ret;
+    }
+
+    uint32_t of = bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16);
+    if (ofcal) *ofcal = (int32_t)(of << 8) >> 8;
+    if (fscal) *fscal = bytes[3] | ((uint32_t)bytes[4] << 8) | ((uint32_t)bytes[5] << 16);
+    return ESP_OK;
+}
+
+esp_err_t ads1261_calibrate(ads1261_t *device, uint8_t cmd, uint32_t timeout_ms)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+    if (cmd != ADS1261_CMD_SYOCAL && cmd != ADS1261_CMD_GANCAL && cmd != ADS1261_CMD_SFOCAL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* DRDY falls when the calibration conversion is done */
+    ads1261_drdy_arm(device);
+    esp_err_t ret = ads1261_command(device, cmd);
+    if (ret != ESP_OK) return ret;
+
+    /* The device rewrites its own calibration registers */
+    uint8_t first = (cmd == ADS1261_CMD_GANCAL) ? ADS1261_REG_FSCAL0 : ADS1261_REG_OFCAL0;
+    device->shadow_valid &= ~(0x7u << first);
+
+    ret = ads1261_wait_drdy(device, timeout_ms);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Calibration 0x%02X did not complete: %s", cmd, esp_err_to_name(ret));
+        return ret;
+    }
+
+    int32_t ofcal;
+    uint32_t fscal;
+    ret = ads1261_get_calibration(device, &ofcal, &fscal);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Calibration 0x%02X done: OFCAL=%ld FSCAL=0x%06lX", cmd, (long)ofcal, (unsigned long)fscal);
+    }
     return ret;
 }
 
@@ -370,68 +570,192 @@ esp_err_t ads1261_read_adc(ads1261_t *device, int32_t *result)
 {
     if (!device || !result) return ESP_ERR_INVALID_ARG;
 
-    if (!device->use_hw_cs && device->cs_pin >= 0) {
-        gpio_set_level(device->cs_pin, 0);  /* CS low */
+    /* RDATA frame: [opcode, arbitrary (echo), 00, 00, 00] -> data in bytes 3..5 */
+    uint8_t mode3 = device->shadow.mode3.reg;
+    size_t len = ads1261_frame(mode3, device->tx_buf, ADS1261_OP_RDATA, ADS1261_CMD_RDATA, 0x00);
+    esp_err_t ret = ads1261_xfer(device, len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint8_t status;
+    ret = ads1261_parse(device, mode3, ADS1261_OP_RDATA, device->rx_buf, result, &status);
+
+    ESP_LOGV(TAG, "SPI: RDATA code=%ld status=0x%02X", *result, status);
+
+    return ret;
+}
+
+/* ============================================================================
+ * Asynchronous (queued) access
+ * ============================================================================ */
+
+esp_err_t ads1261_bus_acquire(ads1261_t *device)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+    if (device->bus_acquired) return ESP_OK;
+
+    esp_err_t ret = spi_device_acquire_bus(device->spi_handle, portMAX_DELAY);
+    if (ret == ESP_OK) {
+        device->bus_acquired = true;
     }
+    return ret;
+}
 
-    /* Read ADC using individual byte transfers (like Arduino) */
-    uint8_t cmd = ADS1261_CMD_RDATA;
-    spi_transaction_t t1 = {
-        .length = 8,
-        .tx_buffer = &cmd,
+void ads1261_bus_release(ads1261_t *device)
+{
+    if (!device) return;
+
+    /* Queued transactions must finish before the bus can be handed back */
+    if (ads1261_complete_all(device, ADS1261_TIMEOUT_MS) == ESP_ERR_TIMEOUT) {
+        ESP_LOGE(TAG, "Queued transaction did not complete; dropping %u", device->in_flight);
+        device->in_flight = 0;
+        device->shadow_valid = 0;
+    }
+
+    if (device->bus_acquired) {
+        spi_device_release_bus(device->spi_handle);
+        device->bus_acquired = false;
+    }
+}
+
+/* Queue one command frame from the next free slot */
+static esp_err_t ads1261_submit(ads1261_t *device, ads1261_op_t op, uint8_t reg, uint8_t b0, uint8_t b1)
+{
+    if (device->in_flight >= ADS1261_QUEUE_DEPTH) {
+        return ESP_ERR_INVALID_STATE;  /* Caller must complete() first */
+    }
+
+    ads1261_slot_t *slot = &device->slots[(device->slot_head + device->in_flight) % ADS1261_QUEUE_DEPTH];
+    slot->op = op;
+    slot->reg = reg;
+    slot->mode3 = device->shadow.mode3.reg;
+    size_t len = ads1261_frame(slot->mode3, slot->tx, op, b0, b1);
+    slot->trans = (spi_transaction_t) {
+        .length = len * 8,
+        .tx_buffer = slot->tx,
+        .rx_buffer = slot->rx,
+        .user = device,
     };
-    esp_err_t ret = spi_device_polling_transmit(device->spi_handle, &t1);
-    if (ret != ESP_OK) {
-        goto cleanup;
+
+    esp_err_t ret = spi_device_queue_trans(device->spi_handle, &slot->trans, pdMS_TO_TICKS(ADS1261_TIMEOUT_MS));
+    if (ret == ESP_OK) {
+        device->in_flight++;
     }
-    
-    /* Read 3 data bytes individually */
-    uint8_t data_bytes[3];
-    uint8_t dummy = 0x00;
-    
-    for (int i = 0; i < 3; i++) {
-        spi_transaction_t t_data = {
-            .length = 8,
-            .tx_buffer = &dummy,
-            .rx_buffer = &data_bytes[i],
-        };
-        ret = spi_device_polling_transmit(device->spi_handle, &t_data);
-        if (ret != ESP_OK) {
-            goto cleanup;
-        }
+    return ret;
+}
+
+esp_err_t ads1261_submit_command(ads1261_t *device, uint8_t cmd)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+    esp_err_t ret = ads1261_submit(device, ADS1261_OP_COMMAND, 0, cmd, 0x00);
+    if (ret == ESP_OK) {
+        ads1261_shadow_command(device->shadow.raw, &device->shadow_valid, cmd);
     }
-    
-    if (!device->use_hw_cs && device->cs_pin >= 0) {
-        gpio_set_level(device->cs_pin, 1);  /* CS high */
+    return ret;
+}
+
+esp_err_t ads1261_submit_write_register(ads1261_t *device, uint8_t reg, uint8_t value)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+    if (ads1261_shadow_matches(device->shadow.raw, device->shadow_valid, reg, value)) {
+        device->shadow_skips++;
+        return ESP_OK;
     }
 
-    /* Assemble 24-bit result from 3 bytes (big-endian) */
-    uint32_t raw_value = ((uint32_t)data_bytes[0] << 16) | ((uint32_t)data_bytes[1] << 8) | data_bytes[2];
-    
-    /* Convert to signed 24-bit value */
-    if (raw_value & 0x800000) {
-        *result = (int32_t)(raw_value - 0x1000000);
-    } else {
-        *result = (int32_t)raw_value;
+    esp_err_t ret = ads1261_submit(device, ADS1261_OP_WREG, reg, ADS1261_CMD_WREG | (reg & 0x1F), value);
+    if (ret == ESP_OK) {
+        /* Later submits are ordered behind this write, so the shadow can move now */
+        ads1261_shadow_store(device->shadow.raw, &device->shadow_valid, reg, value);
     }
-    
-    ESP_LOGI(TAG, "SPI: RDATA data=[%02X %02X %02X]", data_bytes[0], data_bytes[1], data_bytes[2]);
+    return ret;
+}
 
+esp_err_t ads1261_submit_calibration(ads1261_t *device, int32_t ofcal, uint32_t fscal)
+{
+    if (!device || !ads1261_calibration_valid(ofcal, fscal)) return ESP_ERR_INVALID_ARG;
+
+    uint8_t bytes[6];
+    ads1261_calibration_bytes(ofcal, fscal, bytes);
+    for (int i = 0; i < 6; i++) {
+        esp_err_t ret = ads1261_submit_write_register(device, ADS1261_REG_OFCAL0 + i, bytes[i]);
+        if (ret != ESP_OK) return ret;
+    }
     return ESP_OK;
+}
 
-cleanup:
-    if (!device->use_hw_cs && device->cs_pin >= 0) {
-        gpio_set_level(device->cs_pin, 1);  /* CS high */
+esp_err_t ads1261_submit_read_register(ads1261_t *device, uint8_t reg)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+    return ads1261_submit(device, ADS1261_OP_RREG, reg, ADS1261_CMD_RREG | (reg & 0x1F), 0x00);
+}
+
+esp_err_t ads1261_submit_read_adc(ads1261_t *device)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+    return ads1261_submit(device, ADS1261_OP_RDATA, 0, ADS1261_CMD_RDATA, 0x00);
+}
+
+esp_err_t ads1261_complete(ads1261_t *device, ads1261_result_t *result, uint32_t timeout_ms)
+{
+    if (!device || !result) return ESP_ERR_INVALID_ARG;
+    if (device->in_flight == 0) return ESP_ERR_INVALID_STATE;
+
+    spi_transaction_t *done = NULL;
+    esp_err_t ret = spi_device_get_trans_result(device->spi_handle, &done, pdMS_TO_TICKS(timeout_ms));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ads1261_slot_t *slot = &device->slots[device->slot_head];
+    device->slot_head = (device->slot_head + 1) % ADS1261_QUEUE_DEPTH;
+    device->in_flight--;
+
+    if (done != &slot->trans) {
+        ESP_LOGE(TAG, "Queued transaction completed out of order");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    result->op = slot->op;
+    result->reg = slot->reg;
+    result->value = 0;
+    result->status = 0;
+    if (slot->op != ADS1261_OP_RREG && slot->op != ADS1261_OP_RDATA) {
+        return ESP_OK;
+    }
+
+    ret = ads1261_parse(device, slot->mode3, slot->op, slot->rx, &result->value, &result->status);
+    if (ret == ESP_OK && slot->op == ADS1261_OP_RREG) {
+        ads1261_shadow_store(device->shadow.raw, &device->shadow_valid, slot->reg, (uint8_t)result->value);
     }
-    
     return ret;
 }
 
+esp_err_t ads1261_complete_all(ads1261_t *device, uint32_t timeout_ms)
+{
+    if (!device) return ESP_ERR_INVALID_ARG;
+
+    esp_err_t first_err = ESP_OK;
+    while (device->in_flight > 0) {
+        ads1261_result_t discard;
+        esp_err_t ret = ads1261_complete(device, &discard, timeout_ms);
+        if (ret == ESP_ERR_TIMEOUT) {
+            return ret;
+        }
+        if (ret != ESP_OK && first_err == ESP_OK) {
+            first_err = ret;
+        }
+    }
+    return first_err;
+}
+
 void ads1261_deinit(ads1261_t *device)
 {
     if (!device) return;
+    ads1261_bus_release(device);
     if (device->drdy_pin >= 0) gpio_isr_handler_remove(device->drdy_pin);
-    if (device->drdy_sem) { vSemaphoreDelete((SemaphoreHandle_t)device->drdy_sem); device->drdy_sem = NULL; }
+    device->drdy_irq = false;
+    device->drdy_task = NULL;
     if (device->spi_handle) { spi_bus_remove_device(device->spi_handle); device->spi_handle = NULL; }
 }
 
@@ -3,32 +3,15 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "driver/spi_master.h"
+#include "ads1261_frame.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/* ADS1261 Register Addresses - Per datasheet */
-#define ADS1261_REG_ID          0x00
-#define ADS1261_REG_STATUS      0x01
-#define ADS1261_REG_MODE0       0x02
-#define ADS1261_REG_MODE1       0x03
-#define ADS1261_REG_MODE2       0x04
-#define ADS1261_REG_MODE3       0x05
-#define ADS1261_REG_REF         0x06
-#define ADS1261_REG_OFCAL0      0x07
-#define ADS1261_REG_OFCAL1      0x08
-#define ADS1261_REG_OFCAL2      0x09
-#define ADS1261_REG_FSCAL0      0x0A
-#define ADS1261_REG_FSCAL1      0x0B
-#define ADS1261_REG_FSCAL2      0x0C
-#define ADS1261_REG_IMUX        0x0D
-#define ADS1261_REG_IMAG        0x0E
-#define ADS1261_REG_RESERVED    0x0F
-#define ADS1261_REG_PGA         0x10
-#define ADS1261_REG_INPMUX      0x11
-#define ADS1261_REG_INPBIAS     0x12
+/* Opcodes, register addresses and SPI framing: ads1261_frame.h */
 
 /* PGA Gain Settings */
 #define ADS1261_PGA_GAIN_1      0x00
@@ -44,7 +27,7 @@ extern "C" {
 #define ADS1261_MUXP_AIN0       0x00
 #define ADS1261_MUXN_AIN1       0x01
 
-/* Data Rate Settings (in SPS - Samples Per Second) - Placed in MODE0[3:0] */
+/* Data Rate Settings (in SPS - Samples Per Second) - Placed in MODE0[7:3] */
 #define ADS1261_DR_2_5_SPS      0x00  /* 2.5 SPS */
 #define ADS1261_DR_5_SPS        0x01  /* 5 SPS */
 #define ADS1261_DR_10_SPS       0x02  /* 10 SPS */
@@ -65,7 +48,7 @@ extern "C" {
 /* For compatibility */
 #define ADS1261_DR_1000         ADS1261_DR_1200_SPS
 
-/* Filter Settings - Placed in MODE0[7:5] */
+/* Filter Settings - Placed in MODE0[2:0] */
 #define ADS1261_REG_MODE0_FILTER_SINC1    0x00
 #define ADS1261_REG_MODE0_FILTER_SINC2    0x01
 #define ADS1261_REG_MODE0_FILTER_SINC3    0x02
@@ -73,20 +56,178 @@ extern "C" {
 #define ADS1261_REG_MODE0_FILTER_FIR      0x04  /* Default filter type */
 #define ADS1261_REG_MODE0_FILTER_SINC5    0x05  /* Required for 40kSPS */
 
+/* MODE1 fields */
+#define ADS1261_MODE1_CONVRT_PULSE        (1 << 4)  /* 0 = continuous, 1 = pulse (one-shot per START) */
+
 /* Reference Selection */
-#define ADS1261_REFSEL_INT      0x00
-#define ADS1261_REFSEL_EXT1     0x01
-#define ADS1261_REFSEL_EXT2     0x02
+#define ADS1261_REFSEL_INT      0x00    /* Internal 2.5 V */
+#define ADS1261_REFSEL_EXT1     0x01    /* External, AIN0 / AIN1 */
+#define ADS1261_REFSEL_EXT2     0x02    /* External, AIN2 / AIN3 */
+#define ADS1261_REFSEL_AVDD     0x03    /* Supply, AVDD / AVSS (power-on default) */
+
+/*
+ * Typed register layouts (datasheet register map, LSB-first bitfields as in
+ * ADS1261_REGISTERS_Type of the Arduino reference driver)
+ */
+typedef union {
+    struct { uint8_t rev_id : 4; uint8_t dev_id : 4; } bits;
+    uint8_t reg;
+} ads1261_id_reg_t;
+
+typedef union {
+    struct {
+        uint8_t reset : 1;
+        uint8_t clock : 1;
+        uint8_t drdy : 1;
+        uint8_t refl_alm : 1;
+        uint8_t pgah_alm : 1;
+        uint8_t pgal_alm : 1;
+        uint8_t crcerr : 1;
+        uint8_t lock : 1;
+    } bits;
+    uint8_t reg;
+} ads1261_status_reg_t;
+
+typedef union {
+    struct { uint8_t filter : 3; uint8_t dr : 5; } bits;
+    uint8_t reg;
+} ads1261_mode0_reg_t;
+
+typedef union {
+    struct { uint8_t delay : 4; uint8_t convrt : 1; uint8_t chop : 2; uint8_t reserved : 1; } bits;
+    uint8_t reg;
+} ads1261_mode1_reg_t;
+
+typedef union {
+    struct { uint8_t gpio_dir : 4; uint8_t gpio_con : 4; } bits;
+    uint8_t reg;
+} ads1261_mode2_reg_t;
+
+typedef union {
+    struct {
+        uint8_t gpio_dat : 4;
+        uint8_t spitim : 1;
+        uint8_t crcenb : 1;
+        uint8_t statenb : 1;
+        uint8_t pwdn : 1;
+    } bits;
+    uint8_t reg;
+} ads1261_mode3_reg_t;
+
+typedef union {
+    struct { uint8_t rmuxn : 2; uint8_t rmuxp : 2; uint8_t refenb : 1; uint8_t reserved : 3; } bits;
+    uint8_t reg;
+} ads1261_ref_reg_t;
+
+typedef union {
+    struct { uint8_t imux1 : 4; uint8_t imux2 : 4; } bits;
+    uint8_t reg;
+} ads1261_imux_reg_t;
+
+typedef union {
+    struct { uint8_t imag1 : 4; uint8_t imag2 : 4; } bits;
+    uint8_t reg;
+} ads1261_imag_reg_t;
+
+typedef union {
+    struct { uint8_t gain : 3; uint8_t reserved : 4; uint8_t bypass : 1; } bits;
+    uint8_t reg;
+} ads1261_pga_reg_t;
+
+typedef union {
+    struct { uint8_t muxn : 4; uint8_t muxp : 4; } bits;
+    uint8_t reg;
+} ads1261_inpmux_reg_t;
+
+typedef union {
+    struct { uint8_t bocs : 3; uint8_t bocsp : 1; uint8_t vbias : 1; uint8_t reserved : 3; } bits;
+    uint8_t reg;
+} ads1261_inpbias_reg_t;
+
+/* Complete register map, addressable by field or by register address */
+typedef union {
+    struct {
+        ads1261_id_reg_t id;
+        ads1261_status_reg_t status;
+        ads1261_mode0_reg_t mode0;
+        ads1261_mode1_reg_t mode1;
+        ads1261_mode2_reg_t mode2;
+        ads1261_mode3_reg_t mode3;
+        ads1261_ref_reg_t ref;
+        uint8_t ofcal[3];           /* OFCAL0..2, little-endian 24-bit */
+        uint8_t fscal[3];           /* FSCAL0..2, little-endian 24-bit */
+        ads1261_imux_reg_t imux;
+        ads1261_imag_reg_t imag;
+        uint8_t reserved;
+        ads1261_pga_reg_t pga;
+        ads1261_inpmux_reg_t inpmux;
+        ads1261_inpbias_reg_t inpbias;
+    };
+    uint8_t raw[ADS1261_NUM_REGS];
+} ads1261_regs_t;
+
+/* Calibration register scaling: output = (input - OFCAL) * FSCAL / ADS1261_FSCAL_UNITY */
+#define ADS1261_FSCAL_UNITY     0x400000
+#define ADS1261_FSCAL_MAX       0xFFFFFF
+#define ADS1261_OFCAL_MIN       (-0x800000)
+#define ADS1261_OFCAL_MAX       0x7FFFFF
+
+/* Depth of the asynchronous transaction queue (submit/complete API):
+ * RDATA plus a full step change (MODE1, PGA, OFCAL x3, FSCAL x3, INPMUX, START) */
+#define ADS1261_QUEUE_DEPTH     12
+
+/* One in-flight queued transaction with its own frame buffers */
+typedef struct {
+    spi_transaction_t trans;
+    ads1261_op_t op;
+    uint8_t reg;
+    uint8_t mode3;              /* MODE3 framing in effect when the frame was built */
+    uint8_t tx[ADS1261_FRAME_MAX] __attribute__((aligned(4)));
+    uint8_t rx[ADS1261_FRAME_MAX] __attribute__((aligned(4)));
+} ads1261_slot_t;
+
+/* Completed queued transaction, returned in submission order */
+typedef struct {
+    ads1261_op_t op;
+    uint8_t reg;                /* Register address for WREG/RREG */
+    int32_t value;              /* Register value (RREG) or sign-extended code (RDATA) */
+    uint8_t status;             /* STATUS byte framed with RDATA (MODE3.STATENB), else 0 */
+} ads1261_result_t;
+
+/* Read-path integrity counters (MODE3.STATENB / CRCENB framing) */
+typedef struct {
+    uint32_t checked;           /* Responses verified against their CRC and/or STATUS */
+    uint32_t crc_errors;        /* Response CRC mismatch: corrupted on the wire */
+    uint32_t stale_reads;       /* RDATA with STATUS.DRDY clear: conversion already read */
+    uint32_t cmd_crc_errors;    /* STATUS.CRCERR raised: the device rejected a command */
+    uint32_t alarms;            /* STATUS PGA / reference alarm raised */
+} ads1261_integrity_t;
 
 typedef struct {
     spi_device_handle_t spi_handle;
     int cs_pin;
     int drdy_pin;
     bool use_hw_cs;
-    // internal SPI buffers (DMA-safe) used by driver transactions
-    uint8_t tx_buf[4];
-    uint8_t rx_buf[4];
-    void *drdy_sem; /* opaque pointer to FreeRTOS semaphore (created in driver) */
+    // internal SPI buffers (DMA-safe) used by driver transactions;
+    // one buffer holds a whole command frame so each command is one transaction
+    uint8_t tx_buf[ADS1261_FRAME_MAX] __attribute__((aligned(4)));
+    uint8_t rx_buf[ADS1261_FRAME_MAX] __attribute__((aligned(4)));
+    void *drdy_task; /* opaque TaskHandle_t notified by the DRDY ISR (set by ads1261_drdy_arm) */
+    volatile bool drdy_flag; /* set by the DRDY ISR, cleared by arm/wait */
+    bool drdy_irq;   /* DRDY ISR installed; otherwise STATUS register polling */
+    uint32_t drdy_timeouts;
+    // asynchronous queue: slots are used round-robin, completed in FIFO order
+    ads1261_slot_t slots[ADS1261_QUEUE_DEPTH];
+    uint8_t slot_head;
+    uint8_t in_flight;
+    bool bus_acquired;
+    // register shadow: last value written to / read from each register
+    ads1261_regs_t shadow;
+    uint32_t shadow_valid;      /* Bit n set when shadow.raw[n] matches the device */
+    uint32_t shadow_skips;      /* Writes skipped because the value was unchanged */
+    // integrity checking of framed reads
+    ads1261_integrity_t integrity;
+    uint8_t last_status;        /* STATUS byte of the latest framed RDATA */
 } ads1261_t;
 
 /* Initialize ADS1261 */
@@ -95,27 +236,126 @@ esp_err_t ads1261_init(ads1261_t *device, spi_host_device_t host, int cs_pin, in
 /* Configure input multiplexer for differential measurement */
 esp_err_t ads1261_set_mux(ads1261_t *device, uint8_t muxp, uint8_t muxn);
 
-/* Set PGA gain */
+/* Set PGA gain (GAIN field only) */
 esp_err_t ads1261_set_pga(ads1261_t *device, uint8_t gain);
 
-/* Set data rate */
+/* Set data rate (DR field only; the digital filter selection is kept) */
 esp_err_t ads1261_set_datarate(ads1261_t *device, uint8_t datarate);
 
-/* Set reference selection */
+/* Set reference selection (ADS1261_REFSEL_*) */
 esp_err_t ads1261_set_ref(ads1261_t *device, uint8_t refsel);
 
 /* Start conversion */
 esp_err_t ads1261_start_conversion(ads1261_t *device);
 
+/*
+ * Hardware calibration
+ *
+ * The ADC corrects every conversion as (input - OFCAL) * FSCAL / 0x400000
+ * before it is read, so offset and gain cost nothing per sample. Writes go
+ * through the register shadow, so loading the same values again is free and
+ * swapping between channels only sends the bytes that differ.
+ */
+
+/* Load offset (24-bit signed) and full-scale (24-bit unsigned) corrections */
+esp_err_t ads1261_set_calibration(ads1261_t *device, int32_t ofcal, uint32_t fscal);
+
+/* Read the corrections currently in OFCAL/FSCAL */
+esp_err_t ads1261_get_calibration(ads1261_t *device, int32_t *ofcal, uint32_t *fscal);
+
+/*
+ * Run a calibration command (ADS1261_CMD_SYOCAL, _GANCAL or _SFOCAL) on the
+ * selected input and wait for it to finish. The ADC measures the input and
+ * updates OFCAL (offset commands) or FSCAL (GANCAL); the new values are read
+ * back into the shadow. Conversions must be running (continuous mode or
+ * after START).
+ */
+esp_err_t ads1261_calibrate(ads1261_t *device, uint8_t cmd, uint32_t timeout_ms);
+
+/*
+ * Data-ready synchronisation
+ *
+ * ads1261_drdy_arm() registers the calling task for DRDY notifications and
+ * discards edges that already happened; call it once the command that
+ * restarts conversion (e.g. an INPMUX write) has completed - the restart
+ * holds DRDY for the settle time, so no edge of the new input is lost, and
+ * any edge seen earlier belongs to the previous one. ads1261_wait_drdy() then
+ * blocks until the next conversion completes: on the DRDY falling edge via a
+ * direct task notification, or by polling STATUS.DRDY when no DRDY pin/ISR
+ * exists. Several devices may notify the same task; each ISR also flags its
+ * own device, so a wait only returns for the device it was called on.
+ * Returns ESP_ERR_TIMEOUT if no conversion completed in time.
+ */
+void ads1261_drdy_arm(ads1261_t *device);
+esp_err_t ads1261_wait_drdy(ads1261_t *device, uint32_t timeout_ms);
+
+/*
+ * Enable STATUS and/or CRC framing of reads (MODE3.STATENB / CRCENB)
+ *
+ * With status_byte, every RDATA carries the STATUS byte and a read whose
+ * DRDY bit is clear fails with ESP_ERR_NOT_FINISHED (stale conversion).
+ * With crc, commands carry an input CRC and every response payload is
+ * followed by a CRC-8 (x^8 + x^2 + x + 1, seed 0xFF); a mismatch fails with
+ * ESP_ERR_INVALID_CRC. Both cost no extra transactions; failures are
+ * counted in device->integrity.
+ */
+esp_err_t ads1261_set_integrity(ads1261_t *device, bool status_byte, bool crc);
+
 /* Read ADC value (24-bit) */
 esp_err_t ads1261_read_adc(ads1261_t *device, int32_t *value);
 
 /* Read register */
 esp_err_t ads1261_read_register(ads1261_t *device, uint8_t reg, uint8_t *value);
 
-/* Write register */
+/* Write register (skipped when the shadow shows the value is already set) */
 esp_err_t ads1261_write_register(ads1261_t *device, uint8_t reg, uint8_t value);
 
+/* Get a register value from the shadow, reading the device only on a miss */
+esp_err_t ads1261_get_register(ads1261_t *device, uint8_t reg, uint8_t *value);
+
+/*
+ * Read all registers, compare them with the shadow and refresh it.
+ * Bit n of *mismatch is set when register n differed from a valid shadow entry.
+ */
+esp_err_t ads1261_snapshot(ads1261_t *device, ads1261_regs_t *regs, uint32_t *mismatch);
+
+/*
+ * Asynchronous (queued) access
+ *
+ * Submit calls queue a transaction and return immediately; ads1261_complete()
+ * returns results in submission order. Acquiring the bus for a whole frame
+ * keeps other devices off it so back-to-back transactions run without
+ * re-arbitration. Polling calls (read_adc, read/write_register) must not be
+ * mixed with outstanding queued transactions.
+ */
+
+/* Acquire the SPI bus for a sequence of transactions */
+esp_err_t ads1261_bus_acquire(ads1261_t *device);
+
+/* Drain outstanding transactions and release the SPI bus */
+void ads1261_bus_release(ads1261_t *device);
+
+/* Queue a bare command opcode */
+esp_err_t ads1261_submit_command(ads1261_t *device, uint8_t cmd);
+
+/* Queue a register write (not queued when the shadow shows it is already set) */
+esp_err_t ads1261_submit_write_register(ads1261_t *device, uint8_t reg, uint8_t value);
+
+/* Queue the OFCAL/FSCAL writes that differ from the shadow */
+esp_err_t ads1261_submit_calibration(ads1261_t *device, int32_t ofcal, uint32_t fscal);
+
+/* Queue a register read */
+esp_err_t ads1261_submit_read_register(ads1261_t *device, uint8_t reg);
+
+/* Queue a conversion read */
+esp_err_t ads1261_submit_read_adc(ads1261_t *device);
+
+/* Wait for the oldest queued transaction and decode its result */
+esp_err_t ads1261_complete(ads1261_t *device, ads1261_result_t *result, uint32_t timeout_ms);
+
+/* Wait for every outstanding queued transaction, discarding results */
+esp_err_t ads1261_complete_all(ads1261_t *device, uint32_t timeout_ms);
+
 /* Deinitialize */
 void ads1261_deinit(ads1261_t *device);
 
@@ -0,0 +1,302 @@
+/**
+ * @file ads1261.hpp
+ * @brief Header-only ADS1261 driver, templated on the SPI transport
+ *
+ * The select/wait/read path over the command framing (STATUS prefix and
+ * CRC-8 as configured in MODE3), shared by the ESP-IDF, Arduino and host
+ * builds. The transport is a policy
+ * class; ads1261_transport.hpp has the ESP-IDF spi_master and Arduino SPI
+ * ones. A transport provides:
+ *
+ *   bool transfer(const uint8_t *tx, uint8_t *rx, size_t n);
+ *       One full-duplex frame of n bytes (n <= ads1261::MAX_FRAME) under CS
+ *   int drdy_level();
+ *       DRDY pin level, or -1 when DRDY is not wired (STATUS is polled)
+ *   uint32_t micros();
+ *   void delay_us(uint32_t us);
+ *
+ * Everything is inline: a read compiles down to the transport's transfer
+ * calls plus the framing arithmetic. Opcodes, register addresses, the
+ * CRC-8, frame layout and checks and the register shadow come from
+ * ads1261_frame.h, the same code the C driver in ads1261.h runs; that
+ * driver remains the one used by the firmware (queued transactions, DRDY
+ * interrupt, sequencer).
+ */
+
+#ifndef ADS1261_HPP
+#define ADS1261_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ads1261_frame.h"
+
+namespace ads1261 {
+
+/* Register addresses */
+namespace reg {
+constexpr uint8_t ID      = ADS1261_REG_ID;
+constexpr uint8_t STATUS  = ADS1261_REG_STATUS;
+constexpr uint8_t MODE0   = ADS1261_REG_MODE0;
+constexpr uint8_t MODE1   = ADS1261_REG_MODE1;
+constexpr uint8_t MODE2   = ADS1261_REG_MODE2;
+constexpr uint8_t MODE3   = ADS1261_REG_MODE3;
+constexpr uint8_t REF     = ADS1261_REG_REF;
+constexpr uint8_t OFCAL0  = ADS1261_REG_OFCAL0;
+constexpr uint8_t OFCAL1  = ADS1261_REG_OFCAL1;
+constexpr uint8_t OFCAL2  = ADS1261_REG_OFCAL2;
+constexpr uint8_t FSCAL0  = ADS1261_REG_FSCAL0;
+constexpr uint8_t FSCAL1  = ADS1261_REG_FSCAL1;
+constexpr uint8_t FSCAL2  = ADS1261_REG_FSCAL2;
+constexpr uint8_t IMUX    = ADS1261_REG_IMUX;
+constexpr uint8_t IMAG    = ADS1261_REG_IMAG;
+constexpr uint8_t PGA     = ADS1261_REG_PGA;
+constexpr uint8_t INPMUX  = ADS1261_REG_INPMUX;
+constexpr uint8_t INPBIAS = ADS1261_REG_INPBIAS;
+constexpr uint8_t COUNT   = ADS1261_NUM_REGS;
+}  // namespace reg
+
+/* Command opcodes (RREG/WREG take the register address in the low 5 bits) */
+namespace cmd {
+constexpr uint8_t NOP    = ADS1261_CMD_NOP;
+constexpr uint8_t RESET  = ADS1261_CMD_RESET;
+constexpr uint8_t START  = ADS1261_CMD_START;
+constexpr uint8_t STOP   = ADS1261_CMD_STOP;
+constexpr uint8_t RDATA  = ADS1261_CMD_RDATA;
+constexpr uint8_t SYOCAL = ADS1261_CMD_SYOCAL;
+constexpr uint8_t GANCAL = ADS1261_CMD_GANCAL;
+constexpr uint8_t SFOCAL = ADS1261_CMD_SFOCAL;
+constexpr uint8_t RREG   = ADS1261_CMD_RREG;
+constexpr uint8_t WREG   = ADS1261_CMD_WREG;
+constexpr uint8_t LOCK   = ADS1261_CMD_LOCK;
+constexpr uint8_t UNLOCK = ADS1261_CMD_UNLOCK;
+}  // namespace cmd
+
+/* A bit field of one register */
+template <uint8_t Reg, uint8_t Shift, uint8_t Width>
+struct Field {
+    static constexpr uint8_t reg = Reg;
+    static constexpr uint8_t mask = static_cast<uint8_t>(((1u << Width) - 1u) << Shift);
+
+    static constexpr uint8_t get(uint8_t value) { return static_cast<uint8_t>((value & mask) >> Shift); }
+    static constexpr uint8_t set(uint8_t value, uint8_t field)
+    {
+        return static_cast<uint8_t>((value & ~mask) | ((field << Shift) & mask));
+    }
+};
+
+namespace field {
+using STATUS_RESET    = Field<reg::STATUS, 0, 1>;
+using STATUS_CLOCK    = Field<reg::STATUS, 1, 1>;
+using STATUS_DRDY     = Field<reg::STATUS, 2, 1>;
+using STATUS_REFL_ALM = Field<reg::STATUS, 3, 1>;
+using STATUS_PGAH_ALM = Field<reg::STATUS, 4, 1>;
+using STATUS_PGAL_ALM = Field<reg::STATUS, 5, 1>;
+using STATUS_CRCERR   = Field<reg::STATUS, 6, 1>;
+using STATUS_LOCK     = Field<reg::STATUS, 7, 1>;
+using MODE0_FILTER    = Field<reg::MODE0, 0, 3>;
+using MODE0_DR        = Field<reg::MODE0, 3, 5>;
+using MODE1_DELAY     = Field<reg::MODE1, 0, 4>;
+using MODE1_CONVRT    = Field<reg::MODE1, 4, 1>;
+using MODE1_CHOP      = Field<reg::MODE1, 5, 2>;
+using MODE3_SPITIM    = Field<reg::MODE3, 4, 1>;
+using MODE3_CRCENB    = Field<reg::MODE3, 5, 1>;
+using MODE3_STATENB   = Field<reg::MODE3, 6, 1>;
+using MODE3_PWDN      = Field<reg::MODE3, 7, 1>;
+using REF_RMUXN       = Field<reg::REF, 0, 2>;
+using REF_RMUXP       = Field<reg::REF, 2, 2>;
+using REF_REFENB      = Field<reg::REF, 4, 1>;
+using PGA_GAIN        = Field<reg::PGA, 0, 3>;
+using PGA_BYPASS      = Field<reg::PGA, 7, 1>;
+using INPMUX_MUXN     = Field<reg::INPMUX, 0, 4>;
+using INPMUX_MUXP     = Field<reg::INPMUX, 4, 4>;
+}  // namespace field
+
+/* Longest frame: header + CRC, STATUS + 3 data bytes + CRC */
+constexpr size_t MAX_FRAME = ADS1261_FRAME_MAX;
+
+enum class Result : uint8_t {
+    ok,
+    bus_error,      /* Transport failed */
+    crc_error,      /* Response CRC mismatch */
+    stale,          /* STATUS.DRDY clear: the data was already read */
+    timeout,        /* No conversion completed in time */
+};
+
+/* Read-path counters (same meaning as ads1261_integrity_t) */
+struct Integrity {
+    uint32_t checked;
+    uint32_t crc_errors;
+    uint32_t stale_reads;
+};
+
+template <class Transport>
+class Device {
+public:
+    explicit Device(Transport &bus) : bus_(bus) {}
+
+    Transport &transport() { return bus_; }
+    const Integrity &integrity() const { return integrity_; }
+
+    /* RESET command: registers return to their power-on values, framing to plain */
+    Result reset() { return command(cmd::RESET); }
+
+    Result command(uint8_t opcode)
+    {
+        uint8_t tx[MAX_FRAME];
+        uint8_t rx[MAX_FRAME];
+        size_t len = ads1261_frame(mode3(), tx, ADS1261_OP_COMMAND, opcode, 0x00);
+        ads1261_shadow_command(shadow_, &shadow_valid_, opcode);
+        return xfer(tx, rx, len);
+    }
+
+    /* Read a register from the device (refreshes the shadow) */
+    Result read_register(uint8_t address, uint8_t &value)
+    {
+        uint8_t tx[MAX_FRAME];
+        uint8_t rx[MAX_FRAME];
+        uint8_t framing = mode3();
+        size_t len = ads1261_frame(framing, tx, ADS1261_OP_RREG, static_cast<uint8_t>(cmd::RREG | address), 0x00);
+
+        int32_t data;
+        Result r = receive(framing, ADS1261_OP_RREG, tx, rx, len, data);
+        if (r != Result::ok) {
+            return r;
+        }
+        value = static_cast<uint8_t>(data);
+        ads1261_shadow_store(shadow_, &shadow_valid_, address, value);
+        return Result::ok;
+    }
+
+    /* Write a register; a value the shadow already holds is not sent */
+    Result write_register(uint8_t address, uint8_t value)
+    {
+        if (ads1261_shadow_matches(shadow_, shadow_valid_, address, value)) {
+            return Result::ok;
+        }
+        uint8_t tx[MAX_FRAME];
+        uint8_t rx[MAX_FRAME];
+        size_t len = ads1261_frame(mode3(), tx, ADS1261_OP_WREG, static_cast<uint8_t>(cmd::WREG | address), value);
+        Result r = xfer(tx, rx, len);
+        if (r == Result::ok) {
+            ads1261_shadow_store(shadow_, &shadow_valid_, address, value);
+        } else {
+            ads1261_shadow_forget(&shadow_valid_, address);
+        }
+        return r;
+    }
+
+    /* Read-modify-write of one field, from the shadow when it is known */
+    template <class F>
+    Result write_field(uint8_t value)
+    {
+        uint8_t current = shadow_[F::reg];
+        if (!ads1261_shadow_known(shadow_valid_, F::reg)) {
+            Result r = read_register(F::reg, current);
+            if (r != Result::ok) {
+                return r;
+            }
+        }
+        return write_register(F::reg, F::set(current, value));
+    }
+
+    /* STATUS byte ahead of each conversion and CRC on every frame */
+    Result set_framing(bool status, bool crc)
+    {
+        uint8_t framing = field::MODE3_STATENB::set(mode3(), status);
+        return write_register(reg::MODE3, field::MODE3_CRCENB::set(framing, crc));
+    }
+
+    /* Select the input pair; the mux write restarts conversion */
+    Result select_input(uint8_t muxp, uint8_t muxn)
+    {
+        uint8_t inpmux = field::INPMUX_MUXN::set(field::INPMUX_MUXP::set(0, muxp), muxn);
+        return write_register(reg::INPMUX, inpmux);
+    }
+
+    /* Wait for a completed conversion: DRDY pin when wired, STATUS.DRDY otherwise */
+    Result wait_ready(uint32_t timeout_us)
+    {
+        uint32_t start = bus_.micros();
+        for (;;) {
+            int level = bus_.drdy_level();
+            if (level == 0) {
+                return Result::ok;
+            }
+            if (level < 0) {
+                uint8_t status;
+                if (read_register(reg::STATUS, status) == Result::ok && field::STATUS_DRDY::get(status)) {
+                    return Result::ok;
+                }
+            }
+            if (bus_.micros() - start >= timeout_us) {
+                return Result::timeout;
+            }
+            bus_.delay_us(1);
+        }
+    }
+
+    /* RDATA in one frame; with STATENB a read of already-read data reports stale */
+    Result read_data(int32_t &code)
+    {
+        uint8_t tx[MAX_FRAME];
+        uint8_t rx[MAX_FRAME];
+        uint8_t framing = mode3();
+        size_t len = ads1261_frame(framing, tx, ADS1261_OP_RDATA, cmd::RDATA, 0x00);
+        return receive(framing, ADS1261_OP_RDATA, tx, rx, len, code);
+    }
+
+    /* Select an input pair and read its first settled conversion */
+    Result read_input(uint8_t muxp, uint8_t muxn, int32_t &code, uint32_t timeout_us)
+    {
+        Result r = select_input(muxp, muxn);
+        if (r == Result::ok) {
+            r = wait_ready(timeout_us);
+        }
+        if (r == Result::ok) {
+            r = read_data(code);
+        }
+        return r;
+    }
+
+private:
+    uint8_t mode3() const { return shadow_[reg::MODE3]; }
+
+    /* Transfer a RREG/RDATA frame and check its response, counting the outcome */
+    Result receive(uint8_t framing, ads1261_op_t op, const uint8_t *tx, uint8_t *rx, size_t len, int32_t &value)
+    {
+        Result r = xfer(tx, rx, len);
+        if (r != Result::ok) {
+            return r;
+        }
+        uint8_t status;
+        switch (ads1261_frame_check(framing, op, rx, &value, &status)) {
+        case ADS1261_FRAME_UNCHECKED:
+            return Result::ok;
+        case ADS1261_FRAME_CRC_ERROR:
+            integrity_.checked++;
+            integrity_.crc_errors++;
+            return Result::crc_error;
+        case ADS1261_FRAME_STALE:
+            integrity_.checked++;
+            integrity_.stale_reads++;
+            return Result::stale;
+        default:
+            integrity_.checked++;
+            return Result::ok;
+        }
+    }
+
+    Result xfer(const uint8_t *tx, uint8_t *rx, size_t n)
+    {
+        return bus_.transfer(tx, rx, n) ? Result::ok : Result::bus_error;
+    }
+
+    Transport &bus_;
+    uint8_t shadow_[ADS1261_NUM_REGS] = {};    /* Register shadow, see ads1261_frame.h */
+    uint32_t shadow_valid_ = 0;
+    Integrity integrity_ = {};
+};
+
+}  // namespace ads1261
+
+#endif /* ADS1261_HPP */
@@ -0,0 +1,258 @@
+/**
+ * @file ads1261_frame.h
+ * @brief ADS1261 register map, SPI command framing and register shadow
+ *
+ * The one implementation of what goes over the wire, shared by the C driver
+ * (ads1261.c) and the header-only C++ driver (ads1261.hpp): opcodes and
+ * register addresses, the CRC-8 the device uses, frame layout for the
+ * MODE3 STATENB/CRCENB setting in effect, the response check, and the
+ * register shadow that lets unchanged writes be skipped. Everything is
+ * static inline and depends on no framework, so the Arduino build needs
+ * only this directory on its include path.
+ */
+
+#ifndef ADS1261_FRAME_H
+#define ADS1261_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ADS1261 Commands */
+#define ADS1261_CMD_NOP         0x00
+#define ADS1261_CMD_RESET       0x06
+#define ADS1261_CMD_START       0x08
+#define ADS1261_CMD_STOP        0x0A
+#define ADS1261_CMD_RDATA       0x12
+#define ADS1261_CMD_SYOCAL      0x16    /* System offset calibration (inputs at zero) */
+#define ADS1261_CMD_GANCAL      0x17    /* System gain calibration (inputs at full scale) */
+#define ADS1261_CMD_SFOCAL      0x19    /* Self offset calibration (inputs shorted internally) */
+#define ADS1261_CMD_RREG        0x20
+#define ADS1261_CMD_WREG        0x40
+#define ADS1261_CMD_LOCK        0xF2
+#define ADS1261_CMD_UNLOCK      0xF5
+
+/* ADS1261 Register Addresses - Per datasheet */
+#define ADS1261_REG_ID          0x00
+#define ADS1261_REG_STATUS      0x01
+#define ADS1261_REG_MODE0       0x02
+#define ADS1261_REG_MODE1       0x03
+#define ADS1261_REG_MODE2       0x04
+#define ADS1261_REG_MODE3       0x05
+#define ADS1261_REG_REF         0x06
+#define ADS1261_REG_OFCAL0      0x07
+#define ADS1261_REG_OFCAL1      0x08
+#define ADS1261_REG_OFCAL2      0x09
+#define ADS1261_REG_FSCAL0      0x0A
+#define ADS1261_REG_FSCAL1      0x0B
+#define ADS1261_REG_FSCAL2      0x0C
+#define ADS1261_REG_IMUX        0x0D
+#define ADS1261_REG_IMAG        0x0E
+#define ADS1261_REG_RESERVED    0x0F
+#define ADS1261_REG_PGA         0x10
+#define ADS1261_REG_INPMUX      0x11
+#define ADS1261_REG_INPBIAS     0x12
+
+/* Number of registers in the map (0x00..0x12) */
+#define ADS1261_NUM_REGS        19
+
+/* Registers the device changes on its own; never served from the shadow */
+#define ADS1261_SHADOW_VOLATILE ((1u << ADS1261_REG_ID) | (1u << ADS1261_REG_STATUS))
+
+/* Longest SPI command frame: RDATA opcode + echo + input CRC + STATUS + 3 data + CRC */
+#define ADS1261_FRAME_MAX       8
+
+/* MODE3 framing bits */
+#define ADS1261_MODE3_CRCENB    (1 << 5)    /* Input CRC on commands, CRC after each response */
+#define ADS1261_MODE3_STATENB   (1 << 6)    /* STATUS byte ahead of each conversion */
+
+/* STATUS bits */
+#define ADS1261_STATUS_DRDY     (1 << 2)
+#define ADS1261_STATUS_CRCERR   (1 << 6)
+#define ADS1261_STATUS_ALARMS   ((1 << 5) | (1 << 4) | (1 << 3))  /* PGAL, PGAH, REFL */
+
+/* Kind of command carried by a frame */
+typedef enum {
+    ADS1261_OP_COMMAND = 0,     /* Bare opcode (START, STOP, ...) */
+    ADS1261_OP_WREG,            /* Register write */
+    ADS1261_OP_RREG,            /* Register read */
+    ADS1261_OP_RDATA,           /* Conversion read */
+} ads1261_op_t;
+
+/* Outcome of checking a response payload */
+typedef enum {
+    ADS1261_FRAME_UNCHECKED = 0,    /* Framing carries no CRC or STATUS to check */
+    ADS1261_FRAME_OK,               /* Checked and intact */
+    ADS1261_FRAME_CRC_ERROR,        /* Response CRC mismatch: corrupted on the wire */
+    ADS1261_FRAME_STALE,            /* STATUS.DRDY clear: the conversion was already read */
+} ads1261_frame_check_t;
+
+/* CRC-8, polynomial x^8 + x^2 + x + 1 (0x07) */
+static const uint8_t ads1261_crc8_table[256] = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15,
+    0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+    0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65,
+    0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+    0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5,
+    0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85,
+    0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+    0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2,
+    0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+    0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2,
+    0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32,
+    0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+    0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42,
+    0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+    0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C,
+    0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC,
+    0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+    0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C,
+    0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+    0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C,
+    0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B,
+    0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+    0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B,
+    0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+    0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB,
+    0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB,
+    0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3,
+};
+
+/* CRC-8 as used by the ADS1261 SPI frames, seeded with 0xFF */
+static inline uint8_t ads1261_crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0xFF;
+    while (len--) {
+        crc = ads1261_crc8_table[crc ^ *data++];
+    }
+    return crc;
+}
+
+/* Sign-extend a big-endian 24-bit two's complement conversion code */
+static inline int32_t ads1261_decode_code(const uint8_t *data)
+{
+    uint32_t raw_value = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
+    return (int32_t)(raw_value << 8) >> 8;
+}
+
+/* Command header: opcode + arbitrary/data byte, plus an input CRC when CRCENB */
+static inline size_t ads1261_header_len(uint8_t mode3)
+{
+    return (mode3 & ADS1261_MODE3_CRCENB) ? 3 : 2;
+}
+
+/* True when the response to op starts with the STATUS byte */
+static inline bool ads1261_has_status(uint8_t mode3, ads1261_op_t op)
+{
+    return op == ADS1261_OP_RDATA && (mode3 & ADS1261_MODE3_STATENB);
+}
+
+/* Response bytes after the header: data, STATUS prefix and CRC suffix as enabled */
+static inline size_t ads1261_payload_len(uint8_t mode3, ads1261_op_t op)
+{
+    size_t n = (op == ADS1261_OP_RREG) ? 1 : (op == ADS1261_OP_RDATA) ? 3 + ads1261_has_status(mode3, op) : 0;
+    return (n && (mode3 & ADS1261_MODE3_CRCENB)) ? n + 1 : n;
+}
+
+/* Build a command frame for the given MODE3 framing; returns its length */
+static inline size_t ads1261_frame(uint8_t mode3, uint8_t *tx, ads1261_op_t op, uint8_t b0, uint8_t b1)
+{
+    size_t hdr = ads1261_header_len(mode3);
+    size_t len = hdr + ads1261_payload_len(mode3, op);
+
+    tx[0] = b0;
+    tx[1] = b1;
+    if (mode3 & ADS1261_MODE3_CRCENB) {
+        tx[2] = ads1261_crc8(tx, 2);
+    }
+    for (size_t i = hdr; i < len; i++) {
+        tx[i] = 0;
+    }
+    return len;
+}
+
+/*
+ * Decode and check the response payload of a RREG/RDATA frame received with
+ * the given MODE3 framing. The value is decoded even when the check fails;
+ * *status is the STATUS byte, or 0 when the framing carries none.
+ */
+static inline ads1261_frame_check_t ads1261_frame_check(uint8_t mode3, ads1261_op_t op, const uint8_t *rx,
+                                                        int32_t *value, uint8_t *status)
+{
+    const uint8_t *payload = rx + ads1261_header_len(mode3);
+    bool has_status = ads1261_has_status(mode3, op);
+    bool has_crc = (mode3 & ADS1261_MODE3_CRCENB) != 0;
+    size_t n = ads1261_payload_len(mode3, op) - has_crc;
+
+    *status = has_status ? payload[0] : 0;
+    *value = (op == ADS1261_OP_RDATA) ? ads1261_decode_code(&payload[has_status]) : payload[0];
+
+    if (!has_crc && !has_status) {
+        return ADS1261_FRAME_UNCHECKED;
+    }
+    if (has_crc && ads1261_crc8(payload, n) != payload[n]) {
+        return ADS1261_FRAME_CRC_ERROR;
+    }
+    if (has_status && !(*status & ADS1261_STATUS_DRDY)) {
+        return ADS1261_FRAME_STALE;
+    }
+    return ADS1261_FRAME_OK;
+}
+
+/*
+ * Register shadow: raw[ADS1261_NUM_REGS] holds the last value written to or
+ * read from each register, bit n of *valid is set while raw[n] matches the
+ * device. raw[ADS1261_REG_MODE3] is the framing the next frame is built for.
+ */
+
+/* Record a register value known to be in the device */
+static inline void ads1261_shadow_store(uint8_t *raw, uint32_t *valid, uint8_t reg, uint8_t value)
+{
+    if (reg >= ADS1261_NUM_REGS) return;
+    raw[reg] = value;
+    *valid |= (1u << reg);
+}
+
+/* Stop trusting a register (a write of it may or may not have landed) */
+static inline void ads1261_shadow_forget(uint32_t *valid, uint8_t reg)
+{
+    if (reg < ADS1261_NUM_REGS) {
+        *valid &= ~(1u << reg);
+    }
+}
+
+/* True when raw[reg] can be used instead of reading the device */
+static inline bool ads1261_shadow_known(uint32_t valid, uint8_t reg)
+{
+    return reg < ADS1261_NUM_REGS && !(ADS1261_SHADOW_VOLATILE & (1u << reg)) && (valid & (1u << reg));
+}
+
+/* True when a write of value to reg would not change the device */
+static inline bool ads1261_shadow_matches(const uint8_t *raw, uint32_t valid, uint8_t reg, uint8_t value)
+{
+    return ads1261_shadow_known(valid, reg) && raw[reg] == value;
+}
+
+/* RESET returns every register to its power-on value behind the shadow's back */
+static inline void ads1261_shadow_command(uint8_t *raw, uint32_t *valid, uint8_t cmd)
+{
+    if (cmd == ADS1261_CMD_RESET) {
+        *valid = 0;
+        raw[ADS1261_REG_MODE3] = 0x00;  /* Frames after reset carry no STATUS/CRC */
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADS1261_FRAME_H */
@@ -0,0 +1,269 @@
+/**
+ * @file ads1261_seq.c
+ * @brief Scan-list sequencer for multiplexed ADS1261 inputs
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "ads1261_seq.h"
+
+static const char *TAG = "ADS1261_SEQ";
+
+#define SEQ_SPI_TIMEOUT_MS      100
+#define SEQ_DRDY_TIMEOUT_MS     1000
+
+/*
+ * Queue the writes that take the ADC to step; INPMUX goes last so it restarts
+ * conversion. The device shadow drops writes of values already in place, so
+ * only registers that differ between consecutive steps reach the bus.
+ */
+static esp_err_t seq_queue_step(ads1261_seq_t *seq, const ads1261_seq_step_t *step)
+{
+    ads1261_t *dev = seq->device;
+    ads1261_mode1_reg_t mode1 = dev->shadow.mode1;
+    mode1.bits.convrt = (step->mode == ADS1261_CONV_PULSE);
+
+    esp_err_t ret = ads1261_submit_write_register(dev, ADS1261_REG_MODE1, mode1.reg);
+    if (ret == ESP_OK) {
+        ret = ads1261_submit_write_register(dev, ADS1261_REG_PGA, step->pga);
+    }
+    if (ret == ESP_OK && step->hw_cal) {
+        ret = ads1261_submit_calibration(dev, step->ofcal, step->fscal);
+    }
+    if (ret == ESP_OK) {
+        ret = ads1261_submit_write_register(dev, ADS1261_REG_INPMUX, step->inpmux);
+    }
+    /* Pulse mode converts only on START; a settle delay defers START until after it */
+    if (ret == ESP_OK && step->mode == ADS1261_CONV_PULSE && step->settle_us == 0) {
+        ret = ads1261_submit_command(dev, ADS1261_CMD_START);
+    }
+    return ret;
+}
+
+esp_err_t ads1261_seq_init(ads1261_seq_t *seq, ads1261_t *device,
+                           const ads1261_seq_step_t *steps, uint8_t num_steps,
+                           uint32_t drdy_timeout_ms)
+{
+    if (!seq || !device || !steps || num_steps == 0 || num_steps > ADS1261_SEQ_MAX_STEPS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint8_t i = 0; i < num_steps; i++) {
+        if (steps[i].conversions > 1 && steps[i].mode != ADS1261_CONV_CONTINUOUS) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    memset(seq, 0, sizeof(*seq));
+    seq->device = device;
+    seq->num_steps = num_steps;
+    seq->drdy_timeout_ms = drdy_timeout_ms ? drdy_timeout_ms : SEQ_DRDY_TIMEOUT_MS;
+    memcpy(seq->steps, steps, num_steps * sizeof(steps[0]));
+
+    /* Load the shadow for every register the steps touch; MODE1 chop/delay bits are kept */
+    static const uint8_t regs[] = {
+        ADS1261_REG_MODE1, ADS1261_REG_PGA, ADS1261_REG_INPMUX,
+        ADS1261_REG_OFCAL0, ADS1261_REG_OFCAL1, ADS1261_REG_OFCAL2,
+        ADS1261_REG_FSCAL0, ADS1261_REG_FSCAL1, ADS1261_REG_FSCAL2,
+    };
+    for (size_t i = 0; i < sizeof(regs); i++) {
+        uint8_t value;
+        esp_err_t ret = ads1261_get_register(device, regs[i], &value);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    ESP_LOGI(TAG, "Scan list: %u steps", num_steps);
+    return ESP_OK;
+}
+
+/* Move one device to step i: settle delay and START when the step asks for it, then re-arm DRDY */
+static esp_err_t seq_begin_step(ads1261_seq_t *seq, uint8_t i)
+{
+    ads1261_t *dev = seq->device;
+    esp_err_t ret = ESP_OK;
+
+    if (seq->steps[i].settle_us) {
+        /* Inputs have settled: (re)start the conversion now */
+        esp_rom_delay_us(seq->steps[i].settle_us);
+        ret = ads1261_submit_command(dev, ADS1261_CMD_START);
+        if (ret == ESP_OK) {
+            ret = ads1261_complete_all(dev, SEQ_SPI_TIMEOUT_MS);
+        }
+        ads1261_drdy_arm(dev);
+    }
+    return ret;
+}
+
+/*
+ * Leading conversions of a burst: the input stays selected and the ADC keeps
+ * converting, so each one is a plain RDATA one data period after the last.
+ * DRDY is re-armed as soon as a result is in, before the callback runs.
+ */
+static esp_err_t seq_read_burst(ads1261_seq_t *seq, uint8_t index, uint8_t i,
+                                ads1261_seq_cb_t cb, void *ctx)
+{
+    ads1261_t *dev = seq->device;
+    ads1261_result_t result;
+
+    for (uint16_t k = 0; k + 1 < seq->steps[i].conversions; k++) {
+        esp_err_t ret = ads1261_wait_drdy(dev, seq->drdy_timeout_ms);
+        if (ret == ESP_OK) {
+            ret = ads1261_submit_read_adc(dev);
+        }
+        if (ret == ESP_OK) {
+            ret = ads1261_complete(dev, &result, SEQ_SPI_TIMEOUT_MS);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Seq %u step %u conversion %u failed: %s", index, i, k, esp_err_to_name(ret));
+            return ret;
+        }
+        ads1261_drdy_arm(dev);
+
+        ads1261_sample_t sample = {
+            .seq = index,
+            .step = i,
+            .burst_index = k,
+            .burst_end = false,
+            .raw = result.value,
+            .timestamp_us = esp_timer_get_time(),
+        };
+        cb(&sample, ctx);
+    }
+    return ESP_OK;
+}
+
+/* Read step i of one device while its step i + 1 is queued behind the RDATA */
+static esp_err_t seq_read_step(ads1261_seq_t *seq, uint8_t index, uint8_t i,
+                               ads1261_seq_cb_t cb, void *ctx)
+{
+    ads1261_t *dev = seq->device;
+    ads1261_result_t result;
+    bool has_next = (i + 1) < seq->num_steps;
+
+    esp_err_t ret = seq_read_burst(seq, index, i, cb, ctx);
+    if (ret == ESP_OK) {
+        ret = ads1261_wait_drdy(dev, seq->drdy_timeout_ms);
+    }
+    if (ret == ESP_OK) {
+        ret = ads1261_submit_read_adc(dev);
+    }
+    if (ret == ESP_OK && has_next) {
+        ret = seq_queue_step(seq, &seq->steps[i + 1]);
+    }
+    if (ret == ESP_OK) {
+        ret = ads1261_complete(dev, &result, SEQ_SPI_TIMEOUT_MS);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Seq %u step %u failed: %s", index, i, esp_err_to_name(ret));
+        return ret;
+    }
+
+    /* CPU work overlaps the next step's register writes */
+    ads1261_sample_t sample = {
+        .seq = index,
+        .step = i,
+        .burst_index = seq->steps[i].conversions > 1 ? seq->steps[i].conversions - 1 : 0,
+        .burst_end = true,
+        .raw = result.value,
+        .timestamp_us = esp_timer_get_time(),
+    };
+    cb(&sample, ctx);
+
+    ret = ads1261_complete_all(dev, SEQ_SPI_TIMEOUT_MS);
+    ads1261_drdy_arm(dev);
+    return ret;
+}
+
+/* One pass over a group: step-major, so every device converts while the others are read */
+static esp_err_t seq_run_steps(ads1261_seq_t *seqs, uint8_t num_seqs, ads1261_seq_cb_t cb, void *ctx)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t max_steps = 0;
+
+    for (uint8_t d = 0; d < num_seqs && ret == ESP_OK; d++) {
+        ret = seq_queue_step(&seqs[d], &seqs[d].steps[0]);
+        if (ret == ESP_OK) {
+            ret = ads1261_complete_all(seqs[d].device, SEQ_SPI_TIMEOUT_MS);
+        }
+        ads1261_drdy_arm(seqs[d].device);
+        if (seqs[d].num_steps > max_steps) {
+            max_steps = seqs[d].num_steps;
+        }
+    }
+
+    for (uint8_t i = 0; i < max_steps && ret == ESP_OK; i++) {
+        for (uint8_t d = 0; d < num_seqs && ret == ESP_OK; d++) {
+            if (i < seqs[d].num_steps) {
+                ret = seq_begin_step(&seqs[d], i);
+            }
+        }
+        for (uint8_t d = 0; d < num_seqs && ret == ESP_OK; d++) {
+            if (i < seqs[d].num_steps) {
+                ret = seq_read_step(&seqs[d], d, i, cb, ctx);
+            }
+        }
+    }
+
+    if (ret == ESP_OK) {
+        for (uint8_t d = 0; d < num_seqs; d++) {
+            seqs[d].passes++;
+        }
+    }
+    return ret;
+}
+
+esp_err_t ads1261_seq_run(ads1261_seq_t *seq, ads1261_seq_cb_t cb, void *ctx)
+{
+    if (!seq || !seq->device || !cb) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ads1261_bus_acquire(seq->device);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = seq_run_steps(seq, 1, cb, ctx);
+    ads1261_bus_release(seq->device);
+    return ret;
+}
+
+esp_err_t ads1261_seq_set_conversions(ads1261_seq_t *seq, uint16_t conversions)
+{
+    if (!seq || conversions == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint8_t i = 0; i < seq->num_steps; i++) {
+        if (conversions > 1 && seq->steps[i].mode != ADS1261_CONV_CONTINUOUS) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    for (uint8_t i = 0; i < seq->num_steps; i++) {
+        seq->steps[i].conversions = conversions;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ads1261_seq_run_group(ads1261_seq_t *seqs, uint8_t num_seqs, ads1261_seq_cb_t cb, void *ctx)
+{
+    if (!seqs || num_seqs == 0 || !cb) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint8_t d = 0; d < num_seqs; d++) {
+        if (!seqs[d].device) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (num_seqs == 1) {
+        return ads1261_seq_run(seqs, cb, ctx);
+    }
+
+    esp_err_t ret = seq_run_steps(seqs, num_seqs, cb, ctx);
+    for (uint8_t d = 0; d < num_seqs; d++) {
+        /* Drains anything a failed step left queued */
+        ads1261_bus_release(seqs[d].device);
+    }
+    return ret;
+}
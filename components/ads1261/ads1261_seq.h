@@ -0,0 +1,134 @@
+/**
+ * @file ads1261_seq.h
+ * @brief Scan-list sequencer for multiplexed ADS1261 inputs
+ *
+ * Runs a table of steps (input pair, PGA, settle delay, conversion mode) on
+ * one ADS1261 and emits one sample per step, tagged with the step index.
+ * A continuous-mode step may instead dwell on its input for a burst of
+ * consecutive conversions, all of which are emitted (for oversampling).
+ * Each step's RDATA is queued back-to-back with the next step's register
+ * writes (including per-step OFCAL/FSCAL corrections, so every input gets
+ * its own hardware calibration), and the device register shadow drops writes that change nothing,
+ * so adding channels only adds their own bus and conversion time.
+ *
+ * Several sequencers on devices that share a bus can run as a group: their
+ * steps are interleaved, so while one device is read out and reconfigured
+ * the others keep converting, and a pass costs about one device's settle
+ * time per step rather than one per device.
+ */
+
+#ifndef ADS1261_SEQ_H
+#define ADS1261_SEQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ads1261.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of steps in one scan list */
+#define ADS1261_SEQ_MAX_STEPS   16
+
+/* Conversion mode of a step (MODE1.CONVRT) */
+typedef enum {
+    ADS1261_CONV_CONTINUOUS = 0,    /* Mux write restarts free-running conversions */
+    ADS1261_CONV_PULSE = 1,         /* One conversion per START command */
+} ads1261_conv_mode_t;
+
+/* One entry of the scan list */
+typedef struct {
+    uint8_t inpmux;                 /* INPMUX value (MUXP << 4 | MUXN) */
+    uint8_t pga;                    /* PGA register value */
+    uint16_t settle_us;             /* Extra delay before the step's conversion starts */
+    ads1261_conv_mode_t mode;
+    bool hw_cal;                    /* Load ofcal/fscal for this step (else leave OFCAL/FSCAL alone) */
+    int32_t ofcal;                  /* OFCAL value, 24-bit signed */
+    uint32_t fscal;                 /* FSCAL value, ADS1261_FSCAL_UNITY = 1.0 */
+    uint16_t conversions;           /* Conversions read per pass (0 or 1: one; more: continuous mode only) */
+} ads1261_seq_step_t;
+
+/* Sample emitted by the sequencer */
+typedef struct {
+    uint8_t seq;                    /* Sequencer index within a group (0 for ads1261_seq_run) */
+    uint8_t step;                   /* Index into the scan list */
+    uint16_t burst_index;           /* Conversion within the step's burst (0 for single conversions) */
+    bool burst_end;                 /* Last conversion of the step in this pass */
+    int32_t raw;                    /* Sign-extended 24-bit conversion */
+    int64_t timestamp_us;           /* Time the conversion was read */
+} ads1261_sample_t;
+
+/* Called once per conversion; the last of a step runs while the next step's configuration is on the bus */
+typedef void (*ads1261_seq_cb_t)(const ads1261_sample_t *sample, void *ctx);
+
+typedef struct {
+    ads1261_t *device;
+    ads1261_seq_step_t steps[ADS1261_SEQ_MAX_STEPS];
+    uint8_t num_steps;
+    uint32_t drdy_timeout_ms;
+    uint32_t passes;                /* Completed scan passes */
+} ads1261_seq_t;
+
+/**
+ * Initialize a sequencer over an initialized ADS1261
+ *
+ * @param[out] seq          Sequencer context
+ * @param[in] device        ADS1261 device
+ * @param[in] steps         Scan list (copied)
+ * @param[in] num_steps     Number of steps (1..ADS1261_SEQ_MAX_STEPS)
+ * @param[in] drdy_timeout_ms Per-step conversion timeout
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on a bad table
+ */
+esp_err_t ads1261_seq_init(ads1261_seq_t *seq, ads1261_t *device,
+                           const ads1261_seq_step_t *steps, uint8_t num_steps,
+                           uint32_t drdy_timeout_ms);
+
+/**
+ * Run one pass over the scan list
+ *
+ * Holds the SPI bus for the whole pass. The callback is invoked once per
+ * step in order; it must not touch the ADS1261.
+ *
+ * @param[in] seq   Sequencer context
+ * @param[in] cb    Sample callback
+ * @param[in] ctx   Callback context
+ *
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if a step never converted
+ */
+esp_err_t ads1261_seq_run(ads1261_seq_t *seq, ads1261_seq_cb_t cb, void *ctx);
+
+/**
+ * Set how many consecutive conversions every step reads per pass
+ *
+ * @param[in] seq           Sequencer context (not running)
+ * @param[in] conversions   Conversions per step, 1 for one sample per step
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for 0 or pulse-mode steps with a burst
+ */
+esp_err_t ads1261_seq_set_conversions(ads1261_seq_t *seq, uint16_t conversions);
+
+/**
+ * Run one pass over several sequencers, one per device, interleaved
+ *
+ * Step i of every sequencer converts concurrently; each device is read out
+ * and moved to its step i + 1 as soon as it has converted, in group order.
+ * Lists may have different lengths. The bus is not held across devices
+ * (other devices on it could not be addressed); a group of one behaves like
+ * ads1261_seq_run(). Samples carry the sequencer's index in the group.
+ *
+ * @param[in] seqs      Sequencers, each on a different device
+ * @param[in] num_seqs  Number of sequencers
+ * @param[in] cb        Sample callback
+ * @param[in] ctx       Callback context
+ *
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if a step never converted
+ */
+esp_err_t ads1261_seq_run_group(ads1261_seq_t *seqs, uint8_t num_seqs, ads1261_seq_cb_t cb, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADS1261_SEQ_H */
@@ -0,0 +1,225 @@
+/**
+ * @file ads1261_timing.c
+ * @brief ADS1261 conversion-latency model and multiplexed-scan planner
+ */
+
+#include <math.h>
+#include <string.h>
+#include "ads1261_timing.h"
+
+/*
+ * Per data rate: conversion period and the fixed part of the first-conversion
+ * latency (decimator pipeline), both in microseconds. A sincN filter adds N
+ * periods, the FIR filter one period plus its group delay, and the 40 kSPS
+ * sinc5 path five periods.
+ */
+typedef struct {
+    float sps;
+    uint32_t period_us;
+    uint32_t base_us;
+} dr_timing_t;
+
+static const dr_timing_t dr_table[] = {
+    [ADS1261_DR_2_5_SPS]    = { 2.5f,     400000, 400 },
+    [ADS1261_DR_5_SPS]      = { 5.0f,     200000, 400 },
+    [ADS1261_DR_10_SPS]     = { 10.0f,    100000, 400 },
+    [ADS1261_DR_16_6_SPS]   = { 16.6f,    60000,  400 },
+    [ADS1261_DR_20_SPS]     = { 20.0f,    50000,  400 },
+    [ADS1261_DR_50_SPS]     = { 50.0f,    20000,  400 },
+    [ADS1261_DR_60_SPS]     = { 60.0f,    16667,  400 },
+    [ADS1261_DR_100_SPS]    = { 100.0f,   10000,  400 },
+    [ADS1261_DR_400_SPS]    = { 400.0f,   2500,   400 },
+    [ADS1261_DR_1200_SPS]   = { 1200.0f,  833,    400 },
+    [ADS1261_DR_2400_SPS]   = { 2400.0f,  417,    400 },
+    [ADS1261_DR_4800_SPS]   = { 4800.0f,  208,    400 },
+    [ADS1261_DR_7200_SPS]   = { 7200.0f,  139,    400 },
+    [ADS1261_DR_14400_SPS]  = { 14400.0f, 69,     400 },
+    [ADS1261_DR_19200_SPS]  = { 19200.0f, 52,     400 },
+    [ADS1261_DR_25600_SPS]  = { 25600.0f, 39,     400 },
+    [ADS1261_DR_40000_SPS]  = { 40000.0f, 25,     75 },
+};
+
+#define NUM_DATARATES   (sizeof(dr_table) / sizeof(dr_table[0]))
+
+/* FIR group delay on top of one conversion period */
+#define FIR_BASE_US     2200
+
+/* MODE1.DELAY: programmable wait between conversion start and sampling */
+static const uint32_t delay_table_us[ADS1261_NUM_DELAYS] = {
+    0, 50, 59, 67, 85, 119, 189, 328, 605, 1160, 2270, 4490, 8930, 17800,
+};
+
+/* Filters tried by the planner, most filtering first */
+static const uint8_t plan_filters[] = {
+    ADS1261_REG_MODE0_FILTER_FIR,
+    ADS1261_REG_MODE0_FILTER_SINC5,
+    ADS1261_REG_MODE0_FILTER_SINC4,
+    ADS1261_REG_MODE0_FILTER_SINC3,
+    ADS1261_REG_MODE0_FILTER_SINC2,
+    ADS1261_REG_MODE0_FILTER_SINC1,
+};
+
+float ads1261_datarate_sps(uint8_t datarate)
+{
+    return datarate < NUM_DATARATES ? dr_table[datarate].sps : 0.0f;
+}
+
+uint32_t ads1261_start_delay_us(uint8_t delay)
+{
+    return delay < ADS1261_NUM_DELAYS ? delay_table_us[delay] : 0;
+}
+
+const char *ads1261_filter_name(uint8_t filter)
+{
+    switch (filter) {
+    case ADS1261_REG_MODE0_FILTER_SINC1: return "sinc1";
+    case ADS1261_REG_MODE0_FILTER_SINC2: return "sinc2";
+    case ADS1261_REG_MODE0_FILTER_SINC3: return "sinc3";
+    case ADS1261_REG_MODE0_FILTER_SINC4: return "sinc4";
+    case ADS1261_REG_MODE0_FILTER_SINC5: return "sinc5";
+    case ADS1261_REG_MODE0_FILTER_FIR:   return "FIR";
+    default:                             return "?";
+    }
+}
+
+bool ads1261_filter_valid(uint8_t filter, uint8_t datarate)
+{
+    if (datarate >= NUM_DATARATES) {
+        return false;
+    }
+    switch (filter) {
+    case ADS1261_REG_MODE0_FILTER_SINC5:
+        return datarate == ADS1261_DR_40000_SPS;
+    case ADS1261_REG_MODE0_FILTER_FIR:
+        return datarate == ADS1261_DR_2_5_SPS || datarate == ADS1261_DR_5_SPS ||
+               datarate == ADS1261_DR_10_SPS || datarate == ADS1261_DR_20_SPS;
+    case ADS1261_REG_MODE0_FILTER_SINC1:
+    case ADS1261_REG_MODE0_FILTER_SINC2:
+    case ADS1261_REG_MODE0_FILTER_SINC3:
+    case ADS1261_REG_MODE0_FILTER_SINC4:
+        return datarate != ADS1261_DR_40000_SPS;
+    default:
+        return false;
+    }
+}
+
+uint32_t ads1261_settle_time_us(uint8_t filter, uint8_t datarate, uint8_t delay)
+{
+    if (!ads1261_filter_valid(filter, datarate) || delay >= ADS1261_NUM_DELAYS) {
+        return 0;
+    }
+
+    const dr_timing_t *dr = &dr_table[datarate];
+    uint32_t filter_us;
+    switch (filter) {
+    case ADS1261_REG_MODE0_FILTER_FIR:
+        filter_us = dr->period_us + FIR_BASE_US;
+        break;
+    case ADS1261_REG_MODE0_FILTER_SINC5:
+        filter_us = 5 * dr->period_us + dr->base_us;
+        break;
+    default:
+        /* SINC1..SINC4 encode as 0..3 */
+        filter_us = (filter + 1) * dr->period_us + dr->base_us;
+        break;
+    }
+    return delay_table_us[delay] + filter_us;
+}
+
+uint32_t ads1261_device_settle_time_us(const ads1261_t *device)
+{
+    if (!device) {
+        return 0;
+    }
+    return ads1261_settle_time_us(device->shadow.mode0.bits.filter, device->shadow.mode0.bits.dr,
+                                  device->shadow.mode1.bits.delay);
+}
+
+esp_err_t ads1261_timing_evaluate(uint8_t filter, uint8_t datarate, uint8_t delay,
+                                  uint8_t num_channels, uint32_t overhead_us,
+                                  ads1261_timing_plan_t *plan)
+{
+    if (!plan || num_channels == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t settle_us = ads1261_settle_time_us(filter, datarate, delay);
+    if (settle_us == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(plan, 0, sizeof(*plan));
+    plan->filter = filter;
+    plan->datarate = datarate;
+    plan->delay = delay;
+    plan->settle_us = settle_us;
+    plan->step_us = settle_us + overhead_us;
+    plan->conversions = 1;
+    /* A single input never switches: it converts at the data rate */
+    if (num_channels == 1) {
+        plan->channel_rate_hz = ads1261_datarate_sps(datarate);
+    } else {
+        plan->channel_rate_hz = 1e6f / ((float)plan->step_us * num_channels);
+    }
+    plan->frame_rate_hz = plan->channel_rate_hz;
+    return ESP_OK;
+}
+
+esp_err_t ads1261_timing_oversample(uint8_t num_channels, uint16_t conversions,
+                                    ads1261_timing_plan_t *plan)
+{
+    if (!plan || num_channels == 0 || conversions == 0 || plan->conversions == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    float sps = ads1261_datarate_sps(plan->datarate);
+    if (sps <= 0.0f) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t period_us = (uint32_t)ceilf(1e6f / sps);
+
+    /* Undo any earlier burst, then add this one */
+    plan->step_us -= (uint32_t)(plan->conversions - 1) * period_us;
+    plan->step_us += (uint32_t)(conversions - 1) * period_us;
+    plan->conversions = conversions;
+
+    if (num_channels == 1) {
+        plan->channel_rate_hz = sps / conversions;
+    } else {
+        plan->channel_rate_hz = 1e6f / ((float)plan->step_us * num_channels);
+    }
+    plan->frame_rate_hz = plan->channel_rate_hz;
+    return ESP_OK;
+}
+
+esp_err_t ads1261_plan_scan(uint8_t num_channels, float target_rate_hz, uint32_t overhead_us,
+                            uint8_t min_delay, ads1261_timing_plan_t *plan)
+{
+    if (!plan || num_channels == 0 || target_rate_hz <= 0.0f || min_delay >= ADS1261_NUM_DELAYS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ads1261_timing_plan_t fastest = {0};
+    ads1261_timing_plan_t candidate;
+
+    /* Lowest data rate first: the first choice that reaches the target filters the most */
+    for (uint8_t dr = 0; dr < NUM_DATARATES; dr++) {
+        for (size_t f = 0; f < sizeof(plan_filters); f++) {
+            if (ads1261_timing_evaluate(plan_filters[f], dr, min_delay, num_channels,
+                                        overhead_us, &candidate) != ESP_OK) {
+                continue;
+            }
+            if (candidate.channel_rate_hz >= target_rate_hz) {
+                candidate.meets_target = true;
+                *plan = candidate;
+                return ESP_OK;
+            }
+            if (candidate.channel_rate_hz > fastest.channel_rate_hz) {
+                fastest = candidate;
+            }
+        }
+    }
+
+    *plan = fastest;
+    return ESP_ERR_NOT_SUPPORTED;
+}
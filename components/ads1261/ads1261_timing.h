@@ -0,0 +1,108 @@
+/**
+ * @file ads1261_timing.h
+ * @brief ADS1261 conversion-latency model and multiplexed-scan planner
+ *
+ * After a mux or configuration change the ADS1261 holds DRDY until the
+ * digital filter has fully settled, so the first conversion it reports is
+ * already valid. That latency depends on the MODE1 start delay, the filter
+ * order and the data rate, and it - not the data rate - bounds how fast a
+ * multiplexed scan can run. The tables here follow the datasheet's
+ * conversion-latency table at the nominal 7.3728 MHz clock, chop off.
+ */
+
+#ifndef ADS1261_TIMING_H
+#define ADS1261_TIMING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "ads1261.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of MODE1.DELAY codes */
+#define ADS1261_NUM_DELAYS      14
+
+/* Filter/rate/delay choice and the scan timing it gives */
+typedef struct {
+    uint8_t filter;             /* ADS1261_REG_MODE0_FILTER_* */
+    uint8_t datarate;           /* ADS1261_DR_* */
+    uint8_t delay;              /* MODE1.DELAY code */
+    uint32_t settle_us;         /* Mux change to first valid conversion */
+    uint32_t step_us;           /* settle_us plus per-step bus overhead, plus any burst */
+    uint16_t conversions;       /* Conversions read per step (1 unless oversampling) */
+    float channel_rate_hz;      /* Per-channel rate of a continuous scan */
+    float frame_rate_hz;        /* Complete scans per second (same as channel_rate_hz) */
+    bool meets_target;          /* channel_rate_hz >= requested rate */
+} ads1261_timing_plan_t;
+
+/* Output data rate of a DR code in samples per second (0 for an invalid code) */
+float ads1261_datarate_sps(uint8_t datarate);
+
+/* MODE1.DELAY code in microseconds */
+uint32_t ads1261_start_delay_us(uint8_t delay);
+
+/* Short name of a MODE0.FILTER code ("sinc1".."sinc5", "FIR") */
+const char *ads1261_filter_name(uint8_t filter);
+
+/* True when the filter is available at the data rate */
+bool ads1261_filter_valid(uint8_t filter, uint8_t datarate);
+
+/*
+ * Latency from a mux/configuration change (or START) to the first fully
+ * settled conversion. Returns 0 for an invalid filter/rate combination.
+ */
+uint32_t ads1261_settle_time_us(uint8_t filter, uint8_t datarate, uint8_t delay);
+
+/* Settle time of the configuration held in the device's register shadow */
+uint32_t ads1261_device_settle_time_us(const ads1261_t *device);
+
+/*
+ * Fill in the scan timing of one filter/rate/delay choice
+ *
+ * @param[in] num_channels  Inputs scanned per frame
+ * @param[in] overhead_us   Bus/CPU time per step on top of the settle time
+ */
+esp_err_t ads1261_timing_evaluate(uint8_t filter, uint8_t datarate, uint8_t delay,
+                                  uint8_t num_channels, uint32_t overhead_us,
+                                  ads1261_timing_plan_t *plan);
+
+/*
+ * Extend an evaluated plan to read a burst of conversions per step
+ *
+ * After the settled first conversion the input stays selected and the ADC
+ * keeps converting, so each further conversion adds one data period to the
+ * step. Rates are recomputed; conversions = 1 gives back the plain scan.
+ *
+ * @param[in] num_channels  Inputs scanned per frame
+ * @param[in] conversions   Conversions per step (>= 1)
+ * @param[in,out] plan      Plan from ads1261_timing_evaluate()
+ */
+esp_err_t ads1261_timing_oversample(uint8_t num_channels, uint16_t conversions,
+                                    ads1261_timing_plan_t *plan);
+
+/*
+ * Pick filter, data rate and delay for a multiplexed scan
+ *
+ * Among the choices that reach target_rate_hz per channel, picks the one
+ * with the most filtering: the lowest data rate, then the highest filter
+ * order. min_delay is the smallest MODE1.DELAY the inputs need (e.g. for
+ * external RC filters). If no choice reaches the target, the fastest one
+ * is returned with meets_target = false and ESP_ERR_NOT_SUPPORTED.
+ *
+ * @param[in] num_channels  Inputs scanned per frame
+ * @param[in] target_rate_hz Required samples per second per channel
+ * @param[in] overhead_us   Bus/CPU time per step on top of the settle time
+ * @param[in] min_delay     Smallest acceptable MODE1.DELAY code
+ * @param[out] plan         Chosen configuration and reachable rates
+ */
+esp_err_t ads1261_plan_scan(uint8_t num_channels, float target_rate_hz, uint32_t overhead_us,
+                            uint8_t min_delay, ads1261_timing_plan_t *plan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADS1261_TIMING_H */
@@ -0,0 +1,126 @@
+/**
+ * @file ads1261_transport.hpp
+ * @brief SPI transports for the header-only ADS1261 driver (ads1261.hpp)
+ *
+ * IdfSpiTransport  - ESP-IDF spi_master, one polling transaction per frame
+ *                    (also what the host tests run against the SPI stand-in)
+ * ArduinoSpiTransport - Arduino SPIClass, SPI mode 1 at 8 MHz
+ *
+ * Each is only defined when its framework headers are available.
+ */
+
+#ifndef ADS1261_TRANSPORT_HPP
+#define ADS1261_TRANSPORT_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ads1261.hpp"
+
+#if defined(__has_include)
+#if __has_include("driver/spi_master.h")
+#define ADS1261_HAVE_IDF_SPI 1
+#endif
+#endif
+
+#ifdef ADS1261_HAVE_IDF_SPI
+#include "driver/spi_master.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#endif
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <SPI.h>
+#endif
+
+namespace ads1261 {
+
+#ifdef ADS1261_HAVE_IDF_SPI
+class IdfSpiTransport {
+public:
+    /* Add the device to an initialized bus; cs_pin and drdy_pin may be -1 */
+    esp_err_t attach(spi_host_device_t host, int cs_pin, int drdy_pin)
+    {
+        spi_device_interface_config_t dev_cfg = {};
+        dev_cfg.mode = 1;  /* CPOL=0, CPHA=1 */
+        dev_cfg.clock_speed_hz = 8 * 1000 * 1000;
+        dev_cfg.spics_io_num = cs_pin;
+        dev_cfg.queue_size = 1;
+        drdy_pin_ = drdy_pin;
+        return spi_bus_add_device(host, &dev_cfg, &handle_);
+    }
+
+    void detach()
+    {
+        if (handle_) {
+            spi_bus_remove_device(handle_);
+            handle_ = nullptr;
+        }
+    }
+
+    bool transfer(const uint8_t *tx, uint8_t *rx, size_t n)
+    {
+        spi_transaction_t t = {};
+        t.length = n * 8;
+        t.tx_buffer = tx;
+        t.rx_buffer = rx;
+        return spi_device_polling_transmit(handle_, &t) == ESP_OK;
+    }
+
+    int drdy_level() { return drdy_pin_ >= 0 ? gpio_get_level(static_cast<gpio_num_t>(drdy_pin_)) : -1; }
+    uint32_t micros() { return static_cast<uint32_t>(esp_timer_get_time()); }
+    void delay_us(uint32_t us) { esp_rom_delay_us(us); }
+
+private:
+    spi_device_handle_t handle_ = nullptr;
+    int drdy_pin_ = -1;
+};
+#endif /* ADS1261_HAVE_IDF_SPI */
+
+#ifdef ARDUINO
+class ArduinoSpiTransport {
+public:
+    /* SPI must already be started with the board's pins; cs_pin -1 when CS is tied low */
+    void attach(SPIClass &spi, int cs_pin, int drdy_pin)
+    {
+        spi_ = &spi;
+        cs_pin_ = cs_pin;
+        drdy_pin_ = drdy_pin;
+        if (cs_pin_ >= 0) {
+            pinMode(cs_pin_, OUTPUT);
+            digitalWrite(cs_pin_, HIGH);
+        }
+        if (drdy_pin_ >= 0) {
+            pinMode(drdy_pin_, INPUT);
+        }
+    }
+
+    bool transfer(const uint8_t *tx, uint8_t *rx, size_t n)
+    {
+        spi_->beginTransaction(SPISettings(8000000, MSBFIRST, SPI_MODE1));
+        if (cs_pin_ >= 0) {
+            digitalWrite(cs_pin_, LOW);
+        }
+        spi_->transferBytes(tx, rx, n);
+        if (cs_pin_ >= 0) {
+            digitalWrite(cs_pin_, HIGH);
+        }
+        spi_->endTransaction();
+        return true;
+    }
+
+    int drdy_level() { return drdy_pin_ >= 0 ? digitalRead(drdy_pin_) : -1; }
+    uint32_t micros() { return ::micros(); }
+    void delay_us(uint32_t us) { delayMicroseconds(us); }
+
+private:
+    SPIClass *spi_ = &SPI;
+    int cs_pin_ = -1;
+    int drdy_pin_ = -1;
+};
+#endif /* ARDUINO */
+
+}  // namespace ads1261
+
+#endif /* ADS1261_TRANSPORT_HPP */
@@ -0,0 +1,96 @@
+/**
+ * @file bench_decim.c
+ * @brief Cycle budget of the burst decimator
+ *
+ * Times loadcell_decim_push() per conversion and a whole frame (every
+ * channel's burst pushed and closed) at each oversampling factor, for 4 and
+ * 12 channels. Counts come from esp_cpu_get_cycle_count().
+ *
+ * The budget line puts the frame cost against the fastest frame rate the
+ * 40 kSPS/sinc5 scan reaches at that factor (ads1261_timing_oversample()),
+ * as a share of the C6's 160 MHz. The C6 is RV32: each of the three 64-bit
+ * integrator adds is an add, a carry compare and a second add there, so
+ * the host figures are scaled by BENCH_RV32_FACTOR for the estimate.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "esp_cpu.h"
+#include "ads1261.h"
+#include "ads1261_timing.h"
+#include "loadcell_decim.h"
+
+#define BENCH_CONVERSIONS   4000000     /* Per configuration, spread over the frames */
+#define BENCH_MAX_CHANNELS  12
+#define BENCH_CPU_HZ        160e6
+#define BENCH_RV32_FACTOR   3.0         /* Host cycles to C6 cycles, 64-bit arithmetic on a 32-bit core */
+#define BENCH_CODES         1024
+
+static loadcell_decim_t s_decim[BENCH_MAX_CHANNELS];
+static int32_t s_codes[BENCH_CODES];
+static volatile int32_t s_sink;
+
+static void fill_codes(void)
+{
+    uint32_t x = 12345;
+    for (int i = 0; i < BENCH_CODES; i++) {
+        x = x * 1664525u + 1013904223u;
+        s_codes[i] = 200000 + (int32_t)(x >> 20) - 2048;
+    }
+}
+
+/* Cycles per frame: every channel's burst pushed and closed */
+static double time_frames(int channels, uint16_t factor, int frames)
+{
+    for (int ch = 0; ch < channels; ch++) {
+        loadcell_decim_init(&s_decim[ch], factor);
+    }
+
+    unsigned k = 0;
+    int32_t sink = 0;
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (int f = 0; f < frames; f++) {
+        for (int ch = 0; ch < channels; ch++) {
+            for (int i = 0; i < factor; i++) {
+                loadcell_decim_push(&s_decim[ch], s_codes[k++ & (BENCH_CODES - 1)]);
+            }
+            sink += loadcell_decim_end_burst(&s_decim[ch]);
+        }
+    }
+    esp_cpu_cycle_count_t cycles = esp_cpu_get_cycle_count() - start;
+    s_sink = sink;
+    return (double)(uint32_t)cycles / frames;
+}
+
+int main(void)
+{
+    const int channel_counts[] = { 4, 12 };
+    ads1261_timing_plan_t plan;
+
+    fill_codes();
+    if (ads1261_timing_evaluate(ADS1261_REG_MODE0_FILTER_SINC5, ADS1261_DR_40000_SPS, 0,
+                                4, 15, &plan) != ESP_OK) {
+        printf("FAIL: no timing for 40 kSPS sinc5\n");
+        return 1;
+    }
+
+    printf("Burst decimation, CIC order %d + 3-tap compensator (host cycles)\n", LOADCELL_DECIM_ORDER);
+    printf("  %-9s %6s %10s %10s %10s %12s\n", "channels", "factor", "per conv", "per frame", "max rate",
+           "C6 load (est)");
+    for (size_t c = 0; c < sizeof(channel_counts) / sizeof(channel_counts[0]); c++) {
+        int channels = channel_counts[c];
+        for (uint16_t factor = 1; factor <= LOADCELL_DECIM_MAX_FACTOR; factor *= 2) {
+            int frames = BENCH_CONVERSIONS / (channels * factor);
+            time_frames(channels, factor, frames / 10);     /* Warm up */
+            double per_frame = time_frames(channels, factor, frames);
+
+            /* Each ADC scans its own 4 channels in parallel: the rate does not depend on the ADC count */
+            ads1261_timing_oversample(4, factor, &plan);
+            double load = per_frame * BENCH_RV32_FACTOR * plan.frame_rate_hz / BENCH_CPU_HZ;
+            printf("  %-9d %6u %10.1f %10.1f %8.0f Hz %11.2f%%\n", channels, factor,
+                   per_frame / (channels * factor), per_frame, plan.frame_rate_hz, 100.0 * load);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file bench_despike.c
+ * @brief Cycle cost of the running median and the Hampel filter
+ *
+ * Per sample and window length: loadcell_median_push(), a full Hampel step
+ * (two running medians and the outlier test), and for comparison what the
+ * Arduino reference does per sample, a copy of the window and a sort of it
+ * (insertion sort, as fast as a sort gets at these lengths). Counts come
+ * from esp_cpu_get_cycle_count().
+ *
+ * The budget line holds a Hampel frame of 12 channels against a 1 kHz frame
+ * on the C6's 160 MHz. The work is 32-bit compares and byte moves, so the
+ * host figures are scaled by BENCH_RV32_FACTOR only for the in-order core.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp_cpu.h"
+#include "loadcell_despike.h"
+
+#define BENCH_SAMPLES       1000000
+#define BENCH_CHANNELS      12
+#define BENCH_RATE_HZ       1000.0
+#define BENCH_CPU_HZ        160e6
+#define BENCH_RV32_FACTOR   2.0         /* Host cycles to C6 cycles, single-issue in-order core */
+#define BENCH_CODES         1024
+
+static int32_t s_forces[BENCH_CODES];
+static volatile int32_t s_sink;
+
+static void fill_forces(void)
+{
+    uint32_t x = 777;
+    for (int i = 0; i < BENCH_CODES; i++) {
+        x = x * 1664525u + 1013904223u;
+        s_forces[i] = 400000 + (int32_t)(x >> 20) - 2048;
+        if (i % 97 == 0) {
+            s_forces[i] += 5000000;     /* Occasional spike */
+        }
+    }
+}
+
+static double time_median(uint8_t window)
+{
+    loadcell_median_t m;
+    loadcell_median_init(&m, window);
+    int32_t sink = 0;
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < BENCH_SAMPLES; n++) {
+        sink += loadcell_median_push(&m, s_forces[n & (BENCH_CODES - 1)]);
+    }
+    esp_cpu_cycle_count_t cycles = esp_cpu_get_cycle_count() - start;
+    s_sink = sink;
+    return (double)(uint32_t)cycles / BENCH_SAMPLES;
+}
+
+static double time_hampel(uint8_t window)
+{
+    loadcell_despike_t d;
+    loadcell_despike_init(&d);
+    loadcell_despike_configure(&d, LOADCELL_DESPIKE_HAMPEL, window, LOADCELL_DESPIKE_K);
+    int32_t sink = 0;
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < BENCH_SAMPLES; n++) {
+        sink += loadcell_despike_run(&d, s_forces[n & (BENCH_CODES - 1)]);
+    }
+    esp_cpu_cycle_count_t cycles = esp_cpu_get_cycle_count() - start;
+    s_sink = sink;
+    return (double)(uint32_t)cycles / BENCH_SAMPLES;
+}
+
+/* The reference's approach: keep a ring, copy it and sort the copy for every sample */
+static double time_copy_sort(uint8_t window)
+{
+    int32_t ring[LOADCELL_MEDIAN_MAX_WINDOW] = { 0 };
+    int32_t sorted[LOADCELL_MEDIAN_MAX_WINDOW];
+    unsigned head = 0;
+    int32_t sink = 0;
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < BENCH_SAMPLES; n++) {
+        ring[head] = s_forces[n & (BENCH_CODES - 1)];
+        head = head + 1 == window ? 0 : head + 1;
+        memcpy(sorted, ring, window * sizeof(int32_t));
+        for (int i = 1; i < window; i++) {
+            int32_t v = sorted[i];
+            int j = i;
+            for (; j > 0 && sorted[j - 1] > v; j--) {
+                sorted[j] = sorted[j - 1];
+            }
+            sorted[j] = v;
+        }
+        sink += sorted[window / 2];
+    }
+    esp_cpu_cycle_count_t cycles = esp_cpu_get_cycle_count() - start;
+    s_sink = sink;
+    return (double)(uint32_t)cycles / BENCH_SAMPLES;
+}
+
+int main(void)
+{
+    const uint8_t windows[] = { 5, 7, 15, 31 };
+    const double frame_cycles = BENCH_CPU_HZ / BENCH_RATE_HZ;
+
+    fill_forces();
+    printf("Running median and Hampel filter (host cycles per sample; C6 estimate x%.0f, %d channels at %.0f Hz)\n",
+           BENCH_RV32_FACTOR, BENCH_CHANNELS, BENCH_RATE_HZ);
+    printf("  %-7s %10s %10s %10s %12s\n", "window", "median", "hampel", "copy+sort", "C6 budget");
+    for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+        uint8_t w = windows[i];
+        time_hampel(w);     /* Warm up */
+        double median = time_median(w);
+        double hampel = time_hampel(w);
+        double sort = time_copy_sort(w);
+        printf("  %-7u %10.1f %10.1f %10.1f %11.2f%%\n", w, median, hampel, sort,
+               100.0 * hampel * BENCH_CHANNELS * BENCH_RV32_FACTOR / frame_cycles);
+    }
+    return 0;
+}
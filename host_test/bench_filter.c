@@ -0,0 +1,99 @@
+/**
+ * @file bench_filter.c
+ * @brief Cycle budget of the per-channel biquad cascades
+ *
+ * Times loadcell_filter_run() over a frame of 4, 8 and 12 channels with one
+ * to LOADCELL_FILTER_MAX_SECTIONS sections each: low-pass, 50 Hz and 60 Hz
+ * notches and a drift high-pass, in that order. Counts come from
+ * esp_cpu_get_cycle_count().
+ *
+ * The budget line holds the frame cost against a 1 kHz frame on the C6's
+ * 160 MHz (160000 cycles). Each section is five 32x32->64-bit products: a
+ * single multiply on the host but a mul/mulh pair plus a carried add on
+ * RV32, so the host figures are scaled by BENCH_RV32_FACTOR for the
+ * estimate.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "esp_cpu.h"
+#include "loadcell_filter.h"
+
+#define BENCH_FRAMES        200000
+#define BENCH_MAX_CHANNELS  12
+#define BENCH_RATE_HZ       1000.0f
+#define BENCH_CPU_HZ        160e6
+#define BENCH_RV32_FACTOR   4.0         /* Host cycles to C6 cycles, 64-bit products on a 32-bit core */
+#define BENCH_CODES         1024
+
+static loadcell_filter_t s_filters[BENCH_MAX_CHANNELS];
+static int32_t s_forces[BENCH_CODES];
+static volatile int32_t s_sink;
+
+static void fill_forces(void)
+{
+    uint32_t x = 2024;
+    for (int i = 0; i < BENCH_CODES; i++) {
+        x = x * 1664525u + 1013904223u;
+        s_forces[i] = 400000 + (int32_t)(x >> 16) - 32768;
+    }
+}
+
+/* The console's typical chain, first `sections` of it */
+static void build_chains(int channels, int sections)
+{
+    const loadcell_filter_type_t types[] = {
+        LOADCELL_FILTER_LOWPASS, LOADCELL_FILTER_NOTCH, LOADCELL_FILTER_NOTCH, LOADCELL_FILTER_HIGHPASS,
+    };
+    const float freqs[] = { 100.0f, 50.0f, 60.0f, 0.1f };
+    const float qs[] = { LOADCELL_FILTER_BUTTERWORTH_Q, LOADCELL_FILTER_NOTCH_Q, LOADCELL_FILTER_NOTCH_Q,
+                         LOADCELL_FILTER_BUTTERWORTH_Q };
+
+    for (int ch = 0; ch < channels; ch++) {
+        loadcell_filter_init(&s_filters[ch]);
+        for (int i = 0; i < sections; i++) {
+            loadcell_biquad_t section;
+            loadcell_biquad_design(types[i], freqs[i], qs[i], BENCH_RATE_HZ, &section);
+            loadcell_filter_add(&s_filters[ch], &section);
+        }
+    }
+}
+
+/* Cycles per frame: one sample through every channel's chain */
+static double time_frames(int channels, int frames)
+{
+    unsigned k = 0;
+    int32_t sink = 0;
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (int f = 0; f < frames; f++) {
+        for (int ch = 0; ch < channels; ch++) {
+            sink += loadcell_filter_run(&s_filters[ch], s_forces[k++ & (BENCH_CODES - 1)]);
+        }
+    }
+    esp_cpu_cycle_count_t cycles = esp_cpu_get_cycle_count() - start;
+    s_sink = sink;
+    return (double)(uint32_t)cycles / frames;
+}
+
+int main(void)
+{
+    const int channel_counts[] = { 4, 8, 12 };
+    const double frame_cycles = BENCH_CPU_HZ / BENCH_RATE_HZ;
+
+    fill_forces();
+    printf("Biquad cascades at %.0f Hz (host cycles; C6 estimate x%.0f against %.0f cycles per frame)\n",
+           BENCH_RATE_HZ, BENCH_RV32_FACTOR, frame_cycles);
+    printf("  %-9s %8s %10s %12s %12s\n", "channels", "sections", "per frame", "per section", "C6 budget");
+    for (size_t c = 0; c < sizeof(channel_counts) / sizeof(channel_counts[0]); c++) {
+        int channels = channel_counts[c];
+        for (int sections = 0; sections <= LOADCELL_FILTER_MAX_SECTIONS; sections++) {
+            build_chains(channels, sections);
+            time_frames(channels, BENCH_FRAMES / 10);       /* Warm up, settle the chains */
+            double per_frame = time_frames(channels, BENCH_FRAMES);
+            double per_section = sections ? per_frame / (channels * sections) : 0.0;
+            printf("  %-9d %8d %10.1f %12.1f %11.2f%%\n", channels, sections, per_frame, per_section,
+                   100.0 * per_frame * BENCH_RV32_FACTOR / frame_cycles);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file bench_frame.c
+ * @brief 4-channel frame timing: sequential polling reads vs queued pipeline
+ *
+ * Runs loadcell_read() (queued, bus held for the frame) and the equivalent
+ * per-channel loadcell_read_channel() loop (blocking polling transmits)
+ * against the host SPI stand-in, and compares both with the floor set by
+ * settling time plus pure wire time. Conversions are gated on STATUS.DRDY,
+ * so the polling cost of the data-ready fallback is included. The simulated
+ * ADS1261 converts at the latency of its configured filter/rate, and the
+ * measured frame is compared with the planner's prediction. A 12-channel
+ * plate (three ADS1261 on the bus, scanned interleaved) is measured against
+ * the 4-channel one.
+ */
+
+#include <stdio.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+
+#define BENCH_FRAMES        5000
+#define BENCH_CS_PIN        5
+#define BENCH_DRDY_PIN      -1
+#define BENCH_DRDY_IRQ_PIN  10
+#define BENCH_MULTI_ADCS    3
+
+static loadcell_t lc;
+
+static esp_err_t sequential_frame(loadcell_t *dev)
+{
+    for (int ch = 0; ch < dev->num_channels; ch++) {
+        esp_err_t ret = loadcell_read_channel(dev, ch, &dev->measurements[ch]);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+static double run(const char *name, esp_err_t (*frame)(loadcell_t *))
+{
+    host_spi_reset_stats();
+    int64_t start = host_spi_now_ns();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        if (frame(&lc) != ESP_OK) {
+            printf("FAIL: %s frame %d\n", name, i);
+            return -1.0;
+        }
+    }
+    double frame_us = (double)(host_spi_now_ns() - start) / 1000.0 / BENCH_FRAMES;
+    host_spi_stats_t st = host_spi_get_stats();
+    printf("  %-28s %8.2f us/frame  %5.2f trans/frame  bus busy %6.2f us/frame\n",
+           name, frame_us, (double)st.transactions / BENCH_FRAMES,
+           (double)st.bus_busy_ns / 1000.0 / BENCH_FRAMES);
+    return frame_us;
+}
+
+int main(void)
+{
+    host_spi_reset();
+    if (loadcell_init(&lc, SPI2_HOST, BENCH_CS_PIN, BENCH_DRDY_PIN,
+                      ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) != ESP_OK) {
+        printf("FAIL: loadcell_init\n");
+        return 1;
+    }
+    host_ads1261_set_code(0x001234);
+
+    ads1261_timing_plan_t timing;
+    if (loadcell_get_timing(&lc, &timing) != ESP_OK) {
+        printf("FAIL: loadcell_get_timing\n");
+        return 1;
+    }
+    uint32_t settle_us = timing.settle_us;
+
+    printf("4-channel frame cost (%d frames, %lu us settle per channel)\n", BENCH_FRAMES,
+           (unsigned long)settle_us);
+    double seq = run("sequential polling", sequential_frame);
+    double pipe = run("queued pipeline", loadcell_read);
+    if (seq < 0 || pipe < 0) {
+        return 1;
+    }
+    /* Floor: 4 settle periods plus RDATA (8 B with STATUS + CRC) and INPMUX (3 B) wire time at 8 MHz */
+    double floor_us = 4.0 * settle_us + 4 * (8 + 3) * 8 / 8.0;
+    printf("  %-28s %8.2f us/frame\n", "settle + wire floor", floor_us);
+    printf("  %-28s %8.2f us/frame\n", "planner prediction", 1e6 / timing.frame_rate_hz);
+    printf("  pipeline overhead above floor: %.2f us (sequential: %.2f us)\n",
+           pipe - floor_us, seq - floor_us);
+
+    if (lc.measurements[3].raw_adc != 0x001234) {
+        printf("FAIL: pipeline decoded %ld\n", (long)lc.measurements[3].raw_adc);
+        return 1;
+    }
+
+    /* Distinct tare offsets and spans per channel: the scan swaps OFCAL/FSCAL on every step */
+    for (int ch = 0; ch < 4; ch++) {
+        int32_t zero = 0x1000 + ch * 0x300;
+        host_ads1261_set_code(zero);
+        loadcell_tare(&lc, ch, 4);
+        host_ads1261_set_code(zero + 20000 + ch * 1000);
+        loadcell_calibrate(&lc, ch, 10.0f, 4);
+        loadcell_cal_set_t set;
+        loadcell_get_cal_set(&lc, ch, &set);
+        if (!set.hw_calibrated) {
+            printf("FAIL: channel %d span not loaded into FSCAL\n", ch);
+            return 1;
+        }
+    }
+    host_ads1261_set_code(0x1000 + 3 * 0x300 + 23000);
+    double cal = run("pipeline, per-channel OFCAL/FSCAL", loadcell_read);
+    if (cal < 0) {
+        return 1;
+    }
+    int32_t f = lc.measurements[3].force_mn;
+    if (f < 9990 || f > 10010) {
+        printf("FAIL: hardware-calibrated channel 3 read %ld mN, expected 10 N\n", (long)f);
+        return 1;
+    }
+    printf("  calibration swap cost: %.2f us/frame\n", cal - pipe);
+    loadcell_deinit(&lc);
+
+    /* Same scan with DRDY wired to an interrupt instead of STATUS polling */
+    host_spi_reset();
+    host_ads1261_set_drdy_gpio(BENCH_DRDY_IRQ_PIN);
+    if (loadcell_init(&lc, SPI2_HOST, BENCH_CS_PIN, BENCH_DRDY_IRQ_PIN,
+                      ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) != ESP_OK) {
+        printf("FAIL: loadcell_init (DRDY interrupt)\n");
+        return 1;
+    }
+    host_ads1261_set_code(0x001234);
+    printf("with DRDY interrupt:\n");
+    double pipe_irq = run("pipeline, DRDY interrupt", loadcell_read);
+    if (run("sequential, DRDY interrupt", sequential_frame) < 0 || pipe_irq < 0) {
+        return 1;
+    }
+    loadcell_deinit(&lc);
+
+    /* Three ADCs on the same bus, each with its own CS and DRDY */
+    static const loadcell_adc_pins_t pins[BENCH_MULTI_ADCS] = { { 5, 10 }, { 6, 11 }, { 7, 12 } };
+    printf("\n%d-channel frame cost (%d ADS1261 on one bus, interleaved)\n",
+           BENCH_MULTI_ADCS * LOADCELL_CHANNELS_PER_ADC, BENCH_MULTI_ADCS);
+    for (int irq = 0; irq < 2; irq++) {
+        loadcell_adc_pins_t wiring[BENCH_MULTI_ADCS];
+        host_spi_reset();
+        for (int a = 0; a < BENCH_MULTI_ADCS; a++) {
+            wiring[a] = (loadcell_adc_pins_t) { pins[a].cs_pin, irq ? pins[a].drdy_pin : -1 };
+            host_ads1261_select(a);
+            host_ads1261_set_drdy_gpio(wiring[a].drdy_pin);
+            host_ads1261_set_code(0x001234 + a);
+        }
+        if (loadcell_init_multi(&lc, SPI2_HOST, wiring, BENCH_MULTI_ADCS,
+                                ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) != ESP_OK) {
+            printf("FAIL: loadcell_init_multi\n");
+            return 1;
+        }
+        double multi = run(irq ? "pipeline, DRDY interrupt" : "pipeline, polling", loadcell_read);
+        if (multi < 0) {
+            return 1;
+        }
+        if (lc.measurements[lc.num_channels - 1].raw_adc != 0x001234 + BENCH_MULTI_ADCS - 1) {
+            printf("FAIL: last ADC decoded %ld\n", (long)lc.measurements[lc.num_channels - 1].raw_adc);
+            return 1;
+        }
+        double single = irq ? pipe_irq : pipe;
+        printf("  per-channel rate %.1f Hz (4 channels: %.1f Hz), %.2f us/frame above 4 channels\n",
+               1e6 / multi, 1e6 / single, multi - single);
+        if (irq) {
+            ads1261_timing_plan_t multi_timing;
+            loadcell_get_timing(&lc, &multi_timing);
+            printf("  %-28s %8.2f us/frame\n", "planner prediction", 1e6 / multi_timing.frame_rate_hz);
+        }
+        loadcell_deinit(&lc);
+    }
+
+    /* Planner runs against the single-ADC plate */
+    host_spi_reset();
+    if (loadcell_init(&lc, SPI2_HOST, BENCH_CS_PIN, BENCH_DRDY_PIN,
+                      ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) != ESP_OK) {
+        printf("FAIL: loadcell_init (planner)\n");
+        return 1;
+    }
+
+    /* Planner choices for the 4-channel scan at a range of target rates */
+    static const float targets[] = { 1.0f, 10.0f, 50.0f, 100.0f, 250.0f, 500.0f, 1000.0f, 2000.0f };
+    printf("\n4-channel scan planner (%lu us overhead per step)\n",
+           (unsigned long)(timing.step_us - timing.settle_us));
+    printf("  %8s  %6s  %9s  %8s  %10s\n", "target", "filter", "rate SPS", "settle", "achieved");
+    for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+        ads1261_timing_plan_t plan;
+        esp_err_t ret = loadcell_plan_timing(&lc, targets[i], &plan);
+        if (ret != ESP_OK && ret != ESP_ERR_NOT_SUPPORTED) {
+            printf("FAIL: planner %.0f Hz\n", targets[i]);
+            return 1;
+        }
+        if (ret == ESP_OK && plan.channel_rate_hz < targets[i]) {
+            printf("FAIL: planner %.0f Hz returned %.1f Hz\n", targets[i], plan.channel_rate_hz);
+            return 1;
+        }
+        printf("  %6.0f Hz  %6s  %9.1f  %5lu us  %7.1f Hz%s\n", targets[i],
+               ads1261_filter_name(plan.filter),
+               ads1261_datarate_sps(plan.datarate), (unsigned long)plan.settle_us, plan.channel_rate_hz,
+               plan.meets_target ? "" : "  (unreachable)");
+    }
+    loadcell_deinit(&lc);
+    return 0;
+}
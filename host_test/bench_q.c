@@ -0,0 +1,254 @@
+/**
+ * @file bench_q.c
+ * @brief Per-frame cost of float vs integer calibration and 0.1 N quantization
+ *
+ * Times the sample-path arithmetic of a 4- and a 12-channel frame: the
+ * previous float calibration plus BLE quantization against the integer
+ * millinewton path, for hardware-calibrated (FSCAL) and software-scaled
+ * channels. Counts come from esp_cpu_get_cycle_count().
+ *
+ * The host has an FPU and the C6 does not: there each float operation
+ * (int-to-float, two multiplies, float-to-int per channel) is a libgcc
+ * soft-float call. The float path is therefore timed twice, with host
+ * floats and with a software IEEE single implementation standing in for
+ * __floatsisf/__mulsf3/__fixsfsi. The emulation is checked bit-for-bit
+ * against the host FPU before it is timed.
+ *
+ * A multi-point calibration table (loadcell_lut) is timed against the
+ * linear integer scale it replaces on non-linear cells.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_cpu.h"
+#include "loadcell_q.h"
+#include "loadcell_lut.h"
+
+#define BENCH_FRAMES        200000
+#define BENCH_MAX_CHANNELS  12
+#define FLOAT_OPS_PER_CH    4
+
+typedef struct {
+    bool hw_calibrated;
+    int32_t offset;
+    float scale;
+    loadcell_q_scale_t scale_q;
+    loadcell_lut_t lut;
+} bench_channel_t;
+
+/* ============================================================================
+ * IEEE single in software (normal operands, round to nearest even)
+ * ============================================================================ */
+
+typedef uint32_t soft_float_t;
+
+static soft_float_t sf_pack(uint32_t sign, int32_t exp, uint64_t mant, int frac_bits)
+{
+    /* mant has frac_bits below the binary point and a leading one at bit frac_bits or frac_bits + 1 */
+    int lead = frac_bits;
+    if (mant >> (frac_bits + 1)) {
+        lead++;
+        exp++;
+    }
+    int drop = lead - 23;
+    uint64_t half = 1ULL << (drop - 1);
+    uint64_t rest = mant & ((1ULL << drop) - 1);
+    mant >>= drop;
+    if (rest > half || (rest == half && (mant & 1))) {
+        mant++;
+        if (mant >> 24) {
+            mant >>= 1;
+            exp++;
+        }
+    }
+    return sign | (uint32_t)(exp + 127) << 23 | ((uint32_t)mant & 0x7FFFFF);
+}
+
+static soft_float_t sf_from_int(int32_t v)
+{
+    if (v == 0) {
+        return 0;
+    }
+    uint32_t sign = v < 0 ? 0x80000000u : 0;
+    uint64_t mag = v < 0 ? -(int64_t)v : v;
+    int top = 63 - __builtin_clzll(mag);
+    return sf_pack(sign, top, mag << 30, top + 30);
+}
+
+static soft_float_t sf_mul(soft_float_t a, soft_float_t b)
+{
+    uint32_t sign = (a ^ b) & 0x80000000u;
+    if (!(a & 0x7FFFFFFF) || !(b & 0x7FFFFFFF)) {
+        return sign;
+    }
+    int32_t exp = (int32_t)((a >> 23) & 0xFF) + (int32_t)((b >> 23) & 0xFF) - 254;
+    uint64_t mant = (uint64_t)((a & 0x7FFFFF) | 0x800000) * ((b & 0x7FFFFF) | 0x800000);
+    return sf_pack(sign, exp, mant, 46);
+}
+
+static int32_t sf_to_int(soft_float_t a)
+{
+    int32_t exp = (int32_t)((a >> 23) & 0xFF) - 127;
+    if (exp < 0) {
+        return 0;
+    }
+    if (exp > 30) {
+        return (a >> 31) ? INT32_MIN : INT32_MAX;
+    }
+    uint32_t mant = (a & 0x7FFFFF) | 0x800000;
+    uint32_t mag = exp >= 23 ? mant << (exp - 23) : mant >> (23 - exp);
+    return (a >> 31) ? -(int32_t)mag : (int32_t)mag;
+}
+
+static soft_float_t sf_from_float(float f)
+{
+    union { float f; uint32_t u; } v = { .f = f };
+    return v.u;
+}
+
+/* ============================================================================
+ * Frame paths
+ * ============================================================================ */
+
+static bench_channel_t s_channels[BENCH_MAX_CHANNELS];
+static int32_t s_raw[BENCH_MAX_CHANNELS];
+static volatile int32_t s_sink;
+
+/* Previous path: float force per sample, float multiply and truncation per BLE value */
+static int32_t float_frame(int channels)
+{
+    int32_t acc = 0;
+    for (int ch = 0; ch < channels; ch++) {
+        const bench_channel_t *c = &s_channels[ch];
+        float force_n = c->hw_calibrated ? (float)s_raw[ch] * (1.0f / 1000)
+                                         : (float)(s_raw[ch] - c->offset) * c->scale;
+        int32_t scaled = (int32_t)(force_n * 10.0f);
+        if (scaled > 32767) scaled = 32767;
+        if (scaled < -32768) scaled = -32768;
+        acc += scaled;
+    }
+    return acc;
+}
+
+/* The same float path as the C6 runs it, one soft-float call per operation */
+static int32_t soft_float_frame(int channels)
+{
+    static const float n_per_count = 1.0f / 1000;
+    int32_t acc = 0;
+    for (int ch = 0; ch < channels; ch++) {
+        const bench_channel_t *c = &s_channels[ch];
+        soft_float_t force_n = c->hw_calibrated ? sf_mul(sf_from_int(s_raw[ch]), sf_from_float(n_per_count))
+                                                : sf_mul(sf_from_int(s_raw[ch] - c->offset), sf_from_float(c->scale));
+        int32_t scaled = sf_to_int(sf_mul(force_n, sf_from_float(10.0f)));
+        if (scaled > 32767) scaled = 32767;
+        if (scaled < -32768) scaled = -32768;
+        acc += scaled;
+    }
+    return acc;
+}
+
+/* Integer path: millinewtons per sample, integer division per BLE value */
+static int32_t q_frame(int channels)
+{
+    int32_t acc = 0;
+    for (int ch = 0; ch < channels; ch++) {
+        const bench_channel_t *c = &s_channels[ch];
+        int32_t force_mn = c->hw_calibrated ? s_raw[ch] : loadcell_q_force_mn(&c->scale_q, s_raw[ch] - c->offset);
+        acc += loadcell_q_deci_newtons(force_mn);
+    }
+    return acc;
+}
+
+/* Multi-point path: table interpolation per sample, integer division per BLE value */
+static int32_t lut_frame(int channels)
+{
+    int32_t acc = 0;
+    for (int ch = 0; ch < channels; ch++) {
+        const bench_channel_t *c = &s_channels[ch];
+        acc += loadcell_q_deci_newtons(loadcell_lut_eval(&c->lut, s_raw[ch] - c->offset));
+    }
+    return acc;
+}
+
+static double cycles_per_frame(int32_t (*frame)(int), int channels)
+{
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        /* New codes every frame so nothing is hoisted out of the loop */
+        s_raw[i % channels] += 17;
+        s_sink += frame(channels);
+    }
+    return (double)(uint32_t)(esp_cpu_get_cycle_count() - start) / BENCH_FRAMES;
+}
+
+static void setup(bool hw_calibrated)
+{
+    for (int ch = 0; ch < BENCH_MAX_CHANNELS; ch++) {
+        bench_channel_t *c = &s_channels[ch];
+        c->hw_calibrated = hw_calibrated;
+        c->offset = 1000 * ch - 5000;
+        c->scale = 1.2e-4f + 1e-6f * ch;
+        loadcell_q_from_float(c->scale, &c->scale_q);
+        /* Five loads on a slightly bowed cell */
+        loadcell_cal_point_t points[5];
+        for (int p = 0; p < 5; p++) {
+            points[p].net = 1000000 * p;
+            points[p].force_mn = loadcell_q_force_mn(&c->scale_q, points[p].net) * (100 + p) / 100;
+        }
+        loadcell_lut_build(points, 5, LOADCELL_FIT_POLY3, &c->lut);
+        s_raw[ch] = 400000 + 12345 * ch;
+    }
+}
+
+/* Soft-float emulation against the host FPU over a sweep of codes, before trusting its timing */
+static bool soft_float_matches(void)
+{
+    for (int32_t raw = -0x800000; raw <= 0x7FFFFF; raw += 101) {
+        for (int ch = 0; ch < BENCH_MAX_CHANNELS; ch++) {
+            s_raw[ch] = raw + ch;
+        }
+        if (soft_float_frame(BENCH_MAX_CHANNELS) != float_frame(BENCH_MAX_CHANNELS)) {
+            printf("FAIL: soft-float emulation differs from the FPU at code %ld\n", (long)raw);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void)
+{
+    static const int channel_counts[] = { 4, BENCH_MAX_CHANNELS };
+
+    printf("Calibration + 0.1 N quantization (%d frames, cycles/frame)\n", BENCH_FRAMES);
+    printf("  %-24s %8s %11s %8s %12s %10s\n", "channels, calibration", "FPU", "soft-float", "integer",
+           "vs soft", "float ops");
+    for (int hw = 1; hw >= 0; hw--) {
+        setup(hw);
+        if (!soft_float_matches()) {
+            return 1;
+        }
+        for (size_t i = 0; i < sizeof(channel_counts) / sizeof(channel_counts[0]); i++) {
+            int channels = channel_counts[i];
+            setup(hw);
+            double f = cycles_per_frame(float_frame, channels);
+            double sf = cycles_per_frame(soft_float_frame, channels);
+            double q = cycles_per_frame(q_frame, channels);
+            char label[32];
+            snprintf(label, sizeof(label), "%2d, %s", channels, hw ? "FSCAL (hardware)" : "software scale");
+            printf("  %-24s %8.1f %11.1f %8.1f %11.0f%% %10d\n", label, f, sf, q, 100.0 * (sf - q) / sf,
+                   channels * FLOAT_OPS_PER_CH);
+        }
+    }
+
+    printf("Multi-point table vs linear scale (cycles/frame)\n");
+    printf("  %-24s %8s %8s\n", "channels", "linear", "table");
+    setup(false);
+    for (size_t i = 0; i < sizeof(channel_counts) / sizeof(channel_counts[0]); i++) {
+        int channels = channel_counts[i];
+        double q = cycles_per_frame(q_frame, channels);
+        double lut = cycles_per_frame(lut_frame, channels);
+        printf("  %-24d %8.1f %8.1f\n", channels, q, lut);
+    }
+    return 0;
+}
@@ -0,0 +1,273 @@
+/**
+ * @file bench_spi.c
+ * @brief SPI transaction-cost benchmark for the ADS1261 command paths
+ *
+ * Compares the original byte-per-transaction RDATA/RREG/WREG sequences with
+ * the driver's single-transaction frames, against the host SPI stand-in.
+ * Reports modeled bus time (driver overhead + wire time) and host CPU time,
+ * and checks STATUS/CRC-framed reads against injected line errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ads1261.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+
+#define BENCH_ITERATIONS    20000
+#define BENCH_CS_PIN        5
+
+typedef esp_err_t (*bench_op_t)(ads1261_t *dev);
+
+/* ============================================================================
+ * Original per-byte command sequences (pre single-transaction driver)
+ * ============================================================================ */
+
+/* One byte per transaction, CS held low until the last byte of the command */
+static esp_err_t legacy_byte(ads1261_t *dev, uint8_t tx, uint8_t *rx, bool last)
+{
+    spi_transaction_t t = {
+        .flags = last ? 0 : SPI_TRANS_CS_KEEP_ACTIVE,
+        .length = 8,
+        .tx_buffer = &tx,
+        .rx_buffer = rx,
+    };
+    return spi_device_polling_transmit(dev->spi_handle, &t);
+}
+
+static esp_err_t legacy_read_adc(ads1261_t *dev)
+{
+    uint8_t data[3];
+    legacy_byte(dev, 0x12, NULL, false);
+    for (int i = 0; i < 3; i++) {
+        legacy_byte(dev, 0x00, &data[i], i == 2);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t legacy_read_register(ads1261_t *dev)
+{
+    uint8_t value;
+    legacy_byte(dev, 0x20 | ADS1261_REG_MODE0, NULL, false);
+    legacy_byte(dev, 0x00, NULL, false);
+    legacy_byte(dev, 0x00, &value, true);
+    return ESP_OK;
+}
+
+static esp_err_t legacy_write_register(ads1261_t *dev)
+{
+    legacy_byte(dev, 0x40 | ADS1261_REG_INPMUX, NULL, false);
+    legacy_byte(dev, 0x23, NULL, true);
+    return ESP_OK;
+}
+
+/* ============================================================================
+ * Current driver paths
+ * ============================================================================ */
+
+static esp_err_t driver_read_adc(ads1261_t *dev)
+{
+    int32_t value;
+    return ads1261_read_adc(dev, &value);
+}
+
+static esp_err_t driver_read_register(ads1261_t *dev)
+{
+    uint8_t value;
+    return ads1261_read_register(dev, ADS1261_REG_MODE0, &value);
+}
+
+static esp_err_t driver_write_register(ads1261_t *dev)
+{
+    /* Alternate values so the register shadow cannot drop the write */
+    static uint8_t value = 0x23;
+    value ^= 0x11;
+    return ads1261_write_register(dev, ADS1261_REG_INPMUX, value);
+}
+
+static esp_err_t driver_write_unchanged(ads1261_t *dev)
+{
+    return ads1261_write_register(dev, ADS1261_REG_INPMUX, 0x23);
+}
+
+/* ============================================================================
+ * Harness
+ * ============================================================================ */
+
+static double host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void run(ads1261_t *dev, const char *name, bench_op_t op)
+{
+    host_spi_reset_stats();
+    int64_t sim_start = host_spi_now_ns();
+    double cpu_start = host_ns();
+
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        op(dev);
+    }
+
+    double cpu_ns = (host_ns() - cpu_start) / BENCH_ITERATIONS;
+    double sim_us = (double)(host_spi_now_ns() - sim_start) / 1000.0 / BENCH_ITERATIONS;
+    host_spi_stats_t st = host_spi_get_stats();
+
+    printf("  %-22s %8.2f us/op  %5.2f trans/op  %5.2f bytes/op  %7.1f host ns/op\n",
+           name, sim_us, (double)st.transactions / BENCH_ITERATIONS,
+           (double)st.bytes / BENCH_ITERATIONS, cpu_ns);
+}
+
+static int check_read(ads1261_t *dev, int32_t code)
+{
+    int32_t value = 0;
+    host_ads1261_set_code(code);
+    vTaskDelay(1);  /* A fresh conversion, so STATUS framing reports DRDY */
+    if (ads1261_read_adc(dev, &value) != ESP_OK || value != code) {
+        printf("FAIL: RDATA returned %ld, expected %ld\n", (long)value, (long)code);
+        return 1;
+    }
+    return 0;
+}
+
+/* Field-level setters must leave the neighbouring fields alone and keep the shadow in sync */
+static int check_shadow(ads1261_t *dev)
+{
+    ads1261_set_datarate(dev, ADS1261_DR_20_SPS);
+    ads1261_set_pga(dev, ADS1261_PGA_GAIN_16);
+
+    ads1261_mode0_reg_t mode0 = { .reg = host_ads1261_get_register(ADS1261_REG_MODE0) };
+    ads1261_pga_reg_t pga = { .reg = host_ads1261_get_register(ADS1261_REG_PGA) };
+    if (mode0.bits.dr != ADS1261_DR_20_SPS || mode0.bits.filter != ADS1261_REG_MODE0_FILTER_SINC5 ||
+        pga.bits.gain != ADS1261_PGA_GAIN_16 || pga.bits.bypass) {
+        printf("FAIL: field update MODE0=0x%02X PGA=0x%02X\n", mode0.reg, pga.reg);
+        return 1;
+    }
+
+    uint32_t mismatch = ~0u;
+    if (ads1261_snapshot(dev, NULL, &mismatch) != ESP_OK || mismatch != 0) {
+        printf("FAIL: shadow mismatch mask 0x%05lX\n", (unsigned long)mismatch);
+        return 1;
+    }
+    return 0;
+}
+
+/* STATUS/CRC framing: good reads decode, line errors and stale reads are caught and counted */
+static int check_integrity(ads1261_t *dev)
+{
+    int32_t value = 0;
+    int failures = 0;
+
+    if (ads1261_set_integrity(dev, true, true) != ESP_OK) {
+        printf("FAIL: enabling STATUS/CRC framing\n");
+        return 1;
+    }
+    failures += check_read(dev, 0x0A5A5A) + check_read(dev, -0x123456);
+
+    ads1261_integrity_t before = dev->integrity;
+    host_ads1261_corrupt_rdata(1);
+    vTaskDelay(1);  /* Let a fresh conversion complete so only the CRC can fail */
+    if (ads1261_read_adc(dev, &value) != ESP_ERR_INVALID_CRC ||
+        dev->integrity.crc_errors != before.crc_errors + 1) {
+        printf("FAIL: corrupted RDATA not detected\n");
+        failures++;
+    }
+
+    /* A mux write restarts conversion: reading before the filter settles is stale */
+    ads1261_write_register(dev, ADS1261_REG_INPMUX, host_ads1261_get_register(ADS1261_REG_INPMUX) ^ 0x11);
+    if (ads1261_read_adc(dev, &value) != ESP_ERR_NOT_FINISHED ||
+        dev->integrity.stale_reads != before.stale_reads + 1) {
+        printf("FAIL: stale RDATA not detected\n");
+        failures++;
+    }
+
+    uint8_t mode0 = 0;
+    if (ads1261_read_register(dev, ADS1261_REG_MODE0, &mode0) != ESP_OK ||
+        mode0 != host_ads1261_get_register(ADS1261_REG_MODE0) || dev->integrity.cmd_crc_errors) {
+        printf("FAIL: CRC-framed RREG\n");
+        failures++;
+    }
+    vTaskDelay(1);
+    return failures;
+}
+
+/* OFCAL/FSCAL correct conversions in the ADC; SYOCAL zeroes the applied input */
+static int check_calibration(ads1261_t *dev)
+{
+    int32_t value = 0, ofcal = 0;
+    uint32_t fscal = 0;
+    int failures = 0;
+
+    host_ads1261_set_code(3000);
+    ads1261_set_calibration(dev, 1000, 2 * ADS1261_FSCAL_UNITY);
+    vTaskDelay(1);
+    if (ads1261_read_adc(dev, &value) != ESP_OK || value != 4000) {
+        printf("FAIL: OFCAL/FSCAL correction gave %ld, expected 4000\n", (long)value);
+        failures++;
+    }
+
+    host_ads1261_set_code(-0x1234);
+    ads1261_set_calibration(dev, 0, ADS1261_FSCAL_UNITY);
+    if (ads1261_calibrate(dev, ADS1261_CMD_SYOCAL, 100) != ESP_OK ||
+        ads1261_get_calibration(dev, &ofcal, &fscal) != ESP_OK ||
+        ofcal != -0x1234 || fscal != ADS1261_FSCAL_UNITY) {
+        printf("FAIL: SYOCAL left OFCAL=%ld FSCAL=0x%06lX\n", (long)ofcal, (unsigned long)fscal);
+        failures++;
+    }
+    vTaskDelay(1);
+    if (ads1261_read_adc(dev, &value) != ESP_OK || value != 0) {
+        printf("FAIL: input after SYOCAL read %ld\n", (long)value);
+        failures++;
+    }
+
+    ads1261_set_calibration(dev, 0, ADS1261_FSCAL_UNITY);
+    return failures;
+}
+
+int main(void)
+{
+    ads1261_t dev = {0};
+
+    host_spi_reset();
+    /* Fixed conversion timing: the shadow checks below change the data rate */
+    host_ads1261_set_timing(100000, 25000);
+    if (ads1261_init(&dev, SPI2_HOST, BENCH_CS_PIN, -1) != ESP_OK) {
+        printf("FAIL: ads1261_init\n");
+        return 1;
+    }
+
+    int failures = check_read(&dev, 0x123456) + check_read(&dev, -0x123456) +
+                   check_read(&dev, -1) + check_read(&dev, -0x800000) + check_shadow(&dev) +
+                   check_calibration(&dev);
+    if (failures) {
+        return 1;
+    }
+
+    printf("ADS1261 SPI command cost (%d iterations, 8 MHz, modeled driver overhead)\n",
+           BENCH_ITERATIONS);
+    printf("before (one transaction per byte):\n");
+    run(&dev, "RDATA", legacy_read_adc);
+    run(&dev, "RREG", legacy_read_register);
+    run(&dev, "WREG", legacy_write_register);
+    printf("after (one transaction per command):\n");
+    run(&dev, "RDATA", driver_read_adc);
+    run(&dev, "RREG", driver_read_register);
+    run(&dev, "WREG", driver_write_register);
+    run(&dev, "WREG (unchanged)", driver_write_unchanged);
+
+    if (check_integrity(&dev)) {
+        return 1;
+    }
+    printf("with STATUS + CRC framing:\n");
+    run(&dev, "RDATA", driver_read_adc);
+    run(&dev, "RREG", driver_read_register);
+
+    ads1261_deinit(&dev);
+    return 0;
+}
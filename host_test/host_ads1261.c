@@ -0,0 +1,561 @@
+/**
+ * @file host_ads1261.c
+ * @brief Behavioral ADS1261 model behind the host SPI stand-in
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "ads1261.h"
+#include "ads1261_timing.h"
+#include "host_ads1261.h"
+
+#define SIM_NUM_REGS        ADS1261_NUM_REGS
+#define SIM_EDGE_RING       32
+#define SIM_FULL_SCALE      8388608.0   /* 2^23 codes per VREF/gain */
+
+#define SIM_MODE1_CONVRT    0x10
+#define SIM_MODE3_CRCENB    0x20
+#define SIM_MODE3_STATENB   0x40
+#define SIM_STATUS_CRCERR   0x40
+#define SIM_STATUS_DRDY     0x04
+
+static const uint8_t reg_defaults[SIM_NUM_REGS] = {
+    0x08, 0x01, 0x24, 0x01, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x40, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00,
+};
+
+/* One simulated converter; every instance has its own CS and DRDY */
+typedef struct {
+    uint8_t regs[SIM_NUM_REGS];
+
+    /* Command frame in progress */
+    uint8_t frame_cmd;
+    uint8_t frame_arg;
+    uint8_t frame_payload[5];    /* Response bytes after the command header */
+    bool frame_crc;              /* MODE3.CRCENB latched at frame start */
+    bool frame_ok;               /* Input CRC matched (or CRC disabled) */
+    uint32_t frame_pos;
+    uint32_t corrupt_rdata;
+
+    /* Conversion engine */
+    bool start_pin;
+    bool running;                /* A conversion is in progress */
+    int64_t next_ns;             /* It completes at this time */
+    int64_t sync_ns;             /* Conversions have been run up to here */
+    bool drdy;                   /* New data not yet read */
+    int32_t data;                /* Output data register */
+    uint32_t conversions;
+    uint32_t fixed_settle_ns;
+    uint32_t fixed_period_ns;
+
+    /* DRDY falling edges not yet taken by the GPIO layer */
+    int64_t edges[SIM_EDGE_RING];
+    uint32_t edge_head;
+    uint32_t edge_count;
+    int drdy_gpio;
+
+    /* Signal model */
+    bool use_code;
+    int32_t code;
+    double inputs_v[256];
+    double vref;
+    double noise_v;
+    uint32_t rng;
+    uint32_t tau_ns;
+    int64_t mux_ns;              /* Time of the last INPMUX change */
+    double mux_from_v;           /* Input voltage held at that moment */
+} sim_adc_t;
+
+static sim_adc_t s_adcs[HOST_ADS1261_MAX];
+static sim_adc_t *s_sel = &s_adcs[0];  /* Target of scenario and inspection calls */
+
+/* ============================================================================
+ * Signal model
+ * ============================================================================ */
+
+/* xorshift32 + Box-Muller: reproducible across hosts for a given seed */
+static double rng_uniform(sim_adc_t *a)
+{
+    a->rng ^= a->rng << 13;
+    a->rng ^= a->rng >> 17;
+    a->rng ^= a->rng << 5;
+    return ((double)a->rng + 1.0) / 4294967297.0;
+}
+
+static double rng_gauss(sim_adc_t *a)
+{
+    double u1 = rng_uniform(a);
+    double u2 = rng_uniform(a);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static double pga_gain(sim_adc_t *a)
+{
+    uint8_t pga = a->regs[ADS1261_REG_PGA];
+    return (pga & 0x80) ? 1.0 : (double)(1u << (pga & 0x07));
+}
+
+/* Voltage at the selected input pair at time t, including the RC settling tail */
+static double input_volts(sim_adc_t *a, int64_t t_ns)
+{
+    double target = a->inputs_v[a->regs[ADS1261_REG_INPMUX]];
+    if (a->tau_ns == 0 || t_ns <= a->mux_ns) {
+        return a->tau_ns == 0 ? target : a->mux_from_v;
+    }
+    return target + (a->mux_from_v - target) * exp(-(double)(t_ns - a->mux_ns) / a->tau_ns);
+}
+
+static int32_t clip24(double code)
+{
+    return code > 0x7FFFFF ? 0x7FFFFF : code < -0x800000 ? -0x800000 : (int32_t)lround(code);
+}
+
+/* Modulator code sampled at t, before OFCAL/FSCAL */
+static int32_t input_code(sim_adc_t *a, int64_t t_ns, bool noisy)
+{
+    if (a->use_code) {
+        return a->code;
+    }
+    double volts = input_volts(a, t_ns);
+    if (noisy && a->noise_v > 0.0) {
+        volts += a->noise_v * rng_gauss(a);
+    }
+    return clip24(volts * pga_gain(a) / a->vref * SIM_FULL_SCALE);
+}
+
+static int32_t reg24(sim_adc_t *a, uint8_t first)
+{
+    uint32_t v = a->regs[first] | ((uint32_t)a->regs[first + 1] << 8) | ((uint32_t)a->regs[first + 2] << 16);
+    return (int32_t)(v << 8) >> 8;
+}
+
+static void set_reg24(sim_adc_t *a, uint8_t first, int32_t value)
+{
+    for (int i = 0; i < 3; i++) {
+        a->regs[first + i] = (uint8_t)((uint32_t)value >> (8 * i));
+    }
+}
+
+/* Conversion result after the OFCAL/FSCAL correction, clipped to 24 bits */
+static int32_t calibrated_code(sim_adc_t *a, int32_t code)
+{
+    int64_t fscal = (uint32_t)reg24(a, ADS1261_REG_FSCAL0) & 0xFFFFFF;
+    int64_t out = ((int64_t)code - reg24(a, ADS1261_REG_OFCAL0)) * fscal / 0x400000;
+    return out > 0x7FFFFF ? 0x7FFFFF : out < -0x800000 ? -0x800000 : (int32_t)out;
+}
+
+/* ============================================================================
+ * Conversion engine
+ * ============================================================================ */
+
+static void conversion_timing(sim_adc_t *a, int64_t *settle_ns, int64_t *period_ns)
+{
+    if (a->fixed_settle_ns) {
+        *settle_ns = a->fixed_settle_ns;
+        *period_ns = a->fixed_period_ns ? a->fixed_period_ns : a->fixed_settle_ns;
+        return;
+    }
+
+    ads1261_mode0_reg_t mode0 = { .reg = a->regs[ADS1261_REG_MODE0] };
+    ads1261_mode1_reg_t mode1 = { .reg = a->regs[ADS1261_REG_MODE1] };
+    uint8_t dr = mode0.bits.dr;
+    uint8_t filter = mode0.bits.filter;
+    float sps = ads1261_datarate_sps(dr);
+    if (sps <= 0.0f) {
+        dr = ADS1261_DR_40000_SPS;
+        sps = ads1261_datarate_sps(dr);
+    }
+    if (!ads1261_filter_valid(filter, dr)) {
+        filter = dr == ADS1261_DR_40000_SPS ? ADS1261_REG_MODE0_FILTER_SINC5 : ADS1261_REG_MODE0_FILTER_SINC4;
+    }
+    uint8_t delay = mode1.bits.delay < ADS1261_NUM_DELAYS ? mode1.bits.delay : ADS1261_NUM_DELAYS - 1;
+    *settle_ns = (int64_t)ads1261_settle_time_us(filter, dr, delay) * 1000;
+    *period_ns = (int64_t)(1e9 / sps);
+}
+
+static bool pulse_mode(sim_adc_t *a)
+{
+    return (a->regs[ADS1261_REG_MODE1] & SIM_MODE1_CONVRT) != 0;
+}
+
+static void push_edge(sim_adc_t *a, int64_t t_ns)
+{
+    uint32_t slot = (a->edge_head + a->edge_count) % SIM_EDGE_RING;
+    a->edges[slot] = t_ns;
+    if (a->edge_count < SIM_EDGE_RING) {
+        a->edge_count++;
+    } else {
+        a->edge_head = (a->edge_head + 1) % SIM_EDGE_RING;  /* Oldest edge is lost */
+    }
+}
+
+/* Abort the conversion in progress and start over: DRDY clears until the filter settles */
+static void conversion_restart(sim_adc_t *a, int64_t t_ns)
+{
+    int64_t settle_ns, period_ns;
+    conversion_timing(a, &settle_ns, &period_ns);
+    a->running = true;
+    a->drdy = false;
+    a->next_ns = t_ns + settle_ns;
+}
+
+static void conversion_complete(sim_adc_t *a, int64_t t_ns, int64_t period_ns)
+{
+    /* The filter output is dominated by its last period of input */
+    a->data = calibrated_code(a, input_code(a, t_ns - period_ns, true));
+    a->drdy = true;
+    a->conversions++;
+    push_edge(a, t_ns);
+}
+
+static void adc_sync(sim_adc_t *a, int64_t t_ns)
+{
+    if (t_ns > a->sync_ns) {
+        a->sync_ns = t_ns;
+    }
+
+    int64_t settle_ns, period_ns;
+    conversion_timing(a, &settle_ns, &period_ns);
+
+    while (a->running && a->next_ns <= t_ns) {
+        if (!pulse_mode(a)) {
+            /* Skip conversions that are overwritten before t: only their edges matter */
+            int64_t skipped = (t_ns - a->next_ns) / period_ns;
+            for (int64_t k = skipped > SIM_EDGE_RING ? skipped - SIM_EDGE_RING : 0; k < skipped; k++) {
+                push_edge(a, a->next_ns + k * period_ns);
+            }
+            a->conversions += (uint32_t)skipped;
+            a->next_ns += skipped * period_ns;
+        }
+        conversion_complete(a, a->next_ns, period_ns);
+        if (pulse_mode(a)) {
+            a->running = false;
+        } else {
+            a->next_ns += period_ns;
+        }
+    }
+}
+
+/* ============================================================================
+ * Command frames
+ * ============================================================================ */
+
+/* Reference bitwise CRC-8 (x^8 + x^2 + x + 1, seed 0xFF), independent of the driver's table */
+static uint8_t sim_crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0xFF;
+    while (len--) {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint8_t status_now(sim_adc_t *a)
+{
+    return a->regs[ADS1261_REG_STATUS] | (a->drdy ? SIM_STATUS_DRDY : 0x00);
+}
+
+static void write_register(sim_adc_t *a, uint8_t reg, uint8_t value, int64_t t_ns)
+{
+    if (reg == ADS1261_REG_INPMUX && value != a->regs[reg]) {
+        a->mux_from_v = input_volts(a, t_ns);
+        a->mux_ns = t_ns;
+    }
+    a->regs[reg] = value;
+
+    /* Configuration writes restart conversion; OFCAL/FSCAL apply to the next result */
+    bool calibration = reg >= ADS1261_REG_OFCAL0 && reg <= ADS1261_REG_FSCAL2;
+    if (!calibration && (a->running || a->start_pin)) {
+        conversion_restart(a, t_ns);
+    }
+}
+
+/* Header complete: execute the command and stage its response payload */
+static void frame_execute(sim_adc_t *a, int64_t t_ns)
+{
+    uint8_t reg = a->frame_cmd & 0x1F;
+    size_t n = 0;
+
+    adc_sync(a, t_ns);
+    if (!a->frame_ok) {
+        a->regs[ADS1261_REG_STATUS] |= SIM_STATUS_CRCERR;  /* Command ignored */
+        return;
+    }
+
+    if ((a->frame_cmd & 0xE0) == ADS1261_CMD_WREG && reg < SIM_NUM_REGS && reg > ADS1261_REG_STATUS) {
+        write_register(a, reg, a->frame_arg, t_ns);
+    } else if (a->frame_cmd == ADS1261_CMD_RESET) {
+        memcpy(a->regs, reg_defaults, sizeof(a->regs));
+        a->running = false;
+        a->drdy = false;
+        if (a->start_pin) {
+            conversion_restart(a, t_ns);
+        }
+    } else if (a->frame_cmd == ADS1261_CMD_START) {
+        conversion_restart(a, t_ns);
+    } else if (a->frame_cmd == ADS1261_CMD_STOP) {
+        a->running = false;
+    } else if (a->frame_cmd == ADS1261_CMD_SYOCAL || a->frame_cmd == ADS1261_CMD_SFOCAL) {
+        /* SYOCAL measures the selected input, SFOCAL the internally shorted one */
+        set_reg24(a, ADS1261_REG_OFCAL0, a->frame_cmd == ADS1261_CMD_SYOCAL ? input_code(a, t_ns, false) : 0);
+        conversion_restart(a, t_ns);
+    } else if (a->frame_cmd == ADS1261_CMD_GANCAL) {
+        /* GANCAL: the applied input becomes positive full scale */
+        int64_t span = (int64_t)input_code(a, t_ns, false) - reg24(a, ADS1261_REG_OFCAL0);
+        if (span > 0) {
+            int64_t fscal = 0x7FFFFFLL * 0x400000 / span;
+            set_reg24(a, ADS1261_REG_FSCAL0, (int32_t)(fscal > 0xFFFFFF ? 0xFFFFFF : fscal));
+        }
+        conversion_restart(a, t_ns);
+    } else if ((a->frame_cmd & 0xE0) == ADS1261_CMD_RREG) {
+        a->frame_payload[n++] = reg == ADS1261_REG_STATUS ? status_now(a) : reg < SIM_NUM_REGS ? a->regs[reg] : 0x00;
+    } else if (a->frame_cmd == ADS1261_CMD_RDATA) {
+        if (a->regs[ADS1261_REG_MODE3] & SIM_MODE3_STATENB) {
+            a->frame_payload[n++] = status_now(a);
+        }
+        uint32_t code = (uint32_t)a->data;
+        a->frame_payload[n++] = (uint8_t)(code >> 16);
+        a->frame_payload[n++] = (uint8_t)(code >> 8);
+        a->frame_payload[n++] = (uint8_t)code;
+        a->drdy = false;  /* Data read clears DRDY */
+    }
+
+    if (n > 0 && a->frame_crc) {
+        a->frame_payload[n] = sim_crc8(a->frame_payload, n);
+        n++;
+    }
+    if (a->frame_cmd == ADS1261_CMD_RDATA && a->corrupt_rdata > 0) {
+        a->corrupt_rdata--;
+        a->frame_payload[n - 2] ^= 0x10;  /* Line error after the CRC was computed */
+    }
+}
+
+static sim_adc_t *adc_at(unsigned index)
+{
+    return &s_adcs[index < HOST_ADS1261_MAX ? index : 0];
+}
+
+void host_ads1261_frame_begin(unsigned index)
+{
+    sim_adc_t *a = adc_at(index);
+
+    a->frame_pos = 0;
+    a->frame_cmd = 0;
+    a->frame_arg = 0;
+}
+
+/*
+ * Frame: [cmd, arg, (CRC of cmd+arg when CRCENB)], then the response payload:
+ * RREG data, or RDATA (STATUS when STATENB) + 3 data bytes, each followed by
+ * a CRC of the payload when CRCENB.
+ */
+uint8_t host_ads1261_exchange(unsigned index, uint8_t mosi, int64_t t_ns)
+{
+    sim_adc_t *a = adc_at(index);
+    uint32_t pos = a->frame_pos++;
+
+    if (pos == 0) {
+        a->frame_cmd = mosi;
+        a->frame_crc = (a->regs[ADS1261_REG_MODE3] & SIM_MODE3_CRCENB) != 0;
+        a->frame_ok = true;
+        memset(a->frame_payload, 0, sizeof(a->frame_payload));
+        return 0xFF;
+    }
+
+    uint32_t header = a->frame_crc ? 3 : 2;
+    if (pos < header) {
+        uint8_t echo = pos == 1 ? a->frame_cmd : a->frame_arg;
+        if (pos == 1) {
+            a->frame_arg = mosi;
+        } else {
+            const uint8_t hdr[2] = { a->frame_cmd, a->frame_arg };
+            a->frame_ok = (mosi == sim_crc8(hdr, 2));
+        }
+        if (pos == header - 1) {
+            frame_execute(a, t_ns);
+        }
+        return echo;
+    }
+
+    pos -= header;
+    return pos < sizeof(a->frame_payload) ? a->frame_payload[pos] : 0x00;
+}
+
+void host_ads1261_sync(unsigned index, int64_t t_ns)
+{
+    adc_sync(adc_at(index), t_ns);
+}
+
+uint32_t host_ads1261_take_edges(unsigned index, int64_t t_ns)
+{
+    sim_adc_t *a = adc_at(index);
+    uint32_t n = 0;
+    while (a->edge_count > 0 && a->edges[a->edge_head] <= t_ns) {
+        a->edge_head = (a->edge_head + 1) % SIM_EDGE_RING;
+        a->edge_count--;
+        n++;
+    }
+    return n;
+}
+
+int64_t host_ads1261_next_edge_ns(unsigned index)
+{
+    sim_adc_t *a = adc_at(index);
+    if (a->edge_count > 0) {
+        return a->edges[a->edge_head];
+    }
+    return a->running ? a->next_ns : INT64_MAX;
+}
+
+int host_ads1261_drdy_gpio(unsigned index)
+{
+    sim_adc_t *a = adc_at(index);
+    return a->drdy_gpio;
+}
+
+int host_ads1261_drdy_level(unsigned index)
+{
+    sim_adc_t *a = adc_at(index);
+    return a->drdy ? 0 : 1;
+}
+
+/* ============================================================================
+ * Scenario control and inspection
+ * ============================================================================ */
+
+static void adc_reset(sim_adc_t *a)
+{
+    memcpy(a->regs, reg_defaults, sizeof(a->regs));
+    a->frame_pos = 0;
+    a->frame_cmd = 0;
+    a->frame_arg = 0;
+    a->corrupt_rdata = 0;
+
+    a->start_pin = true;
+    a->sync_ns = 0;
+    a->data = 0;
+    a->conversions = 0;
+    a->fixed_settle_ns = 0;
+    a->fixed_period_ns = 0;
+    a->edge_head = 0;
+    a->edge_count = 0;
+    a->drdy_gpio = -1;
+
+    a->use_code = true;
+    a->code = 0;
+    memset(a->inputs_v, 0, sizeof(a->inputs_v));
+    a->vref = 5.0;
+    a->noise_v = 0.0;
+    a->rng = 1;
+    a->tau_ns = 0;
+    a->mux_ns = 0;
+    a->mux_from_v = 0.0;
+
+    conversion_restart(a, 0);
+}
+
+void host_ads1261_reset(void)
+{
+    for (unsigned i = 0; i < HOST_ADS1261_MAX; i++) {
+        adc_reset(&s_adcs[i]);
+    }
+    s_sel = &s_adcs[0];
+}
+
+void host_ads1261_select(unsigned index)
+{
+    s_sel = adc_at(index);
+}
+
+void host_ads1261_set_code(int32_t code)
+{
+    sim_adc_t *a = s_sel;
+    a->use_code = true;
+    a->code = (int32_t)((uint32_t)code << 8) >> 8;
+}
+
+void host_ads1261_set_input(uint8_t inpmux, double volts)
+{
+    sim_adc_t *a = s_sel;
+    a->use_code = false;
+    a->inputs_v[inpmux] = volts;
+}
+
+void host_ads1261_set_bridge(uint8_t inpmux, double mv_per_v)
+{
+    host_ads1261_set_input(inpmux, mv_per_v * 1e-3 * s_sel->vref);
+}
+
+void host_ads1261_set_vref(double volts)
+{
+    s_sel->vref = volts > 0.0 ? volts : 5.0;
+}
+
+void host_ads1261_set_noise(double rms_volts, uint32_t seed)
+{
+    sim_adc_t *a = s_sel;
+    a->noise_v = rms_volts;
+    a->rng = seed ? seed : 1;
+}
+
+void host_ads1261_set_input_tau(uint32_t tau_ns)
+{
+    s_sel->tau_ns = tau_ns;
+}
+
+void host_ads1261_set_timing(uint32_t settle_ns, uint32_t period_ns)
+{
+    sim_adc_t *a = s_sel;
+    a->fixed_settle_ns = settle_ns;
+    a->fixed_period_ns = period_ns;
+}
+
+void host_ads1261_set_start_pin(bool high)
+{
+    s_sel->start_pin = high;
+}
+
+void host_ads1261_set_drdy_gpio(int gpio)
+{
+    s_sel->drdy_gpio = gpio;
+}
+
+void host_ads1261_corrupt_rdata(uint32_t count)
+{
+    s_sel->corrupt_rdata = count;
+}
+
+uint8_t host_ads1261_get_register(uint8_t reg)
+{
+    return reg < SIM_NUM_REGS ? s_sel->regs[reg] : 0x00;
+}
+
+int32_t host_ads1261_ideal_code(uint8_t inpmux)
+{
+    sim_adc_t *a = s_sel;
+    if (a->use_code) {
+        return a->code;
+    }
+    return clip24(a->inputs_v[inpmux] * pga_gain(a) / a->vref * SIM_FULL_SCALE);
+}
+
+uint32_t host_ads1261_conversions(void)
+{
+    return s_sel->conversions;
+}
+
+void host_ads1261_get_timing(uint32_t *settle_ns, uint32_t *period_ns)
+{
+    int64_t settle, period;
+    conversion_timing(s_sel, &settle, &period);
+    if (settle_ns) {
+        *settle_ns = (uint32_t)settle;
+    }
+    if (period_ns) {
+        *period_ns = (uint32_t)period;
+    }
+}
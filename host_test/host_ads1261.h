@@ -0,0 +1,131 @@
+/**
+ * @file host_ads1261.h
+ * @brief Behavioral ADS1261 model behind the host SPI stand-in
+ *
+ * Models what the driver can observe of the real part:
+ *
+ * - the register map, with RESET defaults, RREG/WREG, and STATENB/CRCENB
+ *   framing including the input command CRC;
+ * - free-running (or pulse) conversions whose first-conversion latency and
+ *   period follow MODE0 filter/data rate and the MODE1 start delay, restarted
+ *   by configuration writes, START and RESET;
+ * - the data register, STATUS.DRDY and the DRDY pin: both assert when a
+ *   conversion completes and clear when it is read, and reading before DRDY
+ *   returns the previous conversion, possibly from the previous input pair;
+ * - per-input-pair signals (bridge outputs in mV/V of a ratiometric
+ *   reference), the PGA gain, Gaussian input noise and an RC input time
+ *   constant that leaves mux-settling error in the first conversions after
+ *   a channel switch;
+ * - OFCAL/FSCAL correction and the SYOCAL/SFOCAL/GANCAL commands.
+ *
+ * Up to HOST_ADS1261_MAX instances share the bus, each behind its own CS and
+ * DRDY. host_spi.c binds them in spi_bus_add_device() order; the scenario and
+ * inspection calls apply to the instance picked with host_ads1261_select().
+ *
+ * Chop mode, the IDAC and the internal reference are not modelled. Timing
+ * comes from the ads1261_timing tables; filter/rate combinations the part
+ * does not support convert like sinc4.
+ */
+
+#ifndef HOST_ADS1261_H
+#define HOST_ADS1261_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Devices that can share the simulated bus */
+#define HOST_ADS1261_MAX    4
+
+/* ============================================================================
+ * Scenario control
+ * ============================================================================ */
+
+/** Power-on state of every instance (default registers, no inputs, no noise, START pin high); selects instance 0 */
+void host_ads1261_reset(void);
+
+/** Instance the scenario and inspection calls below apply to */
+void host_ads1261_select(unsigned index);
+
+/** Return code (before OFCAL/FSCAL) for every input pair, bypassing the signal model */
+void host_ads1261_set_code(int32_t code);
+
+/** Differential voltage at an input pair (INPMUX value); disables set_code */
+void host_ads1261_set_input(uint8_t inpmux, double volts);
+
+/** Bridge output of an input pair in mV/V of the reference (ratiometric excitation) */
+void host_ads1261_set_bridge(uint8_t inpmux, double mv_per_v);
+
+/** Reference voltage (default 5 V) */
+void host_ads1261_set_vref(double volts);
+
+/** Input-referred Gaussian noise in volts RMS, with a reproducible seed */
+void host_ads1261_set_noise(double rms_volts, uint32_t seed);
+
+/** RC time constant seen by the inputs after a mux change (0 = ideal source) */
+void host_ads1261_set_input_tau(uint32_t tau_ns);
+
+/**
+ * Fix the first-conversion latency and period instead of deriving them from
+ * MODE0/MODE1; settle_ns = 0 returns to the register-driven model.
+ */
+void host_ads1261_set_timing(uint32_t settle_ns, uint32_t period_ns);
+
+/** Level of the START pin; low means conversions only run after a START command */
+void host_ads1261_set_start_pin(bool high);
+
+/** GPIO the DRDY output is wired to (-1 = not connected, the default) */
+void host_ads1261_set_drdy_gpio(int gpio);
+
+/** Flip one data bit in the next count RDATA responses, after their CRC */
+void host_ads1261_corrupt_rdata(uint32_t count);
+
+/* ============================================================================
+ * Inspection
+ * ============================================================================ */
+
+/** Peek at the register file */
+uint8_t host_ads1261_get_register(uint8_t reg);
+
+/** Noise-free, fully settled code of an input pair at the current PGA gain (before OFCAL/FSCAL) */
+int32_t host_ads1261_ideal_code(uint8_t inpmux);
+
+/** Conversions completed since reset */
+uint32_t host_ads1261_conversions(void);
+
+/** Current first-conversion latency and conversion period in nanoseconds */
+void host_ads1261_get_timing(uint32_t *settle_ns, uint32_t *period_ns);
+
+/* ============================================================================
+ * Bus side (used by host_spi.c, addressed by instance index)
+ * ============================================================================ */
+
+/** CS fell: start a new command frame */
+void host_ads1261_frame_begin(unsigned index);
+
+/** Exchange one byte; t_ns is when its last bit is clocked */
+uint8_t host_ads1261_exchange(unsigned index, uint8_t mosi, int64_t t_ns);
+
+/** Run conversions up to t_ns */
+void host_ads1261_sync(unsigned index, int64_t t_ns);
+
+/** Remove and count the DRDY falling edges at or before t_ns */
+uint32_t host_ads1261_take_edges(unsigned index, int64_t t_ns);
+
+/** Time of the next DRDY falling edge after the ones already taken (INT64_MAX if none) */
+int64_t host_ads1261_next_edge_ns(unsigned index);
+
+/** GPIO the DRDY output is wired to, or -1 */
+int host_ads1261_drdy_gpio(unsigned index);
+
+/** DRDY pin level (active low) */
+int host_ads1261_drdy_level(unsigned index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_ADS1261_H */
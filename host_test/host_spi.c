@@ -0,0 +1,775 @@
+/**
+ * @file host_spi.c
+ * @brief Host-side stand-in for the ESP-IDF SPI/GPIO layer used by ads1261.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "driver/spi_master.h"
+#include "driver/gpio.h"
+#include "driver/gptimer.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+
+#define HOST_MAX_GPIO   32
+
+/* Driver overheads are a model, not a measurement: ballpark figures for
+ * ESP32-C6 @160 MHz polling and interrupt-driven single transactions. */
+static const host_spi_cost_t default_cost = {
+    .polling_overhead_ns = 6000,
+    .queue_submit_ns = 2500,
+    .isr_gap_ns = 4000,
+    .result_wake_ns = 3000,
+    .drdy_wake_ns = 5000,
+};
+
+#define HOST_QUEUE_MAX  16
+
+struct spi_device_t {
+    int clock_speed_hz;
+    unsigned adc;               /* ADS1261 model instance behind this CS */
+    spi_transaction_t *queue[HOST_QUEUE_MAX];
+    int64_t done_ns[HOST_QUEUE_MAX];
+    int q_head;
+    int q_count;
+};
+
+struct host_sem {
+    int count;
+};
+
+struct host_queue {
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t items[];
+};
+
+esp_log_level_t host_log_level = ESP_LOG_WARN;
+
+static host_spi_cost_t s_cost;
+static host_spi_stats_t s_stats;
+static int64_t s_now_ns;
+static int64_t s_bus_free_ns;
+static bool s_cs_active;
+static bool s_adc_bound[HOST_ADS1261_MAX];
+static int s_gpio_level[HOST_MAX_GPIO];
+
+static uint32_t s_notify_pending;
+
+struct host_gpio_isr {
+    gpio_isr_t handler;
+    void *arg;
+    gpio_int_type_t type;
+};
+
+static struct host_gpio_isr s_gpio_isr[HOST_MAX_GPIO];
+
+#define HOST_MAX_TIMERS 2
+
+struct gptimer_t {
+    bool in_use;
+    bool enabled;
+    bool running;
+    bool alarm_armed;           /* Alarm set and not yet fired (or auto-reloading) */
+    bool auto_reload;
+    uint32_t resolution_hz;
+    uint64_t alarm_count;
+    uint64_t reload_count;
+    uint64_t base_count;        /* Count at base_ns */
+    int64_t base_ns;
+    gptimer_alarm_cb_t on_alarm;
+    void *user_ctx;
+};
+
+static struct gptimer_t s_timers[HOST_MAX_TIMERS];
+
+/* Run the devices up to the current time and raise the DRDY interrupts they produced */
+static void deliver_drdy_edges(void)
+{
+    for (unsigned i = 0; i < HOST_ADS1261_MAX; i++) {
+        host_ads1261_sync(i, s_now_ns);
+        uint32_t edges = host_ads1261_take_edges(i, s_now_ns);
+        int pin = host_ads1261_drdy_gpio(i);
+        if (pin < 0 || pin >= HOST_MAX_GPIO) {
+            continue;
+        }
+        const struct host_gpio_isr *isr = &s_gpio_isr[pin];
+        if (!isr->handler || (isr->type != GPIO_INTR_NEGEDGE && isr->type != GPIO_INTR_ANYEDGE)) {
+            continue;
+        }
+        while (edges--) {
+            isr->handler(isr->arg);
+        }
+    }
+}
+
+/* Current count of a timer */
+static uint64_t timer_count(const struct gptimer_t *timer)
+{
+    if (!timer->running) {
+        return timer->base_count;
+    }
+    return timer->base_count + (uint64_t)((s_now_ns - timer->base_ns) * (int64_t)timer->resolution_hz / 1000000000LL);
+}
+
+/* Time of a timer's next alarm (INT64_MAX if none is pending) */
+static int64_t timer_alarm_ns(const struct gptimer_t *timer)
+{
+    if (!timer->in_use || !timer->running || !timer->alarm_armed) {
+        return INT64_MAX;
+    }
+    if (timer->base_count >= timer->alarm_count) {
+        return timer->base_ns;
+    }
+    uint64_t counts = timer->alarm_count - timer->base_count;
+    return timer->base_ns + (int64_t)((counts * 1000000000ULL + timer->resolution_hz - 1) / timer->resolution_hz);
+}
+
+/* Run the alarms that fell due by now, in order, reloading periodic ones at their exact alarm time */
+static void deliver_timer_alarms(void)
+{
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        struct gptimer_t *timer = &s_timers[i];
+        int64_t alarm_ns;
+        while ((alarm_ns = timer_alarm_ns(timer)) <= s_now_ns) {
+            gptimer_alarm_event_data_t edata = {
+                .count_value = timer->alarm_count,
+                .alarm_value = timer->alarm_count,
+            };
+            timer->base_ns = alarm_ns;
+            if (timer->auto_reload) {
+                timer->base_count = timer->reload_count;
+            } else {
+                timer->base_count = timer->alarm_count;
+                timer->alarm_armed = false;
+            }
+            if (timer->on_alarm) {
+                timer->on_alarm(timer, &edata, timer->user_ctx);
+            }
+        }
+    }
+}
+
+/* Advance the simulated CPU clock to t_ns (never backwards) */
+static void advance_to(int64_t t_ns)
+{
+    if (t_ns > s_now_ns) {
+        s_now_ns = t_ns;
+    }
+    deliver_drdy_edges();
+    deliver_timer_alarms();
+}
+
+/* Earliest DRDY edge of a device whose pin has an interrupt handler */
+static int64_t next_irq_edge_ns(void)
+{
+    int64_t next = INT64_MAX;
+    for (unsigned i = 0; i < HOST_ADS1261_MAX; i++) {
+        int pin = host_ads1261_drdy_gpio(i);
+        if (pin >= 0 && pin < HOST_MAX_GPIO && s_gpio_isr[pin].handler) {
+            int64_t edge = host_ads1261_next_edge_ns(i);
+            next = edge < next ? edge : next;
+        }
+    }
+    return next;
+}
+
+/* Earliest interrupt of any kind: a handled DRDY edge or a timer alarm */
+static int64_t next_event_ns(void)
+{
+    int64_t next = next_irq_edge_ns();
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        int64_t alarm = timer_alarm_ns(&s_timers[i]);
+        next = alarm < next ? alarm : next;
+    }
+    return next;
+}
+
+/* Clock a transaction through the ADS1261 model; returns its wire time */
+static int64_t wire_exchange(spi_device_handle_t handle, spi_transaction_t *t, int64_t start_ns)
+{
+    size_t nbytes = (t->length + 7) / 8;
+    const uint8_t *tx = (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : t->tx_buffer;
+    uint8_t *rx = (t->flags & SPI_TRANS_USE_RXDATA) ? t->rx_data : t->rx_buffer;
+
+    /* CS falls at the start of a transaction unless the previous one kept it low */
+    if (!s_cs_active) {
+        host_ads1261_frame_begin(handle->adc);
+    }
+    for (size_t i = 0; i < nbytes; i++) {
+        int64_t exchange_ns = start_ns + (int64_t)(i + 1) * 8 * 1000000000LL / handle->clock_speed_hz;
+        uint8_t miso = host_ads1261_exchange(handle->adc, tx ? tx[i] : 0x00, exchange_ns);
+        if (rx) {
+            rx[i] = miso;
+        }
+    }
+    s_cs_active = (t->flags & SPI_TRANS_CS_KEEP_ACTIVE) != 0;
+    if (!s_cs_active) {
+        s_stats.cs_frames++;
+    }
+
+    int64_t wire_ns = (int64_t)t->length * 1000000000LL / handle->clock_speed_hz;
+    s_stats.transactions++;
+    s_stats.bytes += nbytes;
+    s_stats.bus_busy_ns += wire_ns;
+    return wire_ns;
+}
+
+/* ============================================================================
+ * Harness control
+ * ============================================================================ */
+
+void host_spi_reset(void)
+{
+    s_cost = default_cost;
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(s_gpio_level, 0, sizeof(s_gpio_level));
+    memset(s_gpio_isr, 0, sizeof(s_gpio_isr));
+    s_now_ns = 0;
+    s_bus_free_ns = 0;
+    s_cs_active = false;
+    s_notify_pending = 0;
+    memset(s_timers, 0, sizeof(s_timers));
+    memset(s_adc_bound, 0, sizeof(s_adc_bound));
+    host_ads1261_reset();
+}
+
+void host_spi_set_cost(const host_spi_cost_t *cost)
+{
+    s_cost = *cost;
+}
+
+void host_spi_reset_stats(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+host_spi_stats_t host_spi_get_stats(void)
+{
+    return s_stats;
+}
+
+int64_t host_spi_now_ns(void)
+{
+    return s_now_ns;
+}
+
+/* ============================================================================
+ * spi_master
+ * ============================================================================ */
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *dev_config,
+                             spi_device_handle_t *handle)
+{
+    (void)host;
+    if (!dev_config || !handle || dev_config->clock_speed_hz <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    /* Each device gets the lowest model instance not bound to another CS */
+    unsigned adc = 0;
+    while (adc < HOST_ADS1261_MAX && s_adc_bound[adc]) {
+        adc++;
+    }
+    if (adc == HOST_ADS1261_MAX) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct spi_device_t *dev = calloc(1, sizeof(*dev));
+    if (!dev) {
+        return ESP_ERR_NO_MEM;
+    }
+    dev->clock_speed_hz = dev_config->clock_speed_hz;
+    dev->adc = adc;
+    s_adc_bound[adc] = true;
+    *handle = dev;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+    if (handle) {
+        s_adc_bound[handle->adc] = false;
+    }
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans_desc)
+{
+    if (!handle || !trans_desc) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->q_count) {
+        return ESP_ERR_INVALID_STATE;  /* Same restriction as the real driver */
+    }
+    int64_t start = (s_bus_free_ns > s_now_ns ? s_bus_free_ns : s_now_ns) + s_cost.polling_overhead_ns;
+    s_bus_free_ns = start + wire_exchange(handle, trans_desc, start);
+    advance_to(s_bus_free_ns);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans_desc, uint32_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (!handle || !trans_desc) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->q_count >= HOST_QUEUE_MAX) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    advance_to(s_now_ns + s_cost.queue_submit_ns);
+
+    /* The transaction starts when both the caller has queued it and the bus is idle */
+    int64_t start = s_bus_free_ns > s_now_ns ? s_bus_free_ns : s_now_ns;
+    start += s_cost.isr_gap_ns;
+    s_bus_free_ns = start + wire_exchange(handle, trans_desc, start);
+
+    int slot = (handle->q_head + handle->q_count) % HOST_QUEUE_MAX;
+    handle->queue[slot] = trans_desc;
+    handle->done_ns[slot] = s_bus_free_ns;
+    handle->q_count++;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans_desc, uint32_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (!handle || !trans_desc) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->q_count == 0) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    int64_t done = handle->done_ns[handle->q_head];
+    if (done > s_now_ns) {
+        advance_to(done + s_cost.result_wake_ns);
+    }
+    *trans_desc = handle->queue[handle->q_head];
+    handle->q_head = (handle->q_head + 1) % HOST_QUEUE_MAX;
+    handle->q_count--;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_transmit(spi_device_handle_t handle, spi_transaction_t *trans_desc)
+{
+    spi_transaction_t *done;
+    esp_err_t ret = spi_device_queue_trans(handle, trans_desc, portMAX_DELAY);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return spi_device_get_trans_result(handle, &done, portMAX_DELAY);
+}
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, uint32_t wait)
+{
+    (void)wait;
+    return device ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+void spi_device_release_bus(spi_device_handle_t dev)
+{
+    (void)dev;
+}
+
+/* ============================================================================
+ * gpio
+ * ============================================================================ */
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    return cfg ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_num < 0 || gpio_num >= HOST_MAX_GPIO) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_gpio_level[gpio_num] = level ? 1 : 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= HOST_MAX_GPIO) {
+        return 0;
+    }
+    for (unsigned i = 0; i < HOST_ADS1261_MAX; i++) {
+        if (gpio_num == host_ads1261_drdy_gpio(i)) {
+            host_ads1261_sync(i, s_now_ns);
+            return host_ads1261_drdy_level(i);
+        }
+    }
+    return s_gpio_level[gpio_num];
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+{
+    if (gpio_num < 0 || gpio_num >= HOST_MAX_GPIO) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_gpio_isr[gpio_num].type = intr_type;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (gpio_num < 0 || gpio_num >= HOST_MAX_GPIO || !isr_handler) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_gpio_isr[gpio_num].handler = isr_handler;
+    s_gpio_isr[gpio_num].arg = args;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= HOST_MAX_GPIO) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_gpio_isr[gpio_num].handler = NULL;
+    s_gpio_isr[gpio_num].arg = NULL;
+    return ESP_OK;
+}
+
+/* ============================================================================
+ * Timing, FreeRTOS and misc
+ * ============================================================================ */
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_ns / 1000;
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    advance_to(s_now_ns + (int64_t)us * 1000);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    advance_to(s_now_ns + (int64_t)ticks * (1000000000LL / configTICK_RATE_HZ));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(s_now_ns / (1000000000LL / configTICK_RATE_HZ));
+}
+
+/* Single simulated task: notifications are only produced by interrupt handlers */
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)&s_notify_pending;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    deliver_drdy_edges();
+    if (s_notify_pending == 0 && ticks_to_wait > 0) {
+        /* Block until an interrupt wakes the task, or time out */
+        int64_t deadline = s_now_ns + (int64_t)ticks_to_wait * (1000000000LL / configTICK_RATE_HZ);
+        while (s_notify_pending == 0 && s_now_ns < deadline) {
+            int64_t edge = next_event_ns();
+            advance_to(edge < deadline ? edge : deadline);
+        }
+        if (s_notify_pending) {
+            advance_to(s_now_ns + s_cost.drdy_wake_ns);
+        }
+    }
+
+    uint32_t value = s_notify_pending;
+    if (value == 0) {
+        return 0;
+    }
+    s_notify_pending = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    (void)task;
+    s_notify_pending++;
+    if (higher_priority_task_woken) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return calloc(1, sizeof(struct host_sem));
+}
+
+/* Nothing else can hold it on a single thread: a mutex starts given */
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t sem = calloc(1, sizeof(struct host_sem));
+    if (sem) {
+        sem->count = 1;
+    }
+    return sem;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    free(sem);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (!sem || sem->count) {
+        return pdFALSE;
+    }
+    sem->count = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken)
+{
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    return xSemaphoreGive(sem);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    advance_to(s_now_ns);
+    if (sem && !sem->count && ticks > 0) {
+        /* Only an interrupt handler can give it while the single task waits */
+        int64_t deadline = s_now_ns + (int64_t)ticks * (1000000000LL / configTICK_RATE_HZ);
+        while (!sem->count && s_now_ns < deadline) {
+            int64_t event = next_event_ns();
+            advance_to(event < deadline ? event : deadline);
+        }
+        if (sem->count) {
+            advance_to(s_now_ns + s_cost.drdy_wake_ns);
+        }
+    }
+    if (sem && sem->count) {
+        sem->count = 0;
+        return pdTRUE;
+    }
+    if (!sem) {
+        vTaskDelay(ticks);
+    }
+    return pdFALSE;
+}
+
+/* Queues: no other task can make room or send while the single one waits, so none block */
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    if (length == 0 || item_size == 0) {
+        return NULL;
+    }
+    QueueHandle_t queue = calloc(1, sizeof(struct host_queue) + (size_t)length * item_size);
+    if (queue) {
+        queue->length = length;
+        queue->item_size = item_size;
+    }
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    free(queue);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    (void)ticks;
+    if (!queue || queue->count == queue->length) {
+        return pdFALSE;
+    }
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->items[tail * queue->item_size], item, queue->item_size);
+    queue->count++;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    (void)ticks;
+    if (!queue || queue->count == 0) {
+        return pdFALSE;
+    }
+    memcpy(item, &queue->items[queue->head * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return queue ? queue->count : 0;
+}
+
+/* No second thread of execution on the host: tasks cannot be created */
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *handle)
+{
+    (void)task; (void)name; (void)stack_depth; (void)arg; (void)priority;
+    if (handle) {
+        *handle = NULL;
+    }
+    return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+/* ============================================================================
+ * gptimer
+ * ============================================================================ */
+
+esp_err_t gptimer_new_timer(const gptimer_config_t *config, gptimer_handle_t *ret_timer)
+{
+    if (!config || !ret_timer || config->resolution_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        if (!s_timers[i].in_use) {
+            s_timers[i] = (struct gptimer_t) {
+                .in_use = true,
+                .resolution_hz = config->resolution_hz,
+                .base_ns = s_now_ns,
+            };
+            *ret_timer = &s_timers[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t gptimer_del_timer(gptimer_handle_t timer)
+{
+    if (!timer || timer->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->in_use = false;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_register_event_callbacks(gptimer_handle_t timer, const gptimer_event_callbacks_t *cbs, void *user_data)
+{
+    if (!timer || !cbs) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->on_alarm = cbs->on_alarm;
+    timer->user_ctx = user_data;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_alarm_action(gptimer_handle_t timer, const gptimer_alarm_config_t *config)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    timer->base_count = timer_count(timer);
+    timer->base_ns = s_now_ns;
+    timer->alarm_armed = config != NULL;
+    if (config) {
+        timer->alarm_count = config->alarm_count;
+        timer->reload_count = config->reload_count;
+        timer->auto_reload = config->flags.auto_reload_on_alarm;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_raw_count(gptimer_handle_t timer, uint64_t value)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    timer->base_count = value;
+    timer->base_ns = s_now_ns;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_get_raw_count(gptimer_handle_t timer, uint64_t *value)
+{
+    if (!timer || !value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *value = timer_count(timer);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_enable(gptimer_handle_t timer)
+{
+    if (!timer || timer->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_disable(gptimer_handle_t timer)
+{
+    if (!timer || !timer->enabled || timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_start(gptimer_handle_t timer)
+{
+    if (!timer || !timer->enabled || timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->base_ns = s_now_ns;
+    timer->running = true;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_stop(gptimer_handle_t timer)
+{
+    if (!timer || !timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->base_count = timer_count(timer);
+    timer->base_ns = s_now_ns;
+    timer->running = false;
+    return ESP_OK;
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                    return "ESP_OK";
+    case ESP_FAIL:                  return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:            return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:       return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:     return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:      return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:         return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:     return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:           return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:  return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC:       return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_NOT_FINISHED:      return "ESP_ERR_NOT_FINISHED";
+    default:                        return "UNKNOWN ERROR";
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file host_spi.h
+ * @brief Host-side stand-in for the ESP-IDF SPI/GPIO layer used by ads1261.c
+ *
+ * Implements spi_master, gpio, esp_timer and the FreeRTOS primitives the
+ * driver touches, on top of a simulated microsecond clock. Every SPI
+ * transaction is charged a fixed driver overhead plus its wire time, so
+ * driver changes can be compared for bus cost without the ZForce board.
+ * Queued transactions run on a separate bus timeline: the caller only pays
+ * the submit cost and waits in spi_device_get_trans_result() if the bus is
+ * still busy, which models CPU work overlapping SPI traffic.
+ *
+ * The behavioral ADS1261 model in host_ads1261.h sits behind the bus, one
+ * instance per added device. Their DRDY edges run the GPIO interrupt handler
+ * registered for the pin each is wired to, and a task blocked in
+ * ulTaskNotifyTake() sleeps until the edge that wakes it. gptimer alarms
+ * fire on the same clock, so a task waiting on a semaphore given by an alarm
+ * callback sleeps until that alarm. There is only one task: xTaskCreate()
+ * fails and acquisition loops are driven from the test itself.
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Cost model applied to each SPI transaction
+ */
+typedef struct {
+    uint32_t polling_overhead_ns;   /**< spi_device_polling_transmit setup/teardown */
+    uint32_t queue_submit_ns;       /**< CPU cost of spi_device_queue_trans */
+    uint32_t isr_gap_ns;            /**< Bus idle time per queued transaction (ISR setup) */
+    uint32_t result_wake_ns;        /**< Task wake-up when get_trans_result had to block */
+    uint32_t drdy_wake_ns;          /**< DRDY edge to the notified task running (ISR + switch) */
+} host_spi_cost_t;
+
+/**
+ * Bus counters, cleared by host_spi_reset_stats()
+ */
+typedef struct {
+    uint32_t transactions;          /**< spi_device_*_transmit calls */
+    uint32_t bytes;                 /**< Bytes clocked on the wire */
+    uint32_t cs_frames;             /**< CS low->high frames seen by the device */
+    int64_t bus_busy_ns;            /**< Time the bus spent clocking data */
+} host_spi_stats_t;
+
+/** Reset the simulated clock, cost model, counters, GPIO handlers and the ADS1261 model */
+void host_spi_reset(void);
+
+/** Replace the per-transaction cost model */
+void host_spi_set_cost(const host_spi_cost_t *cost);
+
+/** Clear bus counters */
+void host_spi_reset_stats(void);
+
+/** Read bus counters */
+host_spi_stats_t host_spi_get_stats(void);
+
+/** Simulated time since host_spi_reset(), in nanoseconds */
+int64_t host_spi_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SPI_H */
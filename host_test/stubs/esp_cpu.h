@@ -0,0 +1,29 @@
+/* Host stand-in for ESP-IDF esp_cpu.h - cycle counter from the host CPU */
+#ifndef HOST_ESP_CPU_H
+#define HOST_ESP_CPU_H
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (esp_cpu_cycle_count_t)__builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (esp_cpu_cycle_count_t)(ts.tv_sec * 1000000000LL + ts.tv_nsec);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,321 @@
+/**
+ * @file test_acquisition.c
+ * @brief Acquisition engine tests against the simulated ADS1261 and gptimer
+ *
+ * Drives acquisition_step() from the test (the host has a single task) and
+ * checks the schedule a board would see: frames on an exact deadline grid at
+ * 1000 Hz, rates above the scan capacity refused, late frames and skipped
+ * deadlines counted after a stall with the grid kept, free-running frames
+ * back-to-back at the DRDY-paced capacity, and mailbox requests served one
+ * per frame between scans, or dropped when the caller gives up on a stalled
+ * stepping task.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "acquisition.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define TEST_DRDY_PIN       10
+#define TEST_MAX_FRAMES     400
+#define TEST_TIMEOUT_MS     100
+
+/* Frames seen by the callback; stall_frame burns stall_us inside that frame's callback */
+typedef struct {
+    acquisition_frame_t frames[TEST_MAX_FRAMES];
+    int count;
+    int stall_frame;
+    uint32_t stall_us;
+} frame_log_t;
+
+static loadcell_t s_lc;
+static frame_log_t s_log;
+
+static void log_frame(loadcell_t *loadcell, const acquisition_frame_t *frame, void *ctx)
+{
+    frame_log_t *log = (frame_log_t *)ctx;
+    if (log->count < TEST_MAX_FRAMES) {
+        log->frames[log->count] = *frame;
+    }
+    if (log->count == log->stall_frame) {
+        esp_rom_delay_us(log->stall_us);
+    }
+    log->count++;
+}
+
+/* Fresh simulator and a 4-channel loadcell at 40 kSPS with DRDY wired */
+static void setup(acquisition_t *acq, float rate_hz)
+{
+    host_spi_reset();
+    host_ads1261_set_drdy_gpio(TEST_DRDY_PIN);
+    for (int ch = 0; ch < LOADCELL_CHANNELS_PER_ADC; ch++) {
+        host_ads1261_set_bridge((uint8_t)((2 * ch) << 4 | (2 * ch + 1)), 0.2 * (ch + 1));
+    }
+    CHECK(loadcell_init(&s_lc, SPI2_HOST, -1, TEST_DRDY_PIN, ADS1261_PGA_GAIN_128,
+                        ADS1261_DR_40000_SPS) == ESP_OK, "loadcell_init failed");
+
+    s_log = (frame_log_t) { .stall_frame = -1 };
+    acquisition_config_t cfg = {
+        .loadcell = &s_lc,
+        .frame_rate_hz = rate_hz,
+        .on_frame = log_frame,
+        .ctx = &s_log,
+    };
+    CHECK(acquisition_init(acq, &cfg) == ESP_OK, "acquisition_init(%.0f Hz) failed", rate_hz);
+}
+
+static void teardown(acquisition_t *acq)
+{
+    acquisition_deinit(acq);
+    loadcell_deinit(&s_lc);
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_deadline_grid(void)
+{
+    acquisition_t acq;
+    acquisition_stats_t stats;
+    const int frames = 300;
+
+    setup(&acq, 1000.0f);
+    CHECK(acq.period_us == 1000, "period %lu us", (unsigned long)acq.period_us);
+    CHECK(acquisition_begin(&acq) == ESP_OK, "begin failed");
+    for (int i = 0; i < frames; i++) {
+        CHECK(acquisition_step(&acq, TEST_TIMEOUT_MS) == ESP_OK, "frame %d failed", i);
+    }
+    acquisition_end(&acq);
+
+    /* Every frame starts on its own deadline: no drift from read time */
+    int off_grid = 0;
+    uint32_t worst_latency = 0;
+    for (int i = 0; i < frames; i++) {
+        const acquisition_frame_t *f = &s_log.frames[i];
+        if (f->index != (uint32_t)i || f->deadline_us != acq.start_us + (int64_t)(i + 1) * 1000) {
+            off_grid++;
+        }
+        uint32_t latency = (uint32_t)(f->start_us - f->deadline_us);
+        worst_latency = latency > worst_latency ? latency : worst_latency;
+    }
+    CHECK(off_grid == 0, "%d of %d frames off the 1 ms grid", off_grid, frames);
+    CHECK(worst_latency < 50, "deadline-to-start latency up to %lu us", (unsigned long)worst_latency);
+
+    int64_t span_us = s_log.frames[frames - 1].deadline_us - s_log.frames[0].deadline_us;
+    CHECK(span_us == (int64_t)(frames - 1) * 1000, "%d frames spanned %lld us", frames, (long long)span_us);
+
+    acquisition_get_stats(&acq, &stats);
+    CHECK(stats.frames == (uint32_t)frames && stats.late_frames == 0 && stats.overruns == 0,
+          "frames %lu late %lu overruns %lu", (unsigned long)stats.frames, (unsigned long)stats.late_frames,
+          (unsigned long)stats.overruns);
+    CHECK(stats.max_frame_us < 1000, "longest frame %lu us", (unsigned long)stats.max_frame_us);
+    for (int ch = 0; ch < s_lc.num_channels; ch++) {
+        int32_t ideal = host_ads1261_ideal_code((uint8_t)((2 * ch) << 4 | (2 * ch + 1)));
+        CHECK(s_lc.measurements[ch].raw_adc == ideal, "ch%d read %ld, expected %ld", ch,
+              (long)s_lc.measurements[ch].raw_adc, (long)ideal);
+
+        /* Every frame fed the channel's running statistics */
+        loadcell_stats_t ch_stats;
+        loadcell_get_stats(&s_lc, ch, &ch_stats);
+        CHECK(ch_stats.sample_count == (uint32_t)frames && ch_stats.window_count == LOADCELL_STATS_WINDOW,
+              "ch%d statistics hold %lu samples", ch, (unsigned long)ch_stats.sample_count);
+    }
+    teardown(&acq);
+}
+
+static void test_rate_limit(void)
+{
+    acquisition_t acq;
+    ads1261_timing_plan_t timing;
+
+    setup(&acq, ACQUISITION_FREE_RUN);
+    loadcell_get_timing(&s_lc, &timing);
+    CHECK(acquisition_set_rate(&acq, timing.frame_rate_hz * 1.5f) == ESP_ERR_INVALID_ARG,
+          "%.0f Hz accepted with %.0f Hz capacity", timing.frame_rate_hz * 1.5f, timing.frame_rate_hz);
+    CHECK(acquisition_set_rate(&acq, -1.0f) == ESP_ERR_INVALID_ARG, "negative rate accepted");
+    CHECK(acquisition_set_rate(&acq, 250.0f) == ESP_OK && acq.period_us == 4000, "250 Hz gave %lu us",
+          (unsigned long)acq.period_us);
+    CHECK(s_lc.frame_rate_hz == 250.0f, "filters designed for %.1f Hz", s_lc.frame_rate_hz);
+    teardown(&acq);
+}
+
+static void test_overrun(void)
+{
+    acquisition_t acq;
+    acquisition_stats_t stats;
+    const int frames = 40;
+
+    /* Frame 10 stalls 2.5 ms: deadlines 11 and 12 pass during it and 13 runs next, late */
+    setup(&acq, 1000.0f);
+    s_log.stall_frame = 10;
+    s_log.stall_us = 2500;
+    CHECK(acquisition_begin(&acq) == ESP_OK, "begin failed");
+    for (int i = 0; i < frames; i++) {
+        CHECK(acquisition_step(&acq, TEST_TIMEOUT_MS) == ESP_OK, "frame %d failed", i);
+    }
+    acquisition_end(&acq);
+
+    acquisition_get_stats(&acq, &stats);
+    /* Late frames until the slack between scan and period absorbs the delay */
+    CHECK(stats.late_frames >= 1 && stats.late_frames <= 10, "%lu late frames", (unsigned long)stats.late_frames);
+    CHECK(stats.overruns == 2, "%lu overruns", (unsigned long)stats.overruns);
+    CHECK(s_log.frames[11].index == 13, "frame after the stall has index %lu", (unsigned long)s_log.frames[11].index);
+
+    /* Back on the grid, not shifted by the stall */
+    const acquisition_frame_t *last = &s_log.frames[frames - 1];
+    CHECK(last->deadline_us == acq.start_us + (int64_t)(last->index + 1) * 1000 && last->index == frames + 1,
+          "last frame index %lu due at %lld", (unsigned long)last->index, (long long)(last->deadline_us - acq.start_us));
+    CHECK(last->start_us - last->deadline_us < 50, "still %lld us behind after the stall",
+          (long long)(last->start_us - last->deadline_us));
+    teardown(&acq);
+}
+
+static void test_free_run(void)
+{
+    acquisition_t acq;
+    acquisition_stats_t stats;
+    ads1261_timing_plan_t timing;
+    const int frames = 100;
+
+    setup(&acq, ACQUISITION_FREE_RUN);
+    loadcell_get_timing(&s_lc, &timing);
+    CHECK(acquisition_begin(&acq) == ESP_OK, "begin failed");
+    for (int i = 0; i < frames; i++) {
+        CHECK(acquisition_step(&acq, TEST_TIMEOUT_MS) == ESP_OK, "frame %d failed", i);
+    }
+    acquisition_end(&acq);
+
+    double rate = (frames - 1) * 1e6 / (double)(s_log.frames[frames - 1].start_us - s_log.frames[0].start_us);
+    acquisition_get_stats(&acq, &stats);
+    CHECK(stats.late_frames == 0 && stats.overruns == 0, "free-running frames counted late");
+    CHECK(rate > 0.85 * timing.frame_rate_hz && rate > 1000.0, "free-running at %.1f Hz (plan %.1f Hz)", rate,
+          timing.frame_rate_hz);
+    printf("acquisition: free-running %.1f Hz, plan %.1f Hz, longest frame %lu us\n", rate, timing.frame_rate_hz,
+           (unsigned long)stats.max_frame_us);
+    teardown(&acq);
+}
+
+/* Register dump of the first ADC, as a console request would make; records the frame it ran after */
+typedef struct {
+    int after_frame;
+    uint32_t mismatch;
+} dump_req_t;
+
+static esp_err_t dump_registers(loadcell_t *loadcell, void *arg)
+{
+    dump_req_t *req = (dump_req_t *)arg;
+    ads1261_regs_t regs;
+    req->after_frame = s_log.count;
+    return ads1261_snapshot(&loadcell->adcs[0], &regs, &req->mismatch);
+}
+
+static void test_mailbox(void)
+{
+    acquisition_t acq;
+    acquisition_stats_t stats;
+    dump_req_t dumps[ACQUISITION_MAILBOX_DEPTH + 1] = { 0 };
+    acquisition_request_t requests[ACQUISITION_MAILBOX_DEPTH + 1] = { 0 };
+
+    setup(&acq, 1000.0f);
+
+    /* No schedule yet: the call runs at once in the caller */
+    dumps[0].after_frame = -1;
+    CHECK(acquisition_call(&acq, dump_registers, &dumps[0]) == ESP_OK && dumps[0].after_frame == 0,
+          "call before begin ran after frame %d", dumps[0].after_frame);
+    CHECK(acquisition_post(&acq, &requests[0]) == ESP_ERR_INVALID_ARG, "request without fn accepted");
+    requests[0] = (acquisition_request_t) { .fn = dump_registers, .arg = &dumps[0] };
+    CHECK(acquisition_post(&acq, &requests[0]) == ESP_ERR_INVALID_STATE, "post accepted without a schedule");
+
+    /* Posted from elsewhere while the schedule runs: one request after each frame, in order */
+    CHECK(acquisition_begin(&acq) == ESP_OK, "begin failed");
+    for (int i = 0; i < 2; i++) {
+        dumps[i] = (dump_req_t) { .after_frame = -1, .mismatch = ~0u };
+        requests[i] = (acquisition_request_t) {
+            .fn = dump_registers, .arg = &dumps[i], .result = ESP_FAIL, .done = xSemaphoreCreateBinary(),
+        };
+        CHECK(acquisition_post(&acq, &requests[i]) == ESP_OK, "post %d refused", i);
+    }
+    CHECK(dumps[0].after_frame == -1, "request ran before any frame");
+    CHECK(acquisition_step(&acq, TEST_TIMEOUT_MS) == ESP_OK, "frame 0 failed");
+    CHECK(dumps[0].after_frame == 1 && dumps[1].after_frame == -1, "first step served requests after frames %d, %d",
+          dumps[0].after_frame, dumps[1].after_frame);
+    CHECK(xSemaphoreTake(requests[0].done, 0) == pdTRUE && requests[0].result == ESP_OK &&
+          dumps[0].mismatch == 0, "first request not completed (result %d, mismatch 0x%lx)", requests[0].result,
+          (unsigned long)dumps[0].mismatch);
+    CHECK(xSemaphoreTake(requests[1].done, 0) == pdFALSE, "second request done early");
+    CHECK(acquisition_step(&acq, TEST_TIMEOUT_MS) == ESP_OK, "frame 1 failed");
+    CHECK(dumps[1].after_frame == 2 && xSemaphoreTake(requests[1].done, 0) == pdTRUE, "second request served after %d",
+          dumps[1].after_frame);
+
+    /* The stepping task itself calls inline: waiting on its own mailbox would never return */
+    dumps[2].after_frame = -1;
+    CHECK(acquisition_call(&acq, dump_registers, &dumps[2]) == ESP_OK && dumps[2].after_frame == 2,
+          "owner call ran after frame %d", dumps[2].after_frame);
+
+    /* The stepping task stalled elsewhere: the caller gives up, and its request is dropped unrun */
+    acq.owner = NULL;
+    dumps[3].after_frame = -1;
+    int64_t start_us = esp_timer_get_time();
+    CHECK(acquisition_call(&acq, dump_registers, &dumps[3]) == ESP_ERR_TIMEOUT, "call to a stalled task returned");
+    int64_t waited_ms = (esp_timer_get_time() - start_us) / 1000;
+    CHECK(waited_ms >= ACQUISITION_CALL_TIMEOUT_MS && waited_ms < 2 * ACQUISITION_CALL_TIMEOUT_MS,
+          "gave up after %lld ms", (long long)waited_ms);
+    acq.owner = xTaskGetCurrentTaskHandle();
+    CHECK(acquisition_step(&acq, TEST_TIMEOUT_MS) == ESP_OK && dumps[3].after_frame == -1,
+          "cancelled request ran after frame %d", dumps[3].after_frame);
+
+    /* The scan between register dumps still reads every channel correctly */
+    for (int i = 0; i < 20; i++) {
+        CHECK(acquisition_step(&acq, TEST_TIMEOUT_MS) == ESP_OK, "frame %d failed", i + 2);
+    }
+    for (int ch = 0; ch < s_lc.num_channels; ch++) {
+        int32_t ideal = host_ads1261_ideal_code((uint8_t)((2 * ch) << 4 | (2 * ch + 1)));
+        CHECK(s_lc.measurements[ch].raw_adc == ideal, "ch%d read %ld after the dumps, expected %ld", ch,
+              (long)s_lc.measurements[ch].raw_adc, (long)ideal);
+    }
+
+    /* A full mailbox refuses; whatever is queued runs when the schedule ends */
+    for (int i = 0; i <= ACQUISITION_MAILBOX_DEPTH; i++) {
+        dumps[i].after_frame = -1;
+        if (i < 2) {
+            xSemaphoreTake(requests[i].done, 0);
+        } else {
+            requests[i] = (acquisition_request_t) { .fn = dump_registers, .arg = &dumps[i] };
+        }
+        esp_err_t ret = acquisition_post(&acq, &requests[i]);
+        CHECK(ret == (i < ACQUISITION_MAILBOX_DEPTH ? ESP_OK : ESP_ERR_NO_MEM), "post %d returned %d", i, ret);
+    }
+    acquisition_end(&acq);
+    for (int i = 0; i < ACQUISITION_MAILBOX_DEPTH; i++) {
+        CHECK(dumps[i].after_frame == s_log.count, "request %d left in the mailbox", i);
+    }
+    CHECK(dumps[ACQUISITION_MAILBOX_DEPTH].after_frame == -1, "refused request ran");
+    CHECK(xSemaphoreTake(requests[0].done, 0) == pdTRUE, "drained request not completed");
+
+    acquisition_get_stats(&acq, &stats);
+    CHECK(stats.requests == 2 + ACQUISITION_MAILBOX_DEPTH, "%lu requests served", (unsigned long)stats.requests);
+    CHECK(stats.read_errors == 0, "%lu read errors", (unsigned long)stats.read_errors);
+    for (int i = 0; i < 2; i++) {
+        vSemaphoreDelete(requests[i].done);
+    }
+    teardown(&acq);
+}
+
+int main(void)
+{
+    test_deadline_grid();
+    test_rate_limit();
+    test_overrun();
+    test_free_run();
+    test_mailbox();
+
+    return test_summary("test_acquisition");
+}
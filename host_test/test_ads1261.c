@@ -0,0 +1,467 @@
+/**
+ * @file test_ads1261.c
+ * @brief Driver and sequencing regression tests against the simulated ADS1261
+ *
+ * Each test resets the host stand-in, brings the driver up on the behavioral
+ * model and checks what a scan would deliver on the board: conversion timing
+ * per filter/data rate, DRDY interrupt and polling paths, stale reads after a
+ * mux change, mux settling against the MODE1 start delay, per-channel bridge
+ * values through the sequencer (on one ADC or several sharing the bus) and
+ * the noise seen by repeated reads.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ads1261.h"
+#include "ads1261_seq.h"
+#include "ads1261_timing.h"
+#include "loadcell.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define TEST_CS_PIN         5
+#define TEST_DRDY_PIN       10
+#define TEST_TIMEOUT_MS     1000
+#define TEST_CHANNELS       4
+
+/* Fresh simulator and driver; drdy_pin < 0 leaves DRDY unconnected (STATUS polling) */
+static esp_err_t setup(ads1261_t *dev, int drdy_pin)
+{
+    host_spi_reset();
+    host_ads1261_set_drdy_gpio(drdy_pin);
+    *dev = (ads1261_t) {0};
+    return ads1261_init(dev, SPI2_HOST, TEST_CS_PIN, drdy_pin);
+}
+
+/* Select an input pair and read its first settled conversion */
+static esp_err_t read_input(ads1261_t *dev, uint8_t inpmux, int32_t *value)
+{
+    esp_err_t ret = ads1261_write_register(dev, ADS1261_REG_INPMUX, inpmux);
+    ads1261_drdy_arm(dev);
+    if (ret == ESP_OK) {
+        ret = ads1261_wait_drdy(dev, TEST_TIMEOUT_MS);
+    }
+    if (ret == ESP_OK) {
+        ret = ads1261_read_adc(dev, value);
+    }
+    return ret;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_init_register_map(void)
+{
+    ads1261_t dev;
+    CHECK(setup(&dev, -1) == ESP_OK, "ads1261_init failed");
+
+    ads1261_mode0_reg_t mode0 = { .reg = host_ads1261_get_register(ADS1261_REG_MODE0) };
+    CHECK(mode0.bits.dr == ADS1261_DR_40000_SPS && mode0.bits.filter == ADS1261_REG_MODE0_FILTER_SINC5,
+          "MODE0 = 0x%02X", mode0.reg);
+    CHECK(host_ads1261_get_register(ADS1261_REG_PGA) == ADS1261_PGA_GAIN_128,
+          "PGA = 0x%02X", host_ads1261_get_register(ADS1261_REG_PGA));
+
+    uint8_t id = 0;
+    uint32_t mismatch = ~0u;
+    CHECK(ads1261_get_register(&dev, ADS1261_REG_ID, &id) == ESP_OK && id == 0x08, "ID = 0x%02X", id);
+    CHECK(ads1261_snapshot(&dev, NULL, &mismatch) == ESP_OK && mismatch == 0,
+          "shadow mismatch 0x%05lX", (unsigned long)mismatch);
+    ads1261_deinit(&dev);
+}
+
+/* First conversion after a restart arrives after the modelled latency, then once per period */
+static void test_conversion_timing(void)
+{
+    static const struct {
+        uint8_t filter, dr, delay;
+    } configs[] = {
+        { ADS1261_REG_MODE0_FILTER_SINC5, ADS1261_DR_40000_SPS, 0 },
+        { ADS1261_REG_MODE0_FILTER_SINC3, ADS1261_DR_1200_SPS, 0 },
+        { ADS1261_REG_MODE0_FILTER_SINC1, ADS1261_DR_400_SPS, 5 },
+        { ADS1261_REG_MODE0_FILTER_FIR, ADS1261_DR_20_SPS, 0 },
+    };
+    ads1261_t dev;
+    CHECK(setup(&dev, TEST_DRDY_PIN) == ESP_OK && dev.drdy_irq, "DRDY interrupt not installed");
+
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+        ads1261_mode0_reg_t mode0 = { .bits = { .filter = configs[i].filter, .dr = configs[i].dr } };
+        ads1261_write_register(&dev, ADS1261_REG_MODE1, configs[i].delay);
+        ads1261_write_register(&dev, ADS1261_REG_MODE0, mode0.reg);
+        ads1261_start_conversion(&dev);  /* Restart even when the shadow dropped both writes */
+        ads1261_drdy_arm(&dev);
+        int64_t start = esp_timer_get_time();
+        CHECK(ads1261_wait_drdy(&dev, TEST_TIMEOUT_MS) == ESP_OK, "config %zu: no DRDY", i);
+        int64_t first = esp_timer_get_time() - start;
+
+        ads1261_drdy_arm(&dev);
+        start = esp_timer_get_time();
+        CHECK(ads1261_wait_drdy(&dev, TEST_TIMEOUT_MS) == ESP_OK, "config %zu: no second DRDY", i);
+        int64_t second = esp_timer_get_time() - start;
+
+        int64_t settle = ads1261_settle_time_us(configs[i].filter, configs[i].dr, configs[i].delay);
+        int64_t period = (int64_t)(1e6f / ads1261_datarate_sps(configs[i].dr));
+        CHECK(first >= settle - 2 && first <= settle + 8,
+              "config %zu: first DRDY after %lld us, model %lld us", i, (long long)first, (long long)settle);
+        CHECK(second >= period - 2 && second <= period + 2,
+              "config %zu: next DRDY after %lld us, period %lld us", i, (long long)second, (long long)period);
+    }
+    CHECK(dev.drdy_timeouts == 0, "%lu DRDY timeouts", (unsigned long)dev.drdy_timeouts);
+    ads1261_deinit(&dev);
+}
+
+/* Conversions only run while START is high or after a START command */
+static void test_start_pin(void)
+{
+    ads1261_t dev;
+    host_spi_reset();
+    host_ads1261_set_start_pin(false);
+    dev = (ads1261_t) {0};
+    CHECK(ads1261_init(&dev, SPI2_HOST, TEST_CS_PIN, -1) == ESP_OK, "ads1261_init failed");
+
+    CHECK(ads1261_wait_drdy(&dev, 5) == ESP_ERR_TIMEOUT && dev.drdy_timeouts == 1,
+          "conversion ran with START low");
+    CHECK(ads1261_start_conversion(&dev) == ESP_OK, "START failed");
+    CHECK(ads1261_wait_drdy(&dev, 5) == ESP_OK, "no conversion after START");
+    ads1261_deinit(&dev);
+}
+
+/* Reading right after a mux write returns the previous input's conversion */
+static void test_stale_read_after_mux_change(void)
+{
+    ads1261_t dev;
+    int32_t value = 0;
+    CHECK(setup(&dev, -1) == ESP_OK, "ads1261_init failed");
+    host_ads1261_set_input(0x01, 0.005);
+    host_ads1261_set_input(0x23, -0.005);
+
+    CHECK(read_input(&dev, 0x01, &value) == ESP_OK && value == host_ads1261_ideal_code(0x01),
+          "AIN pair 0x01 read %ld, expected %ld", (long)value, (long)host_ads1261_ideal_code(0x01));
+
+    ads1261_write_register(&dev, ADS1261_REG_INPMUX, 0x23);
+    CHECK(ads1261_read_adc(&dev, &value) == ESP_OK && value == host_ads1261_ideal_code(0x01),
+          "unframed read after mux change gave %ld, expected the previous input", (long)value);
+
+    /* With the STATUS byte the driver sees DRDY clear and rejects the stale data */
+    ads1261_set_integrity(&dev, true, false);
+    uint32_t stale = dev.integrity.stale_reads;
+    ads1261_write_register(&dev, ADS1261_REG_INPMUX, 0x01);
+    CHECK(ads1261_read_adc(&dev, &value) == ESP_ERR_NOT_FINISHED && dev.integrity.stale_reads == stale + 1,
+          "stale read not reported");
+    ads1261_deinit(&dev);
+}
+
+/* An RC-filtered input leaves mux-settling error that the MODE1 start delay removes */
+static void test_mux_settling_delay(void)
+{
+    ads1261_t dev;
+    int32_t value = 0;
+    CHECK(setup(&dev, TEST_DRDY_PIN) == ESP_OK, "ads1261_init failed");
+    host_ads1261_set_input(0x01, 0.010);
+    host_ads1261_set_input(0x23, -0.010);
+    host_ads1261_set_input_tau(100000);
+
+    int32_t step = host_ads1261_ideal_code(0x01) - host_ads1261_ideal_code(0x23);
+    for (int pass = 0; pass < 2; pass++) {
+        uint8_t delay = pass ? 9 : 0;   /* 0 us, then 1160 us */
+        ads1261_write_register(&dev, ADS1261_REG_MODE1, delay);
+        read_input(&dev, 0x01, &value);
+        vTaskDelay(5);                  /* Fully settled on 0x01 */
+        CHECK(read_input(&dev, 0x23, &value) == ESP_OK, "read failed");
+
+        int32_t error = value - host_ads1261_ideal_code(0x23);
+        if (delay == 0) {
+            CHECK(error > step / 20, "no settling error without delay (%ld of %ld)", (long)error, (long)step);
+        } else {
+            CHECK(labs(error) < 16, "settling error %ld codes with %lu us delay",
+                  (long)error, (unsigned long)ads1261_start_delay_us(delay));
+        }
+    }
+    ads1261_deinit(&dev);
+}
+
+/* Each sequencer step reads its own bridge, in both DRDY modes and in pulse mode */
+static void test_scan_bridges(void)
+{
+    static const double mv_per_v[TEST_CHANNELS] = { 0.5, -0.25, 1.0, 0.1 };
+    static const uint8_t inpmux[TEST_CHANNELS] = { 0x01, 0x23, 0x45, 0x67 };
+
+    for (int irq = 0; irq < 2; irq++) {
+        loadcell_t lc;
+        host_spi_reset();
+        host_ads1261_set_drdy_gpio(irq ? TEST_DRDY_PIN : -1);
+        CHECK(loadcell_init(&lc, SPI2_HOST, TEST_CS_PIN, irq ? TEST_DRDY_PIN : -1,
+                            ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK, "loadcell_init failed");
+        for (int ch = 0; ch < TEST_CHANNELS; ch++) {
+            host_ads1261_set_bridge(inpmux[ch], mv_per_v[ch]);
+        }
+
+        for (int frame = 0; frame < 3; frame++) {
+            CHECK(loadcell_read(&lc) == ESP_OK, "frame %d failed (irq=%d)", frame, irq);
+            for (int ch = 0; ch < TEST_CHANNELS; ch++) {
+                CHECK(lc.measurements[ch].raw_adc == host_ads1261_ideal_code(inpmux[ch]),
+                      "irq=%d frame %d ch%d read %ld, expected %ld", irq, frame, ch,
+                      (long)lc.measurements[ch].raw_adc, (long)host_ads1261_ideal_code(inpmux[ch]));
+            }
+        }
+
+        /* The per-channel path must not pick up a conversion of the previous input */
+        for (int ch = TEST_CHANNELS - 1; ch >= 0; ch--) {
+            loadcell_measurement_t m;
+            CHECK(loadcell_read_channel(&lc, ch, &m) == ESP_OK && m.raw_adc == host_ads1261_ideal_code(inpmux[ch]),
+                  "irq=%d read_channel %d gave %ld, expected %ld", irq, ch,
+                  (long)m.raw_adc, (long)host_ads1261_ideal_code(inpmux[ch]));
+        }
+        loadcell_deinit(&lc);
+    }
+}
+
+/* Three ADCs on one bus: every channel reads its own bridge, at about the per-channel rate of one ADC */
+static void test_multi_adc_scan(void)
+{
+    static const loadcell_adc_pins_t pins[3] = { { 5, 10 }, { 6, 11 }, { 7, 12 } };
+    static const loadcell_adc_pins_t no_cs[2] = { { -1, 10 }, { 6, 11 } };
+    static const uint8_t inpmux[TEST_CHANNELS] = { 0x01, 0x23, 0x45, 0x67 };
+    static loadcell_t lc;
+    const int frames = 20;
+
+    host_spi_reset();
+    CHECK(loadcell_init_multi(&lc, SPI2_HOST, no_cs, 2, ADS1261_PGA_GAIN_128,
+                              ADS1261_DR_40000_SPS) == ESP_ERR_INVALID_ARG, "shared bus accepted a device without CS");
+
+    for (int irq = 0; irq < 2; irq++) {
+        double frame_us[2];
+        for (int run = 0; run < 2; run++) {
+            uint8_t num_adcs = run ? 3 : 1;
+            host_spi_reset();
+            for (uint8_t a = 0; a < num_adcs; a++) {
+                host_ads1261_select(a);
+                host_ads1261_set_drdy_gpio(irq ? pins[a].drdy_pin : -1);
+                for (int ch = 0; ch < TEST_CHANNELS; ch++) {
+                    host_ads1261_set_bridge(inpmux[ch], 0.1 * (a * TEST_CHANNELS + ch + 1) * (ch & 1 ? -1 : 1));
+                }
+            }
+            loadcell_adc_pins_t wiring[3];
+            for (uint8_t a = 0; a < num_adcs; a++) {
+                wiring[a] = (loadcell_adc_pins_t) { pins[a].cs_pin, irq ? pins[a].drdy_pin : -1 };
+            }
+            CHECK(loadcell_init_multi(&lc, SPI2_HOST, wiring, num_adcs, ADS1261_PGA_GAIN_128,
+                                      ADS1261_DR_40000_SPS) == ESP_OK, "loadcell_init_multi(%u) failed", num_adcs);
+            CHECK(lc.num_channels == num_adcs * TEST_CHANNELS, "%u ADCs gave %u channels", num_adcs, lc.num_channels);
+
+            CHECK(loadcell_read(&lc) == ESP_OK, "first frame failed (irq=%d, %u ADCs)", irq, num_adcs);
+            int64_t start = host_spi_now_ns();
+            for (int frame = 0; frame < frames; frame++) {
+                CHECK(loadcell_read(&lc) == ESP_OK, "frame %d failed (irq=%d, %u ADCs)", frame, irq, num_adcs);
+            }
+            frame_us[run] = (double)(host_spi_now_ns() - start) / 1000.0 / frames;
+
+            for (int ch = 0; ch < lc.num_channels; ch++) {
+                host_ads1261_select(ch / TEST_CHANNELS);
+                int32_t ideal = host_ads1261_ideal_code(inpmux[ch % TEST_CHANNELS]);
+                CHECK(lc.measurements[ch].raw_adc == ideal, "irq=%d ch%d read %ld, expected %ld", irq, ch,
+                      (long)lc.measurements[ch].raw_adc, (long)ideal);
+            }
+
+            /* Single-channel reads address the right device */
+            loadcell_measurement_t m;
+            uint8_t last = lc.num_channels - 1;
+            host_ads1261_select(last / TEST_CHANNELS);
+            CHECK(loadcell_read_channel(&lc, last, &m) == ESP_OK &&
+                  m.raw_adc == host_ads1261_ideal_code(inpmux[last % TEST_CHANNELS]),
+                  "irq=%d read_channel %u gave %ld", irq, last, (long)m.raw_adc);
+            loadcell_deinit(&lc);
+        }
+
+        /* Three times the channels in about the same frame time */
+        CHECK(frame_us[1] < 1.15 * frame_us[0], "irq=%d: 12 channels took %.1f us/frame, 4 took %.1f us/frame",
+              irq, frame_us[1], frame_us[0]);
+    }
+}
+
+static void seq_store(const ads1261_sample_t *sample, void *ctx)
+{
+    ((int32_t *)ctx)[sample->step] = sample->raw;
+}
+
+/* Pulse-mode steps convert once per START and leave the ADC idle after the pass */
+static void test_pulse_mode(void)
+{
+    ads1261_t dev;
+    ads1261_seq_t seq;
+    int32_t raw[2] = {0};
+    CHECK(setup(&dev, TEST_DRDY_PIN) == ESP_OK, "ads1261_init failed");
+    host_ads1261_set_input(0x01, 0.002);
+    host_ads1261_set_input(0x23, -0.003);
+
+    const ads1261_seq_step_t steps[] = {
+        { .inpmux = 0x01, .pga = ADS1261_PGA_GAIN_128, .mode = ADS1261_CONV_PULSE },
+        { .inpmux = 0x23, .pga = ADS1261_PGA_GAIN_128, .mode = ADS1261_CONV_PULSE, .settle_us = 50 },
+    };
+    CHECK(ads1261_seq_init(&seq, &dev, steps, 2, TEST_TIMEOUT_MS) == ESP_OK, "seq_init failed");
+    CHECK(ads1261_seq_run(&seq, seq_store, raw) == ESP_OK, "pulse pass failed");
+    CHECK(raw[0] == host_ads1261_ideal_code(0x01) && raw[1] == host_ads1261_ideal_code(0x23),
+          "pulse pass read %ld/%ld", (long)raw[0], (long)raw[1]);
+
+    uint32_t conversions = host_ads1261_conversions();
+    vTaskDelay(10);
+    CHECK(host_ads1261_conversions() == conversions, "ADC kept converting in pulse mode");
+    ads1261_deinit(&dev);
+}
+
+typedef struct {
+    ads1261_sample_t samples[16];
+    int count;
+} seq_log_t;
+
+static void seq_log(const ads1261_sample_t *sample, void *ctx)
+{
+    seq_log_t *log = (seq_log_t *)ctx;
+    if (log->count < 16) {
+        log->samples[log->count] = *sample;
+    }
+    log->count++;
+}
+
+/* Burst steps emit every conversion of their input, one data period apart */
+static void test_burst_steps(void)
+{
+    ads1261_t dev;
+    ads1261_seq_t seq;
+    seq_log_t log = {0};
+    CHECK(setup(&dev, TEST_DRDY_PIN) == ESP_OK, "ads1261_init failed");
+    host_ads1261_set_input(0x01, 0.002);
+    host_ads1261_set_input(0x23, -0.003);
+
+    const ads1261_seq_step_t steps[] = {
+        { .inpmux = 0x01, .pga = ADS1261_PGA_GAIN_128, .mode = ADS1261_CONV_CONTINUOUS, .conversions = 4 },
+        { .inpmux = 0x23, .pga = ADS1261_PGA_GAIN_128, .mode = ADS1261_CONV_CONTINUOUS, .conversions = 4 },
+    };
+    CHECK(ads1261_seq_init(&seq, &dev, steps, 2, TEST_TIMEOUT_MS) == ESP_OK, "seq_init failed");
+    CHECK(ads1261_seq_run(&seq, seq_log, &log) == ESP_OK, "burst pass failed");
+    CHECK(log.count == 8, "%d samples for two 4-conversion steps", log.count);
+
+    uint32_t settle_ns, period_ns;
+    host_ads1261_get_timing(&settle_ns, &period_ns);
+    for (int i = 0; i < 8 && i < log.count; i++) {
+        const ads1261_sample_t *s = &log.samples[i];
+        uint8_t inpmux = steps[i / 4].inpmux;
+        CHECK(s->step == i / 4 && s->burst_index == i % 4 && s->burst_end == (i % 4 == 3),
+              "sample %d tagged step %u index %u end %d", i, s->step, s->burst_index, s->burst_end);
+        CHECK(s->raw == host_ads1261_ideal_code(inpmux), "sample %d read %ld", i, (long)s->raw);
+        if (i % 4) {
+            int64_t gap_ns = (s->timestamp_us - log.samples[i - 1].timestamp_us) * 1000;
+            CHECK(llabs(gap_ns - (int64_t)period_ns) <= 2000, "sample %d came %lld ns after the last", i,
+                  (long long)gap_ns);
+        }
+    }
+
+    /* Pulse mode converts once per START: no bursts */
+    const ads1261_seq_step_t pulse = { .inpmux = 0x01, .mode = ADS1261_CONV_PULSE, .conversions = 2 };
+    CHECK(ads1261_seq_init(&seq, &dev, &pulse, 1, TEST_TIMEOUT_MS) == ESP_ERR_INVALID_ARG,
+          "pulse-mode burst accepted");
+    CHECK(ads1261_seq_set_conversions(&seq, 0) == ESP_ERR_INVALID_ARG, "zero conversions accepted");
+    ads1261_deinit(&dev);
+}
+
+/* Repeated reads of a noisy bridge average to its value with the injected spread */
+static void test_noise_statistics(void)
+{
+    const int n = 4000;
+    const double noise_v = 1e-6;
+    ads1261_t dev;
+    int32_t value = 0;
+    CHECK(setup(&dev, TEST_DRDY_PIN) == ESP_OK, "ads1261_init failed");
+    host_ads1261_set_bridge(0x01, 0.5);
+    host_ads1261_set_noise(noise_v, 42);
+    read_input(&dev, 0x01, &value);
+
+    double sum = 0.0, sum_sq = 0.0;
+    int32_t ideal = host_ads1261_ideal_code(0x01);
+    for (int i = 0; i < n; i++) {
+        ads1261_drdy_arm(&dev);
+        if (ads1261_wait_drdy(&dev, TEST_TIMEOUT_MS) != ESP_OK || ads1261_read_adc(&dev, &value) != ESP_OK) {
+            CHECK(false, "read %d failed", i);
+            break;
+        }
+        double d = value - ideal;
+        sum += d;
+        sum_sq += d * d;
+    }
+    double mean = sum / n;
+    double sd = sqrt(sum_sq / n - mean * mean);
+    double expected_sd = noise_v * 128 / 5.0 * 8388608.0;
+    CHECK(fabs(sd - expected_sd) < 0.05 * expected_sd, "noise %.1f codes RMS, expected %.1f", sd, expected_sd);
+    CHECK(fabs(mean) < 4 * expected_sd / sqrt(n), "mean offset %.1f codes", mean);
+    ads1261_deinit(&dev);
+}
+
+/* SYOCAL/GANCAL take the applied bridge as zero and full scale */
+static void test_system_calibration(void)
+{
+    ads1261_t dev;
+    int32_t value = 0;
+    CHECK(setup(&dev, -1) == ESP_OK, "ads1261_init failed");
+
+    host_ads1261_set_bridge(0x01, 0.3);
+    read_input(&dev, 0x01, &value);
+    CHECK(ads1261_calibrate(&dev, ADS1261_CMD_SYOCAL, TEST_TIMEOUT_MS) == ESP_OK, "SYOCAL failed");
+    CHECK(ads1261_wait_drdy(&dev, TEST_TIMEOUT_MS) == ESP_OK && ads1261_read_adc(&dev, &value) == ESP_OK &&
+          value == 0, "zeroed bridge read %ld", (long)value);
+
+    host_ads1261_set_bridge(0x01, 6.0);
+    CHECK(ads1261_calibrate(&dev, ADS1261_CMD_GANCAL, TEST_TIMEOUT_MS) == ESP_OK, "GANCAL failed");
+    ads1261_drdy_arm(&dev);
+    CHECK(ads1261_wait_drdy(&dev, TEST_TIMEOUT_MS) == ESP_OK && ads1261_read_adc(&dev, &value) == ESP_OK &&
+          value >= 0x7FFFF0, "full-scale bridge read 0x%06lX", (unsigned long)value);
+    ads1261_deinit(&dev);
+}
+
+/* Spot values of the latency table and the planner's limits */
+static void test_timing_model(void)
+{
+    ads1261_timing_plan_t plan;
+
+    CHECK(ads1261_settle_time_us(ADS1261_REG_MODE0_FILTER_SINC5, ADS1261_DR_40000_SPS, 0) == 200, "40k sinc5");
+    CHECK(ads1261_settle_time_us(ADS1261_REG_MODE0_FILTER_FIR, ADS1261_DR_20_SPS, 0) == 52200, "20 SPS FIR");
+    CHECK(ads1261_settle_time_us(ADS1261_REG_MODE0_FILTER_SINC1, ADS1261_DR_400_SPS, 5) == 3019, "400 SPS sinc1");
+    CHECK(ads1261_settle_time_us(ADS1261_REG_MODE0_FILTER_FIR, ADS1261_DR_40000_SPS, 0) == 0,
+          "FIR accepted at 40 kSPS");
+
+    CHECK(ads1261_plan_scan(4, 100.0f, 15, 0, &plan) == ESP_OK && plan.meets_target &&
+          plan.channel_rate_hz >= 100.0f, "100 Hz plan");
+    CHECK(ads1261_plan_scan(4, 5000.0f, 15, 0, &plan) == ESP_ERR_NOT_SUPPORTED && !plan.meets_target &&
+          plan.datarate == ADS1261_DR_40000_SPS, "unreachable plan");
+
+    /* Each extra conversion of a burst adds one 25 us data period to the step */
+    CHECK(ads1261_timing_evaluate(ADS1261_REG_MODE0_FILTER_SINC5, ADS1261_DR_40000_SPS, 0, 4, 15, &plan) == ESP_OK,
+          "40k sinc5 plan");
+    uint32_t step_us = plan.step_us;
+    CHECK(ads1261_timing_oversample(4, 16, &plan) == ESP_OK && plan.conversions == 16 &&
+          plan.step_us == step_us + 15 * 25, "16-conversion step %lu us", (unsigned long)plan.step_us);
+    CHECK(ads1261_timing_oversample(4, 1, &plan) == ESP_OK && plan.step_us == step_us, "burst not undone");
+}
+
+int main(void)
+{
+    test_init_register_map();
+    test_conversion_timing();
+    test_start_pin();
+    test_stale_read_after_mux_change();
+    test_mux_settling_delay();
+    test_scan_bridges();
+    test_multi_adc_scan();
+    test_pulse_mode();
+    test_burst_steps();
+    test_noise_statistics();
+    test_system_calibration();
+    test_timing_model();
+
+    return test_summary("test_ads1261");
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_ads1261_cpp.cpp
+ * @brief Header-only C++ driver (ads1261.hpp) against the simulated ADS1261
+ *
+ * Runs Device<IdfSpiTransport> over the host SPI stand-in: compile-time
+ * field definitions, the shared CRC and decoding, framing changes, bridge reads through DRDY and
+ * STATUS polling, the bus cost of a read and CRC/stale detection.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "ads1261.hpp"
+#include "ads1261_transport.hpp"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define TEST_CS_PIN         5
+#define TEST_DRDY_PIN       10
+#define TEST_TIMEOUT_US     100000
+
+using Device = ads1261::Device<ads1261::IdfSpiTransport>;
+using ads1261::Result;
+namespace field = ads1261::field;
+namespace reg = ads1261::reg;
+
+/* Field layout is resolved at compile time and agrees with the framing the C driver shares */
+static_assert(field::MODE0_DR::set(0x24, 0x10) == 0x84, "MODE0.DR");
+static_assert(field::MODE0_FILTER::get(0x24) == 0x04, "MODE0.FILTER");
+static_assert(field::MODE3_CRCENB::mask == ADS1261_MODE3_CRCENB && field::MODE3_STATENB::mask == ADS1261_MODE3_STATENB,
+              "MODE3 framing bits");
+static_assert(field::INPMUX_MUXP::set(0, 0x3) == 0x30, "INPMUX.MUXP");
+static_assert(field::STATUS_DRDY::mask == ADS1261_STATUS_DRDY, "STATUS.DRDY");
+
+/* Fresh simulator, device attached and reset, 40 kSPS sinc5 at gain 128 */
+static bool setup(ads1261::IdfSpiTransport &bus, Device &dev, int drdy_pin)
+{
+    host_spi_reset();
+    host_ads1261_set_drdy_gpio(drdy_pin);
+    if (bus.attach(SPI2_HOST, TEST_CS_PIN, drdy_pin) != ESP_OK) {
+        return false;
+    }
+    return dev.reset() == Result::ok &&
+           dev.write_register(reg::MODE0, field::MODE0_FILTER::set(field::MODE0_DR::set(0, 0x10), 0x05)) == Result::ok &&
+           dev.write_field<field::PGA_GAIN>(7) == Result::ok;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+/* CRC and conversion decoding of ads1261_frame.h, which both drivers use */
+static void test_shared_framing(void)
+{
+    static const uint8_t crc_check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    static const uint8_t code[] = { 0xFF, 0xFF, 0xFE };
+
+    CHECK(ads1261_crc8(crc_check, sizeof(crc_check)) == 0xFB, "CRC-8/0x07 seed 0xFF check value 0x%02X",
+          ads1261_crc8(crc_check, sizeof(crc_check)));
+    CHECK(ads1261_decode_code(code) == -2, "24-bit sign extension gave %ld", (long)ads1261_decode_code(code));
+}
+
+static void test_register_access(void)
+{
+    ads1261::IdfSpiTransport bus;
+    Device dev(bus);
+    uint8_t value = 0;
+
+    CHECK(setup(bus, dev, -1), "setup failed");
+    CHECK(host_ads1261_get_register(reg::MODE0) == 0x85, "MODE0 = 0x%02X", host_ads1261_get_register(reg::MODE0));
+    CHECK(host_ads1261_get_register(reg::PGA) == 0x07, "PGA = 0x%02X", host_ads1261_get_register(reg::PGA));
+    CHECK(dev.read_register(reg::REF, value) == Result::ok && value == 0x05, "REF = 0x%02X", value);
+
+    /* Writing what the shadow already holds costs no transaction */
+    host_spi_reset_stats();
+    CHECK(dev.write_register(reg::MODE0, 0x85) == Result::ok, "rewrite MODE0");
+    CHECK(dev.write_field<field::PGA_GAIN>(7) == Result::ok, "rewrite PGA gain");
+    CHECK(host_spi_get_stats().transactions == 0, "%u transactions for unchanged writes",
+          (unsigned)host_spi_get_stats().transactions);
+
+    /* With CRC framing, commands carry their CRC and responses are checked */
+    CHECK(dev.set_framing(true, true) == Result::ok, "set_framing");
+    CHECK(host_ads1261_get_register(reg::MODE3) == 0x60, "MODE3 = 0x%02X", host_ads1261_get_register(reg::MODE3));
+    CHECK(dev.read_register(reg::MODE0, value) == Result::ok && value == 0x85, "MODE0 readback 0x%02X", value);
+    CHECK(dev.read_register(reg::STATUS, value) == Result::ok && !field::STATUS_CRCERR::get(value),
+          "STATUS = 0x%02X", value);
+    CHECK(dev.integrity().crc_errors == 0, "%u CRC errors", (unsigned)dev.integrity().crc_errors);
+
+    bus.detach();
+}
+
+static void test_bridge_reads(void)
+{
+    static const uint8_t muxp[4] = { 0x0, 0x2, 0x4, 0x6 };
+    static const double mv_per_v[4] = { 0.5, -0.25, 1.0, 0.1 };
+
+    for (int drdy = 0; drdy < 2; drdy++) {
+        for (int framed = 0; framed < 2; framed++) {
+            ads1261::IdfSpiTransport bus;
+            Device dev(bus);
+            CHECK(setup(bus, dev, drdy ? TEST_DRDY_PIN : -1), "setup failed");
+            CHECK(dev.set_framing(framed, framed) == Result::ok, "set_framing");
+
+            for (int ch = 0; ch < 4; ch++) {
+                uint8_t inpmux = field::INPMUX_MUXN::set(field::INPMUX_MUXP::set(0, muxp[ch]), muxp[ch] + 1);
+                host_ads1261_set_bridge(inpmux, mv_per_v[ch]);
+            }
+            for (int ch = 0; ch < 4; ch++) {
+                uint8_t inpmux = field::INPMUX_MUXN::set(field::INPMUX_MUXP::set(0, muxp[ch]), muxp[ch] + 1);
+                int32_t code = 0;
+                Result r = dev.read_input(muxp[ch], muxp[ch] + 1, code, TEST_TIMEOUT_US);
+                int32_t ideal = host_ads1261_ideal_code(inpmux);
+                CHECK(r == Result::ok && code == ideal, "drdy %d framed %d ch %d: result %d code %ld, want %ld",
+                      drdy, framed, ch, (int)r, (long)code, (long)ideal);
+            }
+
+            /* Once conversions stop, reading again returns the same data flagged stale */
+            if (framed) {
+                int32_t code = 0;
+                CHECK(dev.command(ads1261::cmd::STOP) == Result::ok, "STOP");
+                dev.read_data(code);
+                CHECK(dev.read_data(code) == Result::stale, "re-read not flagged stale");
+                CHECK(dev.integrity().stale_reads >= 1, "%u stale reads", (unsigned)dev.integrity().stale_reads);
+            }
+            bus.detach();
+        }
+    }
+}
+
+static void test_read_cost(void)
+{
+    ads1261::IdfSpiTransport bus;
+    Device dev(bus);
+    int32_t code = 0;
+
+    CHECK(setup(bus, dev, TEST_DRDY_PIN), "setup failed");
+    CHECK(dev.set_framing(true, true) == Result::ok, "set_framing");
+    CHECK(dev.wait_ready(TEST_TIMEOUT_US) == Result::ok, "no conversion");
+
+    /* RDATA with STATUS and CRC: one transaction of 3 + 1 + 3 + 1 bytes */
+    host_spi_reset_stats();
+    CHECK(dev.read_data(code) == Result::ok, "read_data");
+    host_spi_stats_t stats = host_spi_get_stats();
+    CHECK(stats.transactions == 1 && stats.bytes == 8, "%u transactions, %u bytes",
+          (unsigned)stats.transactions, (unsigned)stats.bytes);
+
+    /* A corrupted response is caught by the CRC */
+    host_ads1261_corrupt_rdata(1);
+    CHECK(dev.wait_ready(TEST_TIMEOUT_US) == Result::ok, "no conversion");
+    CHECK(dev.read_data(code) == Result::crc_error, "corrupted RDATA accepted");
+    CHECK(dev.integrity().crc_errors == 1, "%u CRC errors", (unsigned)dev.integrity().crc_errors);
+
+    bus.detach();
+}
+
+static void test_timeout(void)
+{
+    ads1261::IdfSpiTransport bus;
+    Device dev(bus);
+
+    CHECK(setup(bus, dev, TEST_DRDY_PIN), "setup failed");
+    host_ads1261_set_start_pin(false);
+    CHECK(dev.write_field<field::MODE1_CONVRT>(1) == Result::ok, "pulse mode");
+
+    /* The MODE1 write restarts one conversion; after that nothing runs until START */
+    int32_t code = 0;
+    CHECK(dev.wait_ready(TEST_TIMEOUT_US) == Result::ok && dev.read_data(code) == Result::ok, "restarted conversion");
+    int64_t start = host_spi_now_ns();
+    CHECK(dev.wait_ready(1000) == Result::timeout, "conversion without START");
+    CHECK(host_spi_now_ns() - start >= 1000000, "timed out after %lld ns", (long long)(host_spi_now_ns() - start));
+
+    CHECK(dev.command(ads1261::cmd::START) == Result::ok, "START");
+    CHECK(dev.wait_ready(TEST_TIMEOUT_US) == Result::ok && dev.read_data(code) == Result::ok, "pulse conversion");
+    bus.detach();
+}
+
+int main(void)
+{
+    test_shared_framing();
+    test_register_access();
+    test_bridge_reads();
+    test_read_cost();
+    test_timeout();
+
+    return test_summary("test_ads1261_cpp");
+}
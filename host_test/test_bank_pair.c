@@ -0,0 +1,243 @@
+/**
+ * @file test_bank_pair.c
+ * @brief Bank pair tests: publication, the held spare, one update at a time and a threaded stress run
+ *
+ * An update must not start on the spare while the task still holds it from
+ * before the last publication: it waits, then gives up with a timeout, and
+ * goes ahead once the task lets go. The stress run has one writer thread
+ * publishing against the task taking banks and a second reader copying
+ * them, and checks that neither ever sees a bank half rewritten.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "esp_timer.h"
+#include "bank_pair.h"
+#include "host_spi.h"
+#include "test_check.h"
+
+#define BANK_WORDS          32
+#define STRESS_UPDATES      20000
+#define STRESS_READ_BURST   64      /* Reads between reader yields */
+
+/* Every word derives from one value, so a mix of two updates is detectable */
+typedef struct {
+    uint32_t word[BANK_WORDS];
+} test_bank_t;
+
+static test_bank_t s_banks[2];
+static bank_pair_t s_pair;
+
+static void fill_bank(test_bank_t *bank, uint32_t n)
+{
+    for (int i = 0; i < BANK_WORDS; i++) {
+        bank->word[i] = n * BANK_WORDS + i;
+    }
+}
+
+/* The value the bank was filled with, or UINT32_MAX if it is torn */
+static uint32_t bank_value(const test_bank_t *bank)
+{
+    uint32_t n = bank->word[0] / BANK_WORDS;
+    for (int i = 0; i < BANK_WORDS; i++) {
+        if (bank->word[i] != n * BANK_WORDS + i) {
+            return UINT32_MAX;
+        }
+    }
+    return n;
+}
+
+static void reset_pair(void)
+{
+    memset(s_banks, 0, sizeof(s_banks));
+    fill_bank(&s_banks[0], 0);
+    bank_pair_init(&s_pair);
+}
+
+static esp_err_t update(uint32_t n)
+{
+    test_bank_t *spare;
+    esp_err_t ret = bank_pair_begin_update(&s_pair, s_banks, sizeof(s_banks[0]), (void **)&spare);
+    if (ret == ESP_OK) {
+        fill_bank(spare, n);
+        bank_pair_publish(&s_pair);
+    }
+    return ret;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_publish(void)
+{
+    test_bank_t copy;
+    test_bank_t *spare;
+
+    reset_pair();
+    CHECK(bank_pair_begin_update(&s_pair, s_banks, sizeof(s_banks[0]), (void **)&spare) == ESP_OK,
+          "update refused");
+    CHECK(spare == &s_banks[1] && bank_value(spare) == 0, "spare is not a copy of the published bank");
+    spare->word[0] = 7;
+    bank_pair_read(&s_pair, s_banks, sizeof(copy), &copy);
+    CHECK(bank_value(&copy) == 0, "unpublished edit visible");
+    bank_pair_publish(&s_pair);
+
+    bank_pair_read(&s_pair, s_banks, sizeof(copy), &copy);
+    CHECK(copy.word[0] == 7, "copy did not follow the publication");
+    CHECK(bank_pair_take(&s_pair) == 1, "take did not follow the publication");
+    bank_pair_release(&s_pair);
+
+    /* Cancelled: nothing published */
+    CHECK(bank_pair_begin_update(&s_pair, s_banks, sizeof(s_banks[0]), (void **)&spare) == ESP_OK &&
+          spare == &s_banks[0], "second update refused");
+    bank_pair_cancel(&s_pair);
+    CHECK(bank_pair_take(&s_pair) == 1, "cancelled update published");
+    bank_pair_release(&s_pair);
+}
+
+static void test_held_spare(void)
+{
+    host_spi_reset();
+    reset_pair();
+
+    /* The task takes bank 0; an update publishes bank 1 meanwhile */
+    uint8_t held = bank_pair_take(&s_pair);
+    CHECK(held == 0 && update(1) == ESP_OK, "first update refused");
+
+    /* The next update's spare is the held bank: wait, then give up */
+    int64_t start_us = esp_timer_get_time();
+    CHECK(update(2) == ESP_ERR_TIMEOUT, "update rewrote the held bank");
+    int64_t waited_ms = (esp_timer_get_time() - start_us) / 1000;
+    CHECK(waited_ms >= BANK_PAIR_WAIT_MS && waited_ms < 2 * BANK_PAIR_WAIT_MS, "gave up after %lld ms",
+          (long long)waited_ms);
+    CHECK(bank_value(&s_banks[held]) == 0, "held bank changed to %lu", (unsigned long)bank_value(&s_banks[held]));
+
+    /* Released: the update goes ahead */
+    bank_pair_release(&s_pair);
+    CHECK(update(2) == ESP_OK, "update refused after the release");
+    CHECK(bank_pair_take(&s_pair) == 0 && bank_value(&s_banks[0]) == 2, "released bank not reused");
+    bank_pair_release(&s_pair);
+}
+
+static void test_one_update(void)
+{
+    test_bank_t *first;
+    test_bank_t *second;
+
+    reset_pair();
+    CHECK(bank_pair_begin_update(&s_pair, s_banks, sizeof(s_banks[0]), (void **)&first) == ESP_OK,
+          "update refused");
+    CHECK(bank_pair_begin_update(&s_pair, s_banks, sizeof(s_banks[0]), (void **)&second) == ESP_ERR_INVALID_STATE,
+          "second concurrent update accepted");
+    bank_pair_cancel(&s_pair);
+    CHECK(update(1) == ESP_OK, "update refused after the cancel");
+}
+
+/* ============================================================================
+ * Threaded stress
+ * ============================================================================ */
+
+typedef struct {
+    uint32_t published;
+    uint32_t timeouts;
+} stress_writer_t;
+
+typedef struct {
+    bool take;                  /**< Take banks as the task does, rather than copy them */
+    uint32_t reads;
+    uint32_t torn;
+    uint32_t backwards;
+} stress_reader_t;
+
+static _Atomic bool s_writer_done;
+
+static void *writer_thread(void *arg)
+{
+    stress_writer_t *w = (stress_writer_t *)arg;
+
+    while (w->published < STRESS_UPDATES) {
+        esp_err_t ret = update(w->published + 1);
+        if (ret == ESP_OK) {
+            w->published++;
+        } else {
+            w->timeouts++;
+        }
+        sched_yield();
+    }
+    atomic_store(&s_writer_done, true);
+    return NULL;
+}
+
+static void *reader_thread(void *arg)
+{
+    stress_reader_t *r = (stress_reader_t *)arg;
+    test_bank_t copy;
+    uint32_t last = 0;
+
+    while (!atomic_load(&s_writer_done)) {
+        uint32_t n;
+        if (r->take) {
+            n = bank_value(&s_banks[bank_pair_take(&s_pair)]);
+            bank_pair_release(&s_pair);
+        } else {
+            bank_pair_read(&s_pair, s_banks, sizeof(copy), &copy);
+            n = bank_value(&copy);
+        }
+        if (n == UINT32_MAX) {
+            r->torn++;
+        } else if (n < last) {
+            r->backwards++;
+        } else {
+            last = n;
+        }
+        if (++r->reads % STRESS_READ_BURST == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_threaded_stress(void)
+{
+    pthread_t writer;
+    pthread_t readers[2];
+    stress_writer_t w = { 0 };
+    stress_reader_t state[2] = { { .take = true }, { .take = false } };
+
+    host_spi_reset();
+    reset_pair();
+    atomic_store(&s_writer_done, false);
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&readers[i], NULL, reader_thread, &state[i]);
+    }
+    pthread_create(&writer, NULL, writer_thread, &w);
+
+    pthread_join(writer, NULL);
+    for (int i = 0; i < 2; i++) {
+        pthread_join(readers[i], NULL);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        stress_reader_t *r = &state[i];
+        CHECK(r->torn == 0, "%s saw %lu torn banks", r->take ? "task" : "copier", (unsigned long)r->torn);
+        CHECK(r->backwards == 0, "%s went back %lu times", r->take ? "task" : "copier", (unsigned long)r->backwards);
+        printf("bank_pair: %s read %lu banks\n", r->take ? "task" : "copier", (unsigned long)r->reads);
+    }
+    CHECK(bank_value(&s_banks[atomic_load(&s_pair.seq) & 1]) == STRESS_UPDATES, "last update not published");
+    printf("bank_pair: %d updates, %lu timed out on a held spare\n", STRESS_UPDATES, (unsigned long)w.timeouts);
+}
+
+int main(void)
+{
+    test_publish();
+    test_held_spare();
+    test_one_update();
+    test_threaded_stress();
+
+    return test_summary("test_bank_pair");
+}
@@ -0,0 +1,36 @@
+/**
+ * @file test_check.h
+ * @brief Check macro and pass/fail summary of the host tests
+ *
+ * Each test is one program built from one test file: a failing CHECK prints
+ * where it failed and is counted, and main() ends with test_summary().
+ */
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+static int s_failures;
+
+#define CHECK(cond, ...) do {                                   \
+    if (!(cond)) {                                              \
+        printf("FAIL %s:%d: ", __func__, __LINE__);             \
+        printf(__VA_ARGS__);                                    \
+        printf("\n");                                           \
+        s_failures++;                                           \
+    }                                                           \
+} while (0)
+
+/* Report the checks of the test named name; its exit status */
+static inline int test_summary(const char *name)
+{
+    if (s_failures) {
+        printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    printf("%s: all checks passed\n", name);
+    return 0;
+}
+
+#endif /* TEST_CHECK_H */
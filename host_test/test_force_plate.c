@@ -0,0 +1,280 @@
+/**
+ * @file test_force_plate.c
+ * @brief Plate outputs against double-precision statics
+ *
+ * Point loads placed across an ideal four-cell plate must come back with
+ * their force and position. A plate with cross-talk, modelled as a mixing
+ * of the true cell forces, must be corrected by the inverse matrix. The COP
+ * threshold, large loads near the matrix limits, matrix updates published
+ * between frames and the frame ring capture are checked too, and the
+ * per-frame cost is printed.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include "esp_cpu.h"
+#include "force_plate.h"
+#include "frame_ring.h"
+#include "test_check.h"
+
+#define HALF_WIDTH_M        0.20f
+#define HALF_LENGTH_M       0.30f
+#define TIMING_FRAMES       1000000
+
+/* Cells front-left, front-right, rear-left, rear-right (the Arduino plate's order) */
+static const float s_x[4] = { -HALF_WIDTH_M, HALF_WIDTH_M, -HALF_WIDTH_M, HALF_WIDTH_M };
+static const float s_y[4] = { HALF_LENGTH_M, HALF_LENGTH_M, -HALF_LENGTH_M, -HALF_LENGTH_M };
+
+static force_plate_t s_plate;
+
+/* Statically determinate split of a point load over the four corners (bilinear) */
+static void point_load(double force_n, double x, double y, double cell_n[4])
+{
+    double u = (x + HALF_WIDTH_M) / (2 * HALF_WIDTH_M);
+    double v = (y + HALF_LENGTH_M) / (2 * HALF_LENGTH_M);
+    cell_n[0] = force_n * (1 - u) * v;
+    cell_n[1] = force_n * u * v;
+    cell_n[2] = force_n * (1 - u) * (1 - v);
+    cell_n[3] = force_n * u * (1 - v);
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_ideal_plate(void)
+{
+    force_plate_output_t out;
+    int32_t force_mn[4];
+    double worst_cop_um = 0.0;
+    int32_t worst_fz_mn = 0;
+
+    force_plate_init(&s_plate, 4);
+    CHECK(force_plate_set_geometry(&s_plate, s_x, s_y, 4) == ESP_OK, "geometry refused");
+
+    for (double force = 20.0; force <= 2000.0; force *= 1.7) {
+        for (double x = -0.19; x <= 0.19; x += 0.038) {
+            for (double y = -0.29; y <= 0.29; y += 0.058) {
+                double cell_n[4];
+                point_load(force, x, y, cell_n);
+                int64_t fz = 0;
+                for (int ch = 0; ch < 4; ch++) {
+                    force_mn[ch] = (int32_t)lround(cell_n[ch] * 1000);
+                    fz += force_mn[ch];
+                }
+                force_plate_compute(&s_plate, force_mn, &out);
+                if (abs(out.fz_mn - (int32_t)fz) > worst_fz_mn) {
+                    worst_fz_mn = abs(out.fz_mn - (int32_t)fz);
+                }
+                /* 1 mN of cell rounding moves the COP by up to 0.5 mm * 1 mN / Fz */
+                double tolerance_um = 1.0 + 4 * 0.3e6 * 0.001 / force;
+                double error = fmax(fabs(out.cop_x_um - x * 1e6), fabs(out.cop_y_um - y * 1e6));
+                worst_cop_um = fmax(worst_cop_um, error / tolerance_um);
+                CHECK(out.cop_valid, "COP invalid at %.0f N", force);
+            }
+        }
+    }
+    CHECK(worst_fz_mn == 0, "Fz off the cell sum by %ld mN", (long)worst_fz_mn);
+    CHECK(worst_cop_um <= 1.0, "COP off by %.2f of its tolerance", worst_cop_um);
+
+    /* Moments of a load at the front-right corner */
+    force_mn[0] = 0;
+    force_mn[1] = 1000000;
+    force_mn[2] = 0;
+    force_mn[3] = 0;
+    force_plate_compute(&s_plate, force_mn, &out);
+    CHECK(out.fz_mn == 1000000 && out.mx_mnm == 300000 && out.my_mnm == -200000,
+          "corner load: Fz %ld Mx %ld My %ld", (long)out.fz_mn, (long)out.mx_mnm, (long)out.my_mnm);
+    CHECK(out.cop_x_um == 200000 && out.cop_y_um == 300000, "corner COP %ld, %ld", (long)out.cop_x_um,
+          (long)out.cop_y_um);
+}
+
+/* Cross-talk: each cell also reads a share of its neighbours' load */
+static void test_crosstalk_correction(void)
+{
+    static const double mix[4][4] = {
+        { 1.02, 0.03, 0.01, 0.00 },
+        { 0.02, 0.97, 0.00, 0.02 },
+        { 0.01, 0.00, 1.05, 0.04 },
+        { 0.00, 0.01, 0.03, 0.99 },
+    };
+    double inv[4][8];
+    force_plate_output_t out;
+
+    /* Invert the mixing (Gauss-Jordan on [mix | I]) */
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 8; c++) {
+            inv[r][c] = c < 4 ? mix[r][c] : (c - 4 == r);
+        }
+    }
+    for (int col = 0; col < 4; col++) {
+        double p = inv[col][col];
+        for (int c = 0; c < 8; c++) {
+            inv[col][c] /= p;
+        }
+        for (int r = 0; r < 4; r++) {
+            if (r != col) {
+                double f = inv[r][col];
+                for (int c = 0; c < 8; c++) {
+                    inv[r][c] -= f * inv[col][c];
+                }
+            }
+        }
+    }
+
+    /* Calibrated rows: the ideal rows applied to the unmixed cell forces */
+    force_plate_init(&s_plate, 4);
+    for (int ch = 0; ch < 4; ch++) {
+        double fz = 0, mx = 0, my = 0;
+        for (int k = 0; k < 4; k++) {
+            fz += inv[k][4 + ch];
+            mx += s_y[k] * inv[k][4 + ch];
+            my += -s_x[k] * inv[k][4 + ch];
+        }
+        CHECK(force_plate_set_coef(&s_plate, FORCE_PLATE_FZ, ch, fz) == ESP_OK &&
+              force_plate_set_coef(&s_plate, FORCE_PLATE_MX, ch, mx) == ESP_OK &&
+              force_plate_set_coef(&s_plate, FORCE_PLATE_MY, ch, my) == ESP_OK, "coefficient refused");
+    }
+
+    double worst_fz = 0.0;
+    double worst_cop = 0.0;
+    double uncorrected = 0.0;
+    for (double x = -0.15; x <= 0.15; x += 0.05) {
+        for (double y = -0.25; y <= 0.25; y += 0.05) {
+            double cell_n[4];
+            int32_t read_mn[4];
+            double read_sum = 0.0;
+            point_load(800.0, x, y, cell_n);
+            for (int r = 0; r < 4; r++) {
+                double read = 0.0;
+                for (int k = 0; k < 4; k++) {
+                    read += mix[r][k] * cell_n[k];
+                }
+                read_mn[r] = (int32_t)lround(read * 1000);
+                read_sum += read;
+            }
+            force_plate_compute(&s_plate, read_mn, &out);
+            worst_fz = fmax(worst_fz, fabs(out.fz_mn - 800000.0));
+            worst_cop = fmax(worst_cop, fmax(fabs(out.cop_x_um - x * 1e6), fabs(out.cop_y_um - y * 1e6)));
+            uncorrected = fmax(uncorrected, fabs(read_sum * 1000 - 800000.0));
+        }
+    }
+    CHECK(worst_fz <= 3.0, "corrected Fz off by %.1f mN", worst_fz);
+    CHECK(worst_cop <= 5.0, "corrected COP off by %.1f um", worst_cop);
+    printf("force_plate: cross-talk matrix, worst Fz error %.1f mN (uncorrected %.0f mN), COP %.1f um\n",
+           worst_fz, uncorrected, worst_cop);
+}
+
+static void test_threshold_and_limits(void)
+{
+    force_plate_output_t out;
+    int32_t force_mn[4] = { 2000, 2000, 2000, 2000 };
+
+    force_plate_init(&s_plate, 4);
+    force_plate_set_geometry(&s_plate, s_x, s_y, 4);
+    force_plate_compute(&s_plate, force_mn, &out);
+    CHECK(out.fz_mn == 8000 && !out.cop_valid && out.cop_x_um == 0 && out.cop_y_um == 0,
+          "8 N below the default threshold: Fz %ld, COP valid %d", (long)out.fz_mn, out.cop_valid);
+    CHECK(force_plate_set_min_fz(&s_plate, 5.0f) == ESP_OK, "threshold refused");
+    force_plate_compute(&s_plate, force_mn, &out);
+    CHECK(out.cop_valid && out.cop_x_um == 0 && out.cop_y_um == 0, "centred 8 N: COP %ld, %ld",
+          (long)out.cop_x_um, (long)out.cop_y_um);
+
+    CHECK(force_plate_set_coef(&s_plate, FORCE_PLATE_MX, 4, 0.1f) == ESP_ERR_INVALID_ARG, "channel 4 accepted");
+    CHECK(force_plate_set_coef(&s_plate, FORCE_PLATE_OUTPUTS, 0, 0.1f) == ESP_ERR_INVALID_ARG, "bad row accepted");
+    CHECK(force_plate_set_coef(&s_plate, FORCE_PLATE_FZ, 0, 100.0f) == ESP_ERR_INVALID_ARG, "huge gain accepted");
+    CHECK(force_plate_set_coef(&s_plate, FORCE_PLATE_FZ, 0, NAN) == ESP_ERR_INVALID_ARG, "NaN accepted");
+    CHECK(fabsf(force_plate_get_coef(&s_plate, FORCE_PLATE_MY, 1) + HALF_WIDTH_M) < 1e-6f, "My coefficient %f",
+          force_plate_get_coef(&s_plate, FORCE_PLATE_MY, 1));
+
+    /* Extreme loads at the largest lever arms: moments saturate, the COP still resolves */
+    for (int ch = 0; ch < 4; ch++) {
+        CHECK(force_plate_set_coef(&s_plate, FORCE_PLATE_MX, ch, FORCE_PLATE_COEF_MAX) == ESP_OK, "max arm refused");
+        force_mn[ch] = INT32_MAX / 2;
+    }
+    force_plate_compute(&s_plate, force_mn, &out);
+    CHECK(out.fz_mn == INT32_MAX && out.mx_mnm == INT32_MAX, "saturation: Fz %ld Mx %ld", (long)out.fz_mn,
+          (long)out.mx_mnm);
+    CHECK(out.cop_y_um == 16000000 && out.cop_x_um == 0, "COP at the limit %ld, %ld", (long)out.cop_x_um,
+          (long)out.cop_y_um);
+}
+
+/* Updates land in the spare bank: frames see the old or the new matrix, whole */
+static void test_update_between_frames(void)
+{
+    force_plate_output_t out;
+    int32_t force_mn[4] = { 100000, 0, 0, 0 };
+
+    force_plate_init(&s_plate, 4);
+    force_plate_set_geometry(&s_plate, s_x, s_y, 4);
+    const force_plate_matrix_t *before = &s_plate.banks[atomic_load(&s_plate.pair.seq) & 1];
+    force_plate_set_coef(&s_plate, FORCE_PLATE_FZ, 0, 2.0f);
+    const force_plate_matrix_t *after = &s_plate.banks[atomic_load(&s_plate.pair.seq) & 1];
+    CHECK(before != after, "update written into the published matrix");
+    CHECK(before->coef[FORCE_PLATE_FZ][0] == 1 << FORCE_PLATE_Q_BITS &&
+          after->coef[FORCE_PLATE_MX][0] == before->coef[FORCE_PLATE_MX][0], "banks not copied");
+    force_plate_compute(&s_plate, force_mn, &out);
+    CHECK(out.fz_mn == 200000 && out.cop_x_um == -100000, "after update: Fz %ld, COPx %ld",
+          (long)out.fz_mn, (long)out.cop_x_um);
+}
+
+static void test_frame_capture(void)
+{
+    static frame_ring_t ring;
+    loadcell_t lc = { .num_channels = 4 };
+    loadcell_frame_t frame;
+
+    frame_ring_init(&ring);
+    force_plate_init(&s_plate, 4);
+    force_plate_set_geometry(&s_plate, s_x, s_y, 4);
+    for (int ch = 0; ch < 4; ch++) {
+        lc.channels[ch].cal_banks[0].calib_state = CALIB_STATE_CALIBRATED;     /* Published: never updated */
+        lc.measurements[ch].force_mn = ch == 3 ? 600000 : 0;
+    }
+    frame_ring_capture(&ring, &lc, &s_plate, 1000, 0);
+    CHECK(frame_ring_latest(&ring, &frame), "no frame");
+    CHECK(frame.plate.fz_mn == 600000 && frame.plate.cop_valid && frame.plate.cop_x_um == 200000 &&
+          frame.plate.cop_y_um == -300000, "frame plate: Fz %ld COP %ld, %ld", (long)frame.plate.fz_mn,
+          (long)frame.plate.cop_x_um, (long)frame.plate.cop_y_um);
+
+    frame_ring_capture(&ring, &lc, NULL, 2000, 0);
+    frame_ring_latest(&ring, &frame);
+    CHECK(frame.plate.fz_mn == 0 && !frame.plate.cop_valid, "plate outputs without a plate");
+}
+
+static void test_compute_cost(void)
+{
+    force_plate_output_t out;
+    int32_t force_mn[LOADCELL_MAX_CHANNELS];
+    volatile int32_t sink = 0;
+
+    for (int n = 4; n <= LOADCELL_MAX_CHANNELS; n += LOADCELL_MAX_CHANNELS - 4) {
+        force_plate_init(&s_plate, n);
+        force_plate_set_geometry(&s_plate, s_x, s_y, 4);
+        for (int ch = 0; ch < n; ch++) {
+            force_mn[ch] = 150000 + 1000 * ch;
+        }
+        esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+        for (int i = 0; i < TIMING_FRAMES; i++) {
+            force_mn[i % n] += 7;
+            force_plate_compute(&s_plate, force_mn, &out);
+            sink += out.cop_x_um;
+        }
+        double cycles = (double)(uint32_t)(esp_cpu_get_cycle_count() - start) / TIMING_FRAMES;
+        printf("force_plate: %.1f host cycles per %d-channel frame\n", cycles, n);
+    }
+}
+
+int main(void)
+{
+    test_ideal_plate();
+    test_crosstalk_correction();
+    test_threshold_and_limits();
+    test_update_between_frames();
+    test_frame_capture();
+    test_compute_cost();
+
+    return test_summary("test_force_plate");
+}
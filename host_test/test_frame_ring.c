@@ -0,0 +1,253 @@
+/**
+ * @file test_frame_ring.c
+ * @brief Frame ring tests: cursors, lapping, capture flags and a threaded stress run
+ *
+ * The stress run has one producer thread pushing in bursts against two
+ * reader threads, one keeping up and one yielding often enough to be lapped, and checks what the acquisition
+ * task's consumers rely on: frames never come back torn, every reader sees
+ * increasing sequence numbers, and frames read plus frames dropped account
+ * for everything pushed.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "frame_ring.h"
+#include "test_check.h"
+
+#define STRESS_FRAMES       200000
+#define STRESS_BURST        16      /* Pushes between producer yields, standing in for scan time */
+#define STRESS_READERS      2
+#define PATTERN_STEP        7919
+
+static frame_ring_t s_ring;
+
+/* Every field derives from one value, so a mix of two frames is detectable */
+static void fill_frame(loadcell_frame_t *frame, uint32_t n)
+{
+    frame->timestamp_us = (int64_t)n * 1000;
+    frame->num_channels = LOADCELL_MAX_CHANNELS;
+    frame->flags = (uint8_t)n;
+    for (int ch = 0; ch < LOADCELL_MAX_CHANNELS; ch++) {
+        frame->raw[ch] = (int32_t)(n * PATTERN_STEP + ch);
+        frame->force_mn[ch] = (int32_t)(n ^ (ch << 24));
+    }
+}
+
+static bool frame_intact(const loadcell_frame_t *frame)
+{
+    uint32_t n = frame->seq;
+    if (frame->timestamp_us != (int64_t)n * 1000 || frame->flags != (uint8_t)n) {
+        return false;
+    }
+    for (int ch = 0; ch < LOADCELL_MAX_CHANNELS; ch++) {
+        if (frame->raw[ch] != (int32_t)(n * PATTERN_STEP + ch) || frame->force_mn[ch] != (int32_t)(n ^ (ch << 24))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void push_frames(uint32_t count)
+{
+    loadcell_frame_t frame;
+    for (uint32_t i = 0; i < count; i++) {
+        fill_frame(&frame, atomic_load(&s_ring.head));
+        frame_ring_push(&s_ring, &frame);
+    }
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_independent_cursors(void)
+{
+    frame_ring_reader_t fast, slow;
+    loadcell_frame_t frame;
+
+    frame_ring_init(&s_ring);
+    CHECK(!frame_ring_latest(&s_ring, &frame), "empty ring returned a latest frame");
+    frame_ring_reader_init(&fast, &s_ring);
+    frame_ring_reader_init(&slow, &s_ring);
+    CHECK(!frame_ring_read(&fast, &frame), "empty ring returned a frame");
+
+    push_frames(10);
+    CHECK(frame_ring_pending(&fast) == 10, "%lu pending", (unsigned long)frame_ring_pending(&fast));
+    for (uint32_t i = 0; i < 10; i++) {
+        CHECK(frame_ring_read(&fast, &frame) && frame.seq == i && frame_intact(&frame), "fast reader frame %lu",
+              (unsigned long)i);
+    }
+    CHECK(!frame_ring_read(&fast, &frame), "fast reader read past the head");
+
+    /* The slow reader is untouched by the fast one */
+    CHECK(frame_ring_pending(&slow) == 10, "slow reader has %lu pending", (unsigned long)frame_ring_pending(&slow));
+    CHECK(frame_ring_read(&slow, &frame) && frame.seq == 0, "slow reader starts at frame %lu", (unsigned long)frame.seq);
+
+    CHECK(frame_ring_latest(&s_ring, &frame) && frame.seq == 9 && frame_intact(&frame), "latest is frame %lu",
+          (unsigned long)frame.seq);
+
+    /* A reader attached later only sees new frames */
+    frame_ring_reader_t late;
+    frame_ring_reader_init(&late, &s_ring);
+    push_frames(1);
+    CHECK(frame_ring_read(&late, &frame) && frame.seq == 10, "late reader got frame %lu", (unsigned long)frame.seq);
+    CHECK(fast.dropped == 0 && slow.dropped == 0 && late.dropped == 0, "frames dropped without lapping");
+}
+
+static void test_lapping(void)
+{
+    frame_ring_reader_t reader;
+    loadcell_frame_t frame;
+    const uint32_t extra = 37;
+
+    frame_ring_init(&s_ring);
+    frame_ring_reader_init(&reader, &s_ring);
+    push_frames(FRAME_RING_CAPACITY + extra);
+
+    CHECK(frame_ring_pending(&reader) == FRAME_RING_CAPACITY, "%lu pending",
+          (unsigned long)frame_ring_pending(&reader));
+    CHECK(frame_ring_read(&reader, &frame) && frame.seq == extra, "lapped reader resumed at %lu",
+          (unsigned long)frame.seq);
+    CHECK(reader.dropped == extra, "%lu dropped, expected %lu", (unsigned long)reader.dropped, (unsigned long)extra);
+
+    uint32_t read = 1;
+    while (frame_ring_read(&reader, &frame)) {
+        CHECK(frame_intact(&frame), "frame %lu torn", (unsigned long)frame.seq);
+        read++;
+    }
+    CHECK(read == FRAME_RING_CAPACITY, "read %lu after lapping", (unsigned long)read);
+    CHECK(frame.seq == FRAME_RING_CAPACITY + extra - 1, "last frame %lu", (unsigned long)frame.seq);
+}
+
+static void test_capture_flags(void)
+{
+    loadcell_t lc = { .num_channels = 4 };
+    loadcell_frame_t frame;
+
+    /* Never updated: bank 0 holds each channel's published calibration set */
+    frame_ring_init(&s_ring);
+    for (int ch = 0; ch < 4; ch++) {
+        lc.channels[ch].cal_banks[0].calib_state = CALIB_STATE_CALIBRATED;
+        lc.measurements[ch].raw_adc = 1000 * (ch + 1);
+        lc.measurements[ch].force_mn = 1500 * ch;
+    }
+
+    frame_ring_capture(&s_ring, &lc, NULL, 123456, FRAME_FLAG_LATE);
+    CHECK(frame_ring_latest(&s_ring, &frame), "no frame after capture");
+    CHECK(frame.flags == FRAME_FLAG_LATE, "flags 0x%02x for a clean late frame", frame.flags);
+    CHECK(frame.timestamp_us == 123456 && frame.num_channels == 4, "timestamp %lld, %u channels",
+          (long long)frame.timestamp_us, frame.num_channels);
+    CHECK(frame.raw[3] == 4000 && frame.force_mn[2] == 3000, "values not copied");
+
+    lc.measurements[1].raw_adc = 0x7FFFFF;
+    lc.channels[3].cal_banks[0].calib_state = CALIB_STATE_TARE_DONE;
+    frame_ring_capture(&s_ring, &lc, NULL, 124456, FRAME_FLAG_GAP);
+    frame_ring_latest(&s_ring, &frame);
+    CHECK(frame.flags == (FRAME_FLAG_GAP | FRAME_FLAG_CLIPPED | FRAME_FLAG_UNCALIBRATED), "flags 0x%02x",
+          frame.flags);
+
+    lc.measurements[1].raw_adc = -0x800000;
+    lc.channels[3].cal_banks[0].calib_state = CALIB_STATE_CALIBRATED;
+    frame_ring_capture(&s_ring, &lc, NULL, 125456, 0);
+    frame_ring_latest(&s_ring, &frame);
+    CHECK(frame.flags == FRAME_FLAG_CLIPPED && frame.seq == 2, "negative full scale: flags 0x%02x, seq %lu",
+          frame.flags, (unsigned long)frame.seq);
+}
+
+/* ============================================================================
+ * Threaded stress
+ * ============================================================================ */
+
+typedef struct {
+    frame_ring_reader_t reader;
+    int yield_every;            /**< Frames between yields: larger keeps up, smaller gets lapped */
+    uint32_t read;
+    uint32_t torn;
+    uint32_t out_of_order;
+} stress_reader_t;
+
+static _Atomic bool s_producer_done;
+
+static void *producer_thread(void *arg)
+{
+    for (uint32_t i = 0; i < STRESS_FRAMES; i++) {
+        push_frames(1);
+        if (i % STRESS_BURST == 0) {
+            sched_yield();
+        }
+    }
+    atomic_store(&s_producer_done, true);
+    return NULL;
+}
+
+static void *reader_thread(void *arg)
+{
+    stress_reader_t *r = (stress_reader_t *)arg;
+    loadcell_frame_t frame;
+    uint32_t next = 0;
+
+    for (;;) {
+        bool done = atomic_load(&s_producer_done);
+        while (frame_ring_read(&r->reader, &frame)) {
+            if (!frame_intact(&frame)) {
+                r->torn++;
+            }
+            if (frame.seq < next) {
+                r->out_of_order++;
+            }
+            next = frame.seq + 1;
+            if (++r->read % r->yield_every == 0) {
+                sched_yield();
+            }
+        }
+        if (done) {
+            return NULL;
+        }
+    }
+}
+
+static void test_threaded_stress(void)
+{
+    pthread_t producer;
+    pthread_t readers[STRESS_READERS];
+    stress_reader_t state[STRESS_READERS] = {
+        { .yield_every = 1 << 20 },
+        { .yield_every = 3 },
+    };
+
+    frame_ring_init(&s_ring);
+    atomic_store(&s_producer_done, false);
+    for (int i = 0; i < STRESS_READERS; i++) {
+        frame_ring_reader_init(&state[i].reader, &s_ring);
+        pthread_create(&readers[i], NULL, reader_thread, &state[i]);
+    }
+    pthread_create(&producer, NULL, producer_thread, NULL);
+
+    pthread_join(producer, NULL);
+    for (int i = 0; i < STRESS_READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+
+    for (int i = 0; i < STRESS_READERS; i++) {
+        stress_reader_t *r = &state[i];
+        CHECK(r->torn == 0, "reader %d saw %lu torn frames", i, (unsigned long)r->torn);
+        CHECK(r->out_of_order == 0, "reader %d saw %lu frames out of order", i, (unsigned long)r->out_of_order);
+        CHECK(r->read + r->reader.dropped == STRESS_FRAMES, "reader %d: %lu read + %lu dropped != %d", i,
+              (unsigned long)r->read, (unsigned long)r->reader.dropped, STRESS_FRAMES);
+        printf("frame_ring: reader %d read %lu, dropped %lu of %d\n", i, (unsigned long)r->read,
+               (unsigned long)r->reader.dropped, STRESS_FRAMES);
+    }
+}
+
+int main(void)
+{
+    test_independent_cursors();
+    test_lapping();
+    test_capture_flags();
+    test_threaded_stress();
+
+    return test_summary("test_frame_ring");
+}
@@ -0,0 +1,208 @@
+/**
+ * @file test_loadcell_align.c
+ * @brief Inter-channel alignment against known force curves
+ *
+ * The interpolators must be exact where their order allows: linear on a
+ * straight line with jittered timestamps, Catmull-Rom on a parabola. Four
+ * channels scanned one after another then sample an impact (a 20 ms
+ * sine-squared pulse) and the summed force of each aligned frame is
+ * compared with the true total at the frame's instant: cubic must beat
+ * linear, and both must beat the unaligned sum taken at the frame start. Finally a step on a
+ * simulated plate shows loadcell_read() and frame_ring_capture() using the
+ * common instant.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "loadcell_align.h"
+#include "frame_ring.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define SCAN_US         1000        /* Frame period of the simulated scans */
+#define CHANNELS        4
+#define IMPACT_US       20000.0     /* Pulse duration */
+#define IMPACT_PEAK_MN  2000000.0   /* 2 kN per cell */
+
+/* Force on every cell at t: a 20 ms sine-squared impact starting at 5 ms */
+static double impact(double t_us)
+{
+    double t = t_us - 5000.0;
+    double s = sin(M_PI * t / IMPACT_US);
+    return t > 0.0 && t < IMPACT_US ? IMPACT_PEAK_MN * s * s : 0.0;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+/* A straight line comes back exactly, whatever the sample spacing */
+static void test_linear_exact(void)
+{
+    loadcell_align_history_t h;
+    loadcell_align_reset(&h);
+    CHECK(!loadcell_align_ready(&h, LOADCELL_ALIGN_LINEAR), "empty history ready");
+    loadcell_align_push(&h, 1000, 3000);
+    CHECK(!loadcell_align_ready(&h, LOADCELL_ALIGN_LINEAR), "one sample ready for linear");
+    loadcell_align_push(&h, 2100, 6300);        /* 3 mN/us, 1100 us later */
+    CHECK(loadcell_align_ready(&h, LOADCELL_ALIGN_LINEAR), "two samples not ready for linear");
+    CHECK(!loadcell_align_ready(&h, LOADCELL_ALIGN_CUBIC), "two samples ready for cubic");
+    CHECK(loadcell_align_anchor(&h, LOADCELL_ALIGN_LINEAR) == 2100, "linear anchor %lld",
+          (long long)loadcell_align_anchor(&h, LOADCELL_ALIGN_LINEAR));
+
+    for (int64_t t = 1000; t <= 2100; t += 37) {
+        int32_t y = loadcell_align_at(&h, LOADCELL_ALIGN_LINEAR, t);
+        CHECK(abs(y - (int32_t)(3 * t)) <= 1, "line at %lld read %ld", (long long)t, (long)y);
+    }
+    /* Outside the interval the ends are held */
+    CHECK(loadcell_align_at(&h, LOADCELL_ALIGN_LINEAR, 500) == 3000, "before the interval");
+    CHECK(loadcell_align_at(&h, LOADCELL_ALIGN_LINEAR, 9000) == 6300, "after the interval");
+}
+
+/* Catmull-Rom on equally spaced samples of a parabola is exact */
+static void test_cubic_parabola(void)
+{
+    loadcell_align_history_t h;
+    loadcell_align_reset(&h);
+    for (int64_t t = 0; t <= 3000; t += 1000) {
+        loadcell_align_push(&h, t, (int32_t)(t * t / 10 - 500 * t));
+    }
+    CHECK(loadcell_align_ready(&h, LOADCELL_ALIGN_CUBIC), "four samples not ready for cubic");
+    CHECK(loadcell_align_anchor(&h, LOADCELL_ALIGN_CUBIC) == 2000, "cubic anchor %lld",
+          (long long)loadcell_align_anchor(&h, LOADCELL_ALIGN_CUBIC));
+
+    int32_t worst = 0;
+    for (int64_t t = 1000; t <= 2000; t += 10) {
+        int32_t y = loadcell_align_at(&h, LOADCELL_ALIGN_CUBIC, t);
+        int32_t err = abs(y - (int32_t)(t * t / 10 - 500 * t));
+        worst = err > worst ? err : worst;
+    }
+    CHECK(worst <= 2, "parabola off by %ld mN", (long)worst);
+
+    /* Extremes saturate rather than wrap */
+    loadcell_align_reset(&h);
+    loadcell_align_push(&h, 0, INT32_MIN);
+    loadcell_align_push(&h, 1000, INT32_MAX);
+    loadcell_align_push(&h, 2000, INT32_MAX);
+    loadcell_align_push(&h, 3000, INT32_MIN);
+    CHECK(loadcell_align_at(&h, LOADCELL_ALIGN_CUBIC, 1500) == INT32_MAX, "overshoot wrapped");
+}
+
+/* Sum of four skewed channels through an impact, aligned and not */
+static void test_impact_total(void)
+{
+    loadcell_align_history_t h[CHANNELS];
+    double worst[3] = { 0.0, 0.0, 0.0 };        /* Unaligned, linear, cubic */
+
+    for (int i = 0; i < CHANNELS; i++) {
+        loadcell_align_reset(&h[i]);
+    }
+    for (int frame = 0; frame < 40; frame++) {
+        /* Channel i converts a quarter scan after channel i - 1, with a few us of jitter */
+        for (int i = 0; i < CHANNELS; i++) {
+            int64_t t = (int64_t)frame * SCAN_US + i * SCAN_US / CHANNELS + (frame * 7 + i * 3) % 5;
+            loadcell_align_push(&h[i], t, (int32_t)lround(impact((double)t)));
+        }
+        if (frame < 4) {
+            continue;
+        }
+
+        double unaligned = 0.0;
+        for (int i = 0; i < CHANNELS; i++) {
+            unaligned += h[i].force_mn[0];
+        }
+        double err = fabs(unaligned - CHANNELS * impact((double)h[0].t_us[0]));
+        worst[0] = err > worst[0] ? err : worst[0];
+
+        for (loadcell_align_mode_t mode = LOADCELL_ALIGN_LINEAR; mode <= LOADCELL_ALIGN_CUBIC; mode++) {
+            int64_t t_ref = INT64_MAX;
+            for (int i = 0; i < CHANNELS; i++) {
+                int64_t anchor = loadcell_align_anchor(&h[i], mode);
+                t_ref = anchor < t_ref ? anchor : t_ref;
+            }
+            double total = 0.0;
+            for (int i = 0; i < CHANNELS; i++) {
+                total += loadcell_align_at(&h[i], mode, t_ref);
+            }
+            err = fabs(total - CHANNELS * impact((double)t_ref));
+            worst[mode] = err > worst[mode] ? err : worst[mode];
+        }
+    }
+
+    printf("loadcell_align: 4 x %.0f kN impact, worst total error: unaligned %.0f N, linear %.1f N, cubic %.2f N\n",
+           IMPACT_PEAK_MN / 1e6, worst[0] / 1000, worst[1] / 1000, worst[2] / 1000);
+    CHECK(worst[1] < worst[0] / 10, "linear %.0f mN not well below unaligned %.0f mN", worst[1], worst[0]);
+    CHECK(worst[2] < worst[1] / 4, "cubic %.0f mN not well below linear %.0f mN", worst[2], worst[1]);
+}
+
+/* A step on the plate: one instant for the frame, forces between the levels by conversion time */
+static void test_plate_step(void)
+{
+    loadcell_t lc;
+    static frame_ring_t ring;
+    frame_ring_reader_t reader;
+    loadcell_frame_t frame;
+
+    host_spi_reset();
+    CHECK(loadcell_init(&lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_4800_SPS) == ESP_OK,
+          "loadcell_init failed");
+    CHECK(loadcell_set_alignment(&lc, (loadcell_align_mode_t)3) == ESP_ERR_INVALID_ARG, "unknown mode accepted");
+    CHECK(loadcell_set_alignment(&lc, LOADCELL_ALIGN_LINEAR) == ESP_OK, "linear refused");
+    CHECK(loadcell_get_alignment(&lc) == LOADCELL_ALIGN_LINEAR, "mode not read back");
+    frame_ring_init(&ring);
+    frame_ring_reader_init(&reader, &ring);
+
+    host_ads1261_set_code(1000);
+    loadcell_read(&lc);
+    CHECK(lc.aligned_us == 0, "first frame aligned without a previous sample");
+    host_ads1261_set_code(2000);
+    loadcell_read(&lc);
+    frame_ring_capture(&ring, &lc, NULL, 123, 0);
+
+    int64_t first = INT64_MAX;
+    for (int i = 0; i < lc.num_channels; i++) {
+        first = lc.channels[i].align.t_us[0] < first ? lc.channels[i].align.t_us[0] : first;
+    }
+    CHECK(lc.aligned_us == first, "aligned at %lld, earliest conversion %lld", (long long)lc.aligned_us,
+          (long long)first);
+    int32_t previous = INT32_MAX;
+    for (int i = 0; i < lc.num_channels; i++) {
+        int32_t f = lc.measurements[i].force_mn;
+        CHECK((int64_t)lc.measurements[i].timestamp_us == first, "channel %d stamped separately", i);
+        CHECK(f >= 1000 * 1000 && f <= 2000 * 1000 && f < previous, "channel %d at %ld mN, previous %ld", i,
+              (long)f, (long)previous);
+        previous = f;
+    }
+    CHECK(lc.measurements[0].force_mn == 2000 * 1000, "first-converted channel interpolated: %ld",
+          (long)lc.measurements[0].force_mn);
+    CHECK(lc.measurements[3].raw_adc == 2000, "raw code resampled: %ld", (long)lc.measurements[3].raw_adc);
+    CHECK(frame_ring_read(&reader, &frame) && frame.timestamp_us == first, "frame stamped %lld",
+          (long long)frame.timestamp_us);
+
+    /* Off again: per-channel times, deadline on the frame */
+    loadcell_set_alignment(&lc, LOADCELL_ALIGN_OFF);
+    loadcell_read(&lc);
+    frame_ring_capture(&ring, &lc, NULL, 456, 0);
+    CHECK(lc.aligned_us == 0 && lc.measurements[1].timestamp_us != lc.measurements[0].timestamp_us,
+          "alignment still applied");
+    CHECK(frame_ring_read(&reader, &frame) && frame.timestamp_us == 456, "unaligned frame stamped %lld",
+          (long long)frame.timestamp_us);
+
+    loadcell_deinit(&lc);
+}
+
+int main(void)
+{
+    test_linear_exact();
+    test_cubic_parabola();
+    test_impact_total();
+    test_plate_step();
+
+    return test_summary("test_loadcell_align");
+}
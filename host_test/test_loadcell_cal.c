@@ -0,0 +1,202 @@
+/**
+ * @file test_loadcell_cal.c
+ * @brief Calibration sets taken up whole at frame boundaries
+ *
+ * A gptimer alarm stands in for a task that preempts the acquisition task
+ * halfway through a scan and resets every channel's calibration. The frame
+ * under way must convert all channels with the old set and the next frame
+ * all channels with the new one, OFCAL included: no frame mixes the two.
+ * A single read takes up a change at once without touching the scan, and
+ * every update bumps the version of the published set. A second update in
+ * the same scan, whose spare is the set the scan converts with, times out.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "driver/gptimer.h"
+#include "esp_timer.h"
+#include "ads1261.h"
+#include "loadcell.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define ZERO_CODE       100000      /* Bridge code the channels are tared at */
+#define LOAD_CODES      20000       /* Codes applied on top during the test */
+
+static loadcell_t s_lc;
+static int s_resets;
+static esp_err_t s_second_reset;
+
+/* The preempting task: rst_calib on every channel, mid-scan */
+static bool reset_all(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *ctx)
+{
+    for (uint8_t i = 0; i < s_lc.num_channels; i++) {
+        loadcell_reset_calibration(&s_lc, i);
+    }
+    s_resets++;
+    return false;
+}
+
+/* A task that resets channel 0 twice, mid-scan: the second update's spare is the set the scan holds */
+static bool reset_twice(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *ctx)
+{
+    if (loadcell_reset_calibration(&s_lc, 0) == ESP_OK) {
+        s_resets++;
+    }
+    s_second_reset = loadcell_reset_calibration(&s_lc, 0);
+    return false;
+}
+
+/* One-shot alarm after_us from now, running on_alarm */
+static gptimer_handle_t arm_alarm(uint32_t after_us, gptimer_alarm_cb_t on_alarm)
+{
+    gptimer_handle_t timer = NULL;
+    gptimer_config_t cfg = { .clk_src = GPTIMER_CLK_SRC_DEFAULT, .direction = GPTIMER_COUNT_UP,
+                             .resolution_hz = 1000000 };
+    gptimer_event_callbacks_t cbs = { .on_alarm = on_alarm };
+    gptimer_alarm_config_t alarm = { .alarm_count = after_us };
+    CHECK(gptimer_new_timer(&cfg, &timer) == ESP_OK && gptimer_register_event_callbacks(timer, &cbs, NULL) == ESP_OK &&
+          gptimer_enable(timer) == ESP_OK && gptimer_set_alarm_action(timer, &alarm) == ESP_OK &&
+          gptimer_start(timer) == ESP_OK, "alarm setup failed");
+    return timer;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_no_torn_frame(void)
+{
+    host_spi_reset();
+    CHECK(loadcell_init(&s_lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    host_ads1261_set_code(ZERO_CODE);
+    loadcell_read(&s_lc);
+    for (uint8_t i = 0; i < s_lc.num_channels; i++) {
+        CHECK(loadcell_tare(&s_lc, i, 4) == ESP_OK, "tare of channel %u failed", i);
+    }
+
+    /* Tared in OFCAL: the load reads as itself on every channel */
+    host_ads1261_set_code(ZERO_CODE + LOAD_CODES);
+    loadcell_read(&s_lc);
+    int64_t start_us = esp_timer_get_time();
+    loadcell_read(&s_lc);
+    uint32_t scan_us = (uint32_t)(esp_timer_get_time() - start_us);
+    loadcell_cal_set_t before;
+    loadcell_get_cal_set(&s_lc, 0, &before);
+    for (int i = 0; i < s_lc.num_channels; i++) {
+        CHECK(s_lc.measurements[i].raw_adc == LOAD_CODES, "channel %d read %ld before the reset", i,
+              (long)s_lc.measurements[i].raw_adc);
+    }
+
+    /* Reset halfway through the next scan: that frame is still converted with the tare */
+    gptimer_handle_t timer = arm_alarm(scan_us / 2, reset_all);
+    loadcell_read(&s_lc);
+    CHECK(s_resets == 1, "alarm fired %d times during the scan", s_resets);
+    for (int i = 0; i < s_lc.num_channels; i++) {
+        CHECK(s_lc.measurements[i].raw_adc == LOAD_CODES, "channel %d read %ld in the frame of the reset", i,
+              (long)s_lc.measurements[i].raw_adc);
+    }
+
+    /* The next frame converts every channel without it */
+    loadcell_read(&s_lc);
+    for (int i = 0; i < s_lc.num_channels; i++) {
+        CHECK(s_lc.measurements[i].raw_adc == ZERO_CODE + LOAD_CODES, "channel %d read %ld after the reset", i,
+              (long)s_lc.measurements[i].raw_adc);
+    }
+    loadcell_cal_set_t after;
+    loadcell_get_cal_set(&s_lc, 0, &after);
+    CHECK(after.version == before.version + 1 && after.hw_offset == 0 && before.hw_offset != 0,
+          "set version %lu -> %lu, OFCAL %ld -> %ld", (unsigned long)before.version, (unsigned long)after.version,
+          (long)before.hw_offset, (long)after.hw_offset);
+
+    gptimer_stop(timer);
+    gptimer_disable(timer);
+    gptimer_del_timer(timer);
+    loadcell_deinit(&s_lc);
+}
+
+/*
+ * A single read is its own frame: it converts with whatever was published before it.
+ * The first conversion after OFCAL changes straddles the register writes, so each
+ * check reads twice.
+ */
+static int32_t read_twice(uint8_t channel)
+{
+    loadcell_measurement_t m;
+    loadcell_read_channel(&s_lc, channel, &m);
+    CHECK(loadcell_read_channel(&s_lc, channel, &m) == ESP_OK, "read of channel %u failed", channel);
+    return m.raw_adc;
+}
+
+static void test_single_read(void)
+{
+    host_spi_reset();
+    CHECK(loadcell_init(&s_lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    host_ads1261_set_code(ZERO_CODE);
+    CHECK(loadcell_tare(&s_lc, 2, 4) == ESP_OK, "tare failed");
+    int32_t code = read_twice(2);
+    CHECK(code == 0, "read %ld after the tare", (long)code);
+
+    /* Single reads leave the scan alone: its next frame takes the tare up */
+    const ads1261_seq_step_t *step = &s_lc.seqs[0].steps[2];
+    loadcell_cal_set_t set;
+    loadcell_get_cal_set(&s_lc, 2, &set);
+    CHECK(step->ofcal == 0, "single read rewrote the scan's OFCAL (%ld)", (long)step->ofcal);
+    loadcell_read(&s_lc);
+    CHECK(step->ofcal == set.hw_offset && set.hw_offset != 0, "scan OFCAL %ld, published %ld", (long)step->ofcal,
+          (long)set.hw_offset);
+    loadcell_reset_calibration(&s_lc, 2);
+    code = read_twice(2);
+    CHECK(code == ZERO_CODE, "read %ld after the reset", (long)code);
+
+    CHECK(loadcell_get_cal_set(&s_lc, 9, &set) == ESP_ERR_INVALID_ARG, "channel 9 accepted");
+    CHECK(loadcell_get_cal_set(&s_lc, 2, &set) == ESP_OK && set.version == 2, "version %lu after two updates",
+          (unsigned long)set.version);
+    loadcell_deinit(&s_lc);
+}
+
+/* The scan holds its sets: an update that would rewrite one gives up, and goes ahead after the scan */
+static void test_held_set(void)
+{
+    host_spi_reset();
+    CHECK(loadcell_init(&s_lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    host_ads1261_set_code(ZERO_CODE);
+    loadcell_read(&s_lc);
+    CHECK(loadcell_tare(&s_lc, 0, 4) == ESP_OK, "tare failed");
+    loadcell_read(&s_lc);
+    int64_t start_us = esp_timer_get_time();
+    loadcell_read(&s_lc);
+    uint32_t scan_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    s_resets = 0;
+    gptimer_handle_t timer = arm_alarm(scan_us / 2, reset_twice);
+    loadcell_read(&s_lc);
+    CHECK(s_resets == 1 && s_second_reset == ESP_ERR_TIMEOUT, "%d reset(s), then %s", s_resets,
+          esp_err_to_name(s_second_reset));
+    CHECK(s_lc.measurements[0].raw_adc == 0, "channel 0 read %ld in the frame of the resets",
+          (long)s_lc.measurements[0].raw_adc);
+
+    loadcell_cal_set_t set;
+    CHECK(loadcell_reset_calibration(&s_lc, 0) == ESP_OK, "reset refused after the scan");
+    CHECK(loadcell_get_cal_set(&s_lc, 0, &set) == ESP_OK && set.version == 3, "version %lu after three updates",
+          (unsigned long)set.version);
+
+    gptimer_stop(timer);
+    gptimer_disable(timer);
+    gptimer_del_timer(timer);
+    loadcell_deinit(&s_lc);
+}
+
+int main(void)
+{
+    test_no_torn_frame();
+    test_single_read();
+    test_held_set();
+
+    return test_summary("test_loadcell_cal");
+}
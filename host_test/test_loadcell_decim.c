@@ -0,0 +1,263 @@
+/**
+ * @file test_loadcell_decim.c
+ * @brief Burst decimator against its transfer function, and end to end
+ *
+ * The CIC/FIR chain is linear apart from its final rounding, so its impulse
+ * response is measured directly: it must sum to exactly one (DC is passed
+ * bit-exact, even at full scale where the integrators wrap) and its power
+ * must be below that of a plain burst mean. Steps settle within the filter
+ * length, sinusoids show the flattened passband, and resets and short
+ * bursts fall back to plain means. Finally a noisy bridge is scanned
+ * through the simulated ADS1261 with and without oversampling.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "loadcell_decim.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define IMPULSE             (1 << 20)   /* Large enough that rounding is negligible */
+#define IMPULSE_BURSTS      8           /* Longer than the CIC plus compensator */
+#define TEST_FACTOR         16
+#define PASSBAND_SETTLE     50
+#define PASSBAND_OUTPUTS    100         /* Whole cycles at 0.1 and 0.2 of the output rate */
+
+/* One full burst of a constant code */
+static int32_t push_burst(loadcell_decim_t *d, int32_t code)
+{
+    for (int i = 0; i < loadcell_decim_factor(d); i++) {
+        loadcell_decim_push(d, code);
+    }
+    return loadcell_decim_end_burst(d);
+}
+
+/* Decimator past its start-up means, fed with zeros */
+static void primed(loadcell_decim_t *d, uint16_t factor)
+{
+    loadcell_decim_init(d, factor);
+    for (int i = 0; i < LOADCELL_DECIM_ORDER + 1; i++) {
+        push_burst(d, 0);
+    }
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+/* Constant input comes out unchanged at every factor, through start-up and wrap-around */
+static void test_dc_exact(void)
+{
+    const int32_t codes[] = { 0, 1, -1, 123457, -765431, 0x7FFFFF, -0x800000 };
+    loadcell_decim_t d;
+
+    for (uint16_t factor = 1; factor <= LOADCELL_DECIM_MAX_FACTOR; factor *= 2) {
+        for (size_t c = 0; c < sizeof(codes) / sizeof(codes[0]); c++) {
+            CHECK(loadcell_decim_init(&d, factor) == ESP_OK, "factor %u refused", factor);
+            for (int b = 0; b < 200; b++) {
+                int32_t out = push_burst(&d, codes[c]);
+                if (out != codes[c]) {
+                    CHECK(false, "factor %u code %ld: burst %d gave %ld", factor, (long)codes[c], b, (long)out);
+                    break;
+                }
+            }
+        }
+    }
+
+    CHECK(loadcell_decim_init(&d, 0) == ESP_ERR_INVALID_ARG, "factor 0 accepted");
+    CHECK(loadcell_decim_init(&d, 12) == ESP_ERR_INVALID_ARG, "factor 12 accepted");
+    CHECK(loadcell_decim_init(&d, 2 * LOADCELL_DECIM_MAX_FACTOR) == ESP_ERR_INVALID_ARG, "factor 128 accepted");
+}
+
+/* Unit DC gain, finite length, and less noise power than a burst mean */
+static void test_impulse_response(void)
+{
+    loadcell_decim_t d;
+
+    for (uint16_t factor = 2; factor <= LOADCELL_DECIM_MAX_FACTOR; factor *= 2) {
+        double sum = 0.0, power = 0.0, tail = 0.0;
+        for (int pos = 0; pos < factor; pos++) {
+            primed(&d, factor);
+            for (int b = 0; b < IMPULSE_BURSTS; b++) {
+                for (int i = 0; i < factor; i++) {
+                    loadcell_decim_push(&d, (b == 0 && i == pos) ? IMPULSE : 0);
+                }
+                double h = (double)loadcell_decim_end_burst(&d) / IMPULSE;
+                sum += h;
+                power += h * h;
+                if (b >= LOADCELL_DECIM_ORDER + 2) {
+                    tail += fabs(h);
+                }
+            }
+        }
+        /* Over every input position: sum h is the DC gain, sum h^2 the white-noise power gain */
+        double noise_gain = sqrt(power);
+        CHECK(fabs(sum - 1.0) < 1e-4, "factor %u: DC gain %.6f", factor, sum);
+        CHECK(tail == 0.0, "factor %u: response longer than %d bursts", factor, LOADCELL_DECIM_ORDER + 2);
+        CHECK(noise_gain < 1.0 / sqrt(factor), "factor %u: noise gain %.3f vs %.3f for the mean", factor,
+              noise_gain, 1.0 / sqrt(factor));
+    }
+}
+
+/* A step settles to the exact new value within the filter length, with bounded ringing */
+static void test_step(void)
+{
+    const int32_t step = 1000000;
+    loadcell_decim_t d;
+    primed(&d, TEST_FACTOR);
+
+    int32_t lo = 0, hi = 0;
+    for (int b = 0; b < 10; b++) {
+        int32_t out = push_burst(&d, step);
+        lo = out < lo ? out : lo;
+        hi = out > hi ? out : hi;
+        if (b >= LOADCELL_DECIM_ORDER + 1) {
+            CHECK(out == step, "burst %d after the step: %ld", b, (long)out);
+        }
+    }
+    CHECK(hi <= step + step / 8 && lo >= -step / 8, "step rang from %ld to %ld", (long)lo, (long)hi);
+}
+
+/* Passband: the compensator removes most of the CIC droop */
+static void test_passband(void)
+{
+    const double fractions[] = { 0.1, 0.2 };
+    const double limits[] = { 0.01, 0.05 };     /* The CIC alone droops 4.8% and 18% */
+    const double amplitude = 1000000.0;
+    loadcell_decim_t d;
+
+    for (int f = 0; f < 2; f++) {
+        /* Cycles per burst: the bursts are filtered back to back */
+        double w = 2.0 * M_PI * fractions[f] / TEST_FACTOR;
+        double in_phase = 0.0, quadrature = 0.0;
+        loadcell_decim_init(&d, TEST_FACTOR);
+        for (int b = 0; b < PASSBAND_SETTLE + PASSBAND_OUTPUTS; b++) {
+            for (int i = 0; i < TEST_FACTOR; i++) {
+                loadcell_decim_push(&d, (int32_t)lround(amplitude * sin(w * (b * TEST_FACTOR + i))));
+            }
+            int32_t out = loadcell_decim_end_burst(&d);
+            /* Whole cycles after start-up: correlate against the output-rate sinusoid */
+            if (b >= PASSBAND_SETTLE) {
+                in_phase += out * sin(2.0 * M_PI * fractions[f] * b);
+                quadrature += out * cos(2.0 * M_PI * fractions[f] * b);
+            }
+        }
+        double gain = 2.0 * hypot(in_phase, quadrature) / PASSBAND_OUTPUTS / amplitude;
+        double cic = pow(sin(M_PI * fractions[f]) / (TEST_FACTOR * sin(M_PI * fractions[f] / TEST_FACTOR)),
+                         LOADCELL_DECIM_ORDER);
+        CHECK(fabs(gain - 1.0) < limits[f], "%.1f of the frame rate: gain %.4f (CIC alone %.4f)", fractions[f],
+              gain, cic);
+        CHECK(fabs(gain - 1.0) < fabs(cic - 1.0), "%.1f of the frame rate: no better than the CIC", fractions[f]);
+    }
+}
+
+/* A reset or a short burst restarts the filters: the next output is that burst's mean */
+static void test_reset(void)
+{
+    loadcell_decim_t d;
+    loadcell_decim_init(&d, TEST_FACTOR);
+    for (int b = 0; b < 10; b++) {
+        push_burst(&d, 50000);
+    }
+
+    loadcell_decim_request_reset(&d);
+    CHECK(push_burst(&d, -20000) == -20000, "reset kept the old history");
+    for (int b = 0; b < 10; b++) {
+        int32_t out = push_burst(&d, -20000);
+        if (out != -20000) {
+            CHECK(false, "burst %d after the reset: %ld", b, (long)out);
+            break;
+        }
+    }
+
+    for (int i = 0; i < TEST_FACTOR / 2; i++) {
+        loadcell_decim_push(&d, 30000);
+    }
+    CHECK(loadcell_decim_end_burst(&d) == 30000, "short burst not taken as its mean");
+    CHECK(push_burst(&d, 40000) == 40000, "filters not restarted after a short burst");
+    CHECK(loadcell_decim_end_burst(&d) == 0, "empty burst");
+}
+
+/* Standard deviation of one channel's code over n scans */
+static double scan_noise(loadcell_t *lc, uint8_t channel, int n)
+{
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = 0; i < n; i++) {
+        if (loadcell_read(lc) != ESP_OK) {
+            CHECK(false, "scan %d failed", i);
+            return 0.0;
+        }
+        double f = lc->measurements[channel].raw_adc;
+        sum += f;
+        sum_sq += f * f;
+    }
+    double mean = sum / n;
+    return sqrt(sum_sq / n - mean * mean);
+}
+
+/* Oversampled scans of a noisy bridge: same mean, less noise, longer scan */
+static void test_oversampled_scan(void)
+{
+    loadcell_t lc;
+    ads1261_timing_plan_t timing;
+
+    host_spi_reset();
+    CHECK(loadcell_init(&lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    host_ads1261_set_bridge(0x23, 0.5);
+    host_ads1261_set_noise(1e-6, 7);
+
+    /* 4 channels at 40 kSPS: no room at 1 kHz, the full burst at 100 Hz */
+    CHECK(loadcell_plan_oversampling(&lc, 1000.0f) == 1, "oversampling planned at 1 kHz");
+    CHECK(loadcell_plan_oversampling(&lc, 250.0f) == 16, "%u conversions planned at 250 Hz",
+          loadcell_plan_oversampling(&lc, 250.0f));
+    CHECK(loadcell_plan_oversampling(&lc, 100.0f) == LOADCELL_DECIM_MAX_FACTOR, "%u conversions planned at 100 Hz",
+          loadcell_plan_oversampling(&lc, 100.0f));
+
+    double plain = scan_noise(&lc, 1, 400);
+    uint32_t before = host_ads1261_conversions();
+    loadcell_read(&lc);
+    uint32_t per_scan_plain = host_ads1261_conversions() - before;
+
+    CHECK(loadcell_set_oversampling(&lc, 3) == ESP_ERR_INVALID_ARG, "3 conversions accepted");
+    CHECK(loadcell_set_oversampling(&lc, TEST_FACTOR) == ESP_OK, "oversampling refused");
+    CHECK(loadcell_get_timing(&lc, &timing) == ESP_OK && timing.conversions == TEST_FACTOR,
+          "timing ignores the oversampling");
+    before = host_ads1261_conversions();
+    loadcell_read(&lc);
+    uint32_t per_scan = host_ads1261_conversions() - before;
+    CHECK(per_scan >= per_scan_plain + LOADCELL_CHANNELS_PER_ADC * (TEST_FACTOR - 1),
+          "%lu conversions per scan, %lu without oversampling", (unsigned long)per_scan,
+          (unsigned long)per_scan_plain);
+
+    for (int i = 0; i < LOADCELL_DECIM_ORDER + 2; i++) {
+        loadcell_read(&lc);
+    }
+    double oversampled = scan_noise(&lc, 1, 400);
+    int32_t ideal = host_ads1261_ideal_code(0x23);
+    CHECK(abs(lc.measurements[1].raw_adc - ideal) < 6 * plain / sqrt(TEST_FACTOR),
+          "oversampled reading %ld, ideal %ld", (long)lc.measurements[1].raw_adc, (long)ideal);
+    printf("loadcell_decim: %.1f codes RMS per frame, %.1f with %dx oversampling\n", plain, oversampled, TEST_FACTOR);
+    CHECK(oversampled < 1.2 * plain / sqrt(TEST_FACTOR), "noise %.1f codes oversampled, %.1f without", oversampled,
+          plain);
+
+    loadcell_deinit(&lc);
+}
+
+int main(void)
+{
+    test_dc_exact();
+    test_impulse_response();
+    test_step();
+    test_passband();
+    test_reset();
+    test_oversampled_scan();
+
+    return test_summary("test_loadcell_decim");
+}
@@ -0,0 +1,246 @@
+/**
+ * @file test_loadcell_despike.c
+ * @brief Running median and Hampel filter against brute force
+ *
+ * The heap-based running median is checked sample by sample against a
+ * sorted copy of the window, for every window length, on wide-range and on
+ * heavily repeated values. The Hampel filter must replace isolated spikes
+ * and short glitch bursts in Gaussian noise while passing nearly every
+ * clean sample unchanged, and let a step through after half a window; the
+ * median mode must delay a ramp by half a window. Configuration changes
+ * take effect at the next sample. Finally the filter runs inside
+ * loadcell_read() on a simulated plate whose codes glitch between frames.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "loadcell_despike.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define NOISE_MN        100         /* Standard deviation of the test noise */
+#define LEVEL_MN        50000
+
+static uint32_t s_rng = 1;
+
+static uint32_t next_random(void)
+{
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng;
+}
+
+/* Approximately Gaussian: sum of four uniforms, scaled to the given deviation */
+static int32_t noise(int32_t sigma)
+{
+    double sum = 0.0;
+    for (int i = 0; i < 4; i++) {
+        sum += (next_random() >> 8) / 16777216.0 - 0.5;
+    }
+    return (int32_t)lround(sum * sqrt(3.0) * sigma);
+}
+
+static int cmp_int32(const void *a, const void *b)
+{
+    int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+/* Every window length, sample by sample, against a sorted copy */
+static void test_median_matches_sort(void)
+{
+    for (uint8_t window = 1; window <= LOADCELL_MEDIAN_MAX_WINDOW; window += 2) {
+        for (int pass = 0; pass < 2; pass++) {
+            loadcell_median_t m;
+            int32_t history[5000];
+            int mismatches = 0;
+            CHECK(loadcell_median_init(&m, window) == ESP_OK, "window %u refused", window);
+
+            for (int n = 0; n < 5000; n++) {
+                /* Wide range including the extremes, then a handful of repeated values */
+                uint32_t r = next_random();
+                history[n] = pass == 0 ? (int32_t)r : (int32_t)(r >> 29) - 4;
+                int32_t got = loadcell_median_push(&m, history[n]);
+
+                int held = n + 1 < window ? n + 1 : window;
+                int32_t sorted[LOADCELL_MEDIAN_MAX_WINDOW];
+                memcpy(sorted, &history[n + 1 - held], held * sizeof(int32_t));
+                qsort(sorted, held, sizeof(int32_t), cmp_int32);
+                if (got != sorted[held / 2]) {
+                    mismatches++;
+                }
+            }
+            CHECK(mismatches == 0, "window %u pass %d: %d wrong medians", window, pass, mismatches);
+            CHECK(loadcell_median_full(&m), "window %u not full", window);
+        }
+    }
+
+    loadcell_median_t m;
+    CHECK(loadcell_median_init(&m, 8) == ESP_ERR_INVALID_ARG, "even window accepted");
+    CHECK(loadcell_median_init(&m, LOADCELL_MEDIAN_MAX_WINDOW + 2) == ESP_ERR_INVALID_ARG, "oversized window accepted");
+}
+
+/* Spikes and glitch bursts in noise are replaced; clean samples pass untouched */
+static void test_hampel_spikes(void)
+{
+    loadcell_despike_t d;
+    loadcell_despike_init(&d);
+    CHECK(loadcell_despike_configure(&d, LOADCELL_DESPIKE_HAMPEL, LOADCELL_DESPIKE_WINDOW, LOADCELL_DESPIKE_K) ==
+          ESP_OK, "Hampel refused");
+
+    int spikes = 0, spikes_passed = 0, clean = 0, clean_changed = 0;
+    int32_t worst = 0;
+    for (int n = 0; n < 20000; n++) {
+        int32_t x = LEVEL_MN + noise(NOISE_MN);
+        /* A single spike every 50 samples, a 3-sample burst (under half the window) every 500 */
+        bool spike = n > 100 && (n % 50 == 0 || n % 500 < 3);
+        int32_t in = spike ? (n % 2 ? -8000000 : 8000000) : x;
+        int32_t y = loadcell_despike_run(&d, in);
+        if (n < LOADCELL_DESPIKE_WINDOW) {
+            continue;
+        }
+        if (spike) {
+            spikes++;
+            spikes_passed += y == in;
+        } else {
+            clean++;
+            clean_changed += y != in;
+        }
+        worst = abs(y - LEVEL_MN) > worst ? abs(y - LEVEL_MN) : worst;
+    }
+    CHECK(spikes_passed == 0, "%d of %d spikes passed", spikes_passed, spikes);
+    CHECK(worst < 6 * NOISE_MN, "output strayed %ld mN from the level", (long)worst);
+    CHECK(clean_changed < clean / 20, "%d of %d clean samples replaced", clean_changed, clean);
+    CHECK(loadcell_despike_replaced(&d) == (uint32_t)(spikes + clean_changed), "replaced count %lu",
+          (unsigned long)loadcell_despike_replaced(&d));
+}
+
+/* A step passes once it fills half the window, and then without delay */
+static void test_hampel_step(void)
+{
+    loadcell_despike_t d;
+    loadcell_despike_init(&d);
+    loadcell_despike_configure(&d, LOADCELL_DESPIKE_HAMPEL, 9, LOADCELL_DESPIKE_K);
+
+    for (int n = 0; n < 100; n++) {
+        loadcell_despike_run(&d, noise(NOISE_MN));
+    }
+    int first_through = -1;
+    for (int n = 0; n < 100; n++) {
+        int32_t x = 200000 + noise(NOISE_MN);
+        int32_t y = loadcell_despike_run(&d, x);
+        if (first_through < 0 && y > 100000) {
+            first_through = n;
+        }
+        if (n >= 9) {
+            CHECK(abs(y - x) < 6 * NOISE_MN, "sample %d after the step read %ld for %ld", n, (long)y, (long)x);
+        }
+    }
+    CHECK(first_through >= 0 && first_through <= 9 / 2, "step reached the output after %d samples", first_through);
+}
+
+/* The plain median follows a ramp half a window late */
+static void test_median_mode(void)
+{
+    loadcell_despike_t d;
+    loadcell_despike_init(&d);
+    loadcell_despike_configure(&d, LOADCELL_DESPIKE_MEDIAN, 15, 0.0f);
+
+    int wrong = 0;
+    for (int32_t n = 0; n < 1000; n++) {
+        int32_t y = loadcell_despike_run(&d, 10 * n);
+        wrong += n >= 15 && y != 10 * (n - 7);
+    }
+    CHECK(wrong == 0, "%d ramp samples off the 7-sample delay", wrong);
+}
+
+/* Settings are validated, read back, and applied at the next sample with fresh windows */
+static void test_configure(void)
+{
+    loadcell_despike_t d;
+    loadcell_despike_mode_t mode;
+    uint8_t window;
+    float k;
+    loadcell_despike_init(&d);
+
+    CHECK(loadcell_despike_run(&d, 12345) == 12345, "off stage changed a sample");
+    CHECK(loadcell_despike_configure(&d, LOADCELL_DESPIKE_HAMPEL, 4, 3.0f) == ESP_ERR_INVALID_ARG, "window 4 accepted");
+    CHECK(loadcell_despike_configure(&d, LOADCELL_DESPIKE_MEDIAN, 1, 3.0f) == ESP_ERR_INVALID_ARG, "window 1 accepted");
+    CHECK(loadcell_despike_configure(&d, LOADCELL_DESPIKE_HAMPEL, 7, 0.0f) == ESP_ERR_INVALID_ARG, "k 0 accepted");
+    CHECK(loadcell_despike_configure(&d, LOADCELL_DESPIKE_HAMPEL, 7, LOADCELL_DESPIKE_MAX_K + 1) == ESP_ERR_INVALID_ARG,
+          "k beyond the maximum accepted");
+    CHECK(loadcell_despike_configure(&d, (loadcell_despike_mode_t)7, 7, 3.0f) == ESP_ERR_INVALID_ARG,
+          "unknown mode accepted");
+
+    CHECK(loadcell_despike_configure(&d, LOADCELL_DESPIKE_HAMPEL, 11, 2.5f) == ESP_OK, "Hampel refused");
+    loadcell_despike_get_config(&d, &mode, &window, &k);
+    CHECK(mode == LOADCELL_DESPIKE_HAMPEL && window == 11 && fabsf(k - 2.5f) < 0.01f, "read back %s/%u/%.3f",
+          loadcell_despike_mode_name(mode), window, k);
+
+    /* Median of a constant, then a switch to median mode restarts from the next sample alone */
+    for (int n = 0; n < 20; n++) {
+        loadcell_despike_run(&d, 500);
+    }
+    loadcell_despike_configure(&d, LOADCELL_DESPIKE_MEDIAN, 3, 0.0f);
+    CHECK(loadcell_despike_run(&d, 900) == 900, "old window survived the reconfiguration");
+    CHECK(loadcell_despike_replaced(&d) == 0, "replaced count survived the reconfiguration");
+
+    loadcell_despike_configure(&d, LOADCELL_DESPIKE_OFF, 0, 0.0f);
+    CHECK(loadcell_despike_run(&d, -77) == -77, "switched-off stage changed a sample");
+}
+
+/* Spikes configured through the loadcell API are removed inside the scan, before the statistics */
+static void test_channel_despike(void)
+{
+    loadcell_t lc;
+    host_spi_reset();
+    CHECK(loadcell_init(&lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    CHECK(loadcell_set_despike(&lc, 9, LOADCELL_DESPIKE_HAMPEL, 7, 3.0f) == ESP_ERR_INVALID_ARG, "channel 9 accepted");
+    CHECK(loadcell_set_despike(&lc, LOADCELL_ALL_CHANNELS, LOADCELL_DESPIKE_HAMPEL, LOADCELL_DESPIKE_WINDOW,
+                               LOADCELL_DESPIKE_K) == ESP_OK, "Hampel refused");
+    CHECK(loadcell_set_despike(&lc, 3, LOADCELL_DESPIKE_OFF, 0, 0.0f) == ESP_OK, "off refused");
+
+    /* Codes alternate by one count, with a full-scale glitch every 10th frame */
+    int glitches = 0;
+    for (int n = 0; n < 200; n++) {
+        bool glitch = n >= 20 && n % 10 == 0;
+        host_ads1261_set_code(glitch ? 0x7FFFFF : 1000 + n % 2);
+        glitches += glitch;
+        loadcell_read(&lc);
+        if (n == 19) {
+            loadcell_reset_stats(&lc, LOADCELL_ALL_CHANNELS);
+        }
+    }
+
+    loadcell_stats_t stats;
+    loadcell_get_stats(&lc, 0, &stats);
+    CHECK(stats.max_force < 1002.0f, "glitch reached the statistics of channel 0: max %.1f N", stats.max_force);
+    CHECK(loadcell_despike_replaced(&lc.channels[0].despike) >= (uint32_t)glitches, "%lu of %d glitches replaced",
+          (unsigned long)loadcell_despike_replaced(&lc.channels[0].despike), glitches);
+    loadcell_get_stats(&lc, 3, &stats);
+    CHECK(stats.max_force > 8000.0f, "channel 3 without despike missed its glitches: max %.1f N", stats.max_force);
+
+    loadcell_deinit(&lc);
+}
+
+int main(void)
+{
+    test_median_matches_sort();
+    test_hampel_spikes();
+    test_hampel_step();
+    test_median_mode();
+    test_configure();
+    test_channel_despike();
+
+    return test_summary("test_loadcell_despike");
+}
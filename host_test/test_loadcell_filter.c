@@ -0,0 +1,298 @@
+/**
+ * @file test_loadcell_filter.c
+ * @brief Fixed-point biquad cascade against its designs
+ *
+ * Designed sections are run on sinusoids and compared with the analytic
+ * response of the float design: a Butterworth low-pass at its corner and in
+ * its stop band, a 50 Hz notch at and beside its centre, a drift high-pass
+ * on a DC offset. DC must pass (or be blocked) exactly despite the Q28
+ * rounding, a decaying input must come to rest at exactly zero, extreme
+ * inputs must saturate without wrapping, and a chain changed between
+ * samples must not disturb a steady output. Finally the chains are set on a
+ * simulated plate and run inside loadcell_read().
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "loadcell_filter.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define RATE_HZ             1000.0f
+#define SETTLE_SAMPLES      2000
+#define MEASURE_SAMPLES     1000        /* Whole cycles of every test tone */
+#define AMPLITUDE           1000000.0   /* 1 kN in mN */
+
+/* Fresh filter with one designed section */
+static void one_section(loadcell_filter_t *f, loadcell_filter_type_t type, float freq_hz, float q)
+{
+    loadcell_biquad_t section;
+    loadcell_filter_init(f);
+    CHECK(loadcell_biquad_design(type, freq_hz, q, RATE_HZ, &section) == ESP_OK, "%s %.1f Hz refused",
+          loadcell_filter_type_name(type), freq_hz);
+    loadcell_filter_add(f, &section);
+}
+
+/* Gain of the filter on a tone, by correlation over whole cycles after settling */
+static double measured_gain(loadcell_filter_t *f, double freq_hz)
+{
+    double w = 2.0 * M_PI * freq_hz / RATE_HZ;
+    double in_phase = 0.0, quadrature = 0.0;
+    for (int n = 0; n < SETTLE_SAMPLES + MEASURE_SAMPLES; n++) {
+        int32_t y = loadcell_filter_run(f, (int32_t)lround(AMPLITUDE * sin(w * n)));
+        if (n >= SETTLE_SAMPLES) {
+            in_phase += y * sin(w * n);
+            quadrature += y * cos(w * n);
+        }
+    }
+    return 2.0 * hypot(in_phase, quadrature) / MEASURE_SAMPLES / AMPLITUDE;
+}
+
+/* |H(e^jw)| of the float coefficients */
+static double design_gain(const loadcell_filter_t *f, double freq_hz)
+{
+    loadcell_filter_chain_t chain;
+    loadcell_filter_get_chain(f, &chain);
+    double w = 2.0 * M_PI * freq_hz / RATE_HZ;
+    double gain = 1.0;
+    for (int i = 0; i < chain.num_sections; i++) {
+        float c[5];
+        loadcell_biquad_get_coefs(&chain.sections[i], c);
+        double nr = c[0] + c[1] * cos(w) + c[2] * cos(2 * w), ni = -c[1] * sin(w) - c[2] * sin(2 * w);
+        double dr = 1.0 + c[3] * cos(w) + c[4] * cos(2 * w), di = -c[3] * sin(w) - c[4] * sin(2 * w);
+        gain *= hypot(nr, ni) / hypot(dr, di);
+    }
+    return gain;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+/* Butterworth low-pass: -3 dB at the corner, following the design in the stop band */
+static void test_lowpass(void)
+{
+    loadcell_filter_t f;
+    one_section(&f, LOADCELL_FILTER_LOWPASS, 20.0f, LOADCELL_FILTER_BUTTERWORTH_Q);
+
+    double corner = measured_gain(&f, 20.0);
+    CHECK(fabs(corner - M_SQRT1_2) < 0.002, "gain at the corner %.4f", corner);
+    double stop = measured_gain(&f, 200.0);
+    CHECK(fabs(stop - design_gain(&f, 200.0)) < 1e-4 && stop < 0.012, "gain at 200 Hz %.5f (design %.5f)", stop,
+          design_gain(&f, 200.0));
+}
+
+/* Notch: mains removed, neighbouring frequencies kept */
+static void test_notch(void)
+{
+    loadcell_filter_t f;
+    one_section(&f, LOADCELL_FILTER_NOTCH, 50.0f, LOADCELL_FILTER_NOTCH_Q);
+
+    double at = measured_gain(&f, 50.0);
+    CHECK(at < 1e-4, "50 Hz passed with gain %.6f", at);
+    double beside = measured_gain(&f, 20.0);
+    CHECK(fabs(beside - design_gain(&f, 20.0)) < 1e-4 && beside > 0.98, "20 Hz gain %.4f", beside);
+
+    /* 50 and 60 Hz chained */
+    loadcell_biquad_t section;
+    loadcell_biquad_design(LOADCELL_FILTER_NOTCH, 60.0f, LOADCELL_FILTER_NOTCH_Q, RATE_HZ, &section);
+    loadcell_filter_add(&f, &section);
+    CHECK(measured_gain(&f, 60.0) < 1e-4 && measured_gain(&f, 50.0) < 1e-4, "50/60 Hz chain leaks");
+}
+
+/* DC through designed sections is exact: low-pass and notch pass it, high-pass blocks it */
+static void test_dc_exact(void)
+{
+    const int32_t levels[] = { 1, -1, 987654, -123456789, LOADCELL_FILTER_LIMIT_MN };
+    loadcell_filter_t f;
+    loadcell_biquad_t section;
+
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        /* A very low corner is the hardest case for the rounding */
+        one_section(&f, LOADCELL_FILTER_LOWPASS, 0.5f, LOADCELL_FILTER_BUTTERWORTH_Q);
+        loadcell_biquad_design(LOADCELL_FILTER_NOTCH, 50.0f, LOADCELL_FILTER_NOTCH_Q, RATE_HZ, &section);
+        loadcell_filter_add(&f, &section);
+        loadcell_filter_run(&f, 0);
+        int32_t y = 0;
+        for (int n = 0; n < 20000; n++) {
+            y = loadcell_filter_run(&f, levels[i]);
+        }
+        CHECK(y == levels[i], "low-pass + notch settled at %ld for %ld", (long)y, (long)levels[i]);
+
+        /* The step decays as exp(-2 pi f t / sqrt(2)): 20 s takes 1e9 below 1 */
+        one_section(&f, LOADCELL_FILTER_HIGHPASS, 1.0f, LOADCELL_FILTER_BUTTERWORTH_Q);
+        loadcell_filter_run(&f, 0);
+        for (int n = 0; n < 20000; n++) {
+            y = loadcell_filter_run(&f, levels[i]);
+        }
+        CHECK(y == 0, "high-pass left %ld of %ld", (long)y, (long)levels[i]);
+    }
+}
+
+/* After an impulse the output comes to rest at exactly zero: no limit cycle */
+static void test_no_limit_cycle(void)
+{
+    loadcell_filter_t f;
+    one_section(&f, LOADCELL_FILTER_LOWPASS, 5.0f, 2.0f);
+    loadcell_filter_run(&f, 0);
+    loadcell_filter_run(&f, 100000);
+
+    int32_t worst_tail = 0;
+    for (int n = 0; n < 10000; n++) {
+        int32_t y = loadcell_filter_run(&f, 0);
+        if (n >= 5000) {
+            worst_tail = abs(y) > worst_tail ? abs(y) : worst_tail;
+        }
+    }
+    CHECK(worst_tail == 0, "output still %ld after 5 s", (long)worst_tail);
+}
+
+/* Inputs beyond the limit saturate; a resonant section does not wrap */
+static void test_saturation(void)
+{
+    loadcell_filter_t f;
+    one_section(&f, LOADCELL_FILTER_LOWPASS, 100.0f, 4.0f);
+    loadcell_filter_run(&f, 0);
+
+    int32_t lo = 0, hi = 0;
+    for (int n = 0; n < 200; n++) {
+        int32_t y = loadcell_filter_run(&f, (n / 5) % 2 ? INT32_MAX : INT32_MIN);
+        lo = y < lo ? y : lo;
+        hi = y > hi ? y : hi;
+    }
+    CHECK(hi == LOADCELL_FILTER_LIMIT_MN && lo == -LOADCELL_FILTER_LIMIT_MN, "output spanned %ld..%ld", (long)lo,
+          (long)hi);
+}
+
+/* Changing the chain between samples keeps a steady output steady */
+static void test_update_while_running(void)
+{
+    const int32_t level = 734512;
+    loadcell_filter_t f;
+    loadcell_biquad_t section;
+    one_section(&f, LOADCELL_FILTER_LOWPASS, 20.0f, LOADCELL_FILTER_BUTTERWORTH_Q);
+    for (int n = 0; n < 2000; n++) {
+        loadcell_filter_run(&f, level);
+    }
+
+    loadcell_biquad_design(LOADCELL_FILTER_NOTCH, 60.0f, LOADCELL_FILTER_NOTCH_Q, RATE_HZ, &section);
+    loadcell_filter_add(&f, &section);
+    for (int n = 0; n < 100; n++) {
+        int32_t y = loadcell_filter_run(&f, level);
+        if (y != level) {
+            CHECK(false, "sample %d after adding a notch: %ld", n, (long)y);
+            break;
+        }
+    }
+
+    loadcell_filter_clear(&f);
+    CHECK(loadcell_filter_run(&f, level + 5) == level + 5, "cleared chain still filters");
+}
+
+/* Redesign at a new rate keeps the frequencies; sections above Nyquist are dropped */
+static void test_rate_change(void)
+{
+    loadcell_filter_t f;
+    loadcell_biquad_t section;
+    loadcell_filter_chain_t chain;
+    const float coef[5] = { 0.5f, 0.5f, 0.0f, 0.0f, 0.0f };
+    int dropped;
+
+    one_section(&f, LOADCELL_FILTER_LOWPASS, 30.0f, LOADCELL_FILTER_BUTTERWORTH_Q);
+    loadcell_biquad_design(LOADCELL_FILTER_NOTCH, 200.0f, LOADCELL_FILTER_NOTCH_Q, RATE_HZ, &section);
+    loadcell_filter_add(&f, &section);
+    CHECK(loadcell_biquad_from_coefs(coef, &section) == ESP_OK, "moving average refused");
+    loadcell_filter_add(&f, &section);
+
+    CHECK(loadcell_filter_set_rate(&f, 250.0f, &dropped) == ESP_OK && dropped == 1,
+          "200 Hz notch kept at 250 Hz frames");
+    loadcell_filter_get_chain(&f, &chain);
+    loadcell_biquad_t expected;
+    loadcell_biquad_design(LOADCELL_FILTER_LOWPASS, 30.0f, LOADCELL_FILTER_BUTTERWORTH_Q, 250.0f, &expected);
+    CHECK(chain.num_sections == 2 && chain.sections[0].a1 == expected.a1 &&
+          chain.sections[1].type == LOADCELL_FILTER_CUSTOM && chain.sections[1].b0 == section.b0,
+          "chain after the rate change");
+}
+
+/* Designs and coefficients out of range are refused; full chains report it */
+static void test_bad_sections(void)
+{
+    loadcell_filter_t f;
+    loadcell_biquad_t section;
+    const float unstable[5] = { 1.0f, 0.0f, 0.0f, -1.9f, 1.0f };
+    const float too_big[5] = { 4.5f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+    CHECK(loadcell_biquad_design(LOADCELL_FILTER_LOWPASS, 500.0f, 0.7f, RATE_HZ, &section) == ESP_ERR_INVALID_ARG,
+          "Nyquist corner accepted");
+    CHECK(loadcell_biquad_design(LOADCELL_FILTER_NOTCH, 50.0f, 0.0f, RATE_HZ, &section) == ESP_ERR_INVALID_ARG,
+          "Q 0 accepted");
+    CHECK(loadcell_biquad_design(LOADCELL_FILTER_CUSTOM, 50.0f, 1.0f, RATE_HZ, &section) == ESP_ERR_INVALID_ARG,
+          "custom design accepted");
+    CHECK(loadcell_biquad_from_coefs(unstable, &section) == ESP_ERR_INVALID_ARG, "pole on the unit circle accepted");
+    CHECK(loadcell_biquad_from_coefs(too_big, &section) == ESP_ERR_INVALID_ARG, "coefficient 4.5 accepted");
+
+    one_section(&f, LOADCELL_FILTER_LOWPASS, 20.0f, 0.7f);
+    for (int i = 1; i < LOADCELL_FILTER_MAX_SECTIONS; i++) {
+        CHECK(loadcell_filter_add(&f, &section) == ESP_OK, "section %d refused", i);
+    }
+    CHECK(loadcell_filter_add(&f, &section) == ESP_ERR_NO_MEM, "section beyond the chain accepted");
+}
+
+/* Chains configured through the loadcell API run inside the scan */
+static void test_channel_filters(void)
+{
+    loadcell_t lc;
+    host_spi_reset();
+    CHECK(loadcell_init(&lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    host_ads1261_set_code(1000);
+
+    CHECK(loadcell_add_filter(&lc, 0, LOADCELL_FILTER_LOWPASS, 20.0f, 0.7f) == ESP_ERR_INVALID_STATE,
+          "filter designed without a frame rate");
+    CHECK(loadcell_set_frame_rate(&lc, RATE_HZ) == ESP_OK, "frame rate refused");
+    CHECK(loadcell_add_filter(&lc, LOADCELL_ALL_CHANNELS, LOADCELL_FILTER_HIGHPASS, 1.0f,
+                              LOADCELL_FILTER_BUTTERWORTH_Q) == ESP_OK, "high-pass refused");
+    CHECK(loadcell_clear_filters(&lc, 2) == ESP_OK, "clear refused");
+
+    /* Channel 2 unfiltered; the others drift back to zero from the 1000-code step */
+    loadcell_read(&lc);
+    loadcell_read(&lc);
+    host_ads1261_set_code(3000);
+    loadcell_read(&lc);
+    loadcell_read(&lc);
+    CHECK(lc.measurements[2].force_mn == 3000 * 1000, "unfiltered channel read %ld", (long)lc.measurements[2].force_mn);
+    CHECK(lc.measurements[0].force_mn > 1900 * 1000 && lc.measurements[0].force_mn < 2000 * 1000,
+          "high-passed step read %ld", (long)lc.measurements[0].force_mn);
+
+    for (int i = 0; i < LOADCELL_FILTER_MAX_SECTIONS - 1; i++) {
+        loadcell_add_filter(&lc, 1, LOADCELL_FILTER_NOTCH, 50.0f, LOADCELL_FILTER_NOTCH_Q);
+    }
+    CHECK(loadcell_add_filter(&lc, LOADCELL_ALL_CHANNELS, LOADCELL_FILTER_NOTCH, 60.0f,
+                              LOADCELL_FILTER_NOTCH_Q) == ESP_ERR_NO_MEM, "full chain accepted a section");
+    loadcell_filter_chain_t chain;
+    loadcell_filter_get_chain(&lc.channels[0].filter, &chain);
+    CHECK(chain.num_sections == 1, "partial update of a channel-0 chain");
+
+    loadcell_deinit(&lc);
+}
+
+int main(void)
+{
+    test_lowpass();
+    test_notch();
+    test_dc_exact();
+    test_no_limit_cycle();
+    test_saturation();
+    test_update_while_running();
+    test_rate_change();
+    test_bad_sections();
+    test_channel_filters();
+
+    return test_summary("test_loadcell_filter");
+}
@@ -0,0 +1,279 @@
+/**
+ * @file test_loadcell_job.c
+ * @brief Tare and span calibration jobs on the frame stream
+ *
+ * The accumulator must give the mean, spread and extremes of a code sequence
+ * as a direct computation does, with a glitch replaced rather than averaged.
+ * On a simulated plate with a different, noisy bridge on every channel, a
+ * tare job and then a span job for all channels must finish in exactly the
+ * requested number of loadcell_read() calls, zero and span every channel
+ * from the same frames, and report the injected noise. Point jobs record
+ * multi-point calibration loads until the table is full. Jobs are refused
+ * while one runs or without a tare, and a cancelled job applies nothing.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "loadcell_job.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define CHANNELS        4
+#define NOISE_V         1e-6        /* Input-referred noise, volts RMS */
+#define SPAN_N          1000.0f     /* Known force on each cell for the span job */
+
+static const uint8_t s_inpmux[CHANNELS] = { 0x01, 0x23, 0x45, 0x67 };
+
+/* Unloaded bridge of channel i, and the same bridge carrying SPAN_N */
+static double zero_mv_per_v(int i)
+{
+    return 0.2 + 0.1 * i;
+}
+
+static double loaded_mv_per_v(int i)
+{
+    return zero_mv_per_v(i) + 0.6 + 0.05 * i;
+}
+
+/* Run frames until the job leaves RUNNING; frames read, or -1 past the limit */
+static int run_job(loadcell_t *lc, int limit)
+{
+    uint32_t last = 0;
+    for (int n = 1; n <= limit; n++) {
+        loadcell_read(lc);
+        uint32_t progress;
+        if (loadcell_get_job(lc, &progress, NULL) != LOADCELL_JOB_RUNNING) {
+            return n;
+        }
+        CHECK(progress == last + 1, "progress %lu after %lu", (unsigned long)progress, (unsigned long)last);
+        last = progress;
+    }
+    return -1;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+/* Mean, spread and extremes match a direct computation over the Hampel output; a glitch is replaced */
+static void test_accumulator(void)
+{
+    loadcell_job_acc_t acc;
+    loadcell_job_result_t r;
+    loadcell_despike_t hampel;
+    int32_t codes[1000];
+    double sum = 0.0, sum_sq = 0.0;
+    int32_t lo = INT32_MAX, hi = INT32_MIN;
+
+    loadcell_despike_init(&hampel);
+    loadcell_despike_configure(&hampel, LOADCELL_DESPIKE_HAMPEL, LOADCELL_DESPIKE_WINDOW, LOADCELL_DESPIKE_K);
+    loadcell_job_acc_init(&acc);
+    loadcell_job_acc_finish(&acc, &r);
+    CHECK(r.count == 0 && r.mean == 0 && r.sd == 0.0f, "empty accumulator reported %ld", (long)r.mean);
+
+    uint32_t x = 99;
+    for (int i = 0; i < 1000; i++) {
+        x = x * 1664525u + 1013904223u;
+        int32_t code = -4000000 + (int32_t)(x >> 24) - 128;     /* Uniform in +/-128 around -4e6 */
+        loadcell_job_acc_push(&acc, code);
+        codes[i] = loadcell_despike_run(&hampel, code);
+        sum += codes[i];
+        lo = codes[i] < lo ? codes[i] : lo;
+        hi = codes[i] > hi ? codes[i] : hi;
+    }
+    double mean = sum / 1000;
+    for (int i = 0; i < 1000; i++) {
+        sum_sq += (codes[i] - mean) * (codes[i] - mean);
+    }
+    loadcell_job_acc_finish(&acc, &r);
+    CHECK(r.count == 1000, "count %lu", (unsigned long)r.count);
+    CHECK(r.mean == (int32_t)lround(mean), "mean %ld, expected %.2f", (long)r.mean, mean);
+    CHECK(fabs(r.sd - sqrt(sum_sq / 999)) < 0.01, "sd %.3f, expected %.3f", r.sd, sqrt(sum_sq / 999));
+    CHECK(r.min == lo && r.max == hi, "range %ld..%ld, expected %ld..%ld", (long)r.min, (long)r.max, (long)lo,
+          (long)hi);
+
+    /* A full-scale glitch among the codes does not reach the sums */
+    loadcell_job_acc_push(&acc, 0x7FFFFF);
+    loadcell_job_acc_finish(&acc, &r);
+    CHECK(r.replaced >= 1 && r.max == hi && abs(r.mean - (int32_t)lround(mean)) <= 1,
+          "glitch averaged: max %ld, mean %ld, %lu replaced", (long)r.max, (long)r.mean, (unsigned long)r.replaced);
+}
+
+/* Tare, then span, of every channel from the live frames */
+static void test_tare_and_span(void)
+{
+    loadcell_t lc;
+    loadcell_job_result_t r;
+
+    host_spi_reset();
+    CHECK(loadcell_init(&lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    CHECK(loadcell_get_job(&lc, NULL, NULL) == LOADCELL_JOB_IDLE, "job state after init");
+    for (int i = 0; i < CHANNELS; i++) {
+        host_ads1261_set_bridge(s_inpmux[i], zero_mv_per_v(i));
+    }
+    host_ads1261_set_noise(NOISE_V, 5);
+    loadcell_read(&lc);
+
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_SPAN, LOADCELL_ALL_CHANNELS, SPAN_N, 100) == ESP_ERR_INVALID_STATE,
+          "span accepted before a tare");
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_TARE, 9, 0.0f, 100) == ESP_ERR_INVALID_ARG, "channel 9 accepted");
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_TARE, 0, 0.0f, 0) == ESP_ERR_INVALID_ARG, "zero frames accepted");
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_TARE, 0, 0.0f, LOADCELL_JOB_MAX_FRAMES + 1) == ESP_ERR_INVALID_ARG,
+          "too many frames accepted");
+
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_TARE, LOADCELL_ALL_CHANNELS, 0.0f, 500) == ESP_OK, "tare refused");
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_TARE, 0, 0.0f, 10) == ESP_ERR_INVALID_STATE,
+          "second job accepted while one runs");
+    CHECK(loadcell_get_job_result(&lc, 0, &r) == ESP_ERR_INVALID_STATE, "result readable while running");
+    int frames = run_job(&lc, 1000);
+    CHECK(frames == 500, "tare took %d frames", frames);
+    CHECK(loadcell_get_job(&lc, NULL, NULL) == LOADCELL_JOB_DONE, "tare job %s",
+          loadcell_job_state_name(loadcell_get_job(&lc, NULL, NULL)));
+
+    /* Noise of the code per conversion: input noise through the PGA, as in test_ads1261 */
+    const double expected_sd = NOISE_V * 128 / 5.0 * 8388608.0;
+    for (int i = 0; i < CHANNELS; i++) {
+        CHECK(loadcell_get_job_result(&lc, i, &r) == ESP_OK, "channel %d tare not applied", i);
+        CHECK(abs(r.mean - host_ads1261_ideal_code(s_inpmux[i])) < 4 * expected_sd / sqrt(500),
+              "channel %d mean %ld, bridge at %ld", i, (long)r.mean, (long)host_ads1261_ideal_code(s_inpmux[i]));
+        CHECK(fabs(r.sd - expected_sd) < 0.15 * expected_sd, "channel %d noise %.1f codes, expected %.1f", i, r.sd,
+              expected_sd);
+        CHECK(r.sd_mn == 0.0f, "channel %d noise in N without a span", i);
+        CHECK(loadcell_get_calib_state(&lc, i) == CALIB_STATE_TARE_DONE, "channel %d not tared", i);
+    }
+    printf("loadcell_job: tare of %d channels over %d frames, noise %.1f codes RMS (injected %.1f)\n", CHANNELS,
+           frames, r.sd, expected_sd);
+
+    /* The known force on every cell: one span job */
+    for (int i = 0; i < CHANNELS; i++) {
+        host_ads1261_set_bridge(s_inpmux[i], loaded_mv_per_v(i));
+    }
+    loadcell_read(&lc);
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_SPAN, LOADCELL_ALL_CHANNELS, 0.0f, 100) == ESP_ERR_INVALID_ARG,
+          "span without a force accepted");
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_SPAN, LOADCELL_ALL_CHANNELS, SPAN_N, 500) == ESP_OK, "span refused");
+    frames = run_job(&lc, 1000);
+    CHECK(frames == 500 && loadcell_get_job(&lc, NULL, NULL) == LOADCELL_JOB_DONE, "span job %s after %d frames",
+          loadcell_job_state_name(loadcell_get_job(&lc, NULL, NULL)), frames);
+
+    host_ads1261_set_noise(0.0, 0);
+    loadcell_read(&lc);
+    loadcell_read(&lc);
+    for (int i = 0; i < CHANNELS; i++) {
+        CHECK(loadcell_get_job_result(&lc, i, &r) == ESP_OK, "channel %d span not applied", i);
+        CHECK(loadcell_get_calib_state(&lc, i) == CALIB_STATE_CALIBRATED, "channel %d not calibrated", i);
+        /* Noise in force: the span's mN per code times the code noise */
+        double loaded = host_ads1261_ideal_code(s_inpmux[i]);
+        double mn_per_code = SPAN_N * 1000.0 / (loaded * (1.0 - zero_mv_per_v(i) / loaded_mv_per_v(i)));
+        CHECK(fabs(r.sd_mn - expected_sd * mn_per_code) < 0.2 * expected_sd * mn_per_code,
+              "channel %d noise %.1f mN, expected %.1f", i, r.sd_mn, expected_sd * mn_per_code);
+        int32_t f = lc.measurements[i].force_mn;
+        CHECK(abs(f - (int32_t)(SPAN_N * 1000)) < 1000, "channel %d reads %.3f N under %.0f N", i, f / 1000.0,
+              SPAN_N);
+    }
+    loadcell_deinit(&lc);
+}
+
+/* Point jobs append one load per channel to the multi-point table */
+static void test_points(void)
+{
+    loadcell_t lc;
+    loadcell_job_result_t r;
+    loadcell_cal_set_t set;
+
+    host_spi_reset();
+    CHECK(loadcell_init(&lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    host_ads1261_set_code(50000);
+    loadcell_read(&lc);
+
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_POINT, 1, 10.0f, 20) == ESP_ERR_INVALID_STATE,
+          "point accepted before a tare");
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_TARE, 1, 0.0f, 20) == ESP_OK && run_job(&lc, 100) == 20,
+          "tare of channel 1");
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_POINT, 1, 0.0f, 20) == ESP_ERR_INVALID_ARG,
+          "point without a force accepted");
+
+    /* Nothing on the cell: the point would sit on the tare zero, and its noise has no force scale */
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_POINT, 1, 10.0f, 20) == ESP_OK && run_job(&lc, 100) == 20,
+          "point job at the tare code");
+    CHECK(loadcell_get_job(&lc, NULL, NULL) == LOADCELL_JOB_FAILED &&
+          loadcell_get_job_result(&lc, 1, &r) == ESP_ERR_INVALID_STATE && r.sd_mn == 0.0f,
+          "point at the tare code: job %s, sd %f mN", loadcell_job_state_name(loadcell_get_job(&lc, NULL, NULL)),
+          (double)r.sd_mn);
+    CHECK(loadcell_get_cal_set(&lc, 1, &set) == ESP_OK && set.num_cal_points == 0, "point at the tare code recorded");
+
+    for (int p = 1; p < LOADCELL_CAL_MAX_POINTS; p++) {
+        host_ads1261_set_code(50000 + 10000 * p);
+        loadcell_read(&lc);
+        CHECK(loadcell_start_job(&lc, LOADCELL_JOB_POINT, 1, 5.0f * p, 20) == ESP_OK, "point %d refused", p);
+        CHECK(run_job(&lc, 100) == 20 && loadcell_get_job(&lc, NULL, NULL) == LOADCELL_JOB_DONE, "point %d job %s", p,
+              loadcell_job_state_name(loadcell_get_job(&lc, NULL, NULL)));
+        CHECK(loadcell_get_job_result(&lc, 1, &r) == ESP_OK && r.mean == 10000 * p, "point %d mean %ld", p,
+              (long)r.mean);
+        loadcell_get_cal_set(&lc, 1, &set);
+        const loadcell_cal_point_t *point = &set.cal_points[p - 1];
+        CHECK(set.num_cal_points == p && point->net == 10000 * p && point->force_mn == 5000 * p,
+              "point %d recorded as %ld codes for %ld mN", p, (long)point->net, (long)point->force_mn);
+    }
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_POINT, 1, 100.0f, 20) == ESP_ERR_NO_MEM, "point beyond the table");
+    CHECK(loadcell_build_lut(&lc, 1, LOADCELL_FIT_PIECEWISE) == ESP_OK, "fit of the recorded points");
+    loadcell_deinit(&lc);
+}
+
+/* A cancelled job stops at the next frame and changes nothing */
+static void test_cancel(void)
+{
+    loadcell_t lc;
+    loadcell_job_result_t r;
+
+    host_spi_reset();
+    CHECK(loadcell_init(&lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    host_ads1261_set_code(50000);
+    loadcell_read(&lc);
+
+    CHECK(loadcell_cancel_job(&lc) == ESP_ERR_INVALID_STATE, "cancel accepted without a job");
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_TARE, 2, 0.0f, 100) == ESP_OK, "tare refused");
+    for (int n = 0; n < 10; n++) {
+        loadcell_read(&lc);
+    }
+    CHECK(loadcell_cancel_job(&lc) == ESP_OK, "cancel refused");
+    loadcell_read(&lc);
+    uint32_t progress;
+    CHECK(loadcell_get_job(&lc, &progress, NULL) == LOADCELL_JOB_CANCELLED && progress == 10,
+          "job %s at %lu frames", loadcell_job_state_name(loadcell_get_job(&lc, NULL, NULL)),
+          (unsigned long)progress);
+    loadcell_cal_set_t set;
+    loadcell_get_cal_set(&lc, 2, &set);
+    CHECK(loadcell_get_calib_state(&lc, 2) == CALIB_STATE_UNCALIBRATED && set.hw_offset == 0 && set.version == 0,
+          "cancelled tare applied");
+    CHECK(loadcell_get_job_result(&lc, 2, &r) == ESP_ERR_INVALID_STATE, "result of a cancelled job readable");
+
+    /* The next job starts from empty sums and only covers its channel */
+    CHECK(loadcell_start_job(&lc, LOADCELL_JOB_TARE, 2, 0.0f, 20) == ESP_OK, "tare after cancel refused");
+    CHECK(run_job(&lc, 100) == 20, "second tare length");
+    CHECK(loadcell_get_job_result(&lc, 2, &r) == ESP_OK && r.count == 20 && r.mean == 50000,
+          "second tare: %lu codes, mean %ld", (unsigned long)r.count, (long)r.mean);
+    CHECK(loadcell_get_job_result(&lc, 1, &r) == ESP_ERR_NOT_FOUND, "channel outside the job reported");
+    loadcell_read(&lc);
+    CHECK(lc.measurements[2].raw_adc == 0 && lc.measurements[1].raw_adc == 50000, "tare reached the wrong channel");
+    loadcell_deinit(&lc);
+}
+
+int main(void)
+{
+    test_accumulator();
+    test_tare_and_span();
+    test_points();
+    test_cancel();
+
+    return test_summary("test_loadcell_job");
+}
@@ -0,0 +1,242 @@
+/**
+ * @file test_loadcell_lut.c
+ * @brief Multi-point calibration tables against the curves they are fitted to
+ *
+ * A bridge with a cubic non-linearity is calibrated at a handful of loads;
+ * the cubic fit must then follow the cell across the whole range to within
+ * the table's interpolation error, where a single span leaves the full bow.
+ * A two-point table must reproduce the linear integer scale, codes beyond
+ * the calibrated loads must extrapolate along the end segments, and bad
+ * point sets must be refused. Finally the points are taken through the
+ * simulated ADS1261 with loadcell_tare() / loadcell_add_cal_point() and the
+ * channel is read back through loadcell_build_lut().
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "loadcell_lut.h"
+#include "loadcell_q.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define CELL_FULL_SCALE     4000000     /* Net code at the top load */
+#define CELL_MN_PER_COUNT   0.5         /* Slope at zero: 2 kN at full scale */
+#define CELL_BOW            0.02        /* Cubic error at full scale, relative */
+#define SWEEP_STRIDE        97
+
+/* Cell force (mN) at a net code: linear with a cubic bow */
+static double cell_mn(double net)
+{
+    double u = net / CELL_FULL_SCALE;
+    return CELL_MN_PER_COUNT * net * (1.0 + CELL_BOW * u * u);
+}
+
+/* Inverse by bisection: the net code a force produces */
+static int32_t cell_net(double force_mn)
+{
+    double lo = -2.0 * CELL_FULL_SCALE;
+    double hi = 2.0 * CELL_FULL_SCALE;
+    for (int i = 0; i < 100; i++) {
+        double mid = (lo + hi) / 2;
+        if (cell_mn(mid) < force_mn) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return (int32_t)lround(lo);
+}
+
+/* Worst |table - cell| over codes from..to */
+static double worst_error(const loadcell_lut_t *lut, int32_t from, int32_t to)
+{
+    double worst = 0.0;
+    for (int32_t net = from; net <= to; net += SWEEP_STRIDE) {
+        worst = fmax(worst, fabs(loadcell_lut_eval(lut, net) - cell_mn(net)));
+    }
+    return worst;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_nonlinear_cell(void)
+{
+    /* Zero and five loads up to full scale, as a user would take them */
+    loadcell_cal_point_t points[6];
+    for (int i = 0; i < 6; i++) {
+        points[i].force_mn = (int32_t)lround(cell_mn(CELL_FULL_SCALE) * i / 5);
+        points[i].net = cell_net(points[i].force_mn);
+    }
+
+    /* One span through the top load: the bow stays */
+    loadcell_cal_point_t span[2] = { points[0], points[5] };
+    loadcell_lut_t lut;
+    CHECK(loadcell_lut_build(span, 2, LOADCELL_FIT_PIECEWISE, &lut) == ESP_OK, "linear build failed");
+    double linear = worst_error(&lut, 0, CELL_FULL_SCALE);
+
+    CHECK(loadcell_lut_build(points, 6, LOADCELL_FIT_POLY3, &lut) == ESP_OK, "cubic build failed");
+    double cubic = worst_error(&lut, 0, CELL_FULL_SCALE);
+    /* Left with the chord error of 64 segments on the bow: h^2 / 8 * f'' */
+    double chord = ldexp(1.0, 2 * lut.shift) / 8 * 6 * CELL_MN_PER_COUNT * CELL_BOW / CELL_FULL_SCALE;
+    CHECK(cubic < chord + 1.0, "cubic fit off the cell by %.1f mN (chord error %.1f mN)", cubic, chord);
+
+    CHECK(loadcell_lut_build(points, 6, LOADCELL_FIT_POLY2, &lut) == ESP_OK, "quadratic build failed");
+    double quadratic = worst_error(&lut, 0, CELL_FULL_SCALE);
+    CHECK(quadratic < linear / 4, "quadratic fit off the cell by %.1f mN", quadratic);
+
+    CHECK(loadcell_lut_build(points, 6, LOADCELL_FIT_PIECEWISE, &lut) == ESP_OK, "piecewise build failed");
+    double piecewise = worst_error(&lut, 0, CELL_FULL_SCALE);
+    CHECK(piecewise < linear / 10, "piecewise fit off the cell by %.1f mN", piecewise);
+
+    /* Points given out of order fit the same table */
+    loadcell_cal_point_t shuffled[6] = { points[3], points[0], points[5], points[1], points[4], points[2] };
+    loadcell_lut_t again;
+    CHECK(loadcell_lut_build(shuffled, 6, LOADCELL_FIT_PIECEWISE, &again) == ESP_OK &&
+          memcmp(&lut, &again, sizeof(lut)) == 0, "point order changed the table");
+
+    printf("loadcell_lut: %.0f N cell with %.0f%% bow, worst error: single span %.1f N, "
+           "piecewise %.2f N, quadratic %.2f N, cubic %.4f N\n", cell_mn(CELL_FULL_SCALE) / 1000, CELL_BOW * 100,
+           linear / 1000, piecewise / 1000, quadratic / 1000, cubic / 1000);
+}
+
+/* Two points describe a straight line: the table is the linear scale */
+static void test_two_point_matches_linear(void)
+{
+    const float scale = 1.234567e-4f;
+    loadcell_q_scale_t q;
+    loadcell_q_from_float(scale, &q);
+
+    loadcell_cal_point_t points[2] = {
+        { .net = 0, .force_mn = 0 },
+        { .net = 3000000, .force_mn = loadcell_q_force_mn(&q, 3000000) },
+    };
+    loadcell_lut_t lut;
+    CHECK(loadcell_lut_build(points, 2, LOADCELL_FIT_PIECEWISE, &lut) == ESP_OK, "build failed");
+
+    int32_t worst = 0;
+    for (int32_t net = 0; net <= 3500000; net += SWEEP_STRIDE) {
+        int32_t error = abs(loadcell_lut_eval(&lut, net) - loadcell_q_force_mn(&q, net));
+        worst = error > worst ? error : worst;
+    }
+    /* Knot rounding, interpolation floor and the scale's truncation */
+    CHECK(worst <= 2, "two-point table off the linear scale by %ld mN", (long)worst);
+}
+
+static void test_extrapolation(void)
+{
+    loadcell_cal_point_t points[3] = {
+        { .net = 0, .force_mn = 0 },
+        { .net = 100000, .force_mn = 50000 },
+        { .net = 200000, .force_mn = 250000 },
+    };
+    loadcell_lut_t lut;
+    CHECK(loadcell_lut_build(points, 3, LOADCELL_FIT_PIECEWISE, &lut) == ESP_OK, "build failed");
+
+    /* Below the tare the first slope continues, above the top load the last one */
+    CHECK(abs(loadcell_lut_eval(&lut, -100000) + 50000) <= 1, "below range: %ld mN",
+          (long)loadcell_lut_eval(&lut, -100000));
+    CHECK(abs(loadcell_lut_eval(&lut, 300000) - 450000) <= 1, "above range: %ld mN",
+          (long)loadcell_lut_eval(&lut, 300000));
+    CHECK(loadcell_lut_eval(&lut, INT32_MAX) == INT32_MAX, "far code did not saturate");
+    CHECK(llabs(loadcell_lut_eval(&lut, INT32_MIN) - INT32_MIN / 2) <= 1, "far negative code: %ld mN",
+          (long)loadcell_lut_eval(&lut, INT32_MIN));
+}
+
+static void test_bad_points(void)
+{
+    loadcell_cal_point_t points[4] = {
+        { .net = 0, .force_mn = 0 },
+        { .net = 1000, .force_mn = 500 },
+        { .net = 1000, .force_mn = 600 },
+        { .net = 3000, .force_mn = 1500 },
+    };
+    loadcell_lut_t lut;
+
+    CHECK(loadcell_lut_build(points, 1, LOADCELL_FIT_PIECEWISE, &lut) == ESP_ERR_INVALID_ARG, "one point accepted");
+    CHECK(loadcell_lut_build(points, 2, LOADCELL_FIT_POLY2, &lut) == ESP_ERR_INVALID_ARG,
+          "quadratic through two points accepted");
+    CHECK(loadcell_lut_build(points, 4, LOADCELL_FIT_PIECEWISE, &lut) == ESP_ERR_INVALID_ARG,
+          "two loads on one code accepted");
+    CHECK(loadcell_lut_build(points, 2, (loadcell_fit_t)1, &lut) == ESP_ERR_INVALID_ARG, "unknown fit accepted");
+    points[2].net = 2000;
+    CHECK(loadcell_lut_build(points, 4, LOADCELL_FIT_POLY3, &lut) == ESP_OK, "valid cubic refused");
+}
+
+/* Apply a code to the simulated input and flush the conversion already under way */
+static void apply_code(loadcell_t *lc, uint8_t channel, int32_t code)
+{
+    loadcell_measurement_t meas;
+    host_ads1261_set_code(code);
+    loadcell_read_channel(lc, channel, &meas);
+}
+
+/* The whole flow on a simulated channel: tare, loads, fit, read */
+static void test_channel_calibration(void)
+{
+    loadcell_t lc;
+    loadcell_measurement_t meas;
+    const int32_t zero = 150000;
+
+    host_spi_reset();
+    CHECK(loadcell_init(&lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+
+    apply_code(&lc, 1, zero + cell_net(300000));
+    CHECK(loadcell_add_cal_point(&lc, 1, 300.0f, 4) == ESP_ERR_INVALID_STATE, "point accepted before tare");
+
+    apply_code(&lc, 1, zero);
+    CHECK(loadcell_tare(&lc, 1, 4) == ESP_OK, "tare failed");
+    CHECK(loadcell_build_lut(&lc, 1, LOADCELL_FIT_POLY2) == ESP_ERR_INVALID_STATE, "fit without points accepted");
+
+    const float loads_n[] = { 500.0f, 1000.0f, 1500.0f, 2000.0f };
+    for (int i = 0; i < 4; i++) {
+        apply_code(&lc, 1, zero + cell_net(loads_n[i] * 1000.0));
+        CHECK(loadcell_add_cal_point(&lc, 1, loads_n[i], 4) == ESP_OK, "point %d refused", i);
+    }
+    CHECK(loadcell_build_lut(&lc, 1, LOADCELL_FIT_POLY3) == ESP_OK, "fit failed");
+    CHECK(loadcell_get_calib_state(&lc, 1) == CALIB_STATE_CALIBRATED, "channel not calibrated");
+
+    int32_t worst = 0;
+    for (double force = 0.0; force <= 2000000.0; force += 62500.0) {
+        apply_code(&lc, 1, zero + cell_net(force));
+        CHECK(loadcell_read_channel(&lc, 1, &meas) == ESP_OK, "read failed");
+        int32_t error = abs(meas.force_mn - (int32_t)lround(force));
+        worst = error > worst ? error : worst;
+    }
+    /* Chord error of the table on the bow, as in test_nonlinear_cell() */
+    CHECK(worst <= 10, "calibrated channel off by %ld mN", (long)worst);
+
+    /* A new tare invalidates the points: the linear path is back */
+    apply_code(&lc, 1, zero);
+    CHECK(loadcell_tare(&lc, 1, 4) == ESP_OK, "re-tare failed");
+    loadcell_cal_set_t set;
+    loadcell_get_cal_set(&lc, 1, &set);
+    CHECK(!set.lut_active && set.num_cal_points == 0, "table survived a tare");
+
+    for (int i = 0; i < LOADCELL_CAL_MAX_POINTS - 1; i++) {
+        apply_code(&lc, 1, zero + 10000 * (i + 1));
+        CHECK(loadcell_add_cal_point(&lc, 1, 10.0f * (i + 1), 4) == ESP_OK, "point %d refused", i);
+    }
+    CHECK(loadcell_add_cal_point(&lc, 1, 100.0f, 4) == ESP_ERR_NO_MEM, "point beyond the table accepted");
+
+    loadcell_deinit(&lc);
+}
+
+int main(void)
+{
+    test_nonlinear_cell();
+    test_two_point_matches_linear();
+    test_extrapolation();
+    test_bad_points();
+    test_channel_calibration();
+
+    return test_summary("test_loadcell_lut");
+}
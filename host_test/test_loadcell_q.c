@@ -0,0 +1,190 @@
+/**
+ * @file test_loadcell_q.c
+ * @brief Integer force path against the float path it replaces
+ *
+ * The float reference below is the calibration and BLE quantization code as
+ * it was before the integer path (host SSE floats round exactly like the
+ * C6's IEEE single soft-float). Every 24-bit code of a hardware-calibrated
+ * channel and a dense sweep of software-scaled channels are run through
+ * both. The integer 0.1 N values must equal the exact (128-bit) truncation
+ * everywhere, and may differ from the float ones only where float rounding
+ * lands on the wrong side of a 0.1 N boundary.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include "loadcell_q.h"
+#include "test_check.h"
+
+#define CODE_MIN            (-0x800000)
+#define CODE_MAX            0x7FFFFF
+#define SWEEP_STRIDE        7
+#define FLOAT_REL_ERROR     (1.0 / (1 << 21))   /* Two single roundings, with margin */
+
+/* ============================================================================
+ * Float reference (previous loadcell_apply_calibration / ble_force_notify)
+ * ============================================================================ */
+
+static float ref_force_n(bool hw_calibrated, int32_t raw, int32_t offset, float scale)
+{
+    if (hw_calibrated) {
+        return (float)raw * (1.0f / 1000);
+    }
+    return (float)(raw - offset) * scale;
+}
+
+static int16_t ref_deci_newtons(float force_n)
+{
+    int32_t scaled = (int32_t)(force_n * 10.0f);
+    if (scaled > 32767) scaled = 32767;
+    if (scaled < -32768) scaled = -32768;
+    return (int16_t)scaled;
+}
+
+/* Exact truncation of net * scale in 0.1 N, clamped like the quantizer */
+static int32_t exact_deci_newtons(const loadcell_q_scale_t *q, int32_t net)
+{
+    __int128 num = (__int128)net * q->mant * 10;
+    __int128 deci = num >= 0 ? num >> q->shift : -((-num) >> q->shift);
+    return deci > INT16_MAX ? INT16_MAX : deci < INT16_MIN ? INT16_MIN : (int32_t)deci;
+}
+
+/* True if value (in 0.1 N) is close enough to an integer for float rounding to cross it */
+static bool near_boundary(long double value)
+{
+    long double distance = fabsl(value - roundl(value));
+    return distance <= fabsl(value) * FLOAT_REL_ERROR + 1e-9L;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_scale_conversion(void)
+{
+    const float scales[] = { 1.0f, 0.001f, 1.234567e-4f, -3.3e-5f, 7.77f, 1e-9f, 0.1f };
+    loadcell_q_scale_t q;
+
+    for (size_t i = 0; i < sizeof(scales) / sizeof(scales[0]); i++) {
+        loadcell_q_from_float(scales[i], &q);
+        CHECK(ldexp((double)q.mant, -(int)q.shift) == (double)scales[i], "scale %g not exact: %ld >> %u",
+              scales[i], (long)q.mant, q.shift);
+        CHECK(labs(q.mant) < (1 << 24), "mantissa %ld wider than 24 bits", (long)q.mant);
+    }
+
+    loadcell_q_from_float(0.0f, &q);
+    CHECK(q.mant == 0 && loadcell_q_force_mn(&q, 123456) == 0, "zero scale");
+    loadcell_q_from_float(NAN, &q);
+    CHECK(q.mant == 0, "NaN scale gave mantissa %ld", (long)q.mant);
+    loadcell_q_from_float(1e-30f, &q);
+    CHECK(loadcell_q_force_mn(&q, CODE_MAX) == 0, "vanishing scale");
+    loadcell_q_from_float(1e30f, &q);
+    CHECK(loadcell_q_force_mn(&q, 1) == INT32_MAX && loadcell_q_force_mn(&q, -1) == INT32_MIN,
+          "huge scale did not saturate");
+}
+
+static void test_quantize(void)
+{
+    CHECK(loadcell_q_deci_newtons(123456) == 1234, "123.456 N");
+    CHECK(loadcell_q_deci_newtons(-123456) == -1234, "-123.456 N truncates toward zero");
+    CHECK(loadcell_q_deci_newtons(99) == 0 && loadcell_q_deci_newtons(-99) == 0, "below 0.1 N");
+    CHECK(loadcell_q_deci_newtons(3276700) == 32767 && loadcell_q_deci_newtons(3276899) == 32767, "top of range");
+    CHECK(loadcell_q_deci_newtons(INT32_MAX) == INT16_MAX, "positive clamp");
+    CHECK(loadcell_q_deci_newtons(INT32_MIN) == INT16_MIN, "negative clamp");
+    CHECK(loadcell_q_deci_newtons(-3276899) == -32768, "bottom of range");
+}
+
+/* FSCAL-normalized channel: codes are millinewtons, the integer path is the identity */
+static void test_hw_calibrated_sweep(void)
+{
+    uint32_t mismatches = 0;
+    uint32_t unexplained = 0;
+
+    for (int32_t raw = CODE_MIN; raw <= CODE_MAX; raw++) {
+        int16_t deci = loadcell_q_deci_newtons(raw);
+        int16_t ref = ref_deci_newtons(ref_force_n(true, raw, 0, 0.0f));
+        int32_t exact = raw / 100 > INT16_MAX ? INT16_MAX : raw / 100 < INT16_MIN ? INT16_MIN : raw / 100;
+        if (deci != exact) {
+            unexplained++;
+        }
+        if (deci != ref) {
+            mismatches++;
+            if (abs(deci - ref) != 1 || !near_boundary((long double)raw / 100)) {
+                unexplained++;
+            }
+        }
+    }
+
+    CHECK(unexplained == 0, "%lu codes differ from the exact value or away from a 0.1 N boundary",
+          (unsigned long)unexplained);
+    printf("loadcell_q: hardware-calibrated, %d codes: %lu differ from float (each a float rounding across a 0.1 N boundary)\n",
+           CODE_MAX - CODE_MIN + 1, (unsigned long)mismatches);
+}
+
+/* Software-scaled channels: net code times the calibrated scale */
+static void test_sw_scaled_sweep(void)
+{
+    static const struct {
+        float scale;
+        int32_t offset;
+    } cases[] = {
+        { 1.234567e-4f, 0 },            /* Typical bridge: ~0.12 mN per count */
+        { 3.906250e-3f, -15000 },       /* Power of two: float is exact */
+        { 1.0f / 3.0f, 250000 },        /* Coarse span, large offset */
+        { -2.5e-4f, 4000000 },          /* Bridge wired inverted */
+        { 1.0e-2f, -8000000 },          /* Net codes beyond 24 bits */
+    };
+    uint32_t compared = 0;
+    uint32_t mismatches = 0;
+    uint32_t mn_off = 0;
+    uint32_t unexplained = 0;
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        loadcell_q_scale_t q;
+        loadcell_q_from_float(cases[c].scale, &q);
+
+        for (int32_t raw = CODE_MIN; raw <= CODE_MAX; raw += SWEEP_STRIDE) {
+            int32_t net = raw - cases[c].offset;
+            int32_t mn = loadcell_q_force_mn(&q, net);
+            int16_t deci = loadcell_q_deci_newtons(mn);
+            float ref_n = ref_force_n(false, raw, cases[c].offset, cases[c].scale);
+            int16_t ref = ref_deci_newtons(ref_n);
+            compared++;
+
+            if (deci != exact_deci_newtons(&q, net)) {
+                unexplained++;
+            }
+            /* Millinewtons agree with the float force to its own precision, short of saturation */
+            double ref_mn = (double)ref_n * 1000.0;
+            if (fabs(ref_mn) < INT32_MAX && fabs(mn - ref_mn) > 1.0 + fabs(ref_mn) * FLOAT_REL_ERROR) {
+                mn_off++;
+            }
+            if (deci != ref) {
+                mismatches++;
+                long double value = (long double)net * cases[c].scale * 10;
+                if (abs(deci - ref) != 1 || !near_boundary(value)) {
+                    unexplained++;
+                }
+            }
+        }
+    }
+
+    CHECK(unexplained == 0, "%lu values differ from the exact value or away from a 0.1 N boundary",
+          (unsigned long)unexplained);
+    CHECK(mn_off == 0, "%lu millinewton values off the float force", (unsigned long)mn_off);
+    printf("loadcell_q: software-scaled, %lu values: %lu differ from float (each a float rounding across a 0.1 N boundary)\n",
+           (unsigned long)compared, (unsigned long)mismatches);
+}
+
+int main(void)
+{
+    test_scale_conversion();
+    test_quantize();
+    test_hw_calibrated_sweep();
+    test_sw_scaled_sweep();
+
+    return test_summary("test_loadcell_q");
+}
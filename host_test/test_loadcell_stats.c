@@ -0,0 +1,230 @@
+/**
+ * @file test_loadcell_stats.c
+ * @brief Streaming statistics against two-pass reference values
+ *
+ * Feeds noisy force streams far from zero (where a naive sum of squares
+ * loses the variance) and compares every snapshot with a two-pass double
+ * computation over the whole stream and over the last window, across the
+ * block and window boundaries. Reset requests are checked from the reader
+ * side, and a writer thread racing a snapshot reader checks that snapshots
+ * are never torn. The per-sample cost is printed.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include "esp_cpu.h"
+#include "loadcell_stats.h"
+#include "test_check.h"
+
+#define STREAM_LEN          5000
+#define STRESS_SAMPLES      2000000
+#define TIMING_SAMPLES      1000000
+
+static loadcell_stats_acc_t s_acc;
+static int32_t s_stream[STREAM_LEN];
+
+/* Deterministic noise around a loaded plate, with a step half way */
+static void make_stream(int32_t base_mn, int32_t noise_mn)
+{
+    uint32_t lcg = 12345;
+    for (int i = 0; i < STREAM_LEN; i++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        int32_t noise = (int32_t)(lcg >> 8) % (noise_mn + 1) - noise_mn / 2;
+        s_stream[i] = base_mn + noise + (i >= STREAM_LEN / 2 ? 25000 : 0);
+    }
+}
+
+/* Two-pass mean / population std / min / max of s_stream[from, to) in Newtons */
+static void reference(int from, int to, double *mean, double *std, double *min, double *max)
+{
+    double sum = 0.0;
+    *min = INFINITY;
+    *max = -INFINITY;
+    for (int i = from; i < to; i++) {
+        sum += s_stream[i];
+        *min = fmin(*min, s_stream[i]);
+        *max = fmax(*max, s_stream[i]);
+    }
+    *mean = sum / (to - from);
+    double sq = 0.0;
+    for (int i = from; i < to; i++) {
+        sq += (s_stream[i] - *mean) * (s_stream[i] - *mean);
+    }
+    *std = sqrt(sq / (to - from)) / 1000.0;
+    *mean /= 1000.0;
+    *min /= 1000.0;
+    *max /= 1000.0;
+}
+
+static bool close_to(double value, double expected, double tolerance)
+{
+    return fabs(value - expected) <= tolerance;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void test_against_two_pass(void)
+{
+    loadcell_stats_t st;
+    int bad_total = 0;
+    int bad_window = 0;
+
+    make_stream(2000000, 400);              /* 2 kN +- 0.2 N */
+    loadcell_stats_init(&s_acc);
+    loadcell_stats_read(&s_acc, &st);
+    CHECK(st.sample_count == 0 && st.window_count == 0, "fresh accumulator has %lu samples",
+          (unsigned long)st.sample_count);
+
+    for (int n = 1; n <= STREAM_LEN; n++) {
+        loadcell_stats_update(&s_acc, s_stream[n - 1]);
+        loadcell_stats_read(&s_acc, &st);
+
+        double mean, std, min, max;
+        reference(0, n, &mean, &std, &min, &max);
+        /* Floats in Newtons around 2 kN: ~0.25 mN resolution */
+        if (st.sample_count != (uint32_t)n || !close_to(st.avg_force, mean, 5e-4) ||
+            !close_to(st.std_force, std, 1e-5 + std * 1e-5) || !close_to(st.min_force, min, 5e-4) ||
+            !close_to(st.max_force, max, 5e-4) || !close_to(st.peak_to_peak, max - min, 1e-6)) {
+            if (bad_total++ == 0) {
+                printf("  n=%d: avg %.6f/%.6f std %.6f/%.6f min %.4f/%.4f max %.4f/%.4f\n", n, st.avg_force, mean,
+                       st.std_force, std, st.min_force, min, st.max_force, max);
+            }
+        }
+
+        int w = n < LOADCELL_STATS_WINDOW ? n : LOADCELL_STATS_WINDOW;
+        reference(n - w, n, &mean, &std, &min, &max);
+        if (st.window_count != (uint32_t)w || !close_to(st.window_avg, mean, 5e-4) ||
+            !close_to(st.window_std, std, 1e-5 + std * 1e-5) || !close_to(st.window_min, min, 5e-4) ||
+            !close_to(st.window_max, max, 5e-4)) {
+            if (bad_window++ == 0) {
+                printf("  n=%d window: avg %.6f/%.6f std %.6f/%.6f min %.4f/%.4f max %.4f/%.4f\n", n, st.window_avg,
+                       mean, st.window_std, std, st.window_min, min, st.window_max, max);
+            }
+        }
+    }
+    CHECK(bad_total == 0, "%d of %d snapshots off the two-pass statistics", bad_total, STREAM_LEN);
+    CHECK(bad_window == 0, "%d of %d snapshots off the two-pass window statistics", bad_window, STREAM_LEN);
+}
+
+static void test_monotonic_window(void)
+{
+    loadcell_stats_t st;
+
+    /* Falling then rising ramps exercise both queues' expiry */
+    loadcell_stats_init(&s_acc);
+    for (int i = 0; i < 1000; i++) {
+        loadcell_stats_update(&s_acc, -1000 * i);
+    }
+    loadcell_stats_read(&s_acc, &st);
+    CHECK(close_to(st.window_max, -(1000 - LOADCELL_STATS_WINDOW), 1e-6) && close_to(st.window_min, -999, 1e-6),
+          "falling ramp window %.3f..%.3f", st.window_min, st.window_max);
+    for (int i = 0; i < 1000; i++) {
+        loadcell_stats_update(&s_acc, 1000 * i);
+    }
+    loadcell_stats_read(&s_acc, &st);
+    CHECK(close_to(st.window_min, 1000 - LOADCELL_STATS_WINDOW, 1e-6) && close_to(st.window_max, 999, 1e-6),
+          "rising ramp window %.3f..%.3f", st.window_min, st.window_max);
+    CHECK(close_to(st.min_force, -999, 1e-6) && close_to(st.max_force, 999, 1e-6) &&
+          close_to(st.peak_to_peak, 1998, 1e-6), "range %.3f..%.3f", st.min_force, st.max_force);
+}
+
+static void test_reset_request(void)
+{
+    loadcell_stats_t st;
+
+    loadcell_stats_init(&s_acc);
+    for (int i = 0; i < 300; i++) {
+        loadcell_stats_update(&s_acc, 5000 + i);
+    }
+    loadcell_stats_request_reset(&s_acc);
+    loadcell_stats_read(&s_acc, &st);
+    CHECK(st.sample_count == 0 && st.avg_force == 0.0f, "pending reset still reads %lu samples",
+          (unsigned long)st.sample_count);
+
+    loadcell_stats_update(&s_acc, -7000);
+    loadcell_stats_update(&s_acc, -9000);
+    loadcell_stats_read(&s_acc, &st);
+    CHECK(st.sample_count == 2 && st.window_count == 2, "%lu samples after reset", (unsigned long)st.sample_count);
+    CHECK(close_to(st.avg_force, -8.0, 1e-6) && close_to(st.std_force, 1.0, 1e-6) && close_to(st.min_force, -9.0, 1e-6)
+          && close_to(st.max_force, -7.0, 1e-6), "after reset: avg %.4f std %.4f min %.4f max %.4f", st.avg_force,
+          st.std_force, st.min_force, st.max_force);
+}
+
+/* ============================================================================
+ * Writer / reader race
+ * ============================================================================ */
+
+static _Atomic bool s_writer_done;
+
+/* Ramp of 1 mN per sample: every consistent snapshot satisfies exact relations */
+static void *writer_thread(void *arg)
+{
+    for (int32_t i = 0; i < STRESS_SAMPLES; i++) {
+        loadcell_stats_update(&s_acc, i);
+    }
+    atomic_store(&s_writer_done, true);
+    return NULL;
+}
+
+static void test_concurrent_snapshots(void)
+{
+    pthread_t writer;
+    uint32_t snapshots = 0;
+    uint32_t torn = 0;
+    uint32_t last_count = 0;
+
+    loadcell_stats_init(&s_acc);
+    atomic_store(&s_writer_done, false);
+    pthread_create(&writer, NULL, writer_thread, NULL);
+
+    while (!atomic_load(&s_writer_done)) {
+        loadcell_stats_t st;
+        loadcell_stats_read(&s_acc, &st);
+        if (st.sample_count == 0) {
+            continue;
+        }
+        snapshots++;
+        /* Max is the newest sample, the window spans the newest window_count, min is sample 0 */
+        double newest = (st.sample_count - 1) / 1000.0;
+        uint32_t w = st.sample_count < LOADCELL_STATS_WINDOW ? st.sample_count : LOADCELL_STATS_WINDOW;
+        if (st.sample_count < last_count || st.window_count != w || st.min_force != 0.0f ||
+            !close_to(st.max_force, newest, 1e-3) || !close_to(st.window_max, newest, 1e-3) ||
+            !close_to(st.window_min, newest - (w - 1) / 1000.0, 1e-3)) {
+            torn++;
+        }
+        last_count = st.sample_count;
+    }
+    pthread_join(writer, NULL);
+
+    CHECK(torn == 0, "%lu of %lu snapshots inconsistent", (unsigned long)torn, (unsigned long)snapshots);
+    printf("loadcell_stats: %lu snapshots taken during %d updates\n", (unsigned long)snapshots, STRESS_SAMPLES);
+}
+
+static void test_update_cost(void)
+{
+    loadcell_stats_init(&s_acc);
+    make_stream(150000, 2000);
+
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < TIMING_SAMPLES; i++) {
+        loadcell_stats_update(&s_acc, s_stream[i % STREAM_LEN]);
+    }
+    double cycles = (double)(uint32_t)(esp_cpu_get_cycle_count() - start) / TIMING_SAMPLES;
+    printf("loadcell_stats: %.1f host cycles per sample (block fold every %d)\n", cycles, LOADCELL_STATS_BLOCK);
+}
+
+int main(void)
+{
+    test_against_two_pass();
+    test_monotonic_window();
+    test_reset_request();
+    test_concurrent_snapshots();
+    test_update_cost();
+
+    return test_summary("test_loadcell_stats");
+}
@@ -0,0 +1,208 @@
+/**
+ * @file test_loadcell_zero.c
+ * @brief Automatic zero tracking on a simulated plate
+ *
+ * Every channel is tared and spanned through OFCAL/FSCAL, then the bridge
+ * codes drift slowly while the plate stays unloaded: with tracking on, the
+ * forces must stay near zero through the drift and settle to within the
+ * rounding of a correction once it stops. A load above the band, or a total
+ * that moves within it, must freeze the offsets; the per-channel limit caps
+ * the correction; a tare starts the tracked amount again from zero.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ads1261.h"
+#include "loadcell.h"
+#include "host_spi.h"
+#include "host_ads1261.h"
+#include "test_check.h"
+
+#define ZERO_CODE       100000      /* Bridge code with the plate unloaded */
+#define SPAN_CODES      500000      /* Codes of the calibration load */
+#define SPAN_N          1000.0f     /* Calibration load: FSCAL at twice unity, 2 mN per input code */
+#define DRIFT_CODES     300         /* Drift of every bridge over the test: 600 mN per channel */
+
+/* Apply a code to every channel and flush the scan already under way */
+static void apply_code(loadcell_t *lc, int32_t code)
+{
+    host_ads1261_set_code(code);
+    loadcell_read(lc);
+}
+
+/* A plate with every channel tared at ZERO_CODE and spanned in hardware */
+static void setup_plate(loadcell_t *lc)
+{
+    host_spi_reset();
+    CHECK(loadcell_init(lc, SPI2_HOST, -1, -1, ADS1261_PGA_GAIN_128, ADS1261_DR_40000_SPS) == ESP_OK,
+          "loadcell_init failed");
+    for (uint8_t i = 0; i < lc->num_channels; i++) {
+        apply_code(lc, ZERO_CODE);
+        CHECK(loadcell_tare(lc, i, 4) == ESP_OK, "tare of channel %u failed", i);
+        apply_code(lc, ZERO_CODE + SPAN_CODES);
+        CHECK(loadcell_calibrate(lc, i, SPAN_N, 4) == ESP_OK, "span of channel %u failed", i);
+        loadcell_cal_set_t set;
+        loadcell_get_cal_set(lc, i, &set);
+        CHECK(set.hw_calibrated, "channel %u spanned in software", i);
+    }
+    apply_code(lc, ZERO_CODE);
+}
+
+/* Published offset of a channel */
+static int32_t offset_raw(loadcell_t *lc, uint8_t channel)
+{
+    loadcell_cal_set_t set;
+    loadcell_get_cal_set(lc, channel, &set);
+    return set.offset_raw;
+}
+
+/* Published zero-tracking correction of a channel since its tare (mN) */
+static int32_t tracked_mn(loadcell_t *lc, uint8_t channel)
+{
+    loadcell_cal_set_t set;
+    loadcell_get_cal_set(lc, channel, &set);
+    return set.zero_tracked_mn;
+}
+
+/* Largest |force| over the channels of the last frame */
+static int32_t worst_force(const loadcell_t *lc)
+{
+    int32_t worst = 0;
+    for (int i = 0; i < lc->num_channels; i++) {
+        int32_t f = abs(lc->measurements[i].force_mn);
+        worst = f > worst ? f : worst;
+    }
+    return worst;
+}
+
+/* Drift every bridge by DRIFT_CODES over the given frames, then hold; worst force during the drift */
+static int32_t run_drift(loadcell_t *lc, int drift_frames, int hold_frames)
+{
+    int32_t worst = 0;
+    for (int n = 1; n <= drift_frames; n++) {
+        host_ads1261_set_code(ZERO_CODE + (int32_t)((int64_t)DRIFT_CODES * n / drift_frames));
+        loadcell_read(lc);
+        int32_t f = worst_force(lc);
+        worst = f > worst ? f : worst;
+    }
+    for (int n = 0; n < hold_frames; n++) {
+        loadcell_read(lc);
+    }
+    return worst;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+/* Off by default: the drift shows in the forces and the offsets stay put */
+static void test_off_by_default(void)
+{
+    loadcell_t lc;
+    setup_plate(&lc);
+    CHECK(atomic_load(&lc.zero_band_mn) == 0, "tracking on after init");
+    run_drift(&lc, 2000, 200);
+    for (int i = 0; i < lc.num_channels; i++) {
+        CHECK(offset_raw(&lc, i) == 0 && tracked_mn(&lc, i) == 0, "channel %d moved", i);
+        CHECK(lc.measurements[i].force_mn == 2 * DRIFT_CODES, "channel %d reads %ld mN", i,
+              (long)lc.measurements[i].force_mn);
+    }
+    CHECK(lc.zero_updates == 0, "%lu corrections while off", (unsigned long)lc.zero_updates);
+    loadcell_deinit(&lc);
+}
+
+/* A slow drift is followed, and the zero settles once it stops */
+static void test_follows_drift(void)
+{
+    loadcell_t lc;
+    setup_plate(&lc);
+    CHECK(loadcell_set_zero_tracking(&lc, -1, LOADCELL_ZERO_LIMIT_MN) == ESP_ERR_INVALID_ARG, "negative band accepted");
+    CHECK(loadcell_set_zero_tracking(&lc, LOADCELL_ZERO_BAND_MN, -1) == ESP_ERR_INVALID_ARG, "negative limit accepted");
+    CHECK(loadcell_set_zero_tracking(&lc, LOADCELL_ZERO_BAND_MN, LOADCELL_ZERO_LIMIT_MN) == ESP_OK, "tracking refused");
+
+    /* 600 mN per channel over 100 blocks: beyond the band in total, were it not tracked */
+    int32_t during = run_drift(&lc, 100 * LOADCELL_ZERO_BLOCK_FRAMES, 40 * LOADCELL_ZERO_BLOCK_FRAMES);
+    printf("loadcell_zero: %d mN drift per channel, worst %ld mN while drifting, %ld mN after settling\n",
+           2 * DRIFT_CODES, (long)during, (long)worst_force(&lc));
+    CHECK(during < 2 * DRIFT_CODES / 4, "drift reached %ld mN", (long)during);
+    /* A correction rounds a quarter of the mean: it stops within two codes */
+    CHECK(worst_force(&lc) <= 4, "settled at %ld mN", (long)worst_force(&lc));
+    for (int i = 0; i < lc.num_channels; i++) {
+        CHECK(abs(tracked_mn(&lc, i) - 2 * DRIFT_CODES) <= 4, "channel %d tracked %ld mN", i,
+              (long)tracked_mn(&lc, i));
+        /* Conversions come out of FSCAL in millinewtons, so the offset is the tracked force */
+        CHECK(offset_raw(&lc, i) == tracked_mn(&lc, i), "channel %d offset %ld for %ld mN", i,
+              (long)offset_raw(&lc, i), (long)tracked_mn(&lc, i));
+    }
+    CHECK(lc.zero_updates >= 100, "%lu corrections", (unsigned long)lc.zero_updates);
+
+    /* A tare starts the tracked amount again */
+    apply_code(&lc, ZERO_CODE + DRIFT_CODES);
+    CHECK(loadcell_tare(&lc, 0, 4) == ESP_OK, "re-tare failed");
+    CHECK(tracked_mn(&lc, 0) == 0 && offset_raw(&lc, 0) == 0, "tracked zero survived the tare");
+    loadcell_deinit(&lc);
+}
+
+/* Loads, and a total moving within the band, freeze the offsets */
+static void test_freezes_under_load(void)
+{
+    loadcell_t lc;
+    setup_plate(&lc);
+    loadcell_set_zero_tracking(&lc, LOADCELL_ZERO_BAND_MN, LOADCELL_ZERO_LIMIT_MN);
+
+    /* 40 N standing on the plate, 4 x 10 N: far outside the band */
+    host_ads1261_set_code(ZERO_CODE + 5000);
+    for (int n = 0; n < 20 * LOADCELL_ZERO_BLOCK_FRAMES; n++) {
+        loadcell_read(&lc);
+    }
+    CHECK(lc.zero_updates == 0 && offset_raw(&lc, 0) == 0, "tracked under load: %lu corrections",
+          (unsigned long)lc.zero_updates);
+
+    /* Within the band but swaying by more than it over each block: never quiet */
+    for (int n = 0; n < 20 * LOADCELL_ZERO_BLOCK_FRAMES; n++) {
+        host_ads1261_set_code(ZERO_CODE + (n % 32 < 16 ? -200 : 200));
+        loadcell_read(&lc);
+    }
+    CHECK(lc.zero_updates == 0, "tracked a moving total: %lu corrections", (unsigned long)lc.zero_updates);
+
+    /* Quiet again: tracking resumes after one full block */
+    apply_code(&lc, ZERO_CODE + 20);
+    for (int n = 0; n < 2 * LOADCELL_ZERO_BLOCK_FRAMES; n++) {
+        loadcell_read(&lc);
+    }
+    CHECK(lc.zero_updates >= 1 && offset_raw(&lc, 0) > 0, "no correction once quiet");
+    loadcell_deinit(&lc);
+}
+
+/* The correction stops at the limit; a drift past it needs a tare */
+static void test_limit(void)
+{
+    loadcell_t lc;
+    setup_plate(&lc);
+    loadcell_set_zero_tracking(&lc, LOADCELL_ZERO_BAND_MN, 100);
+    run_drift(&lc, 100 * LOADCELL_ZERO_BLOCK_FRAMES, 40 * LOADCELL_ZERO_BLOCK_FRAMES);
+    for (int i = 0; i < lc.num_channels; i++) {
+        CHECK(tracked_mn(&lc, i) > 0 && tracked_mn(&lc, i) <= 100,
+              "channel %d tracked %ld mN past the limit", i, (long)tracked_mn(&lc, i));
+    }
+
+    /* Switching off leaves the offsets where they are */
+    int32_t offset = offset_raw(&lc, 0);
+    loadcell_set_zero_tracking(&lc, 0, LOADCELL_ZERO_LIMIT_MN);
+    run_drift(&lc, 10 * LOADCELL_ZERO_BLOCK_FRAMES, 0);
+    CHECK(offset_raw(&lc, 0) == offset, "offset moved while off");
+    loadcell_deinit(&lc);
+}
+
+int main(void)
+{
+    test_off_by_default();
+    test_follows_drift();
+    test_freezes_under_load();
+    test_limit();
+
+    return test_summary("test_loadcell_zero");
+}
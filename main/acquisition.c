@@ -0,0 +1,446 @@
+/**
+ * @file acquisition.c
+ * @brief Timer-paced loadcell acquisition with absolute deadlines
+ */
+
+#include <string.h>
+#include <math.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "acquisition.h"
+
+static const char *TAG = "Acquisition";
+
+#define ACQUISITION_TASK_STACK      4096
+#define ACQUISITION_STEP_TIMEOUT_MS 100     /* Longest wait for a deadline before re-checking for stop */
+#define ACQUISITION_STOP_TIMEOUT_MS 500     /* Time given to the task to finish its frame */
+
+/* Alarm ISR: one deadline passed. The tick count survives a frame that spans several. */
+static bool IRAM_ATTR acquisition_on_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata,
+                                           void *ctx)
+{
+    acquisition_t *acq = (acquisition_t *)ctx;
+    BaseType_t woken = pdFALSE;
+
+    acq->ticks++;
+    xSemaphoreGiveFromISR(acq->tick_sem, &woken);
+    return woken == pdTRUE;
+}
+
+esp_err_t acquisition_init(acquisition_t *acq, const acquisition_config_t *config)
+{
+    if (!acq || !config || !config->loadcell) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(acq, 0, sizeof(*acq));
+    acq->config = *config;
+
+    acq->tick_sem = xSemaphoreCreateBinary();
+    acq->mailbox = xQueueCreate(ACQUISITION_MAILBOX_DEPTH, sizeof(acquisition_request_t *));
+    acq->mailbox_lock = xSemaphoreCreateMutex();
+    bool created = acq->tick_sem && acq->mailbox && acq->mailbox_lock;
+    for (int i = 0; i < ACQUISITION_MAILBOX_DEPTH; i++) {
+        acq->calls[i].done = xSemaphoreCreateBinary();
+        created = created && acq->calls[i].done;
+    }
+    if (!created) {
+        acquisition_deinit(acq);
+        return ESP_ERR_NO_MEM;
+    }
+
+    gptimer_config_t timer_cfg = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = ACQUISITION_TIMER_HZ,
+    };
+    esp_err_t ret = gptimer_new_timer(&timer_cfg, &acq->timer);
+    if (ret == ESP_OK) {
+        gptimer_event_callbacks_t cbs = {
+            .on_alarm = acquisition_on_alarm,
+        };
+        ret = gptimer_register_event_callbacks(acq->timer, &cbs, acq);
+    }
+    if (ret == ESP_OK) {
+        ret = gptimer_enable(acq->timer);
+    }
+    if (ret == ESP_OK) {
+        ret = acquisition_set_rate(acq, config->frame_rate_hz);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Init failed: %s", esp_err_to_name(ret));
+        acquisition_deinit(acq);
+    }
+    return ret;
+}
+
+esp_err_t acquisition_set_rate(acquisition_t *acq, float frame_rate_hz)
+{
+    if (!acq || !(frame_rate_hz >= 0.0f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (acq->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* The schedule cannot run faster than one complete scan per deadline */
+    ads1261_timing_plan_t timing = {0};
+    esp_err_t ret = loadcell_get_timing(acq->config.loadcell, &timing);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (frame_rate_hz == ACQUISITION_FREE_RUN) {
+        /* Back-to-back scans: the force filters run at the scan capacity */
+        acq->config.frame_rate_hz = ACQUISITION_FREE_RUN;
+        acq->period_us = 0;
+        return loadcell_set_frame_rate(acq->config.loadcell, timing.frame_rate_hz);
+    }
+    if (frame_rate_hz > timing.frame_rate_hz) {
+        ESP_LOGE(TAG, "%.1f Hz exceeds the scan capacity of %.1f Hz", frame_rate_hz, timing.frame_rate_hz);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t period_us = (uint32_t)lroundf((float)ACQUISITION_TIMER_HZ / frame_rate_hz);
+    acq->config.frame_rate_hz = frame_rate_hz;
+    acq->period_us = period_us > 0 ? period_us : 1;
+    return loadcell_set_frame_rate(acq->config.loadcell, frame_rate_hz);
+}
+
+esp_err_t acquisition_begin(acquisition_t *acq)
+{
+    if (!acq || !acq->timer) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    acq->ticks = 0;
+    acq->ticks_handled = 0;
+    xSemaphoreTake(acq->tick_sem, 0);
+
+    /* From here on the ADCs belong to whoever steps the schedule */
+    xSemaphoreTake(acq->mailbox_lock, portMAX_DELAY);
+    acq->owner = xTaskGetCurrentTaskHandle();
+    acq->serving = true;
+    xSemaphoreGive(acq->mailbox_lock);
+
+    if (acq->period_us == 0) {
+        acq->start_us = esp_timer_get_time();
+        return ESP_OK;
+    }
+
+    /* Auto-reload keeps every deadline on the hardware's period: nothing accumulates */
+    gptimer_alarm_config_t alarm = {
+        .alarm_count = acq->period_us,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    esp_err_t ret = gptimer_set_raw_count(acq->timer, 0);
+    if (ret == ESP_OK) {
+        ret = gptimer_set_alarm_action(acq->timer, &alarm);
+    }
+    if (ret == ESP_OK) {
+        acq->start_us = esp_timer_get_time();
+        ret = gptimer_start(acq->timer);
+    }
+    return ret;
+}
+
+/* Run the next mailbox request that is still wanted, if any, and hand back its result */
+static bool acquisition_serve(acquisition_t *acq)
+{
+    acquisition_request_t *request;
+    bool cancelled;
+    do {
+        if (xQueueReceive(acq->mailbox, &request, 0) != pdTRUE) {
+            return false;
+        }
+        xSemaphoreTake(acq->mailbox_lock, portMAX_DELAY);
+        cancelled = request->state == ACQUISITION_REQUEST_CANCELLED;
+        request->state = cancelled ? ACQUISITION_REQUEST_IDLE : ACQUISITION_REQUEST_RUNNING;
+        xSemaphoreGive(acq->mailbox_lock);
+    } while (cancelled);
+
+    esp_err_t result = request->fn(acq->config.loadcell, request->arg);
+    xSemaphoreTake(acq->mailbox_lock, portMAX_DELAY);
+    request->result = result;
+    request->state = ACQUISITION_REQUEST_DONE;
+    xSemaphoreGive(acq->mailbox_lock);
+    acq->stats.requests++;
+    if (request->done) {
+        xSemaphoreGive(request->done);
+    }
+    return true;
+}
+
+/* Wait for the next deadline and acquire one frame */
+static esp_err_t acquisition_frame(acquisition_t *acq, uint32_t timeout_ms)
+{
+    acquisition_frame_t frame = {0};
+    if (acq->period_us == 0) {
+        frame.index = acq->ticks_handled++;
+        frame.deadline_us = esp_timer_get_time();
+    } else {
+        /* The semaphore may still be given for a deadline the last frame already took */
+        while (acq->ticks == acq->ticks_handled) {
+            if (xSemaphoreTake(acq->tick_sem, pdMS_TO_TICKS(timeout_ms)) != pdTRUE ||
+                (acq->task && !acq->running)) {
+                return ESP_ERR_TIMEOUT;
+            }
+        }
+
+        /* Run for the latest deadline; any passed while the last frame ran are skipped */
+        uint32_t ticks = acq->ticks;
+        frame.skipped = ticks - acq->ticks_handled - 1;
+        acq->stats.overruns += frame.skipped;
+        acq->ticks_handled = ticks;
+        frame.index = ticks - 1;
+        frame.deadline_us = acq->start_us + (int64_t)ticks * acq->period_us;
+    }
+
+    frame.start_us = esp_timer_get_time();
+    esp_err_t ret = loadcell_read(acq->config.loadcell);
+    frame.end_us = esp_timer_get_time();
+    if (ret != ESP_OK) {
+        acq->stats.read_errors++;
+        return ret;
+    }
+
+    acquisition_stats_t *stats = &acq->stats;
+    uint32_t latency_us = frame.start_us > frame.deadline_us ? (uint32_t)(frame.start_us - frame.deadline_us) : 0;
+    uint32_t frame_us = (uint32_t)(frame.end_us - frame.start_us);
+    stats->frames++;
+    frame.late = acq->period_us && frame.end_us > frame.deadline_us + acq->period_us;
+    if (frame.late) {
+        stats->late_frames++;
+    }
+    if (latency_us > stats->max_latency_us) {
+        stats->max_latency_us = latency_us;
+    }
+    if (frame_us > stats->max_frame_us) {
+        stats->max_frame_us = frame_us;
+    }
+
+    if (acq->config.on_frame) {
+        acq->config.on_frame(acq->config.loadcell, &frame, acq->config.ctx);
+    }
+    return ESP_OK;
+}
+
+esp_err_t acquisition_step(acquisition_t *acq, uint32_t timeout_ms)
+{
+    if (!acq) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = acquisition_frame(acq, timeout_ms);
+    /* Between frames the bus is free: one request per frame keeps the schedule's slack for the scan */
+    acquisition_serve(acq);
+    return ret;
+}
+
+esp_err_t acquisition_end(acquisition_t *acq)
+{
+    if (!acq || !acq->timer) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* Nothing posts once serving is clear: what is queued now is all that will be */
+    xSemaphoreTake(acq->mailbox_lock, portMAX_DELAY);
+    acq->serving = false;
+    xSemaphoreGive(acq->mailbox_lock);
+    while (acquisition_serve(acq)) {
+    }
+    acq->owner = NULL;
+
+    if (acq->period_us == 0) {
+        return ESP_OK;
+    }
+    esp_err_t ret = gptimer_stop(acq->timer);
+    return ret == ESP_ERR_INVALID_STATE ? ESP_OK : ret;
+}
+
+static void acquisition_task(void *arg)
+{
+    acquisition_t *acq = (acquisition_t *)arg;
+
+    acq->owner = xTaskGetCurrentTaskHandle();
+    ESP_LOGI(TAG, "Acquisition task started (%s)", acq->period_us ? "timer" : "free-running");
+
+    while (acq->running) {
+        esp_err_t ret = acquisition_step(acq, ACQUISITION_STEP_TIMEOUT_MS);
+        if (ret != ESP_OK && ret != ESP_ERR_TIMEOUT && acq->period_us == 0) {
+            /* Nothing paces a failing free-running scan: let other tasks run */
+            vTaskDelay(1);
+        }
+    }
+
+    acquisition_end(acq);
+    acq->task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t acquisition_start(acquisition_t *acq, UBaseType_t priority)
+{
+    if (!acq || acq->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = acquisition_begin(acq);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    /* Requests wait for the task from here, even ones this task makes before it runs */
+    acq->owner = NULL;
+    acq->running = true;
+    if (xTaskCreate(acquisition_task, "acquisition", ACQUISITION_TASK_STACK, acq, priority, &acq->task) != pdPASS) {
+        acq->running = false;
+        acquisition_end(acq);
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (acq->period_us) {
+        ESP_LOGI(TAG, "Acquiring at %.1f Hz (%lu us deadlines)", acq->config.frame_rate_hz,
+                 (unsigned long)acq->period_us);
+    } else {
+        ESP_LOGI(TAG, "Acquiring back-to-back at the scan capacity");
+    }
+    return ESP_OK;
+}
+
+esp_err_t acquisition_stop(acquisition_t *acq)
+{
+    if (!acq || !acq->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    acq->running = false;
+    xSemaphoreGive(acq->tick_sem);
+    for (uint32_t waited = 0; acq->task && waited < ACQUISITION_STOP_TIMEOUT_MS; waited += portTICK_PERIOD_MS) {
+        vTaskDelay(1);
+    }
+    return acq->task ? ESP_ERR_TIMEOUT : ESP_OK;
+}
+
+/* Queue a request; the mailbox lock is held and the schedule is serving */
+static esp_err_t acquisition_enqueue(acquisition_t *acq, acquisition_request_t *request)
+{
+    request->state = ACQUISITION_REQUEST_QUEUED;
+    if (xQueueSend(acq->mailbox, &request, 0) != pdTRUE) {
+        request->state = ACQUISITION_REQUEST_IDLE;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t acquisition_post(acquisition_t *acq, acquisition_request_t *request)
+{
+    if (!acq || !request || !request->fn) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(acq->mailbox_lock, portMAX_DELAY);
+    esp_err_t ret = acq->serving ? acquisition_enqueue(acq, request) : ESP_ERR_INVALID_STATE;
+    xSemaphoreGive(acq->mailbox_lock);
+    return ret;
+}
+
+esp_err_t acquisition_call(acquisition_t *acq, acquisition_request_fn_t fn, void *arg)
+{
+    if (!acq || !fn || !acq->mailbox_lock) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(acq->mailbox_lock, portMAX_DELAY);
+    if (!acq->serving || acq->owner == xTaskGetCurrentTaskHandle()) {
+        /* No scan to collide with; holding the lock keeps acquisition_begin() waiting until fn is done */
+        esp_err_t ret = fn(acq->config.loadcell, arg);
+        xSemaphoreGive(acq->mailbox_lock);
+        return ret;
+    }
+
+    /* The engine's slot, not this stack: one given up on stays valid until the stepping task dequeues it */
+    acquisition_request_t *request = NULL;
+    for (int i = 0; i < ACQUISITION_MAILBOX_DEPTH && !request; i++) {
+        if (acq->calls[i].state == ACQUISITION_REQUEST_IDLE) {
+            request = &acq->calls[i];
+        }
+    }
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    if (request) {
+        request->fn = fn;
+        request->arg = arg;
+        request->result = ESP_FAIL;
+        ret = acquisition_enqueue(acq, request);
+    }
+    xSemaphoreGive(acq->mailbox_lock);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    /* Served after the next frame, or by acquisition_end() */
+    if (xSemaphoreTake(request->done, pdMS_TO_TICKS(ACQUISITION_CALL_TIMEOUT_MS)) != pdTRUE) {
+        xSemaphoreTake(acq->mailbox_lock, portMAX_DELAY);
+        bool queued = request->state == ACQUISITION_REQUEST_QUEUED;
+        if (queued) {
+            request->state = ACQUISITION_REQUEST_CANCELLED;
+        }
+        xSemaphoreGive(acq->mailbox_lock);
+        if (queued) {
+            ESP_LOGW(TAG, "Request not served within %d ms: acquisition task stalled?", ACQUISITION_CALL_TIMEOUT_MS);
+            return ESP_ERR_TIMEOUT;
+        }
+        /* Already running, on arg from this stack: see it through */
+        xSemaphoreTake(request->done, portMAX_DELAY);
+    }
+
+    xSemaphoreTake(acq->mailbox_lock, portMAX_DELAY);
+    ret = request->result;
+    request->state = ACQUISITION_REQUEST_IDLE;
+    xSemaphoreGive(acq->mailbox_lock);
+    return ret;
+}
+
+void acquisition_deinit(acquisition_t *acq)
+{
+    if (!acq) {
+        return;
+    }
+    if (acq->timer) {
+        gptimer_disable(acq->timer);
+        gptimer_del_timer(acq->timer);
+        acq->timer = NULL;
+    }
+    if (acq->tick_sem) {
+        vSemaphoreDelete(acq->tick_sem);
+        acq->tick_sem = NULL;
+    }
+    if (acq->mailbox) {
+        vQueueDelete(acq->mailbox);
+        acq->mailbox = NULL;
+    }
+    if (acq->mailbox_lock) {
+        vSemaphoreDelete(acq->mailbox_lock);
+        acq->mailbox_lock = NULL;
+    }
+    for (int i = 0; i < ACQUISITION_MAILBOX_DEPTH; i++) {
+        if (acq->calls[i].done) {
+            vSemaphoreDelete(acq->calls[i].done);
+            acq->calls[i].done = NULL;
+        }
+    }
+}
+
+void acquisition_get_stats(const acquisition_t *acq, acquisition_stats_t *stats)
+{
+    if (acq && stats) {
+        *stats = acq->stats;
+    }
+}
+
+void acquisition_reset_stats(acquisition_t *acq)
+{
+    if (acq) {
+        memset(&acq->stats, 0, sizeof(acq->stats));
+    }
+}
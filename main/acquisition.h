@@ -0,0 +1,267 @@
+/**
+ * @file acquisition.h
+ * @brief Timer-paced loadcell acquisition with absolute deadlines
+ *
+ * Runs loadcell_read() frames at a fixed rate from a gptimer with auto-reload,
+ * so frame k is due at start + k * period regardless of how long earlier
+ * frames took (no drift from read time or tick rounding). With a frame rate
+ * of 0 frames run back-to-back, paced only by the ADC's DRDY, at the scan
+ * capacity of the configured filter/data rate.
+ *
+ * Each frame is timestamped against its deadline. A frame still running when
+ * the next one falls due counts as late; deadlines that pass entirely while a
+ * frame runs are skipped and counted as overruns, and the schedule resumes at
+ * the next deadline rather than trying to catch up.
+ *
+ * While the schedule runs, the task stepping it is the only one that talks
+ * to the ADCs. Anything else that needs the bus or changes what the scan
+ * reads (diagnostics, register dumps, calibration tables) goes through
+ * acquisition_call(): the request waits in a mailbox, and the acquisition
+ * task runs it between two frames. The frames themselves take no lock.
+ */
+
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gptimer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "loadcell.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ACQUISITION_TIMER_HZ        1000000     /**< gptimer resolution: deadlines in whole microseconds */
+#define ACQUISITION_FREE_RUN        0.0f        /**< Frame rate selecting back-to-back, DRDY-paced frames */
+#define ACQUISITION_MAILBOX_DEPTH   4           /**< Requests that can wait for the acquisition task */
+#define ACQUISITION_CALL_TIMEOUT_MS 500         /**< Longest wait of acquisition_call() for its turn */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Timing of one acquired frame (esp_timer microseconds)
+ */
+typedef struct {
+    uint32_t index;             /**< Frame number since acquisition_begin(), counting skipped deadlines */
+    int64_t deadline_us;        /**< When the frame was due (its start in free-running mode) */
+    int64_t start_us;           /**< When the scan started */
+    int64_t end_us;             /**< When the last channel was read */
+    uint32_t skipped;           /**< Deadlines skipped just before this frame */
+    bool late;                  /**< Ended after the next deadline */
+} acquisition_frame_t;
+
+/**
+ * Called from the acquisition task after every frame; the loadcell measurements hold the new frame
+ */
+typedef void (*acquisition_frame_cb_t)(loadcell_t *loadcell, const acquisition_frame_t *frame, void *ctx);
+
+/**
+ * Work run on the loadcell by the task that owns it
+ */
+typedef esp_err_t (*acquisition_request_fn_t)(loadcell_t *loadcell, void *arg);
+
+/**
+ * Where a mailbox request is
+ */
+typedef enum {
+    ACQUISITION_REQUEST_IDLE = 0,   /**< Not in the mailbox */
+    ACQUISITION_REQUEST_QUEUED,     /**< Waiting for the stepping task */
+    ACQUISITION_REQUEST_RUNNING,    /**< fn is running */
+    ACQUISITION_REQUEST_DONE,       /**< result is set */
+    ACQUISITION_REQUEST_CANCELLED,  /**< Given up by its caller: dropped unrun when dequeued */
+} acquisition_request_state_t;
+
+/**
+ * One mailbox request; the poster keeps it alive until done is given
+ */
+typedef struct {
+    acquisition_request_fn_t fn;
+    void *arg;
+    esp_err_t result;               /**< What fn returned */
+    SemaphoreHandle_t done;         /**< Given once result is set (may be NULL) */
+    acquisition_request_state_t state;  /**< Under the mailbox lock */
+} acquisition_request_t;
+
+/**
+ * Acquisition configuration
+ */
+typedef struct {
+    loadcell_t *loadcell;           /**< Initialized loadcell device */
+    float frame_rate_hz;            /**< Frames per second, or ACQUISITION_FREE_RUN */
+    acquisition_frame_cb_t on_frame;
+    void *ctx;
+} acquisition_config_t;
+
+/**
+ * Scheduling counters
+ */
+typedef struct {
+    uint32_t frames;                /**< Frames read */
+    uint32_t late_frames;           /**< Frames that ended after the next deadline */
+    uint32_t overruns;              /**< Deadlines skipped because a frame was still running */
+    uint32_t read_errors;           /**< Frames whose scan failed */
+    uint32_t max_latency_us;        /**< Worst deadline-to-start delay */
+    uint32_t max_frame_us;          /**< Longest scan */
+    uint32_t requests;              /**< Mailbox requests served between frames */
+} acquisition_stats_t;
+
+/**
+ * Acquisition engine context
+ */
+typedef struct {
+    acquisition_config_t config;
+    uint32_t period_us;             /**< Deadline spacing (0 when free-running) */
+
+    gptimer_handle_t timer;
+    SemaphoreHandle_t tick_sem;     /**< Given by the alarm ISR */
+    volatile uint32_t ticks;        /**< Deadlines passed since start (alarm ISR) */
+    uint32_t ticks_handled;         /**< Deadline the last frame ran for */
+    int64_t start_us;               /**< Deadline 0 */
+
+    QueueHandle_t mailbox;          /**< acquisition_request_t pointers for the stepping task */
+    SemaphoreHandle_t mailbox_lock; /**< Orders posting against the end of the schedule */
+    TaskHandle_t owner;             /**< Task stepping the schedule */
+    bool serving;                   /**< Between acquisition_begin() and acquisition_end() */
+    acquisition_request_t calls[ACQUISITION_MAILBOX_DEPTH];    /**< acquisition_call() requests */
+
+    acquisition_stats_t stats;
+    TaskHandle_t task;
+    volatile bool running;
+} acquisition_t;
+
+/* ============================================================================
+ * Engine
+ * ============================================================================ */
+
+/**
+ * @brief Set up the engine (timer and tick semaphore); frames do not run yet
+ *
+ * @param acq Engine context
+ * @param config Loadcell device, frame rate and frame callback
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG if the rate exceeds the scan capacity
+ */
+esp_err_t acquisition_init(acquisition_t *acq, const acquisition_config_t *config);
+
+/**
+ * @brief Change the frame rate (only while stopped)
+ *
+ * The loadcell's force filters are redesigned for the new rate.
+ *
+ * @param acq Engine context
+ * @param frame_rate_hz Frames per second up to the scan capacity, or ACQUISITION_FREE_RUN
+ * @return ESP_OK, ESP_ERR_INVALID_ARG above the scan capacity, ESP_ERR_INVALID_STATE while running
+ */
+esp_err_t acquisition_set_rate(acquisition_t *acq, float frame_rate_hz);
+
+/**
+ * @brief Start the deadline schedule: deadline 0 is now
+ *
+ * acquisition_start() does this and runs acquisition_step() in its own task;
+ * call it directly to drive the steps from an existing loop.
+ *
+ * @param acq Engine context
+ * @return ESP_OK on success
+ */
+esp_err_t acquisition_begin(acquisition_t *acq);
+
+/**
+ * @brief Wait for the next deadline, acquire one frame, then serve one request
+ *
+ * The request waiting longest in the mailbox runs after the frame callback,
+ * also when no deadline came or the scan failed.
+ *
+ * @param acq Engine context (after acquisition_begin())
+ * @param timeout_ms Longest wait for the deadline
+ * @return ESP_OK, ESP_ERR_TIMEOUT if no deadline came, or the scan error
+ */
+esp_err_t acquisition_step(acquisition_t *acq, uint32_t timeout_ms);
+
+/**
+ * @brief Stop the deadline schedule started by acquisition_begin()
+ *
+ * Requests still in the mailbox run here, in the calling task.
+ *
+ * @param acq Engine context
+ * @return ESP_OK on success
+ */
+esp_err_t acquisition_end(acquisition_t *acq);
+
+/**
+ * @brief Begin and run frames in a dedicated task
+ *
+ * @param acq Engine context
+ * @param priority Task priority
+ * @return ESP_OK, or ESP_ERR_NO_MEM if the task could not be created
+ */
+esp_err_t acquisition_start(acquisition_t *acq, UBaseType_t priority);
+
+/**
+ * @brief Stop the task started by acquisition_start() after its current frame
+ *
+ * @param acq Engine context
+ * @return ESP_OK, or ESP_ERR_TIMEOUT if the task did not finish its frame
+ */
+esp_err_t acquisition_stop(acquisition_t *acq);
+
+/**
+ * @brief Run fn on the loadcell from the task that owns the ADCs
+ *
+ * While a schedule runs, the request goes to the mailbox and the caller
+ * blocks until the stepping task has run it between two frames, so fn never
+ * overlaps a scan. Otherwise, or from the stepping task itself, fn runs at
+ * once in the caller. A slow fn delays the next frame like a slow scan.
+ *
+ * A request the stepping task has not picked up within
+ * ACQUISITION_CALL_TIMEOUT_MS is cancelled: it stays in the mailbox, in the
+ * engine's own slot, and is dropped unrun when dequeued. One already running
+ * is waited for, since fn may use arg.
+ *
+ * @param acq Engine context
+ * @param fn  Work on the loadcell
+ * @param arg Passed to fn
+ * @return What fn returned, ESP_ERR_NO_MEM if the mailbox is full,
+ *         ESP_ERR_TIMEOUT if the stepping task did not get to it
+ */
+esp_err_t acquisition_call(acquisition_t *acq, acquisition_request_fn_t fn, void *arg);
+
+/**
+ * @brief Queue a request for the stepping task without waiting
+ *
+ * @param acq     Engine context (after acquisition_begin())
+ * @param request Request with fn set; untouched by the caller until its done
+ *                semaphore is given
+ * @return ESP_OK, ESP_ERR_INVALID_STATE without a schedule, ESP_ERR_NO_MEM
+ *         if the mailbox is full
+ */
+esp_err_t acquisition_post(acquisition_t *acq, acquisition_request_t *request);
+
+/**
+ * @brief Release the timer, semaphores and mailbox
+ *
+ * @param acq Engine context (stopped)
+ */
+void acquisition_deinit(acquisition_t *acq);
+
+/**
+ * @brief Copy the scheduling counters
+ */
+void acquisition_get_stats(const acquisition_t *acq, acquisition_stats_t *stats);
+
+/**
+ * @brief Clear the scheduling counters
+ */
+void acquisition_reset_stats(acquisition_t *acq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ACQUISITION_H */
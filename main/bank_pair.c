@@ -0,0 +1,92 @@
+/**
+ * @file bank_pair.c
+ * @brief Double-buffered parameters: one published bank, one spare for updates
+ */
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "bank_pair.h"
+
+void bank_pair_init(bank_pair_t *pair)
+{
+    atomic_init(&pair->seq, 0);
+    atomic_init(&pair->held, BANK_PAIR_NONE);
+    atomic_init(&pair->updating, false);
+}
+
+uint8_t bank_pair_take(bank_pair_t *pair)
+{
+    /*
+     * Mark the bank, then check it is still the published one. An update that
+     * read the publication count before the mark writes the other bank; one
+     * that reads it after sees the mark and waits.
+     */
+    for (;;) {
+        uint32_t seq = atomic_load(&pair->seq);
+        uint8_t bank = seq & 1;
+        atomic_store(&pair->held, bank);
+        if (atomic_load(&pair->seq) == seq) {
+            return bank;
+        }
+    }
+}
+
+void bank_pair_release(bank_pair_t *pair)
+{
+    atomic_store(&pair->held, BANK_PAIR_NONE);
+}
+
+uint8_t bank_pair_read_begin(const bank_pair_t *pair, uint32_t *seq)
+{
+    *seq = atomic_load_explicit(&pair->seq, memory_order_acquire);
+    return *seq & 1;
+}
+
+bool bank_pair_read_retry(const bank_pair_t *pair, uint32_t seq)
+{
+    /* The bank read is only rewritten after the next publication */
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&pair->seq, memory_order_relaxed) != seq;
+}
+
+void bank_pair_read(const bank_pair_t *pair, const void *banks, size_t bank_size, void *out)
+{
+    uint32_t seq;
+    do {
+        memcpy(out, (const uint8_t *)banks + bank_pair_read_begin(pair, &seq) * bank_size, bank_size);
+    } while (bank_pair_read_retry(pair, seq));
+}
+
+esp_err_t bank_pair_begin_update(bank_pair_t *pair, void *banks, size_t bank_size, void **spare)
+{
+    if (atomic_exchange(&pair->updating, true)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* The task may still hold the spare: published before its current take, and not let go yet */
+    uint32_t seq = atomic_load(&pair->seq);
+    uint8_t bank = (seq + 1) & 1;
+    for (uint32_t waited = 0; atomic_load(&pair->held) == bank; waited += portTICK_PERIOD_MS) {
+        if (waited >= BANK_PAIR_WAIT_MS) {
+            atomic_store(&pair->updating, false);
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(1);
+    }
+
+    *spare = (uint8_t *)banks + bank * bank_size;
+    memcpy(*spare, (const uint8_t *)banks + (seq & 1) * bank_size, bank_size);
+    return ESP_OK;
+}
+
+void bank_pair_publish(bank_pair_t *pair)
+{
+    atomic_fetch_add(&pair->seq, 1);
+    atomic_store(&pair->updating, false);
+}
+
+void bank_pair_cancel(bank_pair_t *pair)
+{
+    atomic_store(&pair->updating, false);
+}
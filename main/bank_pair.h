@@ -0,0 +1,121 @@
+/**
+ * @file bank_pair.h
+ * @brief Double-buffered parameters: one published bank, one spare for updates
+ *
+ * Parameters the acquisition task applies every frame (the plate matrix,
+ * filter chains, channel calibration) are changed by other code while the
+ * frames run. They are kept in two banks of the owner's type: the task uses
+ * the published one, an update copies it into the spare, edits the spare and
+ * publishes it, so the task never sees a half-made change.
+ *
+ * Nothing here assumes the updates are slow. The task marks the bank it
+ * takes for a frame as held, and an update waits (up to BANK_PAIR_WAIT_MS)
+ * while the spare is still held from an earlier publication. One update
+ * runs at a time; a second one started meanwhile is refused. Any task can
+ * also copy the published bank: the copy is retried if a publication
+ * overtook it, as frame_ring readers do with a slot.
+ */
+
+#ifndef BANK_PAIR_H
+#define BANK_PAIR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BANK_PAIR_NONE          0xFF    /**< held when the task holds no bank */
+#define BANK_PAIR_WAIT_MS       100     /**< Longest wait of an update for the task to let go of the spare */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Which of two banks is published, and which one the task holds
+ */
+typedef struct {
+    _Atomic uint32_t seq;       /**< Publications so far: bank seq & 1 is the published one */
+    _Atomic uint8_t held;       /**< Bank the task took, BANK_PAIR_NONE between uses */
+    _Atomic bool updating;      /**< An update is under way */
+} bank_pair_t;
+
+/* ============================================================================
+ * Functions
+ * ============================================================================ */
+
+/**
+ * @brief Bank 0 published, nothing held (before the task starts)
+ */
+void bank_pair_init(bank_pair_t *pair);
+
+/**
+ * @brief Take the published bank for one use (the one task applying the parameters)
+ *
+ * The bank is not rewritten until bank_pair_release() or the next take.
+ *
+ * @return Index of the bank to use
+ */
+uint8_t bank_pair_take(bank_pair_t *pair);
+
+/**
+ * @brief Let go of the bank taken last
+ */
+void bank_pair_release(bank_pair_t *pair);
+
+/**
+ * @brief Start reading the published bank from any task
+ *
+ * @param pair Pair
+ * @param[out] seq Passed to bank_pair_read_retry() once the read is done
+ * @return Index of the bank to read
+ */
+uint8_t bank_pair_read_begin(const bank_pair_t *pair, uint32_t *seq);
+
+/**
+ * @brief Whether a publication overtook the read begun with seq, so it must be repeated
+ */
+bool bank_pair_read_retry(const bank_pair_t *pair, uint32_t seq);
+
+/**
+ * @brief Consistent copy of the published bank, from any task
+ *
+ * @param pair Pair
+ * @param banks The owner's two banks
+ * @param bank_size Size of one bank
+ * @param[out] out Receives the published bank
+ */
+void bank_pair_read(const bank_pair_t *pair, const void *banks, size_t bank_size, void *out);
+
+/**
+ * @brief Start an update: copy the published bank into the spare
+ *
+ * @param pair Pair
+ * @param banks The owner's two banks
+ * @param bank_size Size of one bank
+ * @param[out] spare The spare to edit, then pass to bank_pair_publish() or bank_pair_cancel()
+ * @return ESP_OK, ESP_ERR_INVALID_STATE while another update is under way,
+ *         ESP_ERR_TIMEOUT if the task still held the spare after BANK_PAIR_WAIT_MS
+ */
+esp_err_t bank_pair_begin_update(bank_pair_t *pair, void *banks, size_t bank_size, void **spare);
+
+/**
+ * @brief Publish the spare: the task's next take gets it
+ */
+void bank_pair_publish(bank_pair_t *pair);
+
+/**
+ * @brief End an update without publishing it
+ */
+void bank_pair_cancel(bank_pair_t *pair);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BANK_PAIR_H */
@@ -5,6 +5,7 @@
 
 #include <string.h>
 #include "ble_force.h"
+#include "loadcell_q.h"
 #include "esp_log.h"
 #include "esp_bt.h"
 #include "esp_gap_ble_api.h"
@@ -329,25 +330,20 @@ esp_err_t ble_force_init(const char *device_name)
     return ESP_OK;
 }
 
-esp_err_t ble_force_notify(const loadcell_t *loadcell, uint16_t timestamp_ms)
+esp_err_t ble_force_notify(const loadcell_frame_t *frame)
 {
     if (!ble_connected || !notification_enabled || gatts_if_global == ESP_GATT_IF_NONE) {
         return ESP_FAIL;
     }
     
     ble_force_packet_t packet;
-    packet.timestamp_ms = timestamp_ms;
+    packet.timestamp_ms = (uint16_t)(frame->timestamp_us / 1000);
     
-    // Convert force (Newtons) to 16-bit scaled values (0.1N resolution)
-    // Example: 123.4N -> 1234
+    // Convert force (millinewtons) to 16-bit scaled values (0.1N resolution)
+    // Example: 123456 mN -> 1234
     // Range: -3276.8N to +3276.7N with 0.1N resolution
     for (int i = 0; i < 4; i++) {
-        float force_n = loadcell->measurements[i].force_newtons;
-        int32_t scaled = (int32_t)(force_n * 10.0f);  // Scale to 0.1N
-        
-        // Clamp to 16-bit range
-        if (scaled > 32767) scaled = 32767;
-        if (scaled < -32768) scaled = -32768;
+        int16_t scaled = loadcell_q_deci_newtons(i < frame->num_channels ? frame->force_mn[i] : 0);
         
         switch (i) {
             case 0: packet.force_ch1 = (int16_t)scaled; break;
@@ -356,6 +352,13 @@ esp_err_t ble_force_notify(const loadcell_t *loadcell, uint16_t timestamp_ms)
             case 3: packet.force_ch4 = (int16_t)scaled; break;
         }
     }
+
+    // Plate outputs: mN, mN·m and µm all scale by 1/100 to 0.1N, 0.1N·m and 0.1mm
+    packet.fz = loadcell_q_deci_newtons(frame->plate.fz_mn);
+    packet.mx = loadcell_q_deci_newtons(frame->plate.mx_mnm);
+    packet.my = loadcell_q_deci_newtons(frame->plate.my_mnm);
+    packet.cop_x = loadcell_q_deci_newtons(frame->plate.cop_x_um);
+    packet.cop_y = loadcell_q_deci_newtons(frame->plate.cop_y_um);
     
     // Send notification
     esp_err_t ret = esp_ble_gatts_send_indicate(gatts_if_global, conn_id, force_handle,
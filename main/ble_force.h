@@ -3,17 +3,18 @@
  * @brief BLE Force Plate Data Streaming
  * 
  * Efficient BLE notification system for 4-channel force data:
- * - Counter (32-bit) + 4x Force values (16-bit each)
- * - Total: 12 bytes per notification
- * - Force scaled to 0.01N resolution (0-655.35N range with 16-bit)
- * - ~100 Hz notification rate for real-time streaming
+ * - Ten little-endian 16-bit fields: a ms time counter, the first 4
+ *   channel forces and the plate's Fz, Mx, My, COPx, COPy
+ * - Total: 20 bytes per notification (fits the default 23-byte ATT MTU)
+ * - Forces in 0.1N (±3276.7N), moments in 0.1N·m, COP in 0.1mm
+ * - One notification every BLE_NOTIFY_DIVIDER frames (100 Hz at 1 kHz)
  */
 
 #ifndef BLE_FORCE_H
 #define BLE_FORCE_H
 
 #include "esp_err.h"
-#include "loadcell.h"
+#include "frame_ring.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,7 +22,7 @@ extern "C" {
 
 /**
  * BLE Force Data Packet Structure
- * Total: 10 bytes (4-channel) / 18 bytes (8-channel future)
+ * Total: 20 bytes
  * 
  * timestamp_ms is elapsed time counter (milliseconds since measurement start):
  * - At 1000 Hz: increments by 1 each sample
@@ -31,6 +32,11 @@ extern "C" {
  * Force encoding: 0.1N resolution
  * - int16_t range: -32,768 to +32,767 → -3276.8N to +3276.7N
  * - Covers up to ±327kg force (sufficient for human GRF testing)
+ *
+ * Plate outputs are computed on the device from the calibration matrix:
+ * - Fz in 0.1N, Mx/My in 0.1N·m
+ * - COP in 0.1mm from the plate centre (x right, y front); 0 when Fz is
+ *   below the COP threshold
  */
 typedef struct {
     uint16_t timestamp_ms;      // Elapsed time in ms (0-65,535, wraps at 65.5s)
@@ -38,6 +44,11 @@ typedef struct {
     int16_t force_ch2;          // Channel 2 force in 0.1N
     int16_t force_ch3;          // Channel 3 force in 0.1N
     int16_t force_ch4;          // Channel 4 force in 0.1N
+    int16_t fz;                 // Plate vertical force in 0.1N
+    int16_t mx;                 // Moment about x in 0.1N·m
+    int16_t my;                 // Moment about y in 0.1N·m
+    int16_t cop_x;              // Centre of pressure x in 0.1mm
+    int16_t cop_y;              // Centre of pressure y in 0.1mm
 } __attribute__((packed)) ble_force_packet_t;
 
 /**
@@ -56,14 +67,14 @@ esp_err_t ble_force_init(const char *device_name);
 /**
  * Send force data notification to connected BLE client
  * 
- * Converts loadcell measurements to 16-bit scaled values and sends
- * via BLE notification if client is connected and subscribed.
+ * Converts the first 4 channels and the plate outputs of a frame to 16-bit
+ * scaled values and sends them via BLE notification if client is connected and subscribed.
+ * The time counter is the frame timestamp in ms, truncated to 16 bits.
  * 
- * @param loadcell Pointer to loadcell device with current measurements
- * @param timestamp_ms Elapsed time counter in ms (relative to start, not absolute time)
+ * @param frame Frame taken from the frame ring
  * @return ESP_OK if notification sent, ESP_FAIL if not connected
  */
-esp_err_t ble_force_notify(const loadcell_t *loadcell, uint16_t timestamp_ms);
+esp_err_t ble_force_notify(const loadcell_frame_t *frame);
 
 /**
  * Check if BLE client is connected and subscribed to notifications
@@ -0,0 +1,198 @@
+/**
+ * @file force_plate.c
+ * @brief Plate-level outputs from the per-channel forces
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "esp_log.h"
+#include "bank_pair.h"
+#include "force_plate.h"
+
+static const char *TAG = "ForcePlate";
+
+#define FORCE_PLATE_ONE         (1L << FORCE_PLATE_Q_BITS)
+#define FORCE_PLATE_UM_PER_M    1000000
+#define FORCE_PLATE_COP_NUM_MAX (INT64_MAX / FORCE_PLATE_UM_PER_M)
+
+static int32_t force_plate_to_q(float value)
+{
+    return (int32_t)lroundf(value * FORCE_PLATE_ONE);
+}
+
+static int32_t force_plate_saturate(int64_t value)
+{
+    if (value > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (value < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)value;
+}
+
+/* num / den rounded to nearest, den > 0 */
+static int64_t force_plate_div_round(int64_t num, int64_t den)
+{
+    return (num >= 0 ? num + den / 2 : num - den / 2) / den;
+}
+
+/* Start an update of the plate's spare matrix; the caller publishes or cancels it */
+static esp_err_t force_plate_begin_update(force_plate_t *plate, force_plate_matrix_t **spare)
+{
+    return bank_pair_begin_update(&plate->pair, plate->banks, sizeof(plate->banks[0]), (void **)spare);
+}
+
+void force_plate_init(force_plate_t *plate, uint8_t num_channels)
+{
+    force_plate_matrix_t *m = &plate->banks[0];
+
+    memset(plate->banks, 0, sizeof(plate->banks));
+    m->num_channels = num_channels > LOADCELL_MAX_CHANNELS ? LOADCELL_MAX_CHANNELS : num_channels;
+    for (int ch = 0; ch < m->num_channels; ch++) {
+        m->coef[FORCE_PLATE_FZ][ch] = FORCE_PLATE_ONE;
+    }
+    m->min_fz_mn = (int32_t)(FORCE_PLATE_MIN_FZ_N * 1000);
+    bank_pair_init(&plate->pair);
+}
+
+esp_err_t force_plate_set_geometry(force_plate_t *plate, const float *x_m, const float *y_m,
+                                   uint8_t num_channels)
+{
+    if (!plate || !x_m || !y_m) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int ch = 0; ch < num_channels; ch++) {
+        if (!(fabsf(x_m[ch]) <= FORCE_PLATE_COEF_MAX) || !(fabsf(y_m[ch]) <= FORCE_PLATE_COEF_MAX)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    force_plate_matrix_t *m;
+    esp_err_t ret = force_plate_begin_update(plate, &m);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (num_channels > m->num_channels) {
+        bank_pair_cancel(&plate->pair);
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(m->coef, 0, sizeof(m->coef));
+    for (int ch = 0; ch < num_channels; ch++) {
+        m->coef[FORCE_PLATE_FZ][ch] = FORCE_PLATE_ONE;
+        m->coef[FORCE_PLATE_MX][ch] = force_plate_to_q(y_m[ch]);
+        m->coef[FORCE_PLATE_MY][ch] = force_plate_to_q(-x_m[ch]);
+    }
+    bank_pair_publish(&plate->pair);
+
+    ESP_LOGI(TAG, "Ideal matrix for %u cells", num_channels);
+    return ESP_OK;
+}
+
+esp_err_t force_plate_set_coef(force_plate_t *plate, force_plate_axis_t axis, uint8_t channel, float value)
+{
+    if (!plate || axis >= FORCE_PLATE_OUTPUTS || !(fabsf(value) <= FORCE_PLATE_COEF_MAX)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    force_plate_matrix_t *m;
+    esp_err_t ret = force_plate_begin_update(plate, &m);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (channel >= m->num_channels) {
+        bank_pair_cancel(&plate->pair);
+        return ESP_ERR_INVALID_ARG;
+    }
+    m->coef[axis][channel] = force_plate_to_q(value);
+    bank_pair_publish(&plate->pair);
+    return ESP_OK;
+}
+
+esp_err_t force_plate_set_min_fz(force_plate_t *plate, float min_fz_n)
+{
+    if (!plate || !(min_fz_n > 0.0f && min_fz_n < 2e6f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    force_plate_matrix_t *m;
+    esp_err_t ret = force_plate_begin_update(plate, &m);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    m->min_fz_mn = (int32_t)lroundf(min_fz_n * 1000);
+    bank_pair_publish(&plate->pair);
+    return ESP_OK;
+}
+
+float force_plate_get_coef(const force_plate_t *plate, force_plate_axis_t axis, uint8_t channel)
+{
+    if (!plate || axis >= FORCE_PLATE_OUTPUTS || channel >= LOADCELL_MAX_CHANNELS) {
+        return 0.0f;
+    }
+    uint32_t seq;
+    int32_t coef;
+    do {
+        coef = plate->banks[bank_pair_read_begin(&plate->pair, &seq)].coef[axis][channel];
+    } while (bank_pair_read_retry(&plate->pair, seq));
+    return (float)coef / FORCE_PLATE_ONE;
+}
+
+const char *force_plate_axis_name(force_plate_axis_t axis)
+{
+    switch (axis) {
+    case FORCE_PLATE_FZ: return "Fz";
+    case FORCE_PLATE_MX: return "Mx";
+    case FORCE_PLATE_MY: return "My";
+    default:             return "?";
+    }
+}
+
+void force_plate_compute(force_plate_t *plate, const int32_t *force_mn, force_plate_output_t *out)
+{
+    const force_plate_matrix_t *m = &plate->banks[bank_pair_take(&plate->pair)];
+    int64_t sum[FORCE_PLATE_OUTPUTS] = { 0 };
+
+    /* |coef| <= 16 << 20 and |force| < 2^31: 12 products stay inside 64 bits */
+    for (int ch = 0; ch < m->num_channels; ch++) {
+        sum[FORCE_PLATE_FZ] += (int64_t)m->coef[FORCE_PLATE_FZ][ch] * force_mn[ch];
+        sum[FORCE_PLATE_MX] += (int64_t)m->coef[FORCE_PLATE_MX][ch] * force_mn[ch];
+        sum[FORCE_PLATE_MY] += (int64_t)m->coef[FORCE_PLATE_MY][ch] * force_mn[ch];
+    }
+    int32_t min_fz_mn = m->min_fz_mn;
+    bank_pair_release(&plate->pair);
+
+    /* Round to nearest: mN for Fz, mN·m for the moments */
+    const int64_t half = FORCE_PLATE_ONE / 2;
+    out->fz_mn = force_plate_saturate((sum[FORCE_PLATE_FZ] + half) >> FORCE_PLATE_Q_BITS);
+    out->mx_mnm = force_plate_saturate((sum[FORCE_PLATE_MX] + half) >> FORCE_PLATE_Q_BITS);
+    out->my_mnm = force_plate_saturate((sum[FORCE_PLATE_MY] + half) >> FORCE_PLATE_Q_BITS);
+
+    out->cop_valid = out->fz_mn >= min_fz_mn;
+    if (!out->cop_valid) {
+        out->cop_x_um = 0;
+        out->cop_y_um = 0;
+        return;
+    }
+
+    /*
+     * The COP comes from the unrounded Q20 sums (lever arm = M / Fz), so it
+     * loses nothing to the mN·m rounding at light loads. The numerator is
+     * scaled to µm before dividing; sums too large for that are halved
+     * together first (Fz starts at or above min_fz_mn << 20).
+     */
+    int64_t fz = sum[FORCE_PLATE_FZ];
+    int64_t mx = sum[FORCE_PLATE_MX];
+    int64_t my = sum[FORCE_PLATE_MY];
+    while (llabs(mx) > FORCE_PLATE_COP_NUM_MAX || llabs(my) > FORCE_PLATE_COP_NUM_MAX) {
+        fz >>= 1;
+        mx >>= 1;
+        my >>= 1;
+    }
+    if (fz <= 0) {
+        fz = 1;
+    }
+    out->cop_x_um = force_plate_saturate(force_plate_div_round(-my * FORCE_PLATE_UM_PER_M, fz));
+    out->cop_y_um = force_plate_saturate(force_plate_div_round(mx * FORCE_PLATE_UM_PER_M, fz));
+}
@@ -0,0 +1,151 @@
+/**
+ * @file force_plate.h
+ * @brief Plate-level outputs from the per-channel forces
+ *
+ * Each frame's channel forces are multiplied by a calibration matrix with
+ * one row per output (Fz, Mx, My) and one column per channel. For an ideal
+ * plate the Fz row is all ones and the moment rows hold the cell positions;
+ * a plate calibrated against a reference fills in the cross-talk terms as
+ * well. The centre of pressure follows from the moments and Fz.
+ *
+ * Coordinates: x to the right, y to the front, z up, metres from the plate
+ * centre. A cell at (x, y) loaded with F contributes F*y to Mx and -F*x to
+ * My, so COPx = -My / Fz and COPy = Mx / Fz.
+ *
+ * Coefficients are held in Q20 fixed point and the matrix is applied with
+ * 32x32-bit products summed in 64 bits, so the per-frame cost is integer
+ * only. The acquisition task reads the matrix while the console may be
+ * replacing it, so the matrix is a bank_pair: updates are made to a spare
+ * copy that is then published.
+ */
+
+#ifndef FORCE_PLATE_H
+#define FORCE_PLATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "bank_pair.h"
+#include "loadcell.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FORCE_PLATE_Q_BITS          20      /**< Fraction bits of the matrix coefficients */
+#define FORCE_PLATE_COEF_MAX        16.0f   /**< Largest coefficient magnitude (gain or metres) */
+#define FORCE_PLATE_MIN_FZ_N        10.0f   /**< Default Fz below which the COP is undefined */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Matrix rows
+ */
+typedef enum {
+    FORCE_PLATE_FZ = 0,         /**< Vertical force; coefficients are gains */
+    FORCE_PLATE_MX,             /**< Moment about x; coefficients in metres */
+    FORCE_PLATE_MY,             /**< Moment about y; coefficients in metres */
+    FORCE_PLATE_OUTPUTS,
+} force_plate_axis_t;
+
+/**
+ * Plate-level quantities of one frame
+ */
+typedef struct {
+    int32_t fz_mn;              /**< Vertical force (mN) */
+    int32_t mx_mnm;             /**< Moment about x (mN·m) */
+    int32_t my_mnm;             /**< Moment about y (mN·m) */
+    int32_t cop_x_um;           /**< Centre of pressure (µm), 0 when not valid */
+    int32_t cop_y_um;
+    bool cop_valid;             /**< Fz at or above the threshold */
+} force_plate_output_t;
+
+/**
+ * One calibration matrix
+ */
+typedef struct {
+    uint8_t num_channels;
+    int32_t coef[FORCE_PLATE_OUTPUTS][LOADCELL_MAX_CHANNELS];  /**< Q20 */
+    int32_t min_fz_mn;                                          /**< COP threshold */
+} force_plate_matrix_t;
+
+/**
+ * Plate: the published matrix and a spare one for updates
+ */
+typedef struct {
+    force_plate_matrix_t banks[2];
+    bank_pair_t pair;           /**< Which bank is published, and which one is in use */
+} force_plate_t;
+
+/* ============================================================================
+ * Configuration (one task at a time)
+ * ============================================================================ */
+
+/**
+ * @brief Start with Fz as the plain channel sum and no moments
+ *
+ * @param plate Plate to initialize (before acquisition starts)
+ * @param num_channels Channels summed into the plate outputs
+ */
+void force_plate_init(force_plate_t *plate, uint8_t num_channels);
+
+/**
+ * @brief Ideal matrix from the cell positions: unit gains, no cross-talk
+ *
+ * @param plate Plate
+ * @param x_m Cell x positions (metres)
+ * @param y_m Cell y positions (metres)
+ * @param num_channels Number of cells (at most the plate's channels); others are zeroed
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for out-of-range positions,
+ *         or the error of bank_pair_begin_update()
+ */
+esp_err_t force_plate_set_geometry(force_plate_t *plate, const float *x_m, const float *y_m,
+                                   uint8_t num_channels);
+
+/**
+ * @brief Replace one matrix coefficient
+ *
+ * @param plate Plate
+ * @param axis Row
+ * @param channel Column
+ * @param value Gain (Fz row) or lever arm in metres (moment rows)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a bad index or magnitude,
+ *         or the error of bank_pair_begin_update()
+ */
+esp_err_t force_plate_set_coef(force_plate_t *plate, force_plate_axis_t axis, uint8_t channel, float value);
+
+/**
+ * @brief Set the Fz below which no COP is reported
+ */
+esp_err_t force_plate_set_min_fz(force_plate_t *plate, float min_fz_n);
+
+/**
+ * @brief Read one coefficient back (gain or metres)
+ */
+float force_plate_get_coef(const force_plate_t *plate, force_plate_axis_t axis, uint8_t channel);
+
+/**
+ * @brief Name of a matrix row, for logs
+ */
+const char *force_plate_axis_name(force_plate_axis_t axis);
+
+/* ============================================================================
+ * Per frame (acquisition task)
+ * ============================================================================ */
+
+/**
+ * @brief Apply the published matrix to one frame's forces
+ *
+ * @param plate Plate
+ * @param force_mn Channel forces (millinewtons)
+ * @param out Receives Fz, the moments and the COP
+ */
+void force_plate_compute(force_plate_t *plate, const int32_t *force_mn, force_plate_output_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FORCE_PLATE_H */
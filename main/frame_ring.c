@@ -0,0 +1,126 @@
+/**
+ * @file frame_ring.c
+ * @brief Lock-free ring of loadcell frames with one cursor per consumer
+ */
+
+#include <string.h>
+#include "frame_ring.h"
+
+#define FRAME_RING_MASK         (FRAME_RING_CAPACITY - 1)
+#define FRAME_RAW_MAX           0x7FFFFF
+#define FRAME_RAW_MIN           (-0x800000)
+
+_Static_assert((FRAME_RING_CAPACITY & FRAME_RING_MASK) == 0, "FRAME_RING_CAPACITY must be a power of two");
+
+void frame_ring_init(frame_ring_t *ring)
+{
+    memset(ring->slots, 0, sizeof(ring->slots));
+    for (int i = 0; i < FRAME_RING_CAPACITY; i++) {
+        atomic_init(&ring->slots[i].stamp, 0);
+    }
+    atomic_init(&ring->head, 0);
+}
+
+uint32_t frame_ring_push(frame_ring_t *ring, const loadcell_frame_t *frame)
+{
+    uint32_t seq = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    frame_ring_slot_t *slot = &ring->slots[seq & FRAME_RING_MASK];
+
+    /* Mark the slot as being written before touching the frame */
+    atomic_store_explicit(&slot->stamp, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->frame = *frame;
+    slot->frame.seq = seq;
+    atomic_store_explicit(&slot->stamp, seq + 1, memory_order_release);
+    atomic_store_explicit(&ring->head, seq + 1, memory_order_release);
+    return seq;
+}
+
+uint32_t frame_ring_capture(frame_ring_t *ring, const loadcell_t *device, force_plate_t *plate,
+                            int64_t timestamp_us, uint8_t flags)
+{
+    loadcell_frame_t frame = {
+        .timestamp_us = device->aligned_us ? device->aligned_us : timestamp_us,
+        .num_channels = device->num_channels,
+        .flags = flags,
+    };
+    for (int ch = 0; ch < device->num_channels; ch++) {
+        int32_t raw = device->measurements[ch].raw_adc;
+        frame.raw[ch] = raw;
+        frame.force_mn[ch] = device->measurements[ch].force_mn;
+        if (raw >= FRAME_RAW_MAX || raw <= FRAME_RAW_MIN) {
+            frame.flags |= FRAME_FLAG_CLIPPED;
+        }
+        if (loadcell_get_calib_state(device, ch) != CALIB_STATE_CALIBRATED) {
+            frame.flags |= FRAME_FLAG_UNCALIBRATED;
+        }
+    }
+    if (plate) {
+        force_plate_compute(plate, frame.force_mn, &frame.plate);
+    }
+    return frame_ring_push(ring, &frame);
+}
+
+/* Copy frame seq out of its slot; false if the slot no longer (or not yet) holds it intact */
+static bool frame_ring_copy(const frame_ring_t *ring, uint32_t seq, loadcell_frame_t *frame)
+{
+    const frame_ring_slot_t *slot = &ring->slots[seq & FRAME_RING_MASK];
+
+    uint32_t stamp = atomic_load_explicit(&slot->stamp, memory_order_acquire);
+    if (stamp != seq + 1) {
+        return false;
+    }
+    *frame = slot->frame;
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&slot->stamp, memory_order_relaxed) == stamp;
+}
+
+void frame_ring_reader_init(frame_ring_reader_t *reader, const frame_ring_t *ring)
+{
+    reader->ring = ring;
+    reader->cursor = atomic_load_explicit(&ring->head, memory_order_acquire);
+    reader->dropped = 0;
+}
+
+bool frame_ring_read(frame_ring_reader_t *reader, loadcell_frame_t *frame)
+{
+    const frame_ring_t *ring = reader->ring;
+
+    for (;;) {
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (reader->cursor == head) {
+            return false;
+        }
+        /* Lapped: skip to the oldest frame the ring still holds */
+        if (head - reader->cursor > FRAME_RING_CAPACITY) {
+            reader->dropped += head - reader->cursor - FRAME_RING_CAPACITY;
+            reader->cursor = head - FRAME_RING_CAPACITY;
+        }
+        if (frame_ring_copy(ring, reader->cursor, frame)) {
+            reader->cursor++;
+            return true;
+        }
+        /* Overwritten while we looked: that frame is gone */
+        reader->dropped++;
+        reader->cursor++;
+    }
+}
+
+uint32_t frame_ring_pending(const frame_ring_reader_t *reader)
+{
+    uint32_t pending = atomic_load_explicit(&reader->ring->head, memory_order_acquire) - reader->cursor;
+    return pending > FRAME_RING_CAPACITY ? FRAME_RING_CAPACITY : pending;
+}
+
+bool frame_ring_latest(const frame_ring_t *ring, loadcell_frame_t *frame)
+{
+    for (;;) {
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (head == 0) {
+            return false;
+        }
+        if (frame_ring_copy(ring, head - 1, frame)) {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/**
+ * @file frame_ring.h
+ * @brief Lock-free ring of loadcell frames with one cursor per consumer
+ *
+ * The acquisition task is the only producer: it copies each scan into the
+ * next slot and never waits for anyone. Consumers (BLE, UART, logging) each
+ * hold a frame_ring_reader_t with their own cursor and drain at their own
+ * pace. A reader that falls more than FRAME_RING_CAPACITY frames behind
+ * loses the oldest ones; they are counted in its dropped total and reading
+ * resumes at the oldest frame still held.
+ *
+ * Every slot carries a stamp (sequence + 1, 0 while being written). Readers
+ * copy the frame and check the stamp again, so a slot overwritten mid-copy
+ * is detected and never returned torn.
+ */
+
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "loadcell.h"
+#include "force_plate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_RING_CAPACITY     64      /**< Frames held (power of two) */
+
+/* Frame quality flags */
+#define FRAME_FLAG_LATE         0x01    /**< Scan ended after the next deadline */
+#define FRAME_FLAG_GAP          0x02    /**< Deadlines were skipped before this frame */
+#define FRAME_FLAG_CLIPPED      0x04    /**< A channel read the ADC's full-scale code */
+#define FRAME_FLAG_UNCALIBRATED 0x08    /**< A channel is not fully calibrated */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * One scan of every channel
+ */
+typedef struct {
+    uint32_t seq;                               /**< Position in the ring's stream (set by push) */
+    int64_t timestamp_us;                       /**< Aligned instant of the forces, else the deadline (esp_timer us) */
+    uint8_t num_channels;
+    uint8_t flags;                              /**< FRAME_FLAG_* */
+    int32_t raw[LOADCELL_MAX_CHANNELS];         /**< Raw 24-bit codes */
+    int32_t force_mn[LOADCELL_MAX_CHANNELS];    /**< Force in millinewtons */
+    force_plate_output_t plate;                 /**< Fz, moments and COP (zero without a plate) */
+} loadcell_frame_t;
+
+typedef struct {
+    _Atomic uint32_t stamp;                     /**< seq + 1 of the frame held, 0 while written */
+    loadcell_frame_t frame;
+} frame_ring_slot_t;
+
+/**
+ * Single-producer ring
+ */
+typedef struct {
+    frame_ring_slot_t slots[FRAME_RING_CAPACITY];
+    _Atomic uint32_t head;                      /**< Frames pushed so far */
+} frame_ring_t;
+
+/**
+ * Consumer cursor
+ */
+typedef struct {
+    const frame_ring_t *ring;
+    uint32_t cursor;                            /**< Sequence of the next frame to read */
+    uint32_t dropped;                           /**< Frames overwritten before this reader got them */
+} frame_ring_reader_t;
+
+/* ============================================================================
+ * Producer
+ * ============================================================================ */
+
+/**
+ * @brief Empty the ring (no readers or producer may be active)
+ */
+void frame_ring_init(frame_ring_t *ring);
+
+/**
+ * @brief Publish a frame; never blocks
+ *
+ * @param ring Ring (one producer only)
+ * @param frame Frame to copy in; its seq is assigned here
+ * @return Sequence number given to the frame
+ */
+uint32_t frame_ring_push(frame_ring_t *ring, const loadcell_frame_t *frame);
+
+/**
+ * @brief Publish the loadcell's current measurements as a frame
+ *
+ * Sets FRAME_FLAG_CLIPPED and FRAME_FLAG_UNCALIBRATED from the measurements
+ * and channel states, on top of the flags passed in, and applies the plate's
+ * calibration matrix to the forces.
+ *
+ * @param ring Ring (one producer only)
+ * @param device Loadcell device just read
+ * @param plate Plate matrix, or NULL for channel forces only
+ * @param timestamp_us Frame time, replaced by the device's aligned_us when
+ *                     its forces were aligned to one instant
+ * @param flags FRAME_FLAG_LATE / FRAME_FLAG_GAP from the scheduler
+ * @return Sequence number given to the frame
+ */
+uint32_t frame_ring_capture(frame_ring_t *ring, const loadcell_t *device, force_plate_t *plate,
+                            int64_t timestamp_us, uint8_t flags);
+
+/* ============================================================================
+ * Consumers
+ * ============================================================================ */
+
+/**
+ * @brief Attach a reader; it sees frames pushed from now on
+ */
+void frame_ring_reader_init(frame_ring_reader_t *reader, const frame_ring_t *ring);
+
+/**
+ * @brief Read the reader's next frame; never blocks
+ *
+ * @param reader Reader cursor
+ * @param frame Receives the frame
+ * @return true if a frame was read, false if the reader is up to date
+ */
+bool frame_ring_read(frame_ring_reader_t *reader, loadcell_frame_t *frame);
+
+/**
+ * @brief Frames waiting for this reader (up to FRAME_RING_CAPACITY)
+ */
+uint32_t frame_ring_pending(const frame_ring_reader_t *reader);
+
+/**
+ * @brief Copy the newest frame without a cursor
+ *
+ * @return false if nothing was pushed yet
+ */
+bool frame_ring_latest(const frame_ring_t *ring, loadcell_frame_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_RING_H */
@@ -13,6 +13,8 @@
 #include "freertos/task.h"
 #include "driver/gpio.h"  /* Added for gpio functions */
 #include "ads1261.h"
+#include "ads1261_seq.h"
+#include "ads1261_timing.h"
 #include "loadcell.h"
 
 static const char *TAG = "LoadCell";
@@ -21,61 +23,387 @@ static const char *TAG = "LoadCell";
 #define ADC_MAX_VALUE           0x7FFFFF        /* Max 24-bit signed: 2^23-1 */
 #define ADC_MIN_VALUE           -0x800000       /* Min 24-bit signed: -2^23 */
 
-static ads1261_t adc_device;
+#define LOADCELL_DRDY_MARGIN_MS 10              /* DRDY timeout on top of twice the settle time */
+#define LOADCELL_STEP_OVERHEAD_US 15            /* Bus/CPU time per scan step beyond settling (host model) */
+#define LOADCELL_READ_STATUS    true            /* Frame each RDATA with STATUS to catch stale reads */
+#define LOADCELL_READ_CRC       true            /* CRC-check every response (long cables at 8 MHz) */
+#define LOADCELL_N_PER_COUNT    (1.0f / LOADCELL_COUNTS_PER_N)
+
+_Static_assert(LOADCELL_COUNTS_PER_N == LOADCELL_Q_MN_PER_N, "hardware-calibrated codes must be millinewtons");
+/* Tare/span go into per-channel OFCAL/FSCAL. Swapping them costs a few register
+ * writes per mux change; set false to keep calibration in software instead. */
+#define LOADCELL_HW_CALIBRATION true
+
+/* Differential input pairs of each ADC's channels (Wheatstone bridge per loadcell) */
+static const uint8_t channel_pos_inputs[LOADCELL_CHANNELS_PER_ADC] = {0, 2, 4, 6};
+static const uint8_t channel_neg_inputs[LOADCELL_CHANNELS_PER_ADC] = {1, 3, 5, 7};
+
+/* INPMUX value for a channel: MUXP in upper 4 bits, MUXN in lower 4 bits */
+static inline uint8_t loadcell_inpmux(uint8_t channel)
+{
+    uint8_t pair = channel % LOADCELL_CHANNELS_PER_ADC;
+    return (channel_pos_inputs[pair] << 4) | channel_neg_inputs[pair];
+}
+
+/* ADC a channel is wired to, and its step in that ADC's scan list */
+static inline ads1261_t *loadcell_adc(loadcell_t *device, uint8_t channel)
+{
+    return &device->adcs[channel / LOADCELL_CHANNELS_PER_ADC];
+}
+
+static inline ads1261_seq_step_t *loadcell_step(loadcell_t *device, uint8_t channel)
+{
+    return &device->seqs[channel / LOADCELL_CHANNELS_PER_ADC].steps[channel % LOADCELL_CHANNELS_PER_ADC];
+}
+
+/* Build one ADC's scan list: one continuous-mode step per channel */
+static esp_err_t loadcell_build_scan(loadcell_t *device, uint8_t adc, uint8_t pga_gain)
+{
+    ads1261_seq_step_t steps[LOADCELL_CHANNELS_PER_ADC];
+    for (int ch = 0; ch < LOADCELL_CHANNELS_PER_ADC; ch++) {
+        steps[ch] = (ads1261_seq_step_t) {
+            .inpmux = loadcell_inpmux(ch),
+            .pga = pga_gain & 0x07,     /* GAIN[2:0], BYPASS=0 */
+            .settle_us = 0,
+            .mode = ADS1261_CONV_CONTINUOUS,
+            .hw_cal = true,
+            .ofcal = 0,
+            .fscal = ADS1261_FSCAL_UNITY,
+        };
+    }
+    /* Time out after twice the first-conversion latency of the configured filter and rate */
+    uint32_t drdy_timeout_ms = 2 * ads1261_device_settle_time_us(&device->adcs[adc]) / 1000 + LOADCELL_DRDY_MARGIN_MS;
+    return ads1261_seq_init(&device->seqs[adc], &device->adcs[adc], steps, LOADCELL_CHANNELS_PER_ADC,
+                            drdy_timeout_ms);
+}
+
+/* Start an update of a channel's spare set, a copy of the published one; publish or cancel it after */
+static esp_err_t loadcell_cal_begin_update(loadcell_channel_t *ch, loadcell_cal_set_t **cal)
+{
+    esp_err_t ret = bank_pair_begin_update(&ch->cal_pair, ch->cal_banks, sizeof(ch->cal_banks[0]), (void **)cal);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Channel %d calibration not updated: %s", ch->channel_id, esp_err_to_name(ret));
+        return ret;
+    }
+    (*cal)->version++;
+    return ESP_OK;
+}
+
+/* Calibration state of the published set (any task) */
+static loadcell_calib_state_t loadcell_cal_state(const loadcell_channel_t *ch)
+{
+    uint32_t seq;
+    loadcell_calib_state_t state;
+    do {
+        state = ch->cal_banks[bank_pair_read_begin(&ch->cal_pair, &seq)].calib_state;
+    } while (bank_pair_read_retry(&ch->cal_pair, seq));
+    return state;
+}
+
+/* Software offset of the published set (any task) */
+static int32_t loadcell_cal_offset(const loadcell_channel_t *ch)
+{
+    uint32_t seq;
+    int32_t offset_raw;
+    do {
+        offset_raw = ch->cal_banks[bank_pair_read_begin(&ch->cal_pair, &seq)].offset_raw;
+    } while (bank_pair_read_retry(&ch->cal_pair, seq));
+    return offset_raw;
+}
+
+/*
+ * Scan start: hold the published set until the scan ends, and queue its
+ * OFCAL/FSCAL for the next switch to the channel
+ */
+static void loadcell_cal_take_up(loadcell_t *device, loadcell_channel_t *ch)
+{
+    const loadcell_cal_set_t *cal = &ch->cal_banks[bank_pair_take(&ch->cal_pair)];
+    ch->cal = cal;
+
+    ads1261_seq_step_t *step = loadcell_step(device, ch->channel_id);
+    if (step->ofcal != cal->hw_offset || step->fscal != cal->hw_gain) {
+        step->ofcal = cal->hw_offset;
+        step->fscal = cal->hw_gain;
+        /* Conversions already in the decimator were made with the old correction */
+        loadcell_decim_request_reset(&ch->decim);
+    }
+}
+
+/* Drop a set's multi-point calibration: its codes no longer mean what they did */
+static void loadcell_clear_points(loadcell_cal_set_t *cal)
+{
+    cal->lut_active = false;
+    cal->num_cal_points = 0;
+}
+
+/* Force of a net code (integer only: no soft-float per sample) */
+static inline int32_t loadcell_net_force_mn(const loadcell_cal_set_t *cal, int32_t net)
+{
+    if (cal->lut_active) {
+        /* Multi-point calibration: one table lookup and interpolation */
+        return loadcell_lut_eval(&cal->lut, net);
+    }
+    if (cal->hw_calibrated) {
+        /* The ADC already removed the tare and normalized the span: codes are millinewtons */
+        return net;
+    }
+    return loadcell_q_force_mn(&cal->scale_q, net);
+}
+
+/* Convert a raw conversion into a calibrated measurement */
+static inline void loadcell_apply_calibration(const loadcell_cal_set_t *cal, int32_t raw_value,
+                                              loadcell_measurement_t *measurement)
+{
+    /* offset_raw is the software tare, or only the tracked drift when OFCAL holds the tare */
+    measurement->raw_adc = raw_value;
+    measurement->net = raw_value - cal->offset_raw;
+    measurement->force_mn = loadcell_net_force_mn(cal, measurement->net);
+}
+
+/* Set a channel's software scale and its integer form together */
+static void loadcell_set_scale(loadcell_cal_set_t *cal, float n_per_count)
+{
+    cal->scale_factor = n_per_count;
+    loadcell_q_from_float(n_per_count, &cal->scale_q);
+}
+
+/* Uncalibrated: raw codes at unity OFCAL/FSCAL, one N per count */
+static void loadcell_cal_defaults(loadcell_cal_set_t *cal)
+{
+    cal->calib_state = CALIB_STATE_UNCALIBRATED;
+    cal->offset_raw = 0;
+    cal->zero_tracked_mn = 0;
+    loadcell_set_scale(cal, 1.0f);
+    cal->hw_calibrated = false;
+    cal->hw_offset = 0;
+    cal->hw_gain = ADS1261_FSCAL_UNITY;
+    loadcell_clear_points(cal);
+}
+
+/* Take a tare average as the channel's zero */
+static esp_err_t loadcell_apply_tare(loadcell_t *device, uint8_t channel, int32_t avg)
+{
+    loadcell_channel_t *ch = &device->channels[channel];
+    loadcell_cal_set_t *cal;
+    esp_err_t ret = loadcell_cal_begin_update(ch, &cal);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Fold the average into the channel's OFCAL: (input - OFCAL) * FSCAL / 2^22 reads zero
+    loadcell_clear_points(cal);
+    int64_t ofcal = cal->hw_offset + ((int64_t)avg * ADS1261_FSCAL_UNITY) / (int64_t)cal->hw_gain;
+
+    if (LOADCELL_HW_CALIBRATION && ofcal >= ADS1261_OFCAL_MIN && ofcal <= ADS1261_OFCAL_MAX) {
+        cal->hw_offset = (int32_t)ofcal;
+        cal->offset_raw = 0;
+    } else {
+        ESP_LOGD(TAG, "Channel %d offset kept in software", channel);
+        cal->offset_raw = avg;
+    }
+    cal->zero_tracked_mn = 0;
+    cal->calib_state = CALIB_STATE_TARE_DONE;
+    int32_t hw_offset = cal->hw_offset;
+    bank_pair_publish(&ch->cal_pair);
+
+    ESP_LOGI(TAG, "Tare calibration for channel %d: offset=%ld (OFCAL=%ld)",
+             channel, (long)avg, (long)hw_offset);
+    return ESP_OK;
+}
+
+/* Take an average with known_force_n applied as the channel's span */
+static esp_err_t loadcell_apply_span(loadcell_t *device, uint8_t channel, float known_force_n, int32_t avg)
+{
+    loadcell_channel_t *ch = &device->channels[channel];
+    loadcell_cal_set_t *cal;
+    esp_err_t ret = loadcell_cal_begin_update(ch, &cal);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    /* Reset (or spanned) since the tare the load was measured against */
+    if (cal->calib_state != CALIB_STATE_TARE_DONE) {
+        bank_pair_cancel(&ch->cal_pair);
+        ESP_LOGE(TAG, "Must perform tare calibration before full-scale calibration on channel %d", channel);
+        return ESP_ERR_INVALID_STATE;
+    }
+    int32_t delta_raw = avg - cal->offset_raw;
+    if (delta_raw == 0) {
+        bank_pair_cancel(&ch->cal_pair);
+        ESP_LOGE(TAG, "Zero delta detected for channel %d - invalid calibration", channel);
+        return ESP_FAIL;
+    }
+
+    // Calculate scale factor: how many raw units per Newton
+    loadcell_clear_points(cal);
+    // Preferred: rescale FSCAL so the known force reads LOADCELL_COUNTS_PER_N per Newton
+    double fscal = (double)cal->hw_gain * known_force_n * LOADCELL_COUNTS_PER_N / delta_raw;
+    if (LOADCELL_HW_CALIBRATION && cal->offset_raw == 0 && fscal >= 1.0 && fscal <= ADS1261_FSCAL_MAX) {
+        cal->hw_gain = (uint32_t)lround(fscal);
+        cal->hw_calibrated = true;
+        loadcell_set_scale(cal, LOADCELL_N_PER_COUNT);
+    } else {
+        ESP_LOGD(TAG, "Channel %d span kept in software", channel);
+        cal->hw_calibrated = false;
+        loadcell_set_scale(cal, known_force_n / (float)delta_raw);
+    }
+    cal->calib_state = CALIB_STATE_CALIBRATED;
+    uint32_t hw_gain = cal->hw_gain;
+    bank_pair_publish(&ch->cal_pair);
+
+    ESP_LOGI(TAG, "Scale calibration for channel %d: avg=%ld, delta=%ld, scale=%.6f/N (FSCAL=0x%06lX)",
+             channel, (long)avg, (long)delta_raw, (double)delta_raw / known_force_n, (unsigned long)hw_gain);
+    return ESP_OK;
+}
+
+/* Whether a channel with calibration set cal can take another calibration point */
+static esp_err_t loadcell_check_point(const loadcell_cal_set_t *cal, uint8_t channel)
+{
+    if (cal->calib_state != CALIB_STATE_TARE_DONE && cal->calib_state != CALIB_STATE_CALIBRATED) {
+        ESP_LOGE(TAG, "Must perform tare calibration before adding calibration points on channel %d", channel);
+        return ESP_ERR_INVALID_STATE;
+    }
+    /* The tare is the zero point */
+    if (cal->num_cal_points >= LOADCELL_CAL_MAX_POINTS - 1) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+/* Record an average with known_force_n applied as the channel's next calibration point */
+static esp_err_t loadcell_apply_point(loadcell_t *device, uint8_t channel, float known_force_n, int32_t avg)
+{
+    loadcell_channel_t *ch = &device->channels[channel];
+    loadcell_cal_set_t *cal;
+    esp_err_t ret = loadcell_cal_begin_update(ch, &cal);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = loadcell_check_point(cal, channel);
+    if (ret != ESP_OK) {
+        bank_pair_cancel(&ch->cal_pair);
+        return ret;
+    }
+
+    int32_t net = avg - cal->offset_raw;
+    if (net == 0) {
+        bank_pair_cancel(&ch->cal_pair);
+        ESP_LOGE(TAG, "Calibration point at the tare zero on channel %d - load not applied?", channel);
+        return ESP_ERR_INVALID_STATE;
+    }
+    loadcell_cal_point_t point = { .net = net, .force_mn = (int32_t)lroundf(known_force_n * LOADCELL_Q_MN_PER_N) };
+    cal->cal_points[cal->num_cal_points++] = point;
+    uint8_t num_points = cal->num_cal_points;
+    bank_pair_publish(&ch->cal_pair);
+
+    ESP_LOGI(TAG, "Calibration point %u for channel %d: %.3f N at net code %ld", num_points, channel,
+             known_force_n, (long)point.net);
+    return ESP_OK;
+}
 
 /* ============================================================================
  * Initialization & Deinit
  * ============================================================================ */
 
+/* Bring up and configure one ADC of the plate */
+static esp_err_t loadcell_init_adc(loadcell_t *device, uint8_t adc, spi_host_device_t host,
+                                   const loadcell_adc_pins_t *pins)
+{
+    ads1261_t *dev = &device->adcs[adc];
+
+    esp_err_t ret = ads1261_init(dev, host, pins->cs_pin, pins->drdy_pin);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize ADS1261 #%u (CS %d)", adc, pins->cs_pin);
+        return ret;
+    }
+
+    /* Configure ADS1261 */
+    ads1261_set_pga(dev, device->pga_gain);
+    ads1261_set_datarate(dev, device->data_rate);
+    ads1261_set_ref(dev, ADS1261_REFSEL_EXT1);
+
+    ret = ads1261_set_integrity(dev, LOADCELL_READ_STATUS, LOADCELL_READ_CRC);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to enable STATUS/CRC read framing on ADS1261 #%u: %s", adc, esp_err_to_name(ret));
+    }
+
+    ret = loadcell_build_scan(device, adc, device->pga_gain);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up channel scan on ADS1261 #%u: %s", adc, esp_err_to_name(ret));
+        ads1261_deinit(dev);
+    }
+    return ret;
+}
+
 esp_err_t loadcell_init(loadcell_t *device, spi_host_device_t host,
                        int cs_pin, int drdy_pin,
                        uint8_t pga_gain, uint8_t data_rate)
 {
-    if (!device) {
-        return ESP_FAIL;
+    const loadcell_adc_pins_t pins = { .cs_pin = cs_pin, .drdy_pin = drdy_pin };
+    return loadcell_init_multi(device, host, &pins, 1, pga_gain, data_rate);
+}
+
+esp_err_t loadcell_init_multi(loadcell_t *device, spi_host_device_t host,
+                              const loadcell_adc_pins_t *pins, uint8_t num_adcs,
+                              uint8_t pga_gain, uint8_t data_rate)
+{
+    if (!device || !pins || num_adcs == 0 || num_adcs > LOADCELL_MAX_ADCS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    /* Devices sharing the bus can only be told apart by their chip selects */
+    for (uint8_t a = 0; num_adcs > 1 && a < num_adcs; a++) {
+        if (pins[a].cs_pin < 0) {
+            ESP_LOGE(TAG, "ADS1261 #%u needs a CS pin on a shared bus", a);
+            return ESP_ERR_INVALID_ARG;
+        }
     }
-    /* Initialize ads1261 device structure */
-    memset(&adc_device, 0, sizeof(adc_device));
-    adc_device.cs_pin = -1;
-    adc_device.drdy_pin = -1;
-    memset(device, 0, sizeof(loadcell_t));
 
-    device->cs_pin = cs_pin;
-    device->drdy_pin = drdy_pin;
+    memset(device, 0, sizeof(loadcell_t));
+    device->num_adcs = num_adcs;
+    device->num_channels = num_adcs * LOADCELL_CHANNELS_PER_ADC;
     device->pga_gain = pga_gain;
     device->data_rate = data_rate;
+    device->oversampling = 1;
+    atomic_init(&device->align_mode, LOADCELL_ALIGN_OFF);
+    atomic_init(&device->zero_band_mn, 0);
+    atomic_init(&device->zero_limit_mn, LOADCELL_ZERO_LIMIT_MN);
+    atomic_init(&device->job.state, LOADCELL_JOB_IDLE);
+    atomic_init(&device->job.progress, 0);
+    atomic_init(&device->job.cancel, false);
+    device->zero_block_frames = LOADCELL_ZERO_BLOCK_FRAMES;
 
     /* SPI bus already initialized by main.c - don't reinitialize */
     ESP_LOGI(TAG, "Using pre-initialized SPI bus on host %d", host);
 
-    /* Initialize ADS1261 */
-    esp_err_t ret = ads1261_init(&adc_device, host, cs_pin, drdy_pin);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize ADS1261");
-        return ret;
+    for (uint8_t a = 0; a < num_adcs; a++) {
+        device->adcs[a].cs_pin = -1;
+        device->adcs[a].drdy_pin = -1;
+        esp_err_t ret = loadcell_init_adc(device, a, host, &pins[a]);
+        if (ret != ESP_OK) {
+            while (a-- > 0) {
+                ads1261_deinit(&device->adcs[a]);
+            }
+            return ret;
+        }
     }
 
-    /* Configure ADS1261 */
-    ads1261_set_pga(&adc_device, pga_gain);
-    ads1261_set_datarate(&adc_device, data_rate);
-    ads1261_set_ref(&adc_device, ADS1261_REFSEL_EXT1);
-
     /* Initialize channels */
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < device->num_channels; i++) {
         device->channels[i].channel_id = i;
-        device->channels[i].calib_state = CALIB_STATE_UNCALIBRATED;
-        device->channels[i].offset_raw = 0;
-        device->channels[i].scale_factor = 1.0;
-        device->channels[i].stats.min_force = 0.0;
-        device->channels[i].stats.max_force = 0.0;
-        device->channels[i].stats.avg_force = 0.0;
-        device->channels[i].stats.sample_count = 0;
+        loadcell_cal_defaults(&device->channels[i].cal_banks[0]);
+        bank_pair_init(&device->channels[i].cal_pair);
+        device->channels[i].cal = &device->channels[i].cal_banks[0];
+        loadcell_decim_init(&device->channels[i].decim, 1);
+        loadcell_despike_init(&device->channels[i].despike);
+        loadcell_filter_init(&device->channels[i].filter);
+        loadcell_align_reset(&device->channels[i].align);
+        loadcell_stats_init(&device->channels[i].stats);
     }
 
     device->frame_count = 0;
 
     ESP_LOGI(TAG, "Loadcell driver initialized");
-    ESP_LOGI(TAG, "  Channels: 4 (differential configuration)");
+    ESP_LOGI(TAG, "  Channels: %u on %u ADS1261 (differential configuration)",
+             device->num_channels, device->num_adcs);
     ESP_LOGI(TAG, "  PGA Gain: %d", pga_gain);
     ESP_LOGI(TAG, "  Data Rate: %d", data_rate);
 
@@ -88,7 +416,9 @@ esp_err_t loadcell_deinit(loadcell_t *device)
         return ESP_FAIL;
     }
 
-    ads1261_deinit(&adc_device);
+    for (uint8_t a = 0; a < device->num_adcs; a++) {
+        ads1261_deinit(&device->adcs[a]);
+    }
     ESP_LOGI(TAG, "Loadcell driver deinitialized");
 
     return ESP_OK;
@@ -98,106 +428,522 @@ esp_err_t loadcell_deinit(loadcell_t *device)
  * Measurement Functions
  * ============================================================================ */
 
+/*
+ * Sequencer callback: every conversion feeds the channel's decimator; the
+ * last of a burst runs while the next channel's mux write is on the bus and
+ * turns the decimated code into the frame's measurement
+ */
+static void loadcell_on_sample(const ads1261_sample_t *sample, void *ctx)
+{
+    loadcell_t *device = (loadcell_t *)ctx;
+    uint8_t channel = sample->seq * LOADCELL_CHANNELS_PER_ADC + sample->step;
+    loadcell_channel_t *ch = &device->channels[channel];
+
+    loadcell_decim_push(&ch->decim, sample->raw);
+    if (!sample->burst_end) {
+        return;
+    }
+
+    loadcell_measurement_t *m = &device->measurements[channel];
+    m->timestamp_us = sample->timestamp_us;
+    loadcell_apply_calibration(ch->cal, loadcell_decim_end_burst(&ch->decim), m);
+    m->force_mn = loadcell_despike_run(&ch->despike, m->force_mn);
+    m->force_mn = loadcell_filter_run(&ch->filter, m->force_mn);
+    loadcell_stats_update(&ch->stats, m->force_mn);
+    loadcell_align_push(&ch->align, sample->timestamp_us, m->force_mn);
+}
+
+/*
+ * Zero tracking: average the net codes of quiet, unloaded frames in blocks
+ * and move each calibrated channel's offset part of the way to the block
+ * mean. A loaded or moving frame drops the block.
+ */
+static void loadcell_track_zero(loadcell_t *device)
+{
+    int32_t band = atomic_load_explicit(&device->zero_band_mn, memory_order_relaxed);
+    /* A calibration job sets the zero itself */
+    if (band <= 0 || atomic_load_explicit(&device->job.state, memory_order_relaxed) == LOADCELL_JOB_RUNNING) {
+        device->zero_frames = 0;
+        return;
+    }
+
+    int64_t total = 0;
+    int tracked = 0;
+    for (int i = 0; i < device->num_channels; i++) {
+        if (loadcell_cal_state(&device->channels[i]) == CALIB_STATE_CALIBRATED) {
+            total += device->measurements[i].force_mn;
+            tracked++;
+        }
+    }
+    if (tracked == 0 || total > band || total < -band) {
+        device->zero_frames = 0;
+        return;
+    }
+
+    if (device->zero_frames == 0) {
+        device->zero_min_mn = device->zero_max_mn = (int32_t)total;
+        for (int i = 0; i < device->num_channels; i++) {
+            device->channels[i].zero_sum = 0;
+        }
+    } else {
+        device->zero_min_mn = total < device->zero_min_mn ? (int32_t)total : device->zero_min_mn;
+        device->zero_max_mn = total > device->zero_max_mn ? (int32_t)total : device->zero_max_mn;
+        if (device->zero_max_mn - device->zero_min_mn > band) {
+            device->zero_frames = 0;    /* Moving: start again from the next frame */
+            return;
+        }
+    }
+    for (int i = 0; i < device->num_channels; i++) {
+        device->channels[i].zero_sum += device->measurements[i].net;
+    }
+    if (++device->zero_frames < device->zero_block_frames) {
+        return;
+    }
+
+    /* Quiet block: one rounded division per channel */
+    int32_t limit = atomic_load_explicit(&device->zero_limit_mn, memory_order_relaxed);
+    int64_t frames = device->zero_frames;
+    int64_t divisor = frames << LOADCELL_ZERO_STEP_SHIFT;
+    device->zero_frames = 0;
+    for (int i = 0; i < device->num_channels; i++) {
+        loadcell_channel_t *ch = &device->channels[i];
+        int64_t sum = ch->zero_sum;
+        int32_t step = (int32_t)((sum >= 0 ? sum + divisor / 2 : sum - divisor / 2) / divisor);
+        loadcell_cal_set_t *cal;
+        if (step == 0 || loadcell_cal_begin_update(ch, &cal) != ESP_OK) {
+            continue;   /* Settled, or another update under way: the next block tries again */
+        }
+        int32_t step_mn = loadcell_net_force_mn(cal, step);
+        if (cal->calib_state != CALIB_STATE_CALIBRATED || llabs((int64_t)cal->zero_tracked_mn + step_mn) > limit) {
+            bank_pair_cancel(&ch->cal_pair);
+            continue;   /* Not calibrated, or drifted past the limit: that needs a tare */
+        }
+        /* Taken up with the next frame: the block's frames all used the offset before it */
+        cal->offset_raw += step;
+        cal->zero_tracked_mn += step_mn;
+        bank_pair_publish(&ch->cal_pair);
+    }
+    device->zero_updates++;
+}
+
+/* Interpolate every channel's force to the earliest anchor of the frame */
+static void loadcell_align_frame(loadcell_t *device)
+{
+    loadcell_align_mode_t mode = (loadcell_align_mode_t)atomic_load_explicit(&device->align_mode,
+                                                                             memory_order_relaxed);
+    device->aligned_us = 0;
+    if (mode == LOADCELL_ALIGN_OFF) {
+        return;
+    }
+
+    int64_t t_us = INT64_MAX;
+    for (int i = 0; i < device->num_channels; i++) {
+        const loadcell_align_history_t *h = &device->channels[i].align;
+        if (!loadcell_align_ready(h, mode)) {
+            return;     /* First frames after start: left as converted */
+        }
+        int64_t anchor = loadcell_align_anchor(h, mode);
+        t_us = anchor < t_us ? anchor : t_us;
+    }
+
+    for (int i = 0; i < device->num_channels; i++) {
+        loadcell_measurement_t *m = &device->measurements[i];
+        m->force_mn = loadcell_align_at(&device->channels[i].align, mode, t_us);
+        m->timestamp_us = (uint64_t)t_us;
+    }
+    device->aligned_us = t_us;
+}
+
+/* Average the selected channels' codes of this frame into the running job; apply them after the last */
+static void loadcell_run_job(loadcell_t *device)
+{
+    loadcell_job_t *job = &device->job;
+    if (atomic_load_explicit(&job->state, memory_order_acquire) != LOADCELL_JOB_RUNNING) {
+        return;
+    }
+
+    if (!job->active) {
+        for (int i = 0; i < device->num_channels; i++) {
+            loadcell_job_acc_init(&job->acc[i]);
+        }
+        job->active = true;
+    }
+    if (atomic_load_explicit(&job->cancel, memory_order_relaxed)) {
+        job->active = false;
+        atomic_store_explicit(&job->state, LOADCELL_JOB_CANCELLED, memory_order_release);
+        ESP_LOGI(TAG, "%s job cancelled", loadcell_job_kind_name(job->kind));
+        return;
+    }
+
+    for (int i = 0; i < device->num_channels; i++) {
+        if (job->channel_mask & (1u << i)) {
+            loadcell_job_acc_push(&job->acc[i], device->measurements[i].raw_adc);
+        }
+    }
+    uint32_t progress = atomic_load_explicit(&job->progress, memory_order_relaxed) + 1;
+    atomic_store_explicit(&job->progress, progress, memory_order_relaxed);
+    if (progress < job->frames) {
+        return;
+    }
+
+    /* Last frame: every channel's result from the same frames, applied here between scans */
+    loadcell_job_state_t outcome = LOADCELL_JOB_DONE;
+    for (uint8_t i = 0; i < device->num_channels; i++) {
+        if (!(job->channel_mask & (1u << i))) {
+            continue;
+        }
+        loadcell_channel_t *ch = &device->channels[i];
+        loadcell_job_result_t *result = &job->result[i];
+        loadcell_job_acc_finish(&job->acc[i], result);
+        if (job->kind == LOADCELL_JOB_TARE) {
+            job->status[i] = loadcell_apply_tare(device, i, result->mean);
+        } else if (job->kind == LOADCELL_JOB_POINT) {
+            job->status[i] = loadcell_apply_point(device, i, job->force_n, result->mean);
+        } else {
+            job->status[i] = loadcell_apply_span(device, i, job->force_n, result->mean);
+        }
+        if (job->status[i] != ESP_OK) {
+            outcome = LOADCELL_JOB_FAILED;
+        }
+        /* Noise in force units through the load just measured (a span's codes predate its FSCAL) */
+        int32_t delta = result->mean - loadcell_cal_offset(ch);
+        if (job->kind != LOADCELL_JOB_TARE && job->status[i] == ESP_OK && delta != 0) {
+            float mn_per_code = job->force_n * LOADCELL_Q_MN_PER_N / (float)delta;
+            result->sd_mn = result->sd * fabsf(mn_per_code);
+        }
+        ESP_LOGI(TAG, "Channel %d %s over %lu frames: mean %ld, sd %.1f codes, range %ld..%ld, %lu spike(s)", i,
+                 loadcell_job_kind_name(job->kind), (unsigned long)result->count, (long)result->mean,
+                 (double)result->sd, (long)result->min, (long)result->max, (unsigned long)result->replaced);
+    }
+    job->active = false;
+    atomic_store_explicit(&job->state, outcome, memory_order_release);
+}
+
 esp_err_t loadcell_read(loadcell_t *device)
 {
     if (!device) {
         return ESP_FAIL;
     }
 
-    esp_err_t ret;
+    /* Calibration changes published since the last frame apply from this one on, whole */
+    for (int i = 0; i < device->num_channels; i++) {
+        loadcell_cal_take_up(device, &device->channels[i]);
+    }
+
+    /* One ADC converts while the others are read out and switched */
+    esp_err_t ret = ads1261_seq_run_group(device->seqs, device->num_adcs, loadcell_on_sample, device);
 
-    /* Read all 4 channels in sequence */
-    for (int ch = 0; ch < 4; ch++) {
-        ret = loadcell_read_channel(device, ch, &device->measurements[ch]);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to read channel %d", ch);
-            return ret;
-        }
+    /* Let go before the updates below: jobs and zero tracking publish from this task */
+    for (int i = 0; i < device->num_channels; i++) {
+        bank_pair_release(&device->channels[i].cal_pair);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Channel scan failed: %s", esp_err_to_name(ret));
+        return ret;
     }
 
+    loadcell_run_job(device);
+    loadcell_track_zero(device);
+    loadcell_align_frame(device);
     device->frame_count++;
     return ESP_OK;
 }
 
+/*
+ * Point the channel's ADC at it for single reads, with the OFCAL/FSCAL of cal.
+ * The scan's steps and decimators belong to the acquisition task and are left
+ * alone: its next frame reloads the registers it needs.
+ */
+static esp_err_t loadcell_select_channel(loadcell_t *device, uint8_t channel, const loadcell_cal_set_t *cal)
+{
+    ads1261_t *adc = loadcell_adc(device, channel);
+    uint8_t pos_input = channel_pos_inputs[channel % LOADCELL_CHANNELS_PER_ADC];
+    uint8_t neg_input = channel_neg_inputs[channel % LOADCELL_CHANNELS_PER_ADC];
+    uint8_t inpmux_reg = loadcell_step(device, channel)->inpmux;
+
+    // Swap in the channel's hardware calibration; unchanged bytes are not rewritten
+    esp_err_t ret = ads1261_set_calibration(adc, cal->hw_offset, cal->hw_gain);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to load calibration for channel %d", channel);
+        return ret;
+    }
+
+    ret = ads1261_write_register(adc, ADS1261_REG_INPMUX, inpmux_reg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure INPMUX register for channel %d", channel);
+        return ret;
+    }
+    // Arm DRDY after the write: the mux change restarted conversion, so any edge
+    // seen before this point belongs to the previous input pair
+    ads1261_drdy_arm(adc);
+
+    ESP_LOGD(TAG, "Switched to channel %d (AIN%d - AIN%d), INPMUX=0x%02x", 
+             channel, pos_input, neg_input, inpmux_reg);
+    return ESP_OK;
+}
+
 esp_err_t loadcell_read_channel(loadcell_t *device, uint8_t channel, loadcell_measurement_t *measurement)
 {
-    if (!device || !measurement || channel >= 4) {
+    if (!device || !measurement || channel >= device->num_channels) {
         return ESP_ERR_INVALID_ARG;
     }
+    ads1261_t *adc = loadcell_adc(device, channel);
+
+    /* A single read is a frame of its own: it converts with the calibration published now */
+    loadcell_cal_set_t cal;
+    loadcell_get_cal_set(device, channel, &cal);
 
     // Switch to the appropriate channel
-    esp_err_t switch_ret = loadcell_switch_channel(device, channel);
+    esp_err_t switch_ret = loadcell_select_channel(device, channel, &cal);
     if (switch_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to switch to channel %d", channel);
         return switch_ret;
     }
 
-    // Small settling delay after switching channels
-    esp_rom_delay_us(100);
+    // Wait for the first conversion on the new input pair
+    esp_err_t drdy_ret = ads1261_wait_drdy(adc, device->seqs[channel / LOADCELL_CHANNELS_PER_ADC].drdy_timeout_ms);
+    if (drdy_ret != ESP_OK) {
+        ESP_LOGE(TAG, "No conversion for channel %d: %s", channel, esp_err_to_name(drdy_ret));
+        return drdy_ret;
+    }
 
     // Read from ADC
     int32_t raw_value;
-    esp_err_t adc_ret = ads1261_read_adc(&adc_device, &raw_value);
+    esp_err_t adc_ret = ads1261_read_adc(adc, &raw_value);
     if (adc_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to read ADC for channel %d", channel);
         return adc_ret;
     }
 
-    ESP_LOGI(TAG, "Channel %d read: raw=0x%06X (%d)", channel, raw_value & 0xFFFFFF, raw_value);
+    ESP_LOGD(TAG, "Channel %d read: raw=0x%06lX (%ld)", channel, raw_value & 0xFFFFFF, (long)raw_value);
 
     // Fill in the measurement structure
-    measurement->raw_adc = raw_value;
     measurement->timestamp_us = esp_timer_get_time();
-    
-    // Calculate normalized value based on calibration
-    loadcell_channel_t *channel_ctx = &device->channels[channel];
-    float normalized_raw = (float)(raw_value - channel_ctx->offset_raw);
-    measurement->normalized = normalized_raw; 
-    measurement->force_newtons = normalized_raw * channel_ctx->scale_factor;
+    loadcell_apply_calibration(&cal, raw_value, measurement);
 
     return ESP_OK;
 }
 
-/**
- * @brief Read raw ADC values from all channels
- * 
- * @param device Pointer to loadcell device
- * @param results Array to store results
- * @param num_results Size of results array
- * @return esp_err_t 
- */
-esp_err_t loadcell_read_all_channels(loadcell_t *device, int32_t *results, int num_results)
+esp_err_t loadcell_get_timing(loadcell_t *device, ads1261_timing_plan_t *timing)
 {
-    if (!device || !results || num_results < 4) {  // Assuming 4 channels
+    if (!device || !timing) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Check current MODE3 register to determine if we're in standalone mode
-    uint8_t mode3 = 0;
-    esp_err_t mode3_ret = ads1261_read_register(&adc_device, ADS1261_REG_MODE3, &mode3);
-    bool in_standalone_mode = (mode3_ret == ESP_OK) && (((mode3 >> 4) & 1) == 1);
+    /*
+     * Every ADC runs the same configuration and they settle in parallel, each
+     * one readout behind the previous ADC: a step still costs one settle time
+     * plus one readout as long as all readouts fit in it (always, for
+     * LOADCELL_MAX_ADCS at the shortest settle time).
+     */
+    const ads1261_regs_t *regs = &device->adcs[0].shadow;
+    esp_err_t ret = ads1261_timing_evaluate(regs->mode0.bits.filter, regs->mode0.bits.dr, regs->mode1.bits.delay,
+                                            LOADCELL_CHANNELS_PER_ADC, LOADCELL_STEP_OVERHEAD_US, timing);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return ads1261_timing_oversample(LOADCELL_CHANNELS_PER_ADC, device->oversampling, timing);
+}
 
-    if (in_standalone_mode) {
-        ESP_LOGW(TAG, "ADS1261 is in standalone mode - direct DOUT reading may be needed");
+esp_err_t loadcell_plan_timing(loadcell_t *device, float target_rate_hz, ads1261_timing_plan_t *plan)
+{
+    if (!device) {
+        return ESP_ERR_INVALID_ARG;
     }
+    return ads1261_plan_scan(LOADCELL_CHANNELS_PER_ADC, target_rate_hz, LOADCELL_STEP_OVERHEAD_US, 0, plan);
+}
 
-    for (int i = 0; i < 4; i++) {  // Loop through all 4 channels
-        loadcell_measurement_t measurement;
-        esp_err_t ret = loadcell_read_channel(device, i, &measurement);
+esp_err_t loadcell_set_oversampling(loadcell_t *device, uint16_t conversions)
+{
+    if (!device || conversions == 0 || conversions > LOADCELL_DECIM_MAX_FACTOR || (conversions & (conversions - 1))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (uint8_t a = 0; a < device->num_adcs; a++) {
+        esp_err_t ret = ads1261_seq_set_conversions(&device->seqs[a], conversions);
         if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to read channel %d", i);
             return ret;
         }
-        results[i] = measurement.raw_adc;
     }
+    for (int i = 0; i < device->num_channels; i++) {
+        loadcell_decim_init(&device->channels[i].decim, conversions);
+    }
+    device->oversampling = conversions;
 
+    ESP_LOGI(TAG, "Oversampling: %u conversions per channel per scan", conversions);
     return ESP_OK;
 }
 
+uint16_t loadcell_plan_oversampling(loadcell_t *device, float frame_rate_hz)
+{
+    if (!device || !(frame_rate_hz > 0.0f)) {
+        return 1;
+    }
+
+    ads1261_timing_plan_t timing;
+    if (loadcell_get_timing(device, &timing) != ESP_OK) {
+        return 1;
+    }
+
+    /* Scans must leave headroom in the frame period: rate >= frame rate / headroom */
+    uint16_t best = 1;
+    for (uint16_t n = 2; n <= LOADCELL_DECIM_MAX_FACTOR; n *= 2) {
+        if (ads1261_timing_oversample(LOADCELL_CHANNELS_PER_ADC, n, &timing) != ESP_OK ||
+            timing.frame_rate_hz * LOADCELL_OVERSAMPLING_HEADROOM < frame_rate_hz) {
+            break;
+        }
+        best = n;
+    }
+    return best;
+}
+
+/* ============================================================================
+ * Force Filters
+ * ============================================================================ */
+
+/* Channel range of a channel argument that may be LOADCELL_ALL_CHANNELS */
+static bool loadcell_channel_range(const loadcell_t *device, uint8_t channel, int *first, int *last)
+{
+    if (channel == LOADCELL_ALL_CHANNELS) {
+        *first = 0;
+        *last = device->num_channels - 1;
+        return true;
+    }
+    *first = *last = channel;
+    return channel < device->num_channels;
+}
+
+esp_err_t loadcell_set_frame_rate(loadcell_t *device, float frame_rate_hz)
+{
+    if (!device || !(frame_rate_hz > 0.0f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    device->frame_rate_hz = frame_rate_hz;
+    device->zero_block_frames = (uint32_t)lroundf(frame_rate_hz * LOADCELL_ZERO_BLOCK_S);
+    if (device->zero_block_frames == 0) {
+        device->zero_block_frames = 1;
+    }
+    for (int i = 0; i < device->num_channels; i++) {
+        int dropped;
+        esp_err_t ret = loadcell_filter_set_rate(&device->channels[i].filter, frame_rate_hz, &dropped);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Channel %d: filter not redesigned for %.1f Hz: %s", i, frame_rate_hz,
+                     esp_err_to_name(ret));
+            return ret;
+        }
+        if (dropped) {
+            ESP_LOGW(TAG, "Channel %d: %d filter section(s) dropped at %.1f Hz", i, dropped, frame_rate_hz);
+        }
+    }
+    return ESP_OK;
+}
+
+/* Append one section to the chains of a channel or of all of them */
+static esp_err_t loadcell_add_section(loadcell_t *device, uint8_t channel, const loadcell_biquad_t *section)
+{
+    int first, last;
+    if (!loadcell_channel_range(device, channel, &first, &last)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    /* All or nothing: check for room first */
+    for (int i = first; i <= last; i++) {
+        loadcell_filter_chain_t chain;
+        loadcell_filter_get_chain(&device->channels[i].filter, &chain);
+        if (chain.num_sections >= LOADCELL_FILTER_MAX_SECTIONS) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    for (int i = first; i <= last; i++) {
+        esp_err_t ret = loadcell_filter_add(&device->channels[i].filter, section);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t loadcell_add_filter(loadcell_t *device, uint8_t channel, loadcell_filter_type_t type,
+                              float freq_hz, float q)
+{
+    if (!device) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!(device->frame_rate_hz > 0.0f)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    loadcell_biquad_t section;
+    esp_err_t ret = loadcell_biquad_design(type, freq_hz, q, device->frame_rate_hz, &section);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return loadcell_add_section(device, channel, &section);
+}
+
+esp_err_t loadcell_add_filter_coefs(loadcell_t *device, uint8_t channel, const float coef[5])
+{
+    if (!device) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    loadcell_biquad_t section;
+    esp_err_t ret = loadcell_biquad_from_coefs(coef, &section);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return loadcell_add_section(device, channel, &section);
+}
+
+esp_err_t loadcell_clear_filters(loadcell_t *device, uint8_t channel)
+{
+    int first, last;
+    if (!device || !loadcell_channel_range(device, channel, &first, &last)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = first; i <= last; i++) {
+        esp_err_t ret = loadcell_filter_clear(&device->channels[i].filter);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t loadcell_set_despike(loadcell_t *device, uint8_t channel, loadcell_despike_mode_t mode, uint8_t window,
+                               float k)
+{
+    int first, last;
+    if (!device || !loadcell_channel_range(device, channel, &first, &last)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = first; i <= last; i++) {
+        esp_err_t ret = loadcell_despike_configure(&device->channels[i].despike, mode, window, k);
+        if (ret != ESP_OK) {
+            return ret;     /* Same arguments for every channel: fails on the first or not at all */
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t loadcell_set_alignment(loadcell_t *device, loadcell_align_mode_t mode)
+{
+    if (!device || mode > LOADCELL_ALIGN_CUBIC) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    atomic_store_explicit(&device->align_mode, (uint8_t)mode, memory_order_relaxed);
+    return ESP_OK;
+}
+
+loadcell_align_mode_t loadcell_get_alignment(const loadcell_t *device)
+{
+    return (loadcell_align_mode_t)atomic_load_explicit(&device->align_mode, memory_order_relaxed);
+}
+
 esp_err_t loadcell_get_measurement(loadcell_t *device, uint8_t channel,
                                    loadcell_measurement_t *measurement)
 {
-    if (!device || channel > 3 || !measurement) {
+    if (!device || channel >= device->num_channels || !measurement) {
         return ESP_FAIL;
     }
 
@@ -209,95 +955,270 @@ esp_err_t loadcell_get_measurement(loadcell_t *device, uint8_t channel,
  * Calibration Functions
  * ============================================================================ */
 
-esp_err_t loadcell_tare(loadcell_t *device, uint8_t channel, uint32_t num_samples)
+/* Average raw code of a channel over num_samples single reads, spikes replaced by the running median */
+static esp_err_t loadcell_average_raw(loadcell_t *device, uint8_t channel, uint32_t num_samples, const char *purpose,
+                                      loadcell_job_result_t *avg)
 {
-    if (!device || channel >= 4 || num_samples == 0) {
+    if (num_samples > LOADCELL_JOB_MAX_FRAMES) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    ESP_LOGI(TAG, "Starting tare calibration for channel %d (%lu samples)...", channel, num_samples);
-
-    // Collect multiple samples to average the offset
-    int64_t sum = 0;
+    loadcell_job_acc_t acc;
+    loadcell_job_acc_init(&acc);
     for (uint32_t i = 0; i < num_samples; i++) {
         loadcell_measurement_t meas;
         esp_err_t ret = loadcell_read_channel(device, channel, &meas);
         if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Error reading channel %d for tare", channel);
+            ESP_LOGE(TAG, "Error reading channel %d for %s", channel, purpose);
             return ret;
         }
-        sum += meas.raw_adc;
+        loadcell_job_acc_push(&acc, meas.raw_adc);
         vTaskDelay(pdMS_TO_TICKS(1));  // Small delay between samples
     }
+    loadcell_job_acc_finish(&acc, avg);
 
-    // Calculate and store the average as the offset
-    int32_t avg = (int32_t)(sum / num_samples);
-    device->channels[channel].offset_raw = avg;
-    device->channels[channel].calib_state = CALIB_STATE_TARE_DONE;
-
-    ESP_LOGI(TAG, "Tare calibration for channel %d: offset=%ld", channel, (long)avg);
+    if (avg->replaced) {
+        ESP_LOGD(TAG, "Channel %d %s: %lu spike(s) replaced", channel, purpose, (unsigned long)avg->replaced);
+    }
     return ESP_OK;
 }
 
+esp_err_t loadcell_tare(loadcell_t *device, uint8_t channel, uint32_t num_samples)
+{
+    if (!device || channel >= device->num_channels || num_samples == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_LOGI(TAG, "Starting tare calibration for channel %d (%lu samples)...", channel, num_samples);
+
+    // Collect multiple samples to average the offset
+    loadcell_job_result_t avg;
+    esp_err_t ret = loadcell_average_raw(device, channel, num_samples, "tare", &avg);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return loadcell_apply_tare(device, channel, avg.mean);
+}
+
 esp_err_t loadcell_calibrate(loadcell_t *device, uint8_t channel, float known_force_n, uint32_t num_samples)
 {
-    if (!device || channel >= 4 || num_samples == 0) {
+    if (!device || channel >= device->num_channels || num_samples == 0) {
         return ESP_ERR_INVALID_ARG;
     }
 
     // Must have completed tare calibration first
-    if (device->channels[channel].calib_state != CALIB_STATE_TARE_DONE) {
+    if (loadcell_cal_state(&device->channels[channel]) != CALIB_STATE_TARE_DONE) {
         ESP_LOGE(TAG, "Must perform tare calibration before full-scale calibration on channel %d", channel);
         return ESP_ERR_INVALID_STATE;
     }
 
     // Collect multiple samples with known weight applied
-    int64_t sum = 0;
-    for (uint32_t i = 0; i < num_samples; i++) {
-        loadcell_measurement_t meas;
-        esp_err_t ret = loadcell_read_channel(device, channel, &meas);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Error reading channel %d for calibration", channel);
-            return ret;
+    loadcell_job_result_t avg;
+    esp_err_t ret = loadcell_average_raw(device, channel, num_samples, "calibration", &avg);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return loadcell_apply_span(device, channel, known_force_n, avg.mean);
+}
+
+esp_err_t loadcell_add_cal_point(loadcell_t *device, uint8_t channel, float known_force_n, uint32_t num_samples)
+{
+    if (!device || channel >= device->num_channels || num_samples == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    loadcell_cal_set_t cal;
+    loadcell_get_cal_set(device, channel, &cal);
+    esp_err_t ret = loadcell_check_point(&cal, channel);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    loadcell_job_result_t avg;
+    ret = loadcell_average_raw(device, channel, num_samples, "calibration point", &avg);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return loadcell_apply_point(device, channel, known_force_n, avg.mean);
+}
+
+esp_err_t loadcell_build_lut(loadcell_t *device, uint8_t channel, loadcell_fit_t fit)
+{
+    if (!device || channel >= device->num_channels) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    loadcell_channel_t *ch = &device->channels[channel];
+    loadcell_cal_set_t *cal;
+    esp_err_t ret = loadcell_cal_begin_update(ch, &cal);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint8_t num_points = cal->num_cal_points + 1;
+    if (cal->num_cal_points == 0) {
+        bank_pair_cancel(&ch->cal_pair);
+        ESP_LOGE(TAG, "No calibration points on channel %d", channel);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* Tare zero plus the loaded points */
+    loadcell_cal_point_t points[LOADCELL_CAL_MAX_POINTS] = { { .net = 0, .force_mn = 0 } };
+    memcpy(&points[1], cal->cal_points, cal->num_cal_points * sizeof(points[0]));
+
+    /* Codes are used as read: whatever span FSCAL applied when the points were taken stays */
+    ret = loadcell_lut_build(points, num_points, fit, &cal->lut);
+    if (ret != ESP_OK) {
+        bank_pair_cancel(&ch->cal_pair);
+        ESP_LOGE(TAG, "%s fit of %u points failed on channel %d: %s", loadcell_fit_name(fit),
+                 num_points, channel, esp_err_to_name(ret));
+        return ret;
+    }
+    cal->lut_fit = fit;
+    cal->lut_active = true;
+    cal->calib_state = CALIB_STATE_CALIBRATED;
+    bank_pair_publish(&ch->cal_pair);
+
+    ESP_LOGI(TAG, "Channel %d: %s calibration over %u points, %d-segment table", channel, loadcell_fit_name(fit),
+             num_points, LOADCELL_LUT_SEGMENTS);
+    return ESP_OK;
+}
+
+esp_err_t loadcell_set_zero_tracking(loadcell_t *device, int32_t band_mn, int32_t limit_mn)
+{
+    if (!device || band_mn < 0 || limit_mn < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    atomic_store_explicit(&device->zero_limit_mn, limit_mn, memory_order_relaxed);
+    atomic_store_explicit(&device->zero_band_mn, band_mn, memory_order_relaxed);
+    ESP_LOGI(TAG, "Zero tracking %s (band %.3f N, limit %.3f N)", band_mn ? "on" : "off", band_mn / 1000.0f,
+             limit_mn / 1000.0f);
+    return ESP_OK;
+}
+
+esp_err_t loadcell_start_job(loadcell_t *device, loadcell_job_kind_t kind, uint8_t channel, float known_force_n,
+                             uint32_t frames)
+{
+    int first, last;
+    if (!device || !loadcell_channel_range(device, channel, &first, &last) || frames == 0 ||
+        frames > LOADCELL_JOB_MAX_FRAMES || kind > LOADCELL_JOB_POINT ||
+        (kind != LOADCELL_JOB_TARE && !(fabsf(known_force_n) > 0.0f))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    loadcell_job_t *job = &device->job;
+    if (atomic_load_explicit(&job->state, memory_order_acquire) == LOADCELL_JOB_RUNNING) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint16_t mask = 0;
+    for (int i = first; i <= last; i++) {
+        if (kind == LOADCELL_JOB_SPAN && loadcell_cal_state(&device->channels[i]) != CALIB_STATE_TARE_DONE) {
+            ESP_LOGE(TAG, "Must perform tare calibration before full-scale calibration on channel %d", i);
+            return ESP_ERR_INVALID_STATE;
         }
-        sum += meas.raw_adc;
-        vTaskDelay(pdMS_TO_TICKS(1));  // Small delay between samples
+        if (kind == LOADCELL_JOB_POINT) {
+            loadcell_cal_set_t cal;
+            loadcell_get_cal_set(device, i, &cal);
+            esp_err_t ret = loadcell_check_point(&cal, i);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+        mask |= 1u << i;
     }
 
-    int32_t avg = (int32_t)(sum / num_samples);
-    int32_t delta_raw = avg - device->channels[channel].offset_raw;
+    /* The acquisition task only reads the request once it sees RUNNING */
+    job->kind = kind;
+    job->channel_mask = mask;
+    job->force_n = known_force_n;
+    job->frames = frames;
+    for (int i = 0; i < LOADCELL_MAX_CHANNELS; i++) {
+        memset(&job->result[i], 0, sizeof(job->result[i]));
+        job->status[i] = ESP_ERR_NOT_FOUND;
+    }
+    atomic_store_explicit(&job->progress, 0, memory_order_relaxed);
+    atomic_store_explicit(&job->cancel, false, memory_order_relaxed);
+    atomic_store_explicit(&job->state, LOADCELL_JOB_RUNNING, memory_order_release);
 
-    // Calculate scale factor: how many raw units per Newton
-    if (delta_raw != 0) {
-        device->channels[channel].scale_factor = known_force_n / (float)delta_raw;
-        device->channels[channel].calib_state = CALIB_STATE_CALIBRATED;
+    ESP_LOGI(TAG, "Started %s job on channel mask 0x%03x over %lu frames", loadcell_job_kind_name(kind), mask,
+             (unsigned long)frames);
+    return ESP_OK;
+}
 
-        ESP_LOGI(TAG, "Scale calibration for channel %d: avg=%ld, delta=%ld, scale=%.6f/N",
-                 channel, (long)avg, (long)delta_raw, 1.0/device->channels[channel].scale_factor);
-        return ESP_OK;
-    } else {
-        ESP_LOGE(TAG, "Zero delta detected for channel %d - invalid calibration", channel);
-        return ESP_FAIL;
+loadcell_job_state_t loadcell_get_job(loadcell_t *device, uint32_t *progress, uint32_t *frames)
+{
+    if (!device) {
+        return LOADCELL_JOB_IDLE;
+    }
+    loadcell_job_state_t state = (loadcell_job_state_t)atomic_load_explicit(&device->job.state, memory_order_acquire);
+    if (progress) {
+        *progress = atomic_load_explicit(&device->job.progress, memory_order_relaxed);
     }
+    if (frames) {
+        *frames = device->job.frames;
+    }
+    return state;
 }
 
-loadcell_calib_state_t loadcell_get_calib_state(loadcell_t *device, uint8_t channel)
+esp_err_t loadcell_get_job_result(loadcell_t *device, uint8_t channel, loadcell_job_result_t *result)
 {
-    if (!device || channel > 3) {
+    if (!device || !result || channel >= device->num_channels) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    loadcell_job_state_t state = loadcell_get_job(device, NULL, NULL);
+    if (state != LOADCELL_JOB_DONE && state != LOADCELL_JOB_FAILED) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *result = device->job.result[channel];
+    return device->job.status[channel];
+}
+
+esp_err_t loadcell_cancel_job(loadcell_t *device)
+{
+    if (!device) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (atomic_load_explicit(&device->job.state, memory_order_acquire) != LOADCELL_JOB_RUNNING) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    atomic_store_explicit(&device->job.cancel, true, memory_order_relaxed);
+    return ESP_OK;
+}
+
+loadcell_calib_state_t loadcell_get_calib_state(const loadcell_t *device, uint8_t channel)
+{
+    if (!device || channel >= device->num_channels) {
         return CALIB_STATE_UNCALIBRATED;
     }
-    return device->channels[channel].calib_state;
+    return loadcell_cal_state(&device->channels[channel]);
+}
+
+esp_err_t loadcell_get_cal_set(const loadcell_t *device, uint8_t channel, loadcell_cal_set_t *set)
+{
+    if (!device || !set || channel >= device->num_channels) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const loadcell_channel_t *ch = &device->channels[channel];
+    bank_pair_read(&ch->cal_pair, ch->cal_banks, sizeof(*set), set);
+    return ESP_OK;
 }
 
 esp_err_t loadcell_reset_calibration(loadcell_t *device, uint8_t channel)
 {
-    if (!device || channel > 3) {
+    if (!device || channel >= device->num_channels) {
         return ESP_FAIL;
     }
 
-    device->channels[channel].calib_state = CALIB_STATE_UNCALIBRATED;
-    device->channels[channel].offset_raw = 0;
-    device->channels[channel].scale_factor = 1.0;
+    loadcell_channel_t *ch = &device->channels[channel];
+    loadcell_cal_set_t *cal;
+    esp_err_t ret = loadcell_cal_begin_update(ch, &cal);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    loadcell_cal_defaults(cal);
+    bank_pair_publish(&ch->cal_pair);
 
     ESP_LOGI(TAG, "Calibration reset for channel %d", channel);
 
@@ -306,11 +1227,11 @@ esp_err_t loadcell_reset_calibration(loadcell_t *device, uint8_t channel)
 
 esp_err_t loadcell_get_stats(loadcell_t *device, uint8_t channel, loadcell_stats_t *stats)
 {
-    if (!device || channel > 3 || !stats) {
+    if (!device || channel >= device->num_channels || !stats) {
         return ESP_FAIL;
     }
 
-    *stats = device->channels[channel].stats;
+    loadcell_stats_read(&device->channels[channel].stats, stats);
     return ESP_OK;
 }
 
@@ -320,20 +1241,14 @@ esp_err_t loadcell_reset_stats(loadcell_t *device, uint8_t channel)
         return ESP_FAIL;
     }
 
-    if (channel == 4) {
+    if (channel == LOADCELL_ALL_CHANNELS) {
         /* Reset all channels */
-        for (int i = 0; i < 4; i++) {
-            device->channels[i].stats.min_force = 0.0;
-            device->channels[i].stats.max_force = 0.0;
-            device->channels[i].stats.avg_force = 0.0;
-            device->channels[i].stats.sample_count = 0;
+        for (int i = 0; i < device->num_channels; i++) {
+            loadcell_stats_request_reset(&device->channels[i].stats);
         }
         ESP_LOGI(TAG, "Statistics reset for all channels");
-    } else if (channel <= 3) {
-        device->channels[channel].stats.min_force = 0.0;
-        device->channels[channel].stats.max_force = 0.0;
-        device->channels[channel].stats.avg_force = 0.0;
-        device->channels[channel].stats.sample_count = 0;
+    } else if (channel < device->num_channels) {
+        loadcell_stats_request_reset(&device->channels[channel].stats);
         ESP_LOGI(TAG, "Statistics reset for channel %d", channel);
     } else {
         return ESP_FAIL;
@@ -359,58 +1274,49 @@ void loadcell_print_calib_info(loadcell_t *device)
         "CALIBRATED"
     };
 
-    for (int i = 0; i < 4; i++) {
-        loadcell_channel_t *ch = &device->channels[i];
+    for (int i = 0; i < device->num_channels; i++) {
+        loadcell_cal_set_t cal;
+        loadcell_get_cal_set(device, i, &cal);
         printf("Channel %d:\n", i + 1);
-        printf("  State: %s\n", states[ch->calib_state]);
-        printf("  Offset: %ld\n", ch->offset_raw);
-        printf("  Scale: %.6f N/unit\n", ch->scale_factor);
+        printf("  State: %s (calibration set %lu)\n", states[cal.calib_state], (unsigned long)cal.version);
+        printf("  Offset: %ld\n", cal.offset_raw);
+        if (cal.zero_tracked_mn) {
+            printf("  Zero tracked: %.3f N since the tare\n", cal.zero_tracked_mn / 1000.0f);
+        }
+        printf("  Scale: %.6f N/unit\n", cal.scale_factor);
+        printf("  ADC correction: OFCAL=%ld FSCAL=0x%06lX%s\n", (long)cal.hw_offset,
+               (unsigned long)cal.hw_gain, cal.hw_calibrated ? " (span in hardware)" : "");
+        if (cal.num_cal_points) {
+            printf("  Points:");
+            for (int p = 0; p < cal.num_cal_points; p++) {
+                printf(" %.3f N@%ld", cal.cal_points[p].force_mn / 1000.0f, (long)cal.cal_points[p].net);
+            }
+            printf("%s\n", cal.lut_active ? "" : " (not built)");
+        }
+        if (cal.lut_active) {
+            printf("  Table: %s, %d segments of %ld codes from %ld\n", loadcell_fit_name(cal.lut_fit),
+                   LOADCELL_LUT_SEGMENTS, (long)(1L << cal.lut.shift), (long)cal.lut.base);
+        }
     }
     printf("===================================\n\n");
 }
 
-void loadcell_print_measurements(loadcell_t *device)
+/* Register, integrity, DRDY and read checks of one ADC; true if its registers read back */
+static bool loadcell_diagnose_adc(loadcell_t *device, uint8_t a)
 {
-    if (!device) return;
+    ads1261_t *adc = &device->adcs[a];
 
-    printf("\n=== Loadcell Measurements (Frame %lu) ===\n", device->frame_count);
+    ESP_LOGI(TAG, "--- ADS1261 #%u (CS %d) ---", a, adc->cs_pin);
 
-    float total = 0.0;
-    for (int i = 0; i < 4; i++) {
-        loadcell_measurement_t *m = &device->measurements[i];
-        loadcell_stats_t *s = &device->channels[i].stats;
-
-        printf("Channel %d: %.2f N\n", i + 1, m->force_newtons);
-        printf("  Raw ADC: 0x%06lx (normalized: %.6f)\n", 
-               m->raw_adc & 0xFFFFFF, m->normalized);
-        printf("  Stats: min=%.2f, max=%.2f, avg=%.2f (n=%lu)\n",
-               s->min_force, s->max_force, s->avg_force, s->sample_count);
+    // Read all registers to verify communication and the driver's register shadow
+    ads1261_regs_t regs;
+    uint32_t mismatch = 0;
+    esp_err_t snap_ret = ads1261_snapshot(adc, &regs, &mismatch);
+    bool all_reads_ok = (snap_ret == ESP_OK);
+    const uint8_t *reg_values = regs.raw;
 
-        total += m->force_newtons;
-    }
-
-    printf("Total GRF: %.2f N\n", total);
-    printf("========================================\n\n");
-}
-
-esp_err_t loadcell_diagnostic(loadcell_t *device)
-{
-    if (!device) {
-        return ESP_FAIL;
-    }
-
-    ESP_LOGI(TAG, "=== Loadcell Diagnostic Report ===");
-    
-    // Read all registers to verify communication
-    uint8_t reg_values[19];
-    bool all_reads_ok = true;
-    
-    for (int i = 0; i < 19; i++) {
-        esp_err_t ret = ads1261_read_register(&adc_device, i, &reg_values[i]);
-        if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "Failed to read register 0x%02x: %s", i, esp_err_to_name(ret));
-            all_reads_ok = false;
-        }
+    if (!all_reads_ok) {
+        ESP_LOGW(TAG, "Register snapshot failed: %s", esp_err_to_name(snap_ret));
     }
     
     if (all_reads_ok) {
@@ -418,6 +1324,14 @@ esp_err_t loadcell_diagnostic(loadcell_t *device)
         ESP_LOGI(TAG, "ID:0x%02x ST:0x%02x M0:0x%02x M1:0x%02x M2:0x%02x M3:0x%02x REF:0x%02x PGA:0x%02x INP:0x%02x", 
                  reg_values[0], reg_values[1], reg_values[2], reg_values[3], 
                  reg_values[4], reg_values[5], reg_values[6], reg_values[0x10], reg_values[0x11]);
+
+        if (mismatch) {
+            ESP_LOGW(TAG, "⚠️  Register shadow out of sync (mask 0x%05lx) - device reset or SPI corruption?",
+                     (unsigned long)mismatch);
+        } else {
+            ESP_LOGI(TAG, "✅ Register shadow matches device (%lu redundant writes skipped)",
+                     (unsigned long)adc->shadow_skips);
+        }
         
         // Check if ID register has expected value
         if (reg_values[0] != 0x08) {
@@ -434,7 +1348,7 @@ esp_err_t loadcell_diagnostic(loadcell_t *device)
         }
         
         // Check MODE3 register for SPITIM bit
-        uint8_t spitim = (reg_values[5] >> 4) & 1;
+        uint8_t spitim = regs.mode3.bits.spitim;
         if (spitim) {
             ESP_LOGW(TAG, "⚠️  Device is in STANDALONE DOUT mode (SPITIM=1)");
             ESP_LOGW(TAG, "    Driver expects DOUT/DRDY mode (SPITIM=0)");
@@ -446,7 +1360,7 @@ esp_err_t loadcell_diagnostic(loadcell_t *device)
         }
         
         // Check PGA gain setting
-        uint8_t gain_bits = (reg_values[0x10] >> 4) & 0x07;
+        uint8_t gain_bits = regs.pga.bits.gain;
         if (gain_bits != device->pga_gain) {
             ESP_LOGW(TAG, "⚠️  PGA gain mismatch! Expected: %d, Actual: %d", device->pga_gain, gain_bits);
         } else {
@@ -454,7 +1368,7 @@ esp_err_t loadcell_diagnostic(loadcell_t *device)
         }
         
         // Check data rate setting
-        uint8_t drate_bits = reg_values[2] & 0x0F;
+        uint8_t drate_bits = regs.mode0.bits.dr;
         if (drate_bits != device->data_rate) {
             ESP_LOGW(TAG, "⚠️  Data rate mismatch! Expected: %d, Actual: %d", device->data_rate, drate_bits);
         } else {
@@ -464,10 +1378,23 @@ esp_err_t loadcell_diagnostic(loadcell_t *device)
         ESP_LOGE(TAG, "❌ Some register reads failed - communication issue detected");
     }
     
+    // Read-path integrity counters (STATUS/CRC framing)
+    const ads1261_integrity_t *integ = &adc->integrity;
+    ESP_LOGI(TAG, "Read integrity: %lu checked, %lu CRC errors, %lu stale, %lu rejected commands, %lu alarms, %lu DRDY timeouts",
+             (unsigned long)integ->checked, (unsigned long)integ->crc_errors,
+             (unsigned long)integ->stale_reads, (unsigned long)integ->cmd_crc_errors,
+             (unsigned long)integ->alarms, (unsigned long)adc->drdy_timeouts);
+    if (integ->crc_errors || integ->cmd_crc_errors) {
+        ESP_LOGW(TAG, "⚠️  SPI corruption detected - check cable length, grounding and SPI clock speed");
+    }
+    if (integ->stale_reads) {
+        ESP_LOGW(TAG, "⚠️  Stale conversions read - reads are outrunning the data rate");
+    }
+
     // Check DRDY pin status
-    if (device->drdy_pin >= 0) {
-        int drdy_level = gpio_get_level(device->drdy_pin);
-        ESP_LOGI(TAG, "DRDY pin (GPIO %d) level: %d", device->drdy_pin, drdy_level);
+    if (adc->drdy_pin >= 0) {
+        int drdy_level = gpio_get_level(adc->drdy_pin);
+        ESP_LOGI(TAG, "DRDY pin (GPIO %d) level: %d", adc->drdy_pin, drdy_level);
         if (drdy_level == 1) {
             ESP_LOGW(TAG, "⚠️  DRDY pin is HIGH - should go LOW when data ready");
             ESP_LOGW(TAG, "    This may indicate:");
@@ -485,7 +1412,7 @@ esp_err_t loadcell_diagnostic(loadcell_t *device)
     // Test reading ADC values
     ESP_LOGI(TAG, "Testing ADC read...");
     int32_t test_val;
-    esp_err_t adc_ret = ads1261_read_adc(&adc_device, &test_val);
+    esp_err_t adc_ret = ads1261_read_adc(adc, &test_val);
     if (adc_ret == ESP_OK) {
         ESP_LOGI(TAG, "ADC read successful: 0x%06lx (%ld)", test_val & 0xFFFFFF, test_val);
         if (test_val == 0x00FFFFFF || test_val == 0x00000000) {
@@ -494,12 +1421,28 @@ esp_err_t loadcell_diagnostic(loadcell_t *device)
     } else {
         ESP_LOGE(TAG, "ADC read failed: %s", esp_err_to_name(adc_ret));
     }
+
+    return all_reads_ok;
+}
+
+esp_err_t loadcell_diagnostic(loadcell_t *device)
+{
+    if (!device) {
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "=== Loadcell Diagnostic Report ===");
+
+    bool all_reads_ok = true;
+    for (uint8_t a = 0; a < device->num_adcs; a++) {
+        all_reads_ok &= loadcell_diagnose_adc(device, a);
+    }
     
     ESP_LOGI(TAG, "===============================");
     ESP_LOGI(TAG, "Hardware Troubleshooting Tips:");
     ESP_LOGI(TAG, "1. Verify all SPI connections (MOSI, MISO, CLK) are correct");
     ESP_LOGI(TAG, "2. Ensure CS pin is properly connected (tied to GND or GPIO controlled)");
-    ESP_LOGI(TAG, "3. Verify DRDY pin is connected to GPIO %d", device->drdy_pin);
+    ESP_LOGI(TAG, "3. Verify each DRDY pin is connected to the GPIO reported above");
     ESP_LOGI(TAG, "4. Check power supply (3.3V) to ADS1261");
     ESP_LOGI(TAG, "5. If using standalone mode, modify software to read continuously from DOUT");
     ESP_LOGI(TAG, "===============================");
@@ -508,31 +1451,10 @@ esp_err_t loadcell_diagnostic(loadcell_t *device)
 
 esp_err_t loadcell_switch_channel(loadcell_t *device, uint8_t channel)
 {
-    if (!device || channel >= 4) {
+    if (!device || channel >= device->num_channels) {
         return ESP_ERR_INVALID_ARG;
     }
-
-    // Define channel pairs for differential measurement
-    // This mapping assumes a Wheatstone bridge configuration
-    uint8_t pos_inputs[4] = {0, 2, 4, 6};  // Positive inputs for channels 0-3
-    uint8_t neg_inputs[4] = {1, 3, 5, 7};  // Negative inputs for channels 0-3
-
-    // Select the appropriate positive and negative inputs for the channel
-    uint8_t pos_input = pos_inputs[channel];
-    uint8_t neg_input = neg_inputs[channel];
-
-    // Configure the input multiplexer register (INPMUX)
-    uint8_t inpmux_reg = (pos_input << 4) | neg_input;  // MUXP in upper 4 bits, MUXN in lower 4 bits
-    esp_err_t ret = ads1261_write_register(&adc_device, ADS1261_REG_INPMUX, inpmux_reg);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to configure INPMUX register for channel %d", channel);
-        return ret;
-    }
-
-    // Small settling delay after switching channels
-    esp_rom_delay_us(100);
-
-    ESP_LOGD(TAG, "Switched to channel %d (AIN%d - AIN%d), INPMUX=0x%02x", 
-             channel, pos_input, neg_input, inpmux_reg);
-    return ESP_OK;
+    loadcell_cal_set_t cal;
+    loadcell_get_cal_set(device, channel, &cal);
+    return loadcell_select_channel(device, channel, &cal);
 }
@@ -2,7 +2,8 @@
  * @file loadcell.h
  * @brief Loadcell driver for ESP32 with ADS1261 ADC
  * 
- * Provides high-level API for 4-channel loadcell measurement with:
+ * Provides high-level API for multi-channel loadcell measurement
+ * (4 bridges per ADS1261, several ADS1261 sharing one SPI bus) with:
  * - Automatic tare/offset calibration
  * - Full-scale sensitivity calibration
  * - Real-time force reading with statistics
@@ -14,13 +15,31 @@
 #ifndef LOADCELL_H
 #define LOADCELL_H
 
+#include <stdbool.h>
+#include <stdatomic.h>
 #include "esp_err.h"
 #include "driver/spi_master.h"
+#include "ads1261_seq.h"
+#include "bank_pair.h"
+#include "ads1261_timing.h"
+#include "loadcell_q.h"
+#include "loadcell_stats.h"
+#include "loadcell_lut.h"
+#include "loadcell_decim.h"
+#include "loadcell_despike.h"
+#include "loadcell_filter.h"
+#include "loadcell_align.h"
+#include "loadcell_job.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define LOADCELL_CHANNELS_PER_ADC   4       /**< Differential bridges per ADS1261 */
+#define LOADCELL_MAX_ADCS           3       /**< ADS1261 devices on the SPI bus */
+#define LOADCELL_MAX_CHANNELS       (LOADCELL_CHANNELS_PER_ADC * LOADCELL_MAX_ADCS)
+#define LOADCELL_ALL_CHANNELS       0xFF    /**< Channel argument selecting every channel */
+
 /* ============================================================================
  * Type Definitions
  * ============================================================================ */
@@ -36,60 +55,152 @@ typedef enum {
     CALIB_STATE_CALIBRATED = 4,      /**< Fully calibrated and ready */
 } loadcell_calib_state_t;
 
-/**
- * Statistics for a single channel
- */
-typedef struct {
-    float min_force;        /**< Minimum force reading */
-    float max_force;        /**< Maximum force reading */
-    float avg_force;        /**< Average force reading */
-    uint32_t sample_count;  /**< Number of samples collected */
-} loadcell_stats_t;
-
 /**
  * Single channel measurement
  */
 typedef struct {
     int32_t raw_adc;        /**< Raw 24-bit ADC value */
-    float normalized;       /**< Normalized to ±1.0 range */
-    float force_newtons;    /**< Measured force in Newtons */
+    int32_t net;            /**< Raw value less the software tare offset */
+    int32_t force_mn;       /**< Measured force in millinewtons */
     uint64_t timestamp_us;  /**< Measurement timestamp in microseconds */
 } loadcell_measurement_t;
 
 /**
- * Loadcell channel context
+ * Everything that turns a channel's codes into forces, published as a whole
+ *
+ * The sets of a channel are a bank_pair: changes are made to a spare copy
+ * that is then published. The sample path takes up the published set at the
+ * start of each scan, together with the OFCAL/FSCAL the scan loads for the
+ * channel, and lets go of it when the scan ends, so every conversion of a
+ * frame goes through one set. The state and the points that led to the
+ * values travel with them.
  */
 typedef struct {
-    uint8_t channel_id;             /**< Channel index (0-3) */
+    uint32_t version;               /**< Bumped by every update */
     loadcell_calib_state_t calib_state;
+
+    int32_t offset_raw;             /**< Raw ADC offset: the software tare, or only the tracked drift under OFCAL */
+    float scale_factor;             /**< N per net count */
+    loadcell_q_scale_t scale_q;     /**< scale_factor for the integer sample path */
+
+    /* Hardware calibration, loaded into the ADC when the mux selects this channel */
+    bool hw_calibrated;             /**< Span is in hw_gain: raw codes are LOADCELL_COUNTS_PER_N per Newton */
+    int32_t hw_offset;              /**< OFCAL value (tare), 24-bit signed */
+    uint32_t hw_gain;               /**< FSCAL value (span), 0x400000 = 1.0 */
+
+    /* Compiled multi-point calibration */
+    bool lut_active;                /**< Forces come from lut instead of the linear scale */
+    loadcell_fit_t lut_fit;
+    loadcell_lut_t lut;
+
+    /* Multi-point calibration loads (tare zero implied), compiled into lut */
+    loadcell_cal_point_t cal_points[LOADCELL_CAL_MAX_POINTS - 1];
+    uint8_t num_cal_points;
+
+    int32_t zero_tracked_mn;        /**< Correction zero tracking has added to offset_raw since the last tare */
+} loadcell_cal_set_t;
+
+/**
+ * Loadcell channel context
+ */
+typedef struct {
+    uint8_t channel_id;             /**< Channel index (0..num_channels-1) */
     
-    /* Calibration parameters */
-    int32_t offset_raw;             /**< Raw ADC offset (from tare) */
-    float scale_factor;             /**< N per normalized unit */
-    
-    /* Running statistics */
-    loadcell_stats_t stats;
+    /* Calibration: the published set and a spare one for updates */
+    loadcell_cal_set_t cal_banks[2];
+    bank_pair_t cal_pair;           /**< Which set is published, and which one the scan holds */
+    const loadcell_cal_set_t *cal;  /**< Set the current scan converts with (sample path) */
+
+    /* Oversampled conversions of each scan, decimated to one per frame */
+    loadcell_decim_t decim;
+
+    /* Median/Hampel spike rejection on the frame-rate forces, ahead of the biquads */
+    loadcell_despike_t despike;
+
+    /* Biquad cascade on the frame-rate forces */
+    loadcell_filter_t filter;
+
+    /* Recent filtered forces, for aligning the frame to one instant */
+    loadcell_align_history_t align;
+
+    /* Automatic zero tracking (acquisition task) */
+    int64_t zero_sum;               /**< Net codes over the current quiet block */
+
+    /* Running statistics, updated by loadcell_read() */
+    loadcell_stats_acc_t stats;
     loadcell_measurement_t last_measurement;
 } loadcell_channel_t;
 
+/**
+ * Tare or span calibration averaged over the live frames, see loadcell_start_job()
+ *
+ * The request fields are written before the state turns RUNNING and only the
+ * acquisition task moves it on, so they are stable while it runs; results
+ * are read once it has left RUNNING.
+ */
+typedef struct {
+    loadcell_job_kind_t kind;
+    uint16_t channel_mask;          /**< Bit c selects channel c */
+    float force_n;                  /**< Known force on each selected channel (SPAN) */
+    uint32_t frames;                /**< Frames to average */
+
+    _Atomic uint8_t state;          /**< loadcell_job_state_t */
+    _Atomic uint32_t progress;      /**< Frames averaged so far */
+    _Atomic bool cancel;            /**< Set by loadcell_cancel_job(), seen at the next frame */
+
+    /* Acquisition task */
+    bool active;                    /**< acc[] belongs to the running job */
+    loadcell_job_acc_t acc[LOADCELL_MAX_CHANNELS];
+    loadcell_job_result_t result[LOADCELL_MAX_CHANNELS];
+    esp_err_t status[LOADCELL_MAX_CHANNELS];    /**< Outcome of applying each channel's result */
+} loadcell_job_t;
+
+/**
+ * Wiring of one ADS1261 on the shared SPI bus
+ */
+typedef struct {
+    int cs_pin;             /**< Chip select GPIO (-1 = CS tied low, single ADC only) */
+    int drdy_pin;           /**< Data ready GPIO (-1 = STATUS polling) */
+} loadcell_adc_pins_t;
+
 /**
  * Main loadcell device driver
+ *
+ * Channel c is input pair c % 4 of ADC c / 4.
  */
 typedef struct {
     /* Hardware configuration */
-    spi_device_handle_t spi_handle;
-    int cs_pin;
-    int drdy_pin;
+    ads1261_t adcs[LOADCELL_MAX_ADCS];
+    ads1261_seq_t seqs[LOADCELL_MAX_ADCS];  /**< Scan list of each ADC */
+    uint8_t num_adcs;
+    uint8_t num_channels;
     uint8_t pga_gain;
     uint8_t data_rate;
+    uint16_t oversampling;  /**< Conversions per channel per scan */
+    float frame_rate_hz;    /**< Rate the force filters are designed for (0 = not set) */
     
     /* Per-channel contexts */
-    loadcell_channel_t channels[4];
+    loadcell_channel_t channels[LOADCELL_MAX_CHANNELS];
     
     /* Current measurement frame */
-    loadcell_measurement_t measurements[4];
+    loadcell_measurement_t measurements[LOADCELL_MAX_CHANNELS];
     uint32_t frame_count;
-    
+
+    /* Inter-channel alignment of each frame */
+    _Atomic uint8_t align_mode;     /**< loadcell_align_mode_t, set by loadcell_set_alignment() */
+    int64_t aligned_us;             /**< Instant the frame's forces describe (0 = not aligned) */
+
+    /* Automatic zero tracking, see loadcell_set_zero_tracking() */
+    _Atomic int32_t zero_band_mn;   /**< Total force that still counts as unloaded (0 = off) */
+    _Atomic int32_t zero_limit_mn;  /**< Largest correction per channel between tares */
+    uint32_t zero_block_frames;     /**< Quiet frames averaged per correction */
+    uint32_t zero_frames;           /**< Quiet frames in the current block */
+    int32_t zero_min_mn;            /**< Range of the total over the current block */
+    int32_t zero_max_mn;
+    uint32_t zero_updates;          /**< Corrections applied */
+
+    /* Calibration job on the frame stream */
+    loadcell_job_t job;
 } loadcell_t;
 
 /* ============================================================================
@@ -97,7 +208,7 @@ typedef struct {
  * ============================================================================ */
 
 /**
- * Initialize loadcell driver with ADS1261
+ * Initialize loadcell driver with one ADS1261 (4 channels)
  * 
  * @param[in] device            Loadcell device handle
  * @param[in] host              SPI host (HSPI_HOST or VSPI_HOST)
@@ -112,6 +223,27 @@ esp_err_t loadcell_init(loadcell_t *device, spi_host_device_t host,
                        int cs_pin, int drdy_pin,
                        uint8_t pga_gain, uint8_t data_rate);
 
+/**
+ * Initialize loadcell driver with several ADS1261 on one SPI bus
+ * 
+ * Every ADC gets the same PGA and data rate and contributes 4 channels, in
+ * the order given. Their scans are interleaved: one ADC converts while
+ * another is read out, so the per-channel rate stays close to that of a
+ * single ADC.
+ * 
+ * @param[in] device            Loadcell device handle
+ * @param[in] host              SPI host (already initialized)
+ * @param[in] pins              CS/DRDY wiring of each ADC; CS is required when num_adcs > 1
+ * @param[in] num_adcs          Number of ADCs (1..LOADCELL_MAX_ADCS)
+ * @param[in] pga_gain          PGA gain setting
+ * @param[in] data_rate         Data rate setting
+ * 
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad wiring, or the ADC init error
+ */
+esp_err_t loadcell_init_multi(loadcell_t *device, spi_host_device_t host,
+                              const loadcell_adc_pins_t *pins, uint8_t num_adcs,
+                              uint8_t pga_gain, uint8_t data_rate);
+
 /**
  * De-initialize loadcell driver and free resources
  * 
@@ -125,8 +257,9 @@ esp_err_t loadcell_deinit(loadcell_t *device);
  * ============================================================================ */
 
 /**
- * Read all 4 loadcell channels in sequence
- * Updates device->measurements[] with latest values
+ * Read all loadcell channels, interleaving the ADCs
+ * Updates device->measurements[] with latest values, aligned to one
+ * instant when loadcell_set_alignment() is on
  * 
  * @param[in] device Loadcell device handle
  * @return ESP_OK on success, ESP_FAIL otherwise
@@ -135,11 +268,15 @@ esp_err_t loadcell_read(loadcell_t *device);
 
 /**
  * Switch to a specific channel
+ * Loads the channel's published OFCAL/FSCAL and input pair for single reads;
+ * the acquisition task's scan state is left alone
  * 
  * @param[in] device    Loadcell device handle
- * @param[in] channel   Channel index (0-3)
+ * @param[in] channel   Channel index (0..num_channels-1)
  * 
  * @return ESP_OK on success
+ * @note Writes the ADC on its own; while the acquisition task scans,
+ *       run it through acquisition_call()
  */
 esp_err_t loadcell_switch_channel(loadcell_t *device, uint8_t channel);
 
@@ -147,10 +284,12 @@ esp_err_t loadcell_switch_channel(loadcell_t *device, uint8_t channel);
  * Read single channel
  * 
  * @param[in] device        Loadcell device handle
- * @param[in] channel       Channel index (0-3)
+ * @param[in] channel       Channel index (0..num_channels-1)
  * @param[out] measurement  Measurement result
  * 
  * @return ESP_OK on success
+ * @note Reads the channel on its own; while the acquisition task scans,
+ *       run it through acquisition_call()
  */
 esp_err_t loadcell_read_channel(loadcell_t *device, uint8_t channel,
                                 loadcell_measurement_t *measurement);
@@ -159,7 +298,7 @@ esp_err_t loadcell_read_channel(loadcell_t *device, uint8_t channel,
  * Get last measurement for channel
  * 
  * @param[in] device       Loadcell device handle
- * @param[in] channel      Channel index (0-3)
+ * @param[in] channel      Channel index (0..num_channels-1)
  * @param[out] measurement Measurement result
  * 
  * @return ESP_OK on success
@@ -167,61 +306,368 @@ esp_err_t loadcell_read_channel(loadcell_t *device, uint8_t channel,
 esp_err_t loadcell_get_measurement(loadcell_t *device, uint8_t channel,
                                    loadcell_measurement_t *measurement);
 
+/**
+ * Scan timing of the current ADC configuration
+ * Settle time per channel and the per-channel rate a continuous scan reaches;
+ * the ADCs convert in parallel, so the rate is that of one ADC's 4 channels
+ * 
+ * @param[in] device  Loadcell device handle
+ * @param[out] timing Filter, data rate, delay and reachable rates
+ * 
+ * @return ESP_OK on success
+ */
+esp_err_t loadcell_get_timing(loadcell_t *device, ads1261_timing_plan_t *timing);
+
+/**
+ * Plan filter/data rate/delay for a target per-channel rate over all channels
+ * 
+ * @param[in] device         Loadcell device handle (for the number of ADCs)
+ * @param[in] target_rate_hz Required samples per second per channel
+ * @param[out] plan          Chosen configuration and reachable rates
+ * 
+ * @return ESP_OK if the target is reachable, ESP_ERR_NOT_SUPPORTED if not
+ *         (plan then holds the fastest configuration)
+ */
+esp_err_t loadcell_plan_timing(loadcell_t *device, float target_rate_hz, ads1261_timing_plan_t *plan);
+
+/**
+ * Read a burst of conversions per channel and decimate it to one sample
+ * Each channel's input stays selected for the burst; the conversions pass
+ * through the channel's CIC/FIR decimator (see loadcell_decim.h), so a
+ * frame still carries one sample per channel, with less noise. Call while
+ * acquisition is stopped.
+ * 
+ * @param[in] device      Loadcell device handle
+ * @param[in] conversions Conversions per channel per scan: 1 (off) or a power
+ *                        of two up to LOADCELL_DECIM_MAX_FACTOR
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for an unsupported count
+ */
+esp_err_t loadcell_set_oversampling(loadcell_t *device, uint16_t conversions);
+
+/**
+ * Largest oversampling whose scan still fits the frame period
+ * Leaves LOADCELL_OVERSAMPLING_HEADROOM of the period for readout jitter
+ * 
+ * @param[in] device        Loadcell device handle
+ * @param[in] frame_rate_hz Frames per second the acquisition task will run at
+ * 
+ * @return Conversions per channel per scan (1 when there is no room)
+ */
+uint16_t loadcell_plan_oversampling(loadcell_t *device, float frame_rate_hz);
+
+/** Share of the frame period that oversampled scans may fill */
+#define LOADCELL_OVERSAMPLING_HEADROOM  0.9f
+
+/* ============================================================================
+ * Force Filters
+ * ============================================================================ */
+
+/**
+ * Set the frame rate the force filters run at
+ * Designed sections are recomputed for the new rate; those at or above half
+ * of it are dropped. Zero-tracking blocks are resized to the rate.
+ * acquisition_set_rate() calls this.
+ * 
+ * @param[in] device        Loadcell device handle
+ * @param[in] frame_rate_hz Frames per second
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a rate <= 0, ESP_ERR_TIMEOUT if a
+ *         chain could not be updated (see bank_pair_begin_update())
+ */
+esp_err_t loadcell_set_frame_rate(loadcell_t *device, float frame_rate_hz);
+
+/**
+ * Append a low-pass, high-pass or notch section to a channel's force filter
+ * Safe while acquisition runs: the chain is swapped in between frames
+ * 
+ * @param[in] device  Loadcell device handle
+ * @param[in] channel Channel index (0..num_channels-1) or LOADCELL_ALL_CHANNELS
+ * @param[in] type    LOADCELL_FILTER_LOWPASS, _HIGHPASS or _NOTCH
+ * @param[in] freq_hz Cut-off or notch frequency
+ * @param[in] q       Quality factor (LOADCELL_FILTER_BUTTERWORTH_Q, LOADCELL_FILTER_NOTCH_Q)
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_STATE before the frame rate is set,
+ *         ESP_ERR_INVALID_ARG for a bad design, ESP_ERR_NO_MEM when a chain is full,
+ *         ESP_ERR_TIMEOUT if a chain could not be updated (see bank_pair_begin_update())
+ */
+esp_err_t loadcell_add_filter(loadcell_t *device, uint8_t channel, loadcell_filter_type_t type,
+                              float freq_hz, float q);
+
+/**
+ * Append a section given by its coefficients
+ * 
+ * @param[in] device  Loadcell device handle
+ * @param[in] channel Channel index (0..num_channels-1) or LOADCELL_ALL_CHANNELS
+ * @param[in] coef    b0, b1, b2, a1, a2 (a0 = 1)
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for out-of-range or unstable
+ *         coefficients, ESP_ERR_NO_MEM when a chain is full, ESP_ERR_TIMEOUT
+ *         if a chain could not be updated
+ */
+esp_err_t loadcell_add_filter_coefs(loadcell_t *device, uint8_t channel, const float coef[5]);
+
+/**
+ * Remove every section from a channel's force filter
+ * 
+ * @param[in] device  Loadcell device handle
+ * @param[in] channel Channel index (0..num_channels-1) or LOADCELL_ALL_CHANNELS
+ * 
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if a chain could not be updated
+ */
+esp_err_t loadcell_clear_filters(loadcell_t *device, uint8_t channel);
+
+/**
+ * Set a channel's spike filter (median or Hampel, see loadcell_despike.h)
+ * It runs on the forces ahead of the biquad cascade; safe while acquisition
+ * runs, taking effect at the channel's next frame with empty windows
+ * 
+ * @param[in] device  Loadcell device handle
+ * @param[in] channel Channel index (0..num_channels-1) or LOADCELL_ALL_CHANNELS
+ * @param[in] mode    LOADCELL_DESPIKE_OFF, _MEDIAN or _HAMPEL
+ * @param[in] window  Odd window in frames, 3..LOADCELL_MEDIAN_MAX_WINDOW (e.g. LOADCELL_DESPIKE_WINDOW)
+ * @param[in] k       Hampel threshold in standard deviations (e.g. LOADCELL_DESPIKE_K)
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a bad channel, mode, window or threshold
+ */
+esp_err_t loadcell_set_despike(loadcell_t *device, uint8_t channel, loadcell_despike_mode_t mode, uint8_t window,
+                               float k);
+
+/**
+ * Resample every channel of a frame to one instant (see loadcell_align.h)
+ * The forces of each frame are interpolated to a common time, which
+ * loadcell_read() stores in aligned_us and in every measurement's
+ * timestamp; raw codes stay as converted. Safe while acquisition runs.
+ * 
+ * @param[in] device Loadcell device handle
+ * @param[in] mode   LOADCELL_ALIGN_OFF, _LINEAR or _CUBIC (one frame later)
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for an unknown mode
+ */
+esp_err_t loadcell_set_alignment(loadcell_t *device, loadcell_align_mode_t mode);
+
+/**
+ * Current inter-channel alignment
+ * 
+ * @param[in] device Loadcell device handle
+ * 
+ * @return Mode set by loadcell_set_alignment()
+ */
+loadcell_align_mode_t loadcell_get_alignment(const loadcell_t *device);
+
 /* ============================================================================
  * Calibration Functions
  * ============================================================================ */
 
+/**
+ * Raw counts per Newton on a channel whose span is calibrated in hardware
+ * (FSCAL normalizes every channel to this resolution: 1 count = 1 mN)
+ */
+#define LOADCELL_COUNTS_PER_N   1000
+
 /**
  * Tare (zero) calibration - must be done with no load applied
- * Captures offset value from multiple averaged samples
+ * Captures offset value from multiple averaged samples and loads it into
+ * the channel's OFCAL correction, so raw readings are zero-based; samples
+ * that a Hampel filter flags as spikes are replaced by the running median
+ * before averaging
  * 
  * @param[in] device        Loadcell device handle
- * @param[in] channel       Channel index (0-3)
- * @param[in] num_samples   Number of samples to average (typically 100-500)
+ * @param[in] channel       Channel index (0..num_channels-1)
+ * @param[in] num_samples   Number of samples to average (typically 100-500,
+ *                          at most LOADCELL_JOB_MAX_FRAMES)
  * 
- * @return ESP_OK on success
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if the calibration set could
+ *         not be updated (see bank_pair_begin_update())
+ * @note Reads the channel on its own; while the acquisition task scans,
+ *       use loadcell_start_job() instead
  */
 esp_err_t loadcell_tare(loadcell_t *device, uint8_t channel, uint32_t num_samples);
 
 /**
  * Full-scale calibration - done with known weight on loadcell
  * Must call loadcell_tare() first!
+ * Loads the span into the channel's FSCAL correction so raw readings are
+ * LOADCELL_COUNTS_PER_N per Newton; falls back to a software scale factor
+ * when the required gain is outside the FSCAL range (0..4)
  * 
  * @param[in] device        Loadcell device handle
- * @param[in] channel       Channel index (0-3)
+ * @param[in] channel       Channel index (0..num_channels-1)
  * @param[in] known_force_n Known force in Newtons (e.g., 100.0 for 100N)
- * @param[in] num_samples   Number of samples to average (typically 100-500)
+ * @param[in] num_samples   Number of samples to average (typically 100-500,
+ *                          at most LOADCELL_JOB_MAX_FRAMES)
  * 
- * @return ESP_OK on success
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if the calibration set could
+ *         not be updated
+ * @note Reads the channel on its own; while the acquisition task scans,
+ *       use loadcell_start_job() instead
  */
 esp_err_t loadcell_calibrate(loadcell_t *device, uint8_t channel,
                              float known_force_n, uint32_t num_samples);
 
+/**
+ * Record one known load for multi-point calibration
+ * Must call loadcell_tare() first (the tare is the zero point); the points
+ * take effect once loadcell_build_lut() compiles them
+ * 
+ * @param[in] device        Loadcell device handle
+ * @param[in] channel       Channel index (0..num_channels-1)
+ * @param[in] known_force_n Known force in Newtons
+ * @param[in] num_samples   Number of samples to average (at most
+ *                          LOADCELL_JOB_MAX_FRAMES)
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_STATE before a tare or when the average
+ *         is the tare code itself, ESP_ERR_NO_MEM when
+ *         LOADCELL_CAL_MAX_POINTS - 1 points are already recorded,
+ *         ESP_ERR_TIMEOUT if the calibration set could not be updated
+ * @note Reads the channel on its own; while the acquisition task scans,
+ *       use loadcell_start_job() with LOADCELL_JOB_POINT instead
+ */
+esp_err_t loadcell_add_cal_point(loadcell_t *device, uint8_t channel, float known_force_n, uint32_t num_samples);
+
+/**
+ * Fit the recorded points and switch the channel to the compiled table
+ * A new tare, single-point calibration or reset discards points and table
+ * 
+ * @param[in] device  Loadcell device handle
+ * @param[in] channel Channel index (0..num_channels-1)
+ * @param[in] fit     Piecewise-linear, quadratic or cubic
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_STATE without points, the fit error, or
+ *         ESP_ERR_TIMEOUT if the calibration set could not be updated
+ */
+esp_err_t loadcell_build_lut(loadcell_t *device, uint8_t channel, loadcell_fit_t fit);
+
+/** Quiet time averaged per zero-tracking correction */
+#define LOADCELL_ZERO_BLOCK_S       1.0f
+/** Frames per correction until the frame rate is known */
+#define LOADCELL_ZERO_BLOCK_FRAMES  64
+/** Each correction removes 1 / 2^LOADCELL_ZERO_STEP_SHIFT of the residual zero */
+#define LOADCELL_ZERO_STEP_SHIFT    2
+/** Default unloaded band of the total force */
+#define LOADCELL_ZERO_BAND_MN       2000
+/** Default limit of the tracked correction per channel */
+#define LOADCELL_ZERO_LIMIT_MN      20000
+
+/**
+ * Track the zero of calibrated channels while the plate is unloaded
+ * Runs in loadcell_read() at O(1) per channel and frame. Frames whose total
+ * force over the calibrated channels stays within ±band_mn, and within a
+ * band_mn range of each other, are averaged in blocks of
+ * LOADCELL_ZERO_BLOCK_S; after each quiet block every calibrated channel's
+ * offset_raw moves 1 / 2^LOADCELL_ZERO_STEP_SHIFT of the way to its mean
+ * net code. A frame outside the band or range discards the block at once,
+ * so tracking freezes on the first loaded frame. Corrections stop at
+ * ±limit_mn per channel; a tare starts the count again. Safe while
+ * acquisition runs.
+ * 
+ * @param[in] device   Loadcell device handle
+ * @param[in] band_mn  Unloaded band of the total force (e.g. LOADCELL_ZERO_BAND_MN), 0 = off
+ * @param[in] limit_mn Largest correction per channel (e.g. LOADCELL_ZERO_LIMIT_MN)
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a negative band or limit
+ */
+esp_err_t loadcell_set_zero_tracking(loadcell_t *device, int32_t band_mn, int32_t limit_mn);
+
+/** Frames a calibration job averages unless told otherwise (0.2 s at 1 kHz) */
+#define LOADCELL_JOB_FRAMES     200
+
+/**
+ * Start a tare, span or calibration point on the live frame stream
+ * Returns at once; loadcell_read() averages each selected channel's raw code
+ * over the next `frames` frames (Hampel-filtered, as loadcell_tare() does)
+ * and then applies every channel's result as loadcell_tare(),
+ * loadcell_calibrate() or loadcell_add_cal_point() would. All channels are averaged from the same frames
+ * and nothing competes with the scan for the bus, so this is the way to
+ * calibrate while the acquisition task runs. Zero tracking pauses meanwhile.
+ * Call from one task at a time.
+ *
+ * @param[in] device        Loadcell device handle
+ * @param[in] kind          LOADCELL_JOB_TARE (unloaded), LOADCELL_JOB_SPAN or
+ *                          LOADCELL_JOB_POINT
+ * @param[in] channel       Channel index, or LOADCELL_ALL_CHANNELS
+ * @param[in] known_force_n Known force on each selected channel (SPAN, POINT)
+ * @param[in] frames        Frames to average, 1..LOADCELL_JOB_MAX_FRAMES
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_INVALID_STATE while another
+ *         job runs or for a span or point on a channel without a tare,
+ *         ESP_ERR_NO_MEM for a point on a channel whose points are all used
+ */
+esp_err_t loadcell_start_job(loadcell_t *device, loadcell_job_kind_t kind, uint8_t channel, float known_force_n,
+                             uint32_t frames);
+
+/**
+ * State and progress of the last calibration job (any task)
+ *
+ * @param[in]  device   Loadcell device handle
+ * @param[out] progress Frames averaged so far (may be NULL)
+ * @param[out] frames   Frames the job averages (may be NULL)
+ *
+ * @return Job state
+ */
+loadcell_job_state_t loadcell_get_job(loadcell_t *device, uint32_t *progress, uint32_t *frames);
+
+/**
+ * Average and noise one channel saw in the last finished job
+ *
+ * @param[in]  device  Loadcell device handle
+ * @param[in]  channel Channel index (0..num_channels-1)
+ * @param[out] result  Mean, spread and extremes of its raw codes
+ *
+ * @return ESP_OK when the result was applied, the error that refused it
+ *         (e.g. ESP_FAIL for a span without change, ESP_ERR_NO_MEM for a
+ *         point beyond the table), ESP_ERR_NOT_FOUND if
+ *         the job did not include the channel, ESP_ERR_INVALID_STATE while
+ *         it runs or after a cancel
+ */
+esp_err_t loadcell_get_job_result(loadcell_t *device, uint8_t channel, loadcell_job_result_t *result);
+
+/**
+ * Stop the running job at the next frame without applying anything
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if no job runs
+ */
+esp_err_t loadcell_cancel_job(loadcell_t *device);
+
 /**
  * Get calibration status of channel
  * 
  * @param[in] device  Loadcell device handle
- * @param[in] channel Channel index (0-3)
+ * @param[in] channel Channel index (0..num_channels-1)
  * 
  * @return Current calibration state
  */
-loadcell_calib_state_t loadcell_get_calib_state(loadcell_t *device, uint8_t channel);
+loadcell_calib_state_t loadcell_get_calib_state(const loadcell_t *device, uint8_t channel);
+
+/**
+ * Copy of the calibration set a channel's next frame converts with (any task)
+ * 
+ * @param[in]  device  Loadcell device handle
+ * @param[in]  channel Channel index (0..num_channels-1)
+ * @param[out] set     Offset, scale, OFCAL/FSCAL and table, with the version
+ *                     that published them
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a bad channel
+ */
+esp_err_t loadcell_get_cal_set(const loadcell_t *device, uint8_t channel, loadcell_cal_set_t *set);
 
 /**
  * Reset calibration for channel
  * 
  * @param[in] device  Loadcell device handle
- * @param[in] channel Channel index (0-3)
+ * @param[in] channel Channel index (0..num_channels-1)
  * 
- * @return ESP_OK on success
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if the calibration set could
+ *         not be updated
  */
 esp_err_t loadcell_reset_calibration(loadcell_t *device, uint8_t channel);
 
 /**
  * Get channel statistics
+ * Snapshot of the statistics loadcell_read() keeps; safe while acquisition runs
  * 
  * @param[in] device  Loadcell device handle
- * @param[in] channel Channel index (0-3)
+ * @param[in] channel Channel index (0..num_channels-1)
  * @param[out] stats  Statistics result
  * 
  * @return ESP_OK on success
@@ -230,9 +676,10 @@ esp_err_t loadcell_get_stats(loadcell_t *device, uint8_t channel, loadcell_stats
 
 /**
  * Reset channel statistics
+ * Takes effect at the channel's next sample; snapshots read empty until then
  * 
  * @param[in] device  Loadcell device handle
- * @param[in] channel Channel index (0-3) or 4 for all channels
+ * @param[in] channel Channel index (0..num_channels-1) or LOADCELL_ALL_CHANNELS
  * 
  * @return ESP_OK on success
  */
@@ -243,7 +690,7 @@ esp_err_t loadcell_reset_stats(loadcell_t *device, uint8_t channel);
  * ============================================================================ */
 
 /**
- * @brief Run diagnostic on the ADS1261 communication
+ * @brief Run diagnostic on the communication with every ADS1261
  * 
  * @param[in] device Loadcell device handle
  * 
@@ -258,13 +705,6 @@ esp_err_t loadcell_diagnostic(loadcell_t *device);
  */
 void loadcell_print_calib_info(loadcell_t *device);
 
-/**
- * Print current measurements and statistics
- * 
- * @param[in] device Loadcell device handle
- */
-void loadcell_print_measurements(loadcell_t *device);
-
 #ifdef __cplusplus
 }
 #endif
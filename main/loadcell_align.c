@@ -0,0 +1,103 @@
+/**
+ * @file loadcell_align.c
+ * @brief Resampling of the channels of a frame to one common instant
+ */
+
+#include <string.h>
+#include "loadcell_align.h"
+
+#define ALIGN_FRAC_BITS     24
+#define ALIGN_ONE           (1 << ALIGN_FRAC_BITS)
+
+void loadcell_align_reset(loadcell_align_history_t *history)
+{
+    memset(history, 0, sizeof(*history));
+}
+
+void loadcell_align_push(loadcell_align_history_t *history, int64_t t_us, int32_t force_mn)
+{
+    for (int i = LOADCELL_ALIGN_HISTORY - 1; i > 0; i--) {
+        history->t_us[i] = history->t_us[i - 1];
+        history->force_mn[i] = history->force_mn[i - 1];
+    }
+    history->t_us[0] = t_us;
+    history->force_mn[0] = force_mn;
+    if (history->count < LOADCELL_ALIGN_HISTORY) {
+        history->count++;
+    }
+}
+
+bool loadcell_align_ready(const loadcell_align_history_t *history, loadcell_align_mode_t mode)
+{
+    switch (mode) {
+    case LOADCELL_ALIGN_LINEAR: return history->count >= 2;
+    case LOADCELL_ALIGN_CUBIC:  return history->count >= 4;
+    default:                    return false;
+    }
+}
+
+int64_t loadcell_align_anchor(const loadcell_align_history_t *history, loadcell_align_mode_t mode)
+{
+    return history->t_us[mode == LOADCELL_ALIGN_CUBIC ? 1 : 0];
+}
+
+/* Position of t between t0 and t1 > t0, Q24 in [0, 1] */
+static int64_t loadcell_align_frac(int64_t t0, int64_t t1, int64_t t)
+{
+    if (t <= t0 || t1 <= t0) {
+        return 0;
+    }
+    if (t >= t1) {
+        return ALIGN_ONE;
+    }
+    return ((t - t0) << ALIGN_FRAC_BITS) / (t1 - t0);
+}
+
+static int32_t loadcell_align_clamp(int64_t value)
+{
+    if (value > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (value < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)value;
+}
+
+int32_t loadcell_align_at(const loadcell_align_history_t *history, loadcell_align_mode_t mode, int64_t t_us)
+{
+    const int32_t *y = history->force_mn;
+    const int64_t *t = history->t_us;
+
+    if (mode == LOADCELL_ALIGN_LINEAR) {
+        int64_t u = loadcell_align_frac(t[1], t[0], t_us);
+        return loadcell_align_clamp(y[1] + ((((int64_t)y[0] - y[1]) * u + ALIGN_ONE / 2) >> ALIGN_FRAC_BITS));
+    }
+
+    /*
+     * Catmull-Rom between p1 = y[2] and p2 = y[1], tangents from the outer
+     * samples p0 = y[3] and p3 = y[0]; Horner form of twice the cubic.
+     * |p| < 2^31, so the coefficients stay below 2^35 and each product
+     * with u below 2^60.
+     */
+    int64_t p0 = y[3], p1 = y[2], p2 = y[1], p3 = y[0];
+    int64_t u = loadcell_align_frac(t[2], t[1], t_us);
+    int64_t a = -p0 + 3 * p1 - 3 * p2 + p3;
+    int64_t b = 2 * p0 - 5 * p1 + 4 * p2 - p3;
+    int64_t c = p2 - p0;
+    int64_t twice = (a * u + ALIGN_ONE / 2) >> ALIGN_FRAC_BITS;
+    twice = ((twice + b) * u + ALIGN_ONE / 2) >> ALIGN_FRAC_BITS;
+    twice = ((twice + c) * u + ALIGN_ONE / 2) >> ALIGN_FRAC_BITS;
+    twice += 2 * p1;
+    return loadcell_align_clamp((twice + 1) >> 1);
+}
+
+const char *loadcell_align_mode_name(loadcell_align_mode_t mode)
+{
+    switch (mode) {
+    case LOADCELL_ALIGN_OFF:    return "off";
+    case LOADCELL_ALIGN_LINEAR: return "linear";
+    case LOADCELL_ALIGN_CUBIC:  return "cubic";
+    default:                    return "?";
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file loadcell_align.h
+ * @brief Resampling of the channels of a frame to one common instant
+ *
+ * A scan converts the channels one after another, so the forces of one
+ * frame were measured up to a scan period apart. For slow loads that does
+ * not matter; across an impact transient it makes the total force and the
+ * COP mix different instants. Each channel therefore keeps its last
+ * LOADCELL_ALIGN_HISTORY forces with their conversion timestamps, and at the
+ * end of a scan every channel is interpolated to the same instant:
+ *
+ * - LINEAR: the earliest timestamp of the current scan. Every channel's
+ *   sample from the previous scan precedes it and the one from this scan
+ *   does not, so it lies between each channel's last two samples. No added
+ *   delay.
+ * - CUBIC: the earliest timestamp of the previous scan, between each
+ *   channel's second and third newest samples, through the Catmull-Rom
+ *   cubic of its four newest. One frame of added delay; exact for
+ *   quadratic force curves instead of straight lines.
+ *
+ * The interpolation position is a Q24 fraction of the interval between the
+ * two bracketing samples, and the arithmetic is integer. Catmull-Rom takes
+ * the samples as equally spaced, which the fixed scan order makes them to
+ * within the readout jitter.
+ */
+
+#ifndef LOADCELL_ALIGN_H
+#define LOADCELL_ALIGN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADCELL_ALIGN_HISTORY  4       /**< Samples kept per channel (cubic needs four) */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Interpolation used to align a frame
+ */
+typedef enum {
+    LOADCELL_ALIGN_OFF = 0,         /**< Each channel keeps its own conversion time */
+    LOADCELL_ALIGN_LINEAR,          /**< Straight line between the last two samples */
+    LOADCELL_ALIGN_CUBIC,           /**< Catmull-Rom through the last four, one frame later */
+} loadcell_align_mode_t;
+
+/**
+ * Recent samples of one channel, newest first (acquisition task)
+ */
+typedef struct {
+    int64_t t_us[LOADCELL_ALIGN_HISTORY];       /**< Conversion timestamps */
+    int32_t force_mn[LOADCELL_ALIGN_HISTORY];   /**< Forces after the channel's filters */
+    uint8_t count;                              /**< Samples held */
+} loadcell_align_history_t;
+
+/* ============================================================================
+ * Functions
+ * ============================================================================ */
+
+/**
+ * @brief Forget every sample
+ */
+void loadcell_align_reset(loadcell_align_history_t *history);
+
+/**
+ * @brief Record a channel's newest sample
+ */
+void loadcell_align_push(loadcell_align_history_t *history, int64_t t_us, int32_t force_mn);
+
+/**
+ * @brief Whether the history holds enough samples for a mode
+ */
+bool loadcell_align_ready(const loadcell_align_history_t *history, loadcell_align_mode_t mode);
+
+/**
+ * @brief Timestamp in this channel's history that bounds the common instant
+ *
+ * The common instant of a frame is the earliest of these over its channels:
+ * the newest sample for LINEAR, the second newest for CUBIC.
+ */
+int64_t loadcell_align_anchor(const loadcell_align_history_t *history, loadcell_align_mode_t mode);
+
+/**
+ * @brief Force of the channel at t_us
+ *
+ * @param history Channel history, loadcell_align_ready() for the mode
+ * @param mode LINEAR or CUBIC
+ * @param t_us Instant between the two samples the mode interpolates
+ *             (clamped to them otherwise)
+ * @return Interpolated force (mN), saturated to the int32_t range
+ */
+int32_t loadcell_align_at(const loadcell_align_history_t *history, loadcell_align_mode_t mode, int64_t t_us);
+
+/**
+ * @brief Short name of a mode, for logs
+ */
+const char *loadcell_align_mode_name(loadcell_align_mode_t mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADCELL_ALIGN_H */
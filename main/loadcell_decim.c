@@ -0,0 +1,91 @@
+/**
+ * @file loadcell_decim.c
+ * @brief Per-channel decimation of oversampled conversion bursts
+ */
+
+#include <string.h>
+#include "loadcell_decim.h"
+
+/* Bursts until the compensator's oldest input is a settled CIC output */
+#define LOADCELL_DECIM_FIR_READY    (LOADCELL_DECIM_ORDER + 1)
+
+/* Filters, counters and burst cleared; the factor and reset request kept */
+static void loadcell_decim_clear(loadcell_decim_t *decim)
+{
+    decim->phase = 0;
+    decim->outputs = 0;
+    decim->burst_sum = 0;
+    memset(decim->integ, 0, sizeof(decim->integ));
+    memset(decim->comb, 0, sizeof(decim->comb));
+    memset(decim->history, 0, sizeof(decim->history));
+}
+
+/* a / 2^shift rounded to nearest */
+static inline int64_t loadcell_decim_shift_round(int64_t a, unsigned shift)
+{
+    return shift ? (a + ((int64_t)1 << (shift - 1))) >> shift : a;
+}
+
+esp_err_t loadcell_decim_init(loadcell_decim_t *decim, uint16_t factor)
+{
+    if (!decim || factor == 0 || factor > LOADCELL_DECIM_MAX_FACTOR || (factor & (factor - 1))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t log2_factor = 0;
+    while ((1u << log2_factor) < factor) {
+        log2_factor++;
+    }
+    decim->log2_factor = log2_factor;
+    loadcell_decim_clear(decim);
+    atomic_init(&decim->reset_pending, false);
+    return ESP_OK;
+}
+
+void loadcell_decim_request_reset(loadcell_decim_t *decim)
+{
+    atomic_store_explicit(&decim->reset_pending, true, memory_order_release);
+}
+
+int32_t loadcell_decim_end_burst(loadcell_decim_t *decim)
+{
+    uint16_t factor = loadcell_decim_factor(decim);
+    if (decim->phase == 0) {
+        return 0;
+    }
+
+    int32_t mean = (int32_t)(decim->phase == factor ? loadcell_decim_shift_round(decim->burst_sum, decim->log2_factor)
+                                                    : decim->burst_sum / decim->phase);
+    bool reset = atomic_load_explicit(&decim->reset_pending, memory_order_relaxed) &&
+                 atomic_exchange_explicit(&decim->reset_pending, false, memory_order_acquire);
+    /* No oversampling passes the code through; a short burst restarts the filters */
+    if (factor == 1 || reset || decim->phase != factor) {
+        loadcell_decim_clear(decim);
+        return mean;
+    }
+
+    /* Combs at the decimated rate: the wrapped integrator sums come out exact */
+    uint64_t y = decim->integ[LOADCELL_DECIM_ORDER - 1];
+    for (int i = 0; i < LOADCELL_DECIM_ORDER; i++) {
+        uint64_t d = y - decim->comb[i];
+        decim->comb[i] = y;
+        y = d;
+    }
+    int32_t cic = (int32_t)loadcell_decim_shift_round((int64_t)y, LOADCELL_DECIM_ORDER * decim->log2_factor);
+
+    /* Droop compensation: [-1, 10, -1] / 8 over this and the last two outputs */
+    int64_t fir = 10 * (int64_t)decim->history[0] - decim->history[1] - cic;
+    int32_t out = (int32_t)loadcell_decim_shift_round(fir, 3);
+
+    decim->history[1] = decim->history[0];
+    decim->history[0] = cic;
+    decim->burst_sum = 0;
+    decim->phase = 0;
+
+    /* Plain means until the CIC, then the compensator, have a full history */
+    if (decim->outputs < LOADCELL_DECIM_FIR_READY) {
+        decim->outputs++;
+        return mean;
+    }
+    return out;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file loadcell_decim.h
+ * @brief Per-channel decimation of oversampled conversion bursts
+ *
+ * With oversampling on, each channel's scan step reads a burst of
+ * consecutive conversions instead of one. Every conversion goes through a
+ * CIC filter (LOADCELL_DECIM_ORDER integrator/comb pairs, decimation by the
+ * burst length), which yields one output per burst, i.e. one per frame. The
+ * bursts of a channel are filtered back to back, so the CIC's nulls fall on
+ * multiples of the frame rate: it is the anti-alias filter for the frame
+ * rate as well as the averaging that lowers the noise.
+ *
+ * The CIC's passband droop is flattened by a 3-tap FIR at the frame rate,
+ * [-1, 10, -1] / 8, whose DC gain is exactly one. Together they delay the
+ * signal by about 2.5 frames. Arithmetic is integer only: the integrators
+ * wrap modulo 2^64, which the combs undo, and the CIC gain (burst length to
+ * the power LOADCELL_DECIM_ORDER) is removed by a shift, so the burst length
+ * is a power of two.
+ *
+ * Until the filters have filled after a reset, a burst outputs its plain
+ * mean. The acquisition task owns the state; other tasks only request a
+ * reset, which the next burst applies (as loadcell_stats does).
+ */
+
+#ifndef LOADCELL_DECIM_H
+#define LOADCELL_DECIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADCELL_DECIM_ORDER        3       /**< CIC integrator/comb pairs */
+#define LOADCELL_DECIM_MAX_FACTOR   64      /**< Longest burst (power of two) */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Decimator of one channel, written only by the acquisition task
+ */
+typedef struct {
+    _Atomic bool reset_pending;                 /**< Set by other tasks, applied at a burst end */
+
+    uint8_t log2_factor;                        /**< Burst length is 1 << log2_factor */
+    uint16_t phase;                             /**< Conversions pushed in the current burst */
+    uint8_t outputs;                            /**< Bursts since reset, saturating */
+    int64_t burst_sum;                          /**< Plain sum of the current burst */
+
+    uint64_t integ[LOADCELL_DECIM_ORDER];       /**< Integrators (modulo 2^64) */
+    uint64_t comb[LOADCELL_DECIM_ORDER];        /**< Comb delays */
+    int32_t history[2];                         /**< Last two CIC outputs, newest first */
+} loadcell_decim_t;
+
+/* ============================================================================
+ * Functions
+ * ============================================================================ */
+
+/**
+ * @brief Set the burst length and clear the filters (acquisition stopped)
+ *
+ * @param decim Decimator
+ * @param factor Conversions per burst: a power of two up to LOADCELL_DECIM_MAX_FACTOR
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for any other factor
+ */
+esp_err_t loadcell_decim_init(loadcell_decim_t *decim, uint16_t factor);
+
+/**
+ * @brief Clear the filters at the next burst end (any task)
+ */
+void loadcell_decim_request_reset(loadcell_decim_t *decim);
+
+/**
+ * @brief Feed one conversion
+ *
+ * @param decim Decimator
+ * @param code Conversion result (24-bit signed)
+ */
+static inline void loadcell_decim_push(loadcell_decim_t *decim, int32_t code)
+{
+    uint64_t x = (uint64_t)(int64_t)code;
+    for (int i = 0; i < LOADCELL_DECIM_ORDER; i++) {
+        decim->integ[i] += x;
+        x = decim->integ[i];
+    }
+    decim->burst_sum += code;
+    decim->phase++;
+}
+
+/**
+ * @brief Close the current burst and produce its output
+ *
+ * A burst that did not hold exactly the configured number of conversions
+ * (the scan was interrupted) restarts the filters and outputs its mean.
+ *
+ * @param decim Decimator
+ * @return Decimated code, in the units of the input
+ */
+int32_t loadcell_decim_end_burst(loadcell_decim_t *decim);
+
+/**
+ * @brief Conversions per burst
+ */
+static inline uint16_t loadcell_decim_factor(const loadcell_decim_t *decim)
+{
+    return (uint16_t)1 << decim->log2_factor;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADCELL_DECIM_H */
@@ -0,0 +1,275 @@
+/**
+ * @file loadcell_despike.c
+ * @brief Streaming median and Hampel spike filters on the force samples
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "loadcell_despike.h"
+
+#define MEDIAN_MID              (LOADCELL_MEDIAN_MAX_WINDOW / 2)
+
+/* Gaussian standard deviation per unit of MAD, in Q8 of the threshold */
+#define DESPIKE_MAD_SIGMA       1.4826f
+#define DESPIKE_THRESH_SHIFT    8
+
+/* Packed configuration: mode | window << 8 | threshold (Q8 of k * 1.4826) << 16 */
+#define DESPIKE_MODE(c)         ((loadcell_despike_mode_t)((c) & 0xFF))
+#define DESPIKE_WINDOW(c)       ((uint8_t)(((c) >> 8) & 0xFF))
+#define DESPIKE_THRESH(c)       ((c) >> 16)
+
+_Static_assert(LOADCELL_MEDIAN_MAX_WINDOW % 2 == 1 && LOADCELL_MEDIAN_MAX_WINDOW <= 255,
+               "LOADCELL_MEDIAN_MAX_WINDOW must be odd and fit the uint8_t slot indices");
+_Static_assert(LOADCELL_DESPIKE_MAX_K * DESPIKE_MAD_SIGMA * (1 << DESPIKE_THRESH_SHIFT) < 65536,
+               "Hampel threshold must fit 16 bits of the packed configuration");
+
+/* ============================================================================
+ * Running median
+ * ============================================================================ */
+
+static inline int32_t median_at(const loadcell_median_t *m, int p)
+{
+    return m->values[m->heap[MEDIAN_MID + p]];
+}
+
+/* Samples in the max-heap (positions -1..-lower) and the min-heap (1..upper) */
+static inline int median_lower(const loadcell_median_t *m)
+{
+    return m->count / 2;
+}
+
+static inline int median_upper(const loadcell_median_t *m)
+{
+    return (m->count - 1) / 2;
+}
+
+/* Swap positions a and b when the sample at a is below the one at b */
+static bool median_order(loadcell_median_t *m, int a, int b)
+{
+    if (median_at(m, a) >= median_at(m, b)) {
+        return false;
+    }
+    uint8_t slot_a = m->heap[MEDIAN_MID + a];
+    uint8_t slot_b = m->heap[MEDIAN_MID + b];
+    m->heap[MEDIAN_MID + a] = slot_b;
+    m->heap[MEDIAN_MID + b] = slot_a;
+    m->pos[slot_b] = (int8_t)a;
+    m->pos[slot_a] = (int8_t)b;
+    return true;
+}
+
+/* Move a sample that grew up the min-heap; true when it reached the median */
+static bool median_min_up(loadcell_median_t *m, int p)
+{
+    while (p > 0 && median_order(m, p, p / 2)) {
+        p /= 2;
+    }
+    return p == 0;
+}
+
+/* Move a sample that shrank up the max-heap; true when it reached the median */
+static bool median_max_up(loadcell_median_t *m, int p)
+{
+    while (p < 0 && median_order(m, p / 2, p)) {
+        p /= 2;
+    }
+    return p == 0;
+}
+
+/* Restore the min-heap below the parent of position p (p = 1: from the median) */
+static void median_min_down(loadcell_median_t *m, int p)
+{
+    int upper = median_upper(m);
+    for (; p <= upper; p *= 2) {
+        if (p > 1 && p < upper && median_at(m, p + 1) < median_at(m, p)) {
+            p++;
+        }
+        if (!median_order(m, p, p / 2)) {
+            break;
+        }
+    }
+}
+
+/* Restore the max-heap below the parent of position p (p = -1: from the median) */
+static void median_max_down(loadcell_median_t *m, int p)
+{
+    int lower = median_lower(m);
+    for (; p >= -lower; p *= 2) {
+        if (p < -1 && p > -lower && median_at(m, p) < median_at(m, p - 1)) {
+            p--;
+        }
+        if (!median_order(m, p / 2, p)) {
+            break;
+        }
+    }
+}
+
+esp_err_t loadcell_median_init(loadcell_median_t *median, uint8_t window)
+{
+    if (!median || window == 0 || window > LOADCELL_MEDIAN_MAX_WINDOW || window % 2 == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(median, 0, sizeof(*median));
+    median->window = window;
+    /* Slots fill the positions 0, -1, 1, -2, 2, ... so both heaps grow evenly */
+    for (int slot = 0; slot < window; slot++) {
+        int p = (slot + 1) / 2 * (slot % 2 ? -1 : 1);
+        median->pos[slot] = (int8_t)p;
+        median->heap[MEDIAN_MID + p] = (uint8_t)slot;
+    }
+    return ESP_OK;
+}
+
+int32_t loadcell_median_push(loadcell_median_t *median, int32_t x)
+{
+    bool filling = median->count < median->window;
+    uint8_t slot = median->next;
+    int p = median->pos[slot];
+    int32_t old = median->values[slot];
+
+    median->values[slot] = x;
+    median->next = slot + 1 == median->window ? 0 : slot + 1;
+    if (filling) {
+        median->count++;
+    }
+
+    /* The new sample takes the oldest one's place: sift it within its heap, or across the median */
+    if (p > 0) {
+        if (!filling && x > old) {
+            median_min_down(median, p * 2);
+        } else if (median_min_up(median, p)) {
+            median_max_down(median, -1);
+        }
+    } else if (p < 0) {
+        if (!filling && x < old) {
+            median_max_down(median, p * 2);
+        } else if (median_max_up(median, p)) {
+            median_min_down(median, 1);
+        }
+    } else {
+        if (median_lower(median)) {
+            median_max_down(median, -1);
+        }
+        if (median_upper(median)) {
+            median_min_down(median, 1);
+        }
+    }
+    return median_at(median, 0);
+}
+
+/* ============================================================================
+ * Despike stage
+ * ============================================================================ */
+
+void loadcell_despike_init(loadcell_despike_t *despike)
+{
+    memset(despike, 0, sizeof(*despike));
+    atomic_init(&despike->config, LOADCELL_DESPIKE_OFF);
+    atomic_init(&despike->replaced, 0);
+    despike->applied = LOADCELL_DESPIKE_OFF;
+}
+
+esp_err_t loadcell_despike_configure(loadcell_despike_t *despike, loadcell_despike_mode_t mode, uint8_t window,
+                                     float k)
+{
+    if (!despike) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t config;
+    switch (mode) {
+    case LOADCELL_DESPIKE_OFF:
+        config = LOADCELL_DESPIKE_OFF;
+        break;
+    case LOADCELL_DESPIKE_MEDIAN:
+    case LOADCELL_DESPIKE_HAMPEL:
+        if (window < 3 || window > LOADCELL_MEDIAN_MAX_WINDOW || window % 2 == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        config = mode | (uint32_t)window << 8;
+        if (mode == LOADCELL_DESPIKE_HAMPEL) {
+            if (!(k > 0.0f) || !(k <= LOADCELL_DESPIKE_MAX_K)) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            config |= (uint32_t)lroundf(k * DESPIKE_MAD_SIGMA * (1 << DESPIKE_THRESH_SHIFT)) << 16;
+        }
+        break;
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    atomic_store_explicit(&despike->config, config, memory_order_relaxed);
+    return ESP_OK;
+}
+
+void loadcell_despike_get_config(const loadcell_despike_t *despike, loadcell_despike_mode_t *mode, uint8_t *window,
+                                 float *k)
+{
+    uint32_t config = atomic_load_explicit(&despike->config, memory_order_relaxed);
+    if (mode) {
+        *mode = DESPIKE_MODE(config);
+    }
+    if (window) {
+        *window = DESPIKE_WINDOW(config);
+    }
+    if (k) {
+        *k = (float)DESPIKE_THRESH(config) / (1 << DESPIKE_THRESH_SHIFT) / DESPIKE_MAD_SIGMA;
+    }
+}
+
+uint32_t loadcell_despike_replaced(const loadcell_despike_t *despike)
+{
+    return atomic_load_explicit(&despike->replaced, memory_order_relaxed);
+}
+
+const char *loadcell_despike_mode_name(loadcell_despike_mode_t mode)
+{
+    switch (mode) {
+    case LOADCELL_DESPIKE_OFF:    return "off";
+    case LOADCELL_DESPIKE_MEDIAN: return "median";
+    case LOADCELL_DESPIKE_HAMPEL: return "hampel";
+    default:                      return "?";
+    }
+}
+
+int32_t loadcell_despike_run(loadcell_despike_t *despike, int32_t x)
+{
+    uint32_t config = atomic_load_explicit(&despike->config, memory_order_relaxed);
+    if (config != despike->applied) {
+        /* New configuration: start with empty windows */
+        despike->applied = config;
+        if (DESPIKE_MODE(config) != LOADCELL_DESPIKE_OFF) {
+            loadcell_median_init(&despike->values, DESPIKE_WINDOW(config));
+            loadcell_median_init(&despike->deviations, DESPIKE_WINDOW(config));
+        }
+        atomic_store_explicit(&despike->replaced, 0, memory_order_relaxed);
+    }
+
+    switch (DESPIKE_MODE(config)) {
+    case LOADCELL_DESPIKE_MEDIAN:
+        return loadcell_median_push(&despike->values, x);
+    case LOADCELL_DESPIKE_HAMPEL:
+        break;
+    default:
+        return x;
+    }
+
+    int32_t median = loadcell_median_push(&despike->values, x);
+    int64_t deviation = llabs((int64_t)x - median);
+    if (deviation > INT32_MAX) {
+        deviation = INT32_MAX;
+    }
+    int32_t mad = loadcell_median_push(&despike->deviations, (int32_t)deviation);
+    if (!loadcell_median_full(&despike->deviations)) {
+        return x;
+    }
+
+    /* |x - median| > k * 1.4826 * MAD, without a division */
+    if ((deviation << DESPIKE_THRESH_SHIFT) > (int64_t)mad * DESPIKE_THRESH(config)) {
+        atomic_fetch_add_explicit(&despike->replaced, 1, memory_order_relaxed);
+        return median;
+    }
+    return x;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file loadcell_despike.h
+ * @brief Streaming median and Hampel spike filters on the force samples
+ *
+ * A running median over the last `window` samples is kept in a fixed block
+ * per channel: the samples in arrival order, plus their ranks arranged as a
+ * max-heap of the lower half and a min-heap of the upper half that meet at
+ * the median. Each new sample overwrites the oldest one in place and is
+ * sifted through one heap, so a sample costs O(log window) compares and the
+ * median is read off the top, instead of copying and sorting the window as
+ * the Arduino reference does.
+ *
+ * The Hampel filter adds a second running median over the deviations
+ * |x - median|, a running MAD. A sample further than k * 1.4826 * MAD from
+ * the median (k standard deviations, for Gaussian noise) is an outlier and
+ * replaced by the median; every other sample passes unchanged and without
+ * delay. Isolated SPI glitches and impulse noise are removed, while steps
+ * pass once they have lasted half a window. The plain median mode replaces
+ * every sample and delays the signal by half a window.
+ *
+ * The console configures a channel while the acquisition task runs it: the
+ * configuration is one packed atomic word, and the acquisition task restarts
+ * the windows when it sees a new one.
+ */
+
+#ifndef LOADCELL_DESPIKE_H
+#define LOADCELL_DESPIKE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADCELL_MEDIAN_MAX_WINDOW      31      /**< Longest window (odd) */
+#define LOADCELL_DESPIKE_WINDOW         7       /**< Default window */
+#define LOADCELL_DESPIKE_K              3.0f    /**< Default Hampel threshold, in standard deviations */
+#define LOADCELL_DESPIKE_MAX_K          40.0f   /**< Largest threshold */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Running median of the last `window` samples
+ *
+ * heap[] is indexed relative to its middle (LOADCELL_MEDIAN_MAX_WINDOW / 2):
+ * position 0 holds the median, -1, -2, ... the max-heap of the smaller
+ * samples and 1, 2, ... the min-heap of the larger ones; children of
+ * position p are 2p and 2p +/- 1 on the same side.
+ */
+typedef struct {
+    int32_t values[LOADCELL_MEDIAN_MAX_WINDOW];     /**< Samples, a ring in arrival order */
+    uint8_t heap[LOADCELL_MEDIAN_MAX_WINDOW];       /**< Ring slot at each heap position */
+    int8_t pos[LOADCELL_MEDIAN_MAX_WINDOW];         /**< Heap position of each ring slot */
+    uint8_t window;                                 /**< Samples the median is taken over */
+    uint8_t count;                                  /**< Samples held (window once filled) */
+    uint8_t next;                                   /**< Ring slot the next sample replaces */
+} loadcell_median_t;
+
+/**
+ * What the despike stage does with each sample
+ */
+typedef enum {
+    LOADCELL_DESPIKE_OFF = 0,       /**< Pass samples through */
+    LOADCELL_DESPIKE_MEDIAN,        /**< Output the running median */
+    LOADCELL_DESPIKE_HAMPEL,        /**< Replace outliers by the running median */
+} loadcell_despike_mode_t;
+
+/**
+ * Despike stage of one channel
+ */
+typedef struct {
+    _Atomic uint32_t config;        /**< Mode, window and threshold, packed (any task) */
+    _Atomic uint32_t replaced;      /**< Outliers replaced since the configuration took effect */
+
+    /* Acquisition task only */
+    uint32_t applied;               /**< Configuration the windows belong to */
+    loadcell_median_t values;       /**< Running median of the samples */
+    loadcell_median_t deviations;   /**< Running median of |sample - median| (Hampel) */
+} loadcell_despike_t;
+
+/* ============================================================================
+ * Running median
+ * ============================================================================ */
+
+/**
+ * @brief Empty the window and set its length
+ *
+ * @param median Running median
+ * @param window Odd length, 1..LOADCELL_MEDIAN_MAX_WINDOW
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for an even or out-of-range length
+ */
+esp_err_t loadcell_median_init(loadcell_median_t *median, uint8_t window);
+
+/**
+ * @brief Add a sample, dropping the oldest once the window is full
+ *
+ * @return Median of the samples held (the upper one of the middle two
+ *         while an even number is held)
+ */
+int32_t loadcell_median_push(loadcell_median_t *median, int32_t x);
+
+/**
+ * @brief Whether the window holds `window` samples
+ */
+static inline bool loadcell_median_full(const loadcell_median_t *median)
+{
+    return median->count == median->window;
+}
+
+/* ============================================================================
+ * Despike stage
+ * ============================================================================ */
+
+/**
+ * @brief Start switched off
+ */
+void loadcell_despike_init(loadcell_despike_t *despike);
+
+/**
+ * @brief Set the mode; takes effect at the channel's next sample (any task)
+ *
+ * @param despike Despike stage
+ * @param mode OFF, MEDIAN or HAMPEL
+ * @param window Odd window, 3..LOADCELL_MEDIAN_MAX_WINDOW (ignored when OFF)
+ * @param k Hampel threshold in standard deviations, (0, LOADCELL_DESPIKE_MAX_K]
+ *          (ignored unless HAMPEL)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a bad mode, window or threshold
+ */
+esp_err_t loadcell_despike_configure(loadcell_despike_t *despike, loadcell_despike_mode_t mode, uint8_t window,
+                                     float k);
+
+/**
+ * @brief Current configuration (any task); pointers may be NULL
+ */
+void loadcell_despike_get_config(const loadcell_despike_t *despike, loadcell_despike_mode_t *mode, uint8_t *window,
+                                 float *k);
+
+/**
+ * @brief Outliers replaced since the configuration took effect (any task)
+ */
+uint32_t loadcell_despike_replaced(const loadcell_despike_t *despike);
+
+/**
+ * @brief Short name of a mode, for logs
+ */
+const char *loadcell_despike_mode_name(loadcell_despike_mode_t mode);
+
+/**
+ * @brief Run one sample (acquisition task)
+ *
+ * Until a Hampel window has filled, samples pass unchanged.
+ *
+ * @param despike Despike stage of the channel
+ * @param x Force (mN)
+ * @return x, or the running median when x is an outlier (HAMPEL) or always (MEDIAN)
+ */
+int32_t loadcell_despike_run(loadcell_despike_t *despike, int32_t x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADCELL_DESPIKE_H */
@@ -0,0 +1,285 @@
+/**
+ * @file loadcell_filter.c
+ * @brief Per-channel biquad cascade on the force samples
+ */
+
+#include <math.h>
+#include <string.h>
+#include "bank_pair.h"
+#include "loadcell_filter.h"
+
+#define LOADCELL_FILTER_ONE     (1L << LOADCELL_FILTER_Q_BITS)
+#define LOADCELL_FILTER_HALF    (1L << (LOADCELL_FILTER_Q_BITS - 1))
+
+static int32_t loadcell_filter_clamp(int64_t value)
+{
+    if (value > LOADCELL_FILTER_LIMIT_MN) {
+        return LOADCELL_FILTER_LIMIT_MN;
+    }
+    if (value < -LOADCELL_FILTER_LIMIT_MN) {
+        return -LOADCELL_FILTER_LIMIT_MN;
+    }
+    return (int32_t)value;
+}
+
+static bool loadcell_filter_coef_ok(double value)
+{
+    return fabs(value) < LOADCELL_FILTER_COEF_MAX;
+}
+
+static int32_t loadcell_filter_to_q(double value)
+{
+    return (int32_t)llround(value * LOADCELL_FILTER_ONE);
+}
+
+/* ============================================================================
+ * Design
+ * ============================================================================ */
+
+esp_err_t loadcell_biquad_design(loadcell_filter_type_t type, float freq_hz, float q, float sample_rate_hz,
+                                 loadcell_biquad_t *section)
+{
+    if (!section || !(sample_rate_hz > 0.0f) || !(freq_hz > 0.0f) || !(freq_hz < sample_rate_hz / 2) ||
+        !(q > 0.0f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Bilinear-transform prototypes (RBJ audio EQ cookbook), normalized to a0 = 1 */
+    double w0 = 2.0 * M_PI * freq_hz / sample_rate_hz;
+    double cosw = cos(w0);
+    double alpha = sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha;
+    double b0, b1, b2;
+
+    switch (type) {
+    case LOADCELL_FILTER_LOWPASS:
+        b0 = b2 = (1.0 - cosw) / 2.0;
+        b1 = 1.0 - cosw;
+        break;
+    case LOADCELL_FILTER_HIGHPASS:
+        b0 = b2 = (1.0 + cosw) / 2.0;
+        b1 = -(1.0 + cosw);
+        break;
+    case LOADCELL_FILTER_NOTCH:
+        b0 = b2 = 1.0;
+        b1 = -2.0 * cosw;
+        break;
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+    double a1 = -2.0 * cosw / a0;
+    double a2 = (1.0 - alpha) / a0;
+    b0 /= a0;
+    b1 /= a0;
+    b2 /= a0;
+    if (!loadcell_filter_coef_ok(b0) || !loadcell_filter_coef_ok(b1) || !loadcell_filter_coef_ok(b2) ||
+        !loadcell_filter_coef_ok(a1) || !loadcell_filter_coef_ok(a2)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    section->type = type;
+    section->freq_hz = freq_hz;
+    section->q = q;
+    section->b0 = loadcell_filter_to_q(b0);
+    section->b2 = loadcell_filter_to_q(b2);
+    section->a1 = loadcell_filter_to_q(a1);
+    section->a2 = loadcell_filter_to_q(a2);
+
+    /* b1 absorbs the rounding of the others, so the quantized DC gain is exactly 1 (or 0) */
+    if (type == LOADCELL_FILTER_HIGHPASS) {
+        section->b1 = -section->b0 - section->b2;
+    } else {
+        section->b1 = LOADCELL_FILTER_ONE + section->a1 + section->a2 - section->b0 - section->b2;
+    }
+    return ESP_OK;
+}
+
+esp_err_t loadcell_biquad_from_coefs(const float coef[5], loadcell_biquad_t *section)
+{
+    if (!coef || !section) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < 5; i++) {
+        if (!loadcell_filter_coef_ok(coef[i])) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    /* Stability triangle: both poles strictly inside the unit circle */
+    double a1 = coef[3], a2 = coef[4];
+    if (!(fabs(a2) < 1.0) || !(fabs(a1) < 1.0 + a2)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    section->type = LOADCELL_FILTER_CUSTOM;
+    section->freq_hz = 0.0f;
+    section->q = 0.0f;
+    section->b0 = loadcell_filter_to_q(coef[0]);
+    section->b1 = loadcell_filter_to_q(coef[1]);
+    section->b2 = loadcell_filter_to_q(coef[2]);
+    section->a1 = loadcell_filter_to_q(coef[3]);
+    section->a2 = loadcell_filter_to_q(coef[4]);
+    return ESP_OK;
+}
+
+void loadcell_biquad_get_coefs(const loadcell_biquad_t *section, float coef[5])
+{
+    coef[0] = (float)section->b0 / LOADCELL_FILTER_ONE;
+    coef[1] = (float)section->b1 / LOADCELL_FILTER_ONE;
+    coef[2] = (float)section->b2 / LOADCELL_FILTER_ONE;
+    coef[3] = (float)section->a1 / LOADCELL_FILTER_ONE;
+    coef[4] = (float)section->a2 / LOADCELL_FILTER_ONE;
+}
+
+const char *loadcell_filter_type_name(loadcell_filter_type_t type)
+{
+    switch (type) {
+    case LOADCELL_FILTER_LOWPASS:  return "lp";
+    case LOADCELL_FILTER_HIGHPASS: return "hp";
+    case LOADCELL_FILTER_NOTCH:    return "notch";
+    case LOADCELL_FILTER_CUSTOM:   return "coef";
+    default:                       return "?";
+    }
+}
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+/* Start an update of the spare chain; the caller publishes or cancels it */
+static esp_err_t loadcell_filter_begin_update(loadcell_filter_t *filter, loadcell_filter_chain_t **chain)
+{
+    esp_err_t ret = bank_pair_begin_update(&filter->pair, filter->banks, sizeof(filter->banks[0]), (void **)chain);
+    if (ret == ESP_OK) {
+        (*chain)->generation++;
+    }
+    return ret;
+}
+
+void loadcell_filter_init(loadcell_filter_t *filter)
+{
+    memset(filter, 0, sizeof(*filter));
+    bank_pair_init(&filter->pair);
+}
+
+esp_err_t loadcell_filter_add(loadcell_filter_t *filter, const loadcell_biquad_t *section)
+{
+    if (!filter || !section) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    loadcell_filter_chain_t *chain;
+    esp_err_t ret = loadcell_filter_begin_update(filter, &chain);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (chain->num_sections >= LOADCELL_FILTER_MAX_SECTIONS) {
+        bank_pair_cancel(&filter->pair);
+        return ESP_ERR_NO_MEM;
+    }
+    chain->sections[chain->num_sections++] = *section;
+    bank_pair_publish(&filter->pair);
+    return ESP_OK;
+}
+
+esp_err_t loadcell_filter_clear(loadcell_filter_t *filter)
+{
+    loadcell_filter_chain_t *chain;
+    esp_err_t ret = loadcell_filter_begin_update(filter, &chain);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    chain->num_sections = 0;
+    bank_pair_publish(&filter->pair);
+    return ESP_OK;
+}
+
+esp_err_t loadcell_filter_set_rate(loadcell_filter_t *filter, float sample_rate_hz, int *dropped)
+{
+    loadcell_filter_chain_t *chain;
+    esp_err_t ret = loadcell_filter_begin_update(filter, &chain);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < chain->num_sections; i++) {
+        loadcell_biquad_t section = chain->sections[i];
+        if (section.type == LOADCELL_FILTER_CUSTOM ||
+            loadcell_biquad_design(section.type, section.freq_hz, section.q, sample_rate_hz, &section) == ESP_OK) {
+            chain->sections[kept++] = section;
+        }
+    }
+    *dropped = chain->num_sections - kept;
+    chain->num_sections = kept;
+    bank_pair_publish(&filter->pair);
+    return ESP_OK;
+}
+
+void loadcell_filter_get_chain(const loadcell_filter_t *filter, loadcell_filter_chain_t *chain)
+{
+    bank_pair_read(&filter->pair, filter->banks, sizeof(*chain), chain);
+}
+
+/* ============================================================================
+ * Per frame
+ * ============================================================================ */
+
+/* Section history as if x had been applied forever: the output is x times the DC gain */
+static int32_t loadcell_biquad_settle(const loadcell_biquad_t *c, loadcell_biquad_state_t *s, int32_t x)
+{
+    int64_t num = (int64_t)c->b0 + c->b1 + c->b2;
+    int64_t den = LOADCELL_FILTER_ONE + (int64_t)c->a1 + c->a2;
+    int32_t y = den > 0 ? loadcell_filter_clamp((int64_t)x * num / den) : 0;
+
+    s->x1 = s->x2 = x;
+    s->y1 = s->y2 = y;
+    s->e1 = s->e2 = 0;
+    return y;
+}
+
+/*
+ * |x|, |y| <= 2^30 and |coefficient| < 2^30: the five products stay below
+ * 2^60 each, and the feedback of the remainders (|e| <= 2^27) below 2^58
+ */
+static inline int32_t loadcell_biquad_step(const loadcell_biquad_t *c, loadcell_biquad_state_t *s, int32_t x)
+{
+    int64_t frac = (int64_t)c->a1 * s->e1 + (int64_t)c->a2 * s->e2;
+    int64_t acc = (int64_t)c->b0 * x + (int64_t)c->b1 * s->x1 + (int64_t)c->b2 * s->x2
+                - (int64_t)c->a1 * s->y1 - (int64_t)c->a2 * s->y2
+                - ((frac + LOADCELL_FILTER_HALF) >> LOADCELL_FILTER_Q_BITS);
+    int64_t y = (acc + LOADCELL_FILTER_HALF) >> LOADCELL_FILTER_Q_BITS;
+    int32_t out = loadcell_filter_clamp(y);
+
+    /* Keep the rounding remainder; a saturated output has none worth keeping */
+    s->e2 = s->e1;
+    s->e1 = out == y ? (int32_t)(acc - (y << LOADCELL_FILTER_Q_BITS)) : 0;
+    s->x2 = s->x1;
+    s->x1 = x;
+    s->y2 = s->y1;
+    s->y1 = out;
+    return out;
+}
+
+int32_t loadcell_filter_run(loadcell_filter_t *filter, int32_t x)
+{
+    const loadcell_filter_chain_t *chain = &filter->banks[bank_pair_take(&filter->pair)];
+    if (chain->num_sections == 0) {
+        bank_pair_release(&filter->pair);
+        return x;
+    }
+
+    x = loadcell_filter_clamp(x);
+    if (chain->generation != filter->generation) {
+        /* New chain: start every section settled on this input */
+        filter->generation = chain->generation;
+        for (uint8_t i = 0; i < chain->num_sections; i++) {
+            x = loadcell_biquad_settle(&chain->sections[i], &filter->state[i], x);
+        }
+    } else {
+        for (uint8_t i = 0; i < chain->num_sections; i++) {
+            x = loadcell_biquad_step(&chain->sections[i], &filter->state[i], x);
+        }
+    }
+    bank_pair_release(&filter->pair);
+    return x;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file loadcell_filter.h
+ * @brief Per-channel biquad cascade on the force samples
+ *
+ * Each channel's frame-rate forces can pass through up to
+ * LOADCELL_FILTER_MAX_SECTIONS second-order sections: a low-pass, notches
+ * for 50/60 Hz mains pickup, a high-pass that removes slow drift, or raw
+ * coefficients. Sections are designed in floating point when they are
+ * configured and run in integer arithmetic per frame.
+ *
+ * Coefficients are held in Q28 (magnitudes below 4) and each section is a
+ * direct form I whose outputs keep the remainder of their rounding as Q28
+ * fraction bits for the feedback terms. The recursion therefore runs at
+ * full precision even for cut-offs far below the frame rate: designed
+ * low-pass and notch sections pass DC exactly, high-pass sections block it
+ * exactly, and a decaying output comes to rest at zero.
+ *
+ * The console changes a channel's chain while the acquisition task runs it,
+ * so the chain is a bank_pair: updates go to a spare copy that is then
+ * published.
+ * The acquisition task notices a new chain and restarts its sections in the
+ * steady state of the current input, so reconfiguring does not kick the
+ * output.
+ */
+
+#ifndef LOADCELL_FILTER_H
+#define LOADCELL_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "bank_pair.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADCELL_FILTER_MAX_SECTIONS    4           /**< Biquads per channel */
+#define LOADCELL_FILTER_Q_BITS          28          /**< Fraction bits of the coefficients */
+#define LOADCELL_FILTER_COEF_MAX        4.0f        /**< Coefficient magnitudes stay below this */
+#define LOADCELL_FILTER_LIMIT_MN        ((1L << 30) - 1)    /**< Signals saturate at ±1073 kN */
+#define LOADCELL_FILTER_BUTTERWORTH_Q   0.7071f     /**< Default Q of low- and high-pass sections */
+#define LOADCELL_FILTER_NOTCH_Q         5.0f        /**< Default Q of notches (10 Hz wide at 50 Hz) */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Kind of section
+ */
+typedef enum {
+    LOADCELL_FILTER_LOWPASS = 0,    /**< Second-order low-pass at freq_hz */
+    LOADCELL_FILTER_HIGHPASS,       /**< Second-order high-pass (drift removal) */
+    LOADCELL_FILTER_NOTCH,          /**< Notch at freq_hz, bandwidth freq_hz / q */
+    LOADCELL_FILTER_CUSTOM,         /**< Coefficients given directly */
+} loadcell_filter_type_t;
+
+/**
+ * One section: H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+ */
+typedef struct {
+    loadcell_filter_type_t type;
+    float freq_hz;                  /**< Design frequency (not used by CUSTOM) */
+    float q;                        /**< Design quality factor (not used by CUSTOM) */
+    int32_t b0, b1, b2, a1, a2;     /**< Q28 */
+} loadcell_biquad_t;
+
+/**
+ * One channel's cascade
+ */
+typedef struct {
+    uint8_t num_sections;
+    uint32_t generation;            /**< Bumped by every update */
+    loadcell_biquad_t sections[LOADCELL_FILTER_MAX_SECTIONS];
+} loadcell_filter_chain_t;
+
+/**
+ * History of one section (acquisition task)
+ */
+typedef struct {
+    int32_t x1, x2;                 /**< Last two inputs (mN) */
+    int32_t y1, y2;                 /**< Last two outputs, rounded (mN) */
+    int32_t e1, e2;                 /**< Their rounding remainders (Q28 of a mN) */
+} loadcell_biquad_state_t;
+
+/**
+ * Filter of one channel: published chain, spare chain and running state
+ */
+typedef struct {
+    loadcell_filter_chain_t banks[2];
+    bank_pair_t pair;               /**< Which bank is published, and which one is running */
+
+    /* Acquisition task only */
+    uint32_t generation;            /**< Generation the state belongs to */
+    loadcell_biquad_state_t state[LOADCELL_FILTER_MAX_SECTIONS];
+} loadcell_filter_t;
+
+/* ============================================================================
+ * Design (any task)
+ * ============================================================================ */
+
+/**
+ * @brief Design a low-pass, high-pass or notch section
+ *
+ * @param type LOWPASS, HIGHPASS or NOTCH
+ * @param freq_hz Cut-off or notch frequency, below half the sample rate
+ * @param q Quality factor (> 0)
+ * @param sample_rate_hz Rate the section runs at (the frame rate)
+ * @param section Receives the section
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a bad type, frequency or Q, or
+ *         coefficients out of range
+ */
+esp_err_t loadcell_biquad_design(loadcell_filter_type_t type, float freq_hz, float q, float sample_rate_hz,
+                                 loadcell_biquad_t *section);
+
+/**
+ * @brief Section from raw coefficients
+ *
+ * @param coef b0, b1, b2, a1, a2 (a0 = 1)
+ * @param section Receives the section
+ * @return ESP_OK, ESP_ERR_INVALID_ARG when a magnitude reaches LOADCELL_FILTER_COEF_MAX
+ *         or the poles are not inside the unit circle
+ */
+esp_err_t loadcell_biquad_from_coefs(const float coef[5], loadcell_biquad_t *section);
+
+/**
+ * @brief Coefficients of a section as floats (b0, b1, b2, a1, a2)
+ */
+void loadcell_biquad_get_coefs(const loadcell_biquad_t *section, float coef[5]);
+
+/**
+ * @brief Short name of a section type, for logs
+ */
+const char *loadcell_filter_type_name(loadcell_filter_type_t type);
+
+/* ============================================================================
+ * Configuration (one task at a time)
+ * ============================================================================ */
+
+/**
+ * @brief Start with an empty chain (filter passes forces through)
+ */
+void loadcell_filter_init(loadcell_filter_t *filter);
+
+/**
+ * @brief Append a section to the chain
+ *
+ * @return ESP_OK, ESP_ERR_NO_MEM when the chain is full, or the error of bank_pair_begin_update()
+ */
+esp_err_t loadcell_filter_add(loadcell_filter_t *filter, const loadcell_biquad_t *section);
+
+/**
+ * @brief Remove every section
+ *
+ * @return ESP_OK, or the error of bank_pair_begin_update()
+ */
+esp_err_t loadcell_filter_clear(loadcell_filter_t *filter);
+
+/**
+ * @brief Redesign the designed sections for a new sample rate
+ *
+ * Sections that no longer fit below half the new rate are dropped;
+ * CUSTOM sections are kept as they are.
+ *
+ * @param filter Filter
+ * @param sample_rate_hz New rate
+ * @param[out] dropped Number of sections dropped
+ * @return ESP_OK, or the error of bank_pair_begin_update()
+ */
+esp_err_t loadcell_filter_set_rate(loadcell_filter_t *filter, float sample_rate_hz, int *dropped);
+
+/**
+ * @brief Copy of the published chain
+ */
+void loadcell_filter_get_chain(const loadcell_filter_t *filter, loadcell_filter_chain_t *chain);
+
+/* ============================================================================
+ * Per frame (acquisition task)
+ * ============================================================================ */
+
+/**
+ * @brief Run one sample through the published chain
+ *
+ * @param filter Filter of the channel
+ * @param x Force (mN)
+ * @return Filtered force (mN), saturated to ±LOADCELL_FILTER_LIMIT_MN when
+ *         the chain is not empty
+ */
+int32_t loadcell_filter_run(loadcell_filter_t *filter, int32_t x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADCELL_FILTER_H */
@@ -0,0 +1,76 @@
+/**
+ * @file loadcell_job.c
+ * @brief Averaging of raw codes for tare and span calibration
+ */
+
+#include <math.h>
+#include <string.h>
+#include "loadcell_job.h"
+
+/* (2^24)^2 per code: the squares of a full-scale spread stay within 64 bits */
+_Static_assert(LOADCELL_JOB_MAX_FRAMES <= (1 << 15), "LOADCELL_JOB_MAX_FRAMES would overflow the sum of squares");
+
+void loadcell_job_acc_init(loadcell_job_acc_t *acc)
+{
+    memset(acc, 0, sizeof(*acc));
+    loadcell_despike_init(&acc->despike);
+    loadcell_despike_configure(&acc->despike, LOADCELL_DESPIKE_HAMPEL, LOADCELL_DESPIKE_WINDOW, LOADCELL_DESPIKE_K);
+}
+
+void loadcell_job_acc_push(loadcell_job_acc_t *acc, int32_t code)
+{
+    int32_t x = loadcell_despike_run(&acc->despike, code);
+    if (acc->count == 0) {
+        acc->first = acc->min = acc->max = x;
+    } else {
+        acc->min = x < acc->min ? x : acc->min;
+        acc->max = x > acc->max ? x : acc->max;
+    }
+    int64_t d = (int64_t)x - acc->first;
+    acc->sum += d;
+    acc->sum_sq += (uint64_t)(d * d);
+    acc->count++;
+}
+
+void loadcell_job_acc_finish(const loadcell_job_acc_t *acc, loadcell_job_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    if (acc->count == 0) {
+        return;
+    }
+
+    int64_t n = acc->count;
+    int64_t half = acc->sum >= 0 ? n / 2 : -n / 2;
+    result->mean = (int32_t)(acc->first + (acc->sum + half) / n);
+    if (n > 1) {
+        double mean_d = (double)acc->sum / n;
+        double var = ((double)acc->sum_sq - mean_d * acc->sum) / (n - 1);
+        result->sd = var > 0.0 ? (float)sqrt(var) : 0.0f;
+    }
+    result->min = acc->min;
+    result->max = acc->max;
+    result->count = acc->count;
+    result->replaced = loadcell_despike_replaced(&acc->despike);
+}
+
+const char *loadcell_job_kind_name(loadcell_job_kind_t kind)
+{
+    switch (kind) {
+    case LOADCELL_JOB_TARE:  return "tare";
+    case LOADCELL_JOB_SPAN:  return "span";
+    case LOADCELL_JOB_POINT: return "point";
+    default:                 return "?";
+    }
+}
+
+const char *loadcell_job_state_name(loadcell_job_state_t state)
+{
+    switch (state) {
+    case LOADCELL_JOB_IDLE:      return "idle";
+    case LOADCELL_JOB_RUNNING:   return "running";
+    case LOADCELL_JOB_DONE:      return "done";
+    case LOADCELL_JOB_FAILED:    return "failed";
+    case LOADCELL_JOB_CANCELLED: return "cancelled";
+    default:                     return "?";
+    }
+}
@@ -0,0 +1,120 @@
+/**
+ * @file loadcell_job.h
+ * @brief Averaging of raw codes for tare and span calibration
+ *
+ * A tare, a span or one load of a multi-point calibration is the mean raw
+ * code of a channel over a number of samples. The accumulator here takes
+ * one code at a time, so the same
+ * averaging serves the blocking single-channel calls and the jobs that the
+ * acquisition task runs on every channel of the live frame stream at once.
+ *
+ * Each code first goes through a Hampel filter (LOADCELL_DESPIKE_WINDOW,
+ * LOADCELL_DESPIKE_K), so an SPI glitch or a knock on the plate does not
+ * shift the average. The accumulator keeps the sum and the sum of squares of
+ * the codes relative to the first one: integer adds per sample, and 64 bits
+ * hold them for LOADCELL_JOB_MAX_FRAMES codes of any spread. The mean, the
+ * standard deviation and the extremes come out at the end, so a calibration
+ * also reports how noisy the channel was while it ran.
+ */
+
+#ifndef LOADCELL_JOB_H
+#define LOADCELL_JOB_H
+
+#include <stdint.h>
+#include "loadcell_despike.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADCELL_JOB_MAX_FRAMES     16384   /**< Most codes one average takes */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * What a calibration job measures
+ */
+typedef enum {
+    LOADCELL_JOB_TARE = 0,          /**< Zero, with the plate unloaded */
+    LOADCELL_JOB_SPAN,              /**< Span, with the known force applied */
+    LOADCELL_JOB_POINT,             /**< One load of a multi-point calibration */
+} loadcell_job_kind_t;
+
+/**
+ * Life of a calibration job
+ */
+typedef enum {
+    LOADCELL_JOB_IDLE = 0,          /**< None started since init */
+    LOADCELL_JOB_RUNNING,           /**< Averaging the frames */
+    LOADCELL_JOB_DONE,              /**< Every channel calibrated */
+    LOADCELL_JOB_FAILED,            /**< At least one channel refused its result */
+    LOADCELL_JOB_CANCELLED,         /**< Stopped before the last frame, nothing applied */
+} loadcell_job_state_t;
+
+/**
+ * Average of one channel's codes
+ */
+typedef struct {
+    int32_t mean;           /**< Mean code, after spike replacement */
+    float sd;               /**< Standard deviation of the codes */
+    int32_t min;            /**< Extremes of the codes, after spike replacement */
+    int32_t max;
+    uint32_t count;         /**< Codes averaged */
+    uint32_t replaced;      /**< Codes the Hampel filter replaced */
+    float sd_mn;            /**< sd in millinewtons through the measured load (span and point jobs) */
+} loadcell_job_result_t;
+
+/**
+ * Running sums of one channel's codes
+ */
+typedef struct {
+    loadcell_despike_t despike;     /**< Hampel filter ahead of the sums */
+    int32_t first;                  /**< Origin of the sums */
+    int64_t sum;                    /**< Sum of code - first */
+    uint64_t sum_sq;                /**< Sum of (code - first)^2 */
+    int32_t min;
+    int32_t max;
+    uint32_t count;
+} loadcell_job_acc_t;
+
+/* ============================================================================
+ * Functions
+ * ============================================================================ */
+
+/**
+ * @brief Empty the sums and the spike filter
+ */
+void loadcell_job_acc_init(loadcell_job_acc_t *acc);
+
+/**
+ * @brief Add one code
+ *
+ * At most LOADCELL_JOB_MAX_FRAMES codes per average.
+ */
+void loadcell_job_acc_push(loadcell_job_acc_t *acc, int32_t code);
+
+/**
+ * @brief Mean, spread and extremes of the codes so far
+ *
+ * @param acc Accumulator holding at least one code
+ * @param[out] result Average; sd is 0 for a single code
+ */
+void loadcell_job_acc_finish(const loadcell_job_acc_t *acc, loadcell_job_result_t *result);
+
+/**
+ * @brief Short name of a job kind, for logs
+ */
+const char *loadcell_job_kind_name(loadcell_job_kind_t kind);
+
+/**
+ * @brief Short name of a job state, for logs
+ */
+const char *loadcell_job_state_name(loadcell_job_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADCELL_JOB_H */
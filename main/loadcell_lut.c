@@ -0,0 +1,190 @@
+/**
+ * @file loadcell_lut.c
+ * @brief Multi-point calibration compiled into an interpolation table
+ */
+
+#include <math.h>
+#include <string.h>
+#include "esp_log.h"
+#include "loadcell_lut.h"
+
+static const char *TAG = "LoadCellLUT";
+
+#define LUT_MAX_DEGREE      3
+
+_Static_assert((LOADCELL_LUT_SEGMENTS & (LOADCELL_LUT_SEGMENTS - 1)) == 0, "LOADCELL_LUT_SEGMENTS must be a power of two");
+
+/* Fitted curve, evaluated in double while the table is compiled */
+typedef struct {
+    loadcell_fit_t fit;
+    const loadcell_cal_point_t *points;     /* Sorted by code */
+    uint8_t num_points;
+    double center, half_span;               /* Polynomial variable t = (x - center) / half_span */
+    double coef[LUT_MAX_DEGREE + 1];
+} lut_curve_t;
+
+static double curve_eval(const lut_curve_t *c, double x)
+{
+    if (c->fit == LOADCELL_FIT_PIECEWISE) {
+        /* Segment holding x; the end segments extend beyond the points */
+        int i = 0;
+        while (i < c->num_points - 2 && x > c->points[i + 1].net) {
+            i++;
+        }
+        const loadcell_cal_point_t *a = &c->points[i];
+        const loadcell_cal_point_t *b = &c->points[i + 1];
+        return a->force_mn + (double)(b->force_mn - a->force_mn) * (x - a->net) / (double)(b->net - a->net);
+    }
+
+    double t = (x - c->center) / c->half_span;
+    double y = 0.0;
+    for (int k = c->fit; k >= 0; k--) {
+        y = y * t + c->coef[k];
+    }
+    return y;
+}
+
+/* Least-squares polynomial through the points by the normal equations (at most 4x4) */
+static esp_err_t curve_fit_poly(lut_curve_t *c)
+{
+    int n = c->fit + 1;
+    double a[LUT_MAX_DEGREE + 1][LUT_MAX_DEGREE + 2] = {{0}};
+
+    for (int p = 0; p < c->num_points; p++) {
+        double t = (c->points[p].net - c->center) / c->half_span;
+        double pow_t[2 * LUT_MAX_DEGREE + 1];
+        pow_t[0] = 1.0;
+        for (int k = 1; k < 2 * n - 1; k++) {
+            pow_t[k] = pow_t[k - 1] * t;
+        }
+        for (int r = 0; r < n; r++) {
+            for (int k = 0; k < n; k++) {
+                a[r][k] += pow_t[r + k];
+            }
+            a[r][n] += pow_t[r] * c->points[p].force_mn;
+        }
+    }
+
+    /* Gaussian elimination with partial pivoting */
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < n; r++) {
+            if (fabs(a[r][col]) > fabs(a[pivot][col])) {
+                pivot = r;
+            }
+        }
+        if (fabs(a[pivot][col]) < 1e-12) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        for (int k = 0; k <= n; k++) {
+            double tmp = a[col][k];
+            a[col][k] = a[pivot][k];
+            a[pivot][k] = tmp;
+        }
+        for (int r = 0; r < n; r++) {
+            if (r != col) {
+                double f = a[r][col] / a[col][col];
+                for (int k = col; k <= n; k++) {
+                    a[r][k] -= f * a[col][k];
+                }
+            }
+        }
+    }
+    for (int k = 0; k < n; k++) {
+        c->coef[k] = a[k][n] / a[k][k];
+    }
+    return ESP_OK;
+}
+
+esp_err_t loadcell_lut_build(const loadcell_cal_point_t *points, uint8_t num_points, loadcell_fit_t fit,
+                             loadcell_lut_t *lut)
+{
+    if (!points || !lut || num_points < 2 || num_points > LOADCELL_CAL_MAX_POINTS ||
+        (fit != LOADCELL_FIT_PIECEWISE && fit != LOADCELL_FIT_POLY2 && fit != LOADCELL_FIT_POLY3) ||
+        num_points < (uint8_t)fit + 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Sort by code; two loads on one code cannot be fitted */
+    loadcell_cal_point_t sorted[LOADCELL_CAL_MAX_POINTS];
+    memcpy(sorted, points, num_points * sizeof(*points));
+    for (int i = 1; i < num_points; i++) {
+        loadcell_cal_point_t p = sorted[i];
+        int j = i;
+        for (; j > 0 && sorted[j - 1].net > p.net; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = p;
+    }
+    for (int i = 1; i < num_points; i++) {
+        if (sorted[i].net == sorted[i - 1].net) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    int64_t lo = sorted[0].net;
+    int64_t hi = sorted[num_points - 1].net;
+    lut_curve_t curve = {
+        .fit = fit,
+        .points = sorted,
+        .num_points = num_points,
+        .center = (lo + hi) / 2.0,
+        .half_span = (hi - lo) / 2.0,
+    };
+    if (fit != LOADCELL_FIT_PIECEWISE) {
+        esp_err_t ret = curve_fit_poly(&curve);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    /* Narrowest power-of-two segments that cover the calibrated codes */
+    uint8_t shift = 0;
+    while (((int64_t)LOADCELL_LUT_SEGMENTS << shift) < hi - lo) {
+        shift++;
+    }
+    lut->base = (int32_t)lo;
+    lut->shift = shift;
+    for (int i = 0; i <= LOADCELL_LUT_SEGMENTS; i++) {
+        double y = round(curve_eval(&curve, (double)(lo + ((int64_t)i << shift))));
+        lut->knots[i] = y > INT32_MAX ? INT32_MAX : y < INT32_MIN ? INT32_MIN : (int32_t)y;
+    }
+
+    ESP_LOGD(TAG, "%s fit of %u points: codes %ld..%ld, %ld per segment", loadcell_fit_name(fit), num_points,
+             (long)lo, (long)hi, (long)(1L << shift));
+    return ESP_OK;
+}
+
+int32_t loadcell_lut_eval(const loadcell_lut_t *lut, int32_t net)
+{
+    int64_t offset = (int64_t)net - lut->base;
+    int64_t seg = offset >> lut->shift;
+    if (seg < 0) {
+        seg = 0;
+    } else if (seg >= LOADCELL_LUT_SEGMENTS) {
+        seg = LOADCELL_LUT_SEGMENTS - 1;
+    }
+
+    /* Outside the table frac runs past the segment: the end segments extrapolate */
+    int64_t frac = offset - (seg << lut->shift);
+    int64_t y0 = lut->knots[seg];
+    int64_t y = y0 + (((lut->knots[seg + 1] - y0) * frac) >> lut->shift);
+
+    if (y > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (y < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)y;
+}
+
+const char *loadcell_fit_name(loadcell_fit_t fit)
+{
+    switch (fit) {
+    case LOADCELL_FIT_PIECEWISE: return "piecewise";
+    case LOADCELL_FIT_POLY2:     return "quadratic";
+    case LOADCELL_FIT_POLY3:     return "cubic";
+    default:                     return "unknown";
+    }
+}
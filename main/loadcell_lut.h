@@ -0,0 +1,92 @@
+/**
+ * @file loadcell_lut.h
+ * @brief Multi-point calibration compiled into an interpolation table
+ *
+ * A channel calibrated with several known loads is fitted once, at
+ * calibration time, either piecewise-linearly through the points or with a
+ * least-squares polynomial (degree 2 or 3). The fit is then sampled into
+ * LOADCELL_LUT_SEGMENTS equal segments whose width is a power of two, so the
+ * per-sample correction is a shift to find the segment and one integer
+ * multiply to interpolate inside it: the same cost as the linear scale.
+ * Codes beyond the calibrated range extrapolate along the end segments.
+ */
+
+#ifndef LOADCELL_LUT_H
+#define LOADCELL_LUT_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADCELL_LUT_SEGMENTS       64      /**< Interpolation segments (power of two) */
+#define LOADCELL_CAL_MAX_POINTS     8       /**< Known loads per channel, zero included */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Shape fitted through the calibration points
+ */
+typedef enum {
+    LOADCELL_FIT_PIECEWISE = 0,     /**< Straight lines between neighbouring points */
+    LOADCELL_FIT_POLY2 = 2,         /**< Least-squares quadratic (3+ points) */
+    LOADCELL_FIT_POLY3 = 3,         /**< Least-squares cubic (4+ points) */
+} loadcell_fit_t;
+
+/**
+ * One known load
+ */
+typedef struct {
+    int32_t net;                /**< Averaged ADC code less the tare offset */
+    int32_t force_mn;           /**< Applied force in millinewtons */
+} loadcell_cal_point_t;
+
+/**
+ * Compiled table: knot i sits at code base + (i << shift)
+ */
+typedef struct {
+    int32_t base;
+    uint8_t shift;
+    int32_t knots[LOADCELL_LUT_SEGMENTS + 1];   /**< Force at each knot (mN) */
+} loadcell_lut_t;
+
+/* ============================================================================
+ * Functions
+ * ============================================================================ */
+
+/**
+ * @brief Fit the points and compile the table
+ *
+ * @param points Calibration points (any order, distinct codes)
+ * @param num_points Number of points, at least 2 (3 for POLY2, 4 for POLY3)
+ * @param fit Shape to fit
+ * @param lut Receives the table
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for too few or repeated points,
+ *         ESP_ERR_INVALID_STATE if the polynomial fit is singular
+ */
+esp_err_t loadcell_lut_build(const loadcell_cal_point_t *points, uint8_t num_points, loadcell_fit_t fit,
+                             loadcell_lut_t *lut);
+
+/**
+ * @brief Force of a net code by table interpolation
+ *
+ * @param lut Table from loadcell_lut_build()
+ * @param net ADC code less the tare offset
+ * @return Millinewtons, saturated to the int32_t range
+ */
+int32_t loadcell_lut_eval(const loadcell_lut_t *lut, int32_t net);
+
+/**
+ * @brief Name of a fit, for logs
+ */
+const char *loadcell_fit_name(loadcell_fit_t fit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADCELL_LUT_H */
@@ -0,0 +1,61 @@
+/**
+ * @file loadcell_q.c
+ * @brief Integer force scaling for the FPU-less ESP32-C6
+ */
+
+#include <math.h>
+#include "loadcell_q.h"
+
+#define LOADCELL_Q_MANT_BITS    24              /* float significand, hidden bit included */
+#define LOADCELL_Q_MAX_SHIFT    62              /* Beyond this every 25-bit net code scales to zero */
+
+void loadcell_q_from_float(float n_per_count, loadcell_q_scale_t *q)
+{
+    q->mant = 0;
+    q->shift = 0;
+    if (!isfinite(n_per_count) || n_per_count == 0.0f) {
+        return;
+    }
+
+    /* n_per_count = m * 2^exp with 0.5 <= |m| < 1: m * 2^24 is an exact integer */
+    int exp;
+    float m = frexpf(n_per_count, &exp);
+    int shift = LOADCELL_Q_MANT_BITS - exp;
+    if (shift < 0) {
+        /* Largest mantissa at shift 0: already saturates any non-zero code */
+        q->mant = n_per_count > 0.0f ? (1 << LOADCELL_Q_MANT_BITS) - 1 : 1 - (1 << LOADCELL_Q_MANT_BITS);
+        return;
+    }
+    if (shift > LOADCELL_Q_MAX_SHIFT) {
+        return;
+    }
+    q->mant = (int32_t)ldexpf(m, LOADCELL_Q_MANT_BITS);
+    q->shift = (uint8_t)shift;
+}
+
+int32_t loadcell_q_force_mn(const loadcell_q_scale_t *q, int32_t net)
+{
+    /* |net| < 2^25, |mant| < 2^24, 1000 < 2^10: the product fits in 59 bits */
+    int64_t p = (int64_t)net * q->mant * LOADCELL_Q_MN_PER_N;
+    p = p >= 0 ? p >> q->shift : -((-p) >> q->shift);
+
+    if (p > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (p < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)p;
+}
+
+int16_t loadcell_q_deci_newtons(int32_t force_mn)
+{
+    int32_t deci = force_mn / LOADCELL_Q_MN_PER_DECI_N;
+    if (deci > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (deci < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)deci;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file loadcell_q.h
+ * @brief Integer force scaling for the FPU-less ESP32-C6
+ *
+ * The C6 has no FPU, so every float operation on the sample path is a
+ * soft-float library call. Forces are carried as integer millinewtons
+ * instead: a hardware-calibrated channel's codes already are millinewtons
+ * (FSCAL normalizes them), and a software-scaled channel multiplies its net
+ * code by the calibration scale held as an exact integer mantissa and shift.
+ *
+ * The mantissa is the float scale's own 24-bit significand, so the integer
+ * path computes exactly the product the float path only approximates: both
+ * truncate toward zero, and results differ only where the float rounding
+ * pushes a value across a millinewton or 0.1 N boundary.
+ */
+
+#ifndef LOADCELL_Q_H
+#define LOADCELL_Q_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADCELL_Q_MN_PER_N         1000        /**< Force unit: millinewtons */
+#define LOADCELL_Q_MN_PER_DECI_N    100         /**< 0.1 N BLE resolution */
+
+/**
+ * Calibration scale (N per count) as mantissa * 2^-shift
+ */
+typedef struct {
+    int32_t mant;               /**< Signed 24-bit significand (0 = zero scale) */
+    uint8_t shift;              /**< Right shift applied after multiplying by millinewtons */
+} loadcell_q_scale_t;
+
+/**
+ * @brief Convert a float scale exactly; done once at calibration, never per sample
+ *
+ * @param n_per_count Newtons per ADC count
+ * @param q Receives the integer scale (saturated for scales of 2^24 N per count and up)
+ */
+void loadcell_q_from_float(float n_per_count, loadcell_q_scale_t *q);
+
+/**
+ * @brief Force of a net ADC code, truncated toward zero
+ *
+ * @param q Integer scale from loadcell_q_from_float()
+ * @param net ADC code less the tare offset (within ±2^25)
+ * @return Millinewtons, saturated to the int32_t range
+ */
+int32_t loadcell_q_force_mn(const loadcell_q_scale_t *q, int32_t net);
+
+/**
+ * @brief Quantize millinewtons to the 0.1 N units streamed over BLE
+ *
+ * Truncates toward zero and clamps to int16_t, like the float conversion it replaces.
+ */
+int16_t loadcell_q_deci_newtons(int32_t force_mn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADCELL_Q_H */
@@ -0,0 +1,241 @@
+/**
+ * @file loadcell_stats.c
+ * @brief Streaming per-channel force statistics
+ */
+
+#include <string.h>
+#include <math.h>
+#include "loadcell_stats.h"
+
+#define STATS_DELTA_LIMIT       (1 << 24)
+#define STATS_WINDOW_MASK       (LOADCELL_STATS_WINDOW - 1)
+
+_Static_assert((LOADCELL_STATS_WINDOW & STATS_WINDOW_MASK) == 0 && LOADCELL_STATS_WINDOW <= 128,
+               "LOADCELL_STATS_WINDOW must be a power of two up to 128");
+_Static_assert(LOADCELL_STATS_BLOCK <= 128, "LOADCELL_STATS_BLOCK sums must stay exact");
+
+/* Everything but the sequence counter and the reset request */
+static void loadcell_stats_clear(loadcell_stats_acc_t *acc)
+{
+    acc->count = 0;
+    acc->folded = 0;
+    acc->mean = 0.0;
+    acc->m2 = 0.0;
+    acc->block_count = 0;
+    acc->block_sum = 0;
+    acc->block_sq = 0;
+    acc->window_pos = 0;
+    acc->window_count = 0;
+    acc->window_sum = 0;
+    acc->window_sq = 0;
+    acc->min_head = acc->min_len = 0;
+    acc->max_head = acc->max_len = 0;
+}
+
+void loadcell_stats_init(loadcell_stats_acc_t *acc)
+{
+    memset(acc, 0, sizeof(*acc));
+    atomic_init(&acc->seq, 0);
+    atomic_init(&acc->reset_pending, false);
+}
+
+/* n * sum(d^2) - sum(d)^2, exact for n <= 128 deltas of at most 2^24 */
+static inline uint64_t spread(uint32_t n, int64_t sum, uint64_t sq)
+{
+    return (uint64_t)n * sq - (uint64_t)(sum * sum);
+}
+
+/* Chan's update: merge n samples of mean b_mean and squared deviations b_m2 into (count, mean, m2) */
+static void welford_merge(uint32_t *count, double *mean, double *m2, uint32_t n, double b_mean, double b_m2)
+{
+    uint32_t total = *count + n;
+    double delta = b_mean - *mean;
+    *mean += delta * n / total;
+    *m2 += b_m2 + delta * delta * ((double)*count * n / total);
+    *count = total;
+}
+
+/* Fold the exact block sums into the Welford state: the only floating-point work, once per block */
+static void loadcell_stats_fold(loadcell_stats_acc_t *acc)
+{
+    uint32_t n = acc->block_count;
+    double b_mean = acc->ref_mn + (double)acc->block_sum / n;
+    double b_m2 = (double)spread(n, acc->block_sum, acc->block_sq) / n;
+
+    welford_merge(&acc->folded, &acc->mean, &acc->m2, n, b_mean, b_m2);
+    acc->block_count = 0;
+    acc->block_sum = 0;
+    acc->block_sq = 0;
+}
+
+/* Queue of window slots: front at head, back at head + len - 1 */
+static inline uint8_t *queue_back(uint8_t *queue, uint16_t head, uint16_t len)
+{
+    return &queue[(head + len - 1) & STATS_WINDOW_MASK];
+}
+
+static void loadcell_stats_window_push(loadcell_stats_acc_t *acc, int32_t d)
+{
+    uint32_t slot = acc->window_pos;
+
+    if (acc->window_count == LOADCELL_STATS_WINDOW) {
+        /* The oldest sample leaves the window */
+        int32_t old = acc->window[slot];
+        acc->window_sum -= old;
+        acc->window_sq -= (uint64_t)((int64_t)old * old);
+        if (acc->min_len && acc->min_queue[acc->min_head] == slot) {
+            acc->min_head = (acc->min_head + 1) & STATS_WINDOW_MASK;
+            acc->min_len--;
+        }
+        if (acc->max_len && acc->max_queue[acc->max_head] == slot) {
+            acc->max_head = (acc->max_head + 1) & STATS_WINDOW_MASK;
+            acc->max_len--;
+        }
+    } else {
+        acc->window_count++;
+    }
+
+    acc->window[slot] = d;
+    acc->window_sum += d;
+    acc->window_sq += (uint64_t)((int64_t)d * d);
+
+    /* Samples the new one dominates can never be the window's extreme again */
+    while (acc->min_len && acc->window[*queue_back(acc->min_queue, acc->min_head, acc->min_len)] >= d) {
+        acc->min_len--;
+    }
+    *queue_back(acc->min_queue, acc->min_head, ++acc->min_len) = (uint8_t)slot;
+    while (acc->max_len && acc->window[*queue_back(acc->max_queue, acc->max_head, acc->max_len)] <= d) {
+        acc->max_len--;
+    }
+    *queue_back(acc->max_queue, acc->max_head, ++acc->max_len) = (uint8_t)slot;
+
+    acc->window_pos = (slot + 1) & STATS_WINDOW_MASK;
+}
+
+void loadcell_stats_update(loadcell_stats_acc_t *acc, int32_t force_mn)
+{
+    uint32_t seq = atomic_load_explicit(&acc->seq, memory_order_relaxed);
+    atomic_store_explicit(&acc->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    if (atomic_load_explicit(&acc->reset_pending, memory_order_relaxed) &&
+        atomic_exchange_explicit(&acc->reset_pending, false, memory_order_acquire)) {
+        loadcell_stats_clear(acc);
+    }
+
+    if (acc->count == 0) {
+        acc->ref_mn = force_mn;
+        acc->min_mn = force_mn;
+        acc->max_mn = force_mn;
+    } else if (force_mn < acc->min_mn) {
+        acc->min_mn = force_mn;
+    } else if (force_mn > acc->max_mn) {
+        acc->max_mn = force_mn;
+    }
+    acc->count++;
+
+    int64_t delta = (int64_t)force_mn - acc->ref_mn;
+    int32_t d = delta > STATS_DELTA_LIMIT ? STATS_DELTA_LIMIT :
+                delta < -STATS_DELTA_LIMIT ? -STATS_DELTA_LIMIT : (int32_t)delta;
+
+    acc->block_count++;
+    acc->block_sum += d;
+    acc->block_sq += (uint64_t)((int64_t)d * d);
+    if (acc->block_count == LOADCELL_STATS_BLOCK) {
+        loadcell_stats_fold(acc);
+    }
+    loadcell_stats_window_push(acc, d);
+
+    atomic_store_explicit(&acc->seq, seq + 2, memory_order_release);
+}
+
+void loadcell_stats_request_reset(loadcell_stats_acc_t *acc)
+{
+    atomic_store_explicit(&acc->reset_pending, true, memory_order_release);
+}
+
+/* Fields a snapshot needs, copied under the sequence counter */
+typedef struct {
+    uint32_t count;
+    int32_t ref_mn;
+    int32_t min_mn;
+    int32_t max_mn;
+    uint32_t folded;
+    double mean;
+    double m2;
+    uint32_t block_count;
+    int64_t block_sum;
+    uint64_t block_sq;
+    uint32_t window_count;
+    int64_t window_sum;
+    uint64_t window_sq;
+    int32_t window_min;
+    int32_t window_max;
+} stats_copy_t;
+
+static bool loadcell_stats_copy(const loadcell_stats_acc_t *acc, stats_copy_t *c)
+{
+    uint32_t seq = atomic_load_explicit(&acc->seq, memory_order_acquire);
+    if (seq & 1) {
+        return false;
+    }
+
+    c->count = acc->count;
+    c->ref_mn = acc->ref_mn;
+    c->min_mn = acc->min_mn;
+    c->max_mn = acc->max_mn;
+    c->folded = acc->folded;
+    c->mean = acc->mean;
+    c->m2 = acc->m2;
+    c->block_count = acc->block_count;
+    c->block_sum = acc->block_sum;
+    c->block_sq = acc->block_sq;
+    c->window_count = acc->window_count;
+    c->window_sum = acc->window_sum;
+    c->window_sq = acc->window_sq;
+    c->window_min = acc->window[acc->min_queue[acc->min_head] & STATS_WINDOW_MASK];
+    c->window_max = acc->window[acc->max_queue[acc->max_head] & STATS_WINDOW_MASK];
+
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&acc->seq, memory_order_relaxed) == seq;
+}
+
+void loadcell_stats_read(const loadcell_stats_acc_t *acc, loadcell_stats_t *stats)
+{
+    stats_copy_t c;
+
+    memset(stats, 0, sizeof(*stats));
+    if (atomic_load_explicit(&acc->reset_pending, memory_order_acquire)) {
+        return;
+    }
+    /* Readers run below the acquisition task's priority, so an update in progress finishes */
+    while (!loadcell_stats_copy(acc, &c)) {
+    }
+    if (c.count == 0) {
+        return;
+    }
+
+    /* The partial block joins the folded ones the same way a full block would */
+    uint32_t n = c.folded;
+    double mean = c.mean;
+    double m2 = c.m2;
+    if (c.block_count) {
+        double b_mean = c.ref_mn + (double)c.block_sum / c.block_count;
+        double b_m2 = (double)spread(c.block_count, c.block_sum, c.block_sq) / c.block_count;
+        welford_merge(&n, &mean, &m2, c.block_count, b_mean, b_m2);
+    }
+
+    stats->sample_count = c.count;
+    stats->min_force = c.min_mn / 1000.0f;
+    stats->max_force = c.max_mn / 1000.0f;
+    stats->peak_to_peak = (float)((int64_t)c.max_mn - c.min_mn) / 1000.0f;
+    stats->avg_force = (float)(mean / 1000.0);
+    stats->std_force = (float)(sqrt(m2 / n) / 1000.0);
+
+    uint32_t w = c.window_count;
+    stats->window_count = w;
+    stats->window_min = (float)((double)c.ref_mn + c.window_min) / 1000.0f;
+    stats->window_max = (float)((double)c.ref_mn + c.window_max) / 1000.0f;
+    stats->window_avg = (float)((c.ref_mn + (double)c.window_sum / w) / 1000.0);
+    stats->window_std = (float)(sqrt((double)spread(w, c.window_sum, c.window_sq)) / w / 1000.0);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file loadcell_stats.h
+ * @brief Streaming per-channel force statistics
+ *
+ * Updated by the acquisition path with every sample at O(1) integer cost:
+ * - Since reset: count, min/max (peak-to-peak), and Welford mean/variance.
+ *   Samples are summed exactly in integer blocks of LOADCELL_STATS_BLOCK,
+ *   and only a full block is folded into the floating-point Welford state
+ *   (Chan's pairwise update), so the C6's soft-float cost is paid once per
+ *   block instead of once per sample.
+ * - Over the last LOADCELL_STATS_WINDOW samples: mean/variance from exact
+ *   running sums, and min/max from monotonic queues (amortized O(1)).
+ *
+ * Readers on other tasks take a consistent snapshot without pausing
+ * acquisition: the accumulator is guarded by a sequence counter (odd while
+ * the acquisition task updates it) and a torn copy is simply retried. A reset
+ * from another task is only requested; the writer clears the accumulator on
+ * its next sample.
+ */
+
+#ifndef LOADCELL_STATS_H
+#define LOADCELL_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADCELL_STATS_WINDOW       128     /**< Sliding-window length in samples (at most 128) */
+#define LOADCELL_STATS_BLOCK        128     /**< Samples summed exactly before a Welford update (at most 128) */
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/**
+ * Statistics for a single channel (snapshot, Newtons)
+ */
+typedef struct {
+    float min_force;        /**< Minimum force reading */
+    float max_force;        /**< Maximum force reading */
+    float avg_force;        /**< Average force reading */
+    uint32_t sample_count;  /**< Number of samples collected */
+    float std_force;        /**< Standard deviation */
+    float peak_to_peak;     /**< max_force - min_force */
+
+    /* Last window_count samples (up to LOADCELL_STATS_WINDOW) */
+    uint32_t window_count;
+    float window_min;
+    float window_max;
+    float window_avg;
+    float window_std;
+} loadcell_stats_t;
+
+/**
+ * Running accumulator, written only by the acquisition task
+ *
+ * Samples are held as millinewton deltas from the first sample after reset,
+ * clamped to ±2^24 mN (a 16 kN swing). Up to 128 of them, n * sum(d^2) and
+ * sum(d)^2 both fit in 64 bits, so block and window variances are exact.
+ */
+typedef struct {
+    _Atomic uint32_t seq;                   /**< Odd while an update is in progress */
+    _Atomic bool reset_pending;             /**< Set by readers, applied by the writer */
+
+    uint32_t count;
+    int32_t ref_mn;                         /**< First sample: origin of the deltas */
+    int32_t min_mn;
+    int32_t max_mn;
+
+    /* Welford state of the folded blocks (mN) */
+    uint32_t folded;
+    double mean;
+    double m2;
+
+    /* Current block, exact */
+    uint32_t block_count;
+    int64_t block_sum;
+    uint64_t block_sq;
+
+    /* Sliding window, exact sums and monotonic min/max queues of ring slots */
+    int32_t window[LOADCELL_STATS_WINDOW];
+    uint32_t window_pos;                    /**< Slot of the next sample */
+    uint32_t window_count;
+    int64_t window_sum;
+    uint64_t window_sq;
+    uint8_t min_queue[LOADCELL_STATS_WINDOW];
+    uint8_t max_queue[LOADCELL_STATS_WINDOW];
+    uint16_t min_head, min_len;
+    uint16_t max_head, max_len;
+} loadcell_stats_acc_t;
+
+/* ============================================================================
+ * Writer (acquisition task)
+ * ============================================================================ */
+
+/**
+ * @brief Clear an accumulator nobody else is using yet
+ */
+void loadcell_stats_init(loadcell_stats_acc_t *acc);
+
+/**
+ * @brief Add one sample
+ *
+ * @param acc Channel accumulator (single writer)
+ * @param force_mn Force in millinewtons
+ */
+void loadcell_stats_update(loadcell_stats_acc_t *acc, int32_t force_mn);
+
+/* ============================================================================
+ * Readers (tasks below the acquisition task's priority)
+ * ============================================================================ */
+
+/**
+ * @brief Ask the writer to clear the statistics at its next sample
+ *
+ * Snapshots read as empty from now on, even before the writer gets there.
+ */
+void loadcell_stats_request_reset(loadcell_stats_acc_t *acc);
+
+/**
+ * @brief Consistent snapshot while the writer keeps running
+ *
+ * Retries while an update is in progress, so the caller must not be able to
+ * preempt the writer in the middle of one.
+ *
+ * @param acc Channel accumulator
+ * @param stats Receives the statistics in Newtons (all zero before the first sample)
+ */
+void loadcell_stats_read(const loadcell_stats_acc_t *acc, loadcell_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADCELL_STATS_H */
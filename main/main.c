@@ -3,10 +3,15 @@
 #include "freertos/task.h"
 #include "esp_system.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
 #include "esp32c6/rom/gpio.h"  /* For gpio_matrix_in/out ROM functions */
 #include "loadcell.h"
+#include "acquisition.h"
+#include "frame_ring.h"
+#include "force_plate.h"
 #include "uart_cmd.h"
 #include "ads1261.h"
 #include "ble_force.h"
@@ -35,7 +40,14 @@ static const char *TAG = "GRF_Platform";
 /* Force Platform Configuration */
 #define PGA_GAIN                ADS1261_PGA_GAIN_128        /* 128x gain for high resolution */
 #define DATA_RATE               ADS1261_DR_40000_SPS        /* 40ksps with SINC5 filter (only filter at 40kSPS) */
-#define MEASUREMENT_INTERVAL_MS 10                          /* Read all 4 channels every 10ms (100 Hz) */
+#define FRAME_RATE_HZ           1000.0f                     /* Scan frames per second (ISO 1000 Hz per channel) */
+#define STATUS_LOG_FRAMES       1000                        /* Frames between status log lines */
+#define BLE_NOTIFY_DIVIDER      10                          /* Frames per BLE notification (link can't carry 1 kHz) */
+#define ACQUISITION_PRIORITY    5
+
+/* Plate geometry: cells at the corners, front-left, front-right, rear-left, rear-right */
+#define PLATE_HALF_WIDTH_M      0.20f                       /* Cell x offset from the plate centre */
+#define PLATE_HALF_LENGTH_M     0.30f                       /* Cell y offset from the plate centre */
 
 /* Output Format Selection */
 #define OUTPUT_FORMAT_HUMAN     1   /* Readable format with labels */
@@ -43,79 +55,130 @@ static const char *TAG = "GRF_Platform";
 #define OUTPUT_FORMAT_BLE       2   /* BLE streaming only (no serial output) */
 #define OUTPUT_FORMAT           OUTPUT_FORMAT_BLE
 
+#define OUTPUT_PERIOD_MS        10                          /* Output task drains the frame ring this often */
+#define OUTPUT_PRIORITY         3
+
 static loadcell_t loadcell_device;
-static uint32_t measurement_count = 0;
+static acquisition_t acquisition;
+static frame_ring_t frame_ring;
+static force_plate_t force_plate;
+
+/* Frame rate actually achieved since the previous call */
+static float measured_rate_hz(uint32_t frames)
+{
+    static int64_t last_us = 0;
+    static uint32_t last_frames = 0;
+
+    int64_t now_us = esp_timer_get_time();
+    float rate = 0.0f;
+    if (last_us != 0 && now_us > last_us) {
+        rate = (float)(frames - last_frames) * 1e6f / (float)(now_us - last_us);
+    }
+    last_us = now_us;
+    last_frames = frames;
+    return rate;
+}
 
 /**
- * Measurement task - reads loadcells periodically
+ * Frame callback - runs in the acquisition task after every scan; only publishes
  */
-static void measurement_task(void *arg)
+static void on_frame(loadcell_t *loadcell, const acquisition_frame_t *frame, void *ctx)
 {
-    ESP_LOGI(TAG, "Measurement task started");
-
-    while (1) {
-        esp_err_t ret = loadcell_read(&loadcell_device);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to read loadcells");
-            vTaskDelay(pdMS_TO_TICKS(MEASUREMENT_INTERVAL_MS));
-            continue;
-        }
+    uint8_t flags = (frame->late ? FRAME_FLAG_LATE : 0) | (frame->skipped ? FRAME_FLAG_GAP : 0);
+    frame_ring_capture(&frame_ring, loadcell, &force_plate, frame->deadline_us, flags);
+}
 
-        measurement_count++;
-#if OUTPUT_FORMAT == OUTPUT_FORMAT_BLE
-        /* BLE streaming mode: Send notification every frame */
-        if (ble_force_is_connected()) {
-            uint16_t timestamp_ms = (uint16_t)(esp_timer_get_time() / 1000);
-            ble_force_notify(&loadcell_device, timestamp_ms);
-        }
-        
-        /* Log status periodically (every 100 frames ~ every 1000ms) */
-        if (measurement_count % 100 == 0) {
-            uint32_t timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
-            if (ble_force_is_connected()) {
-                ESP_LOGI(TAG, "[%lu ms] BLE streaming active (%.1f Hz)", 
-                         timestamp_ms, 1000.0f / MEASUREMENT_INTERVAL_MS);
-            } else {
-                ESP_LOGI(TAG, "[%lu ms] Waiting for BLE connection...", timestamp_ms);
-            }
-        }
-#else
-        /* Log measurements periodically (every 100 frames ~ every 1000ms) */
-        if (measurement_count % 100 == 0) {
-            float total_force = 0.0;
+#if OUTPUT_FORMAT != OUTPUT_FORMAT_BLE
+static void print_frame(const loadcell_frame_t *frame, uint32_t dropped)
+{
+    float total_force = 0.0;
 
 #if OUTPUT_FORMAT == OUTPUT_FORMAT_CSV
-            /* CSV format: frame,timestamp,ch1,ch2,ch3,ch4,total */
-            printf("%lu,%llu", measurement_count, loadcell_device.measurements[0].timestamp_us);
+    /* CSV format: frame,timestamp,ch1..chN,total,copx_mm,copy_mm,flags */
+    printf("%lu,%lld", (unsigned long)frame->seq, (long long)frame->timestamp_us);
 #else
-            /* Human-readable format */
-            ESP_LOGI(TAG, "[Frame %lu] Force readings:", measurement_count);
+    /* Human-readable format */
+    ESP_LOGI(TAG, "[Frame %lu] Force readings (%.1f Hz measured, %lu dropped by logger):",
+             (unsigned long)frame->seq, measured_rate_hz(frame->seq), (unsigned long)dropped);
 #endif
 
-            for (int ch = 0; ch < 4; ch++) {  /* Read all 4 channels */
-                total_force += loadcell_device.measurements[ch].force_newtons;
+    for (int ch = 0; ch < frame->num_channels; ch++) {
+        float force_n = frame->force_mn[ch] / 1000.0f;
+        total_force += force_n;
 
 #if OUTPUT_FORMAT == OUTPUT_FORMAT_CSV
-                printf(",%.4f", loadcell_device.measurements[ch].force_newtons);
+        printf(",%.3f", force_n);
 #else
-                ESP_LOGI(TAG, "  Ch%d: %.2f N (raw=%06lx, norm=%.6f)",
-                        ch + 1,
-                        loadcell_device.measurements[ch].force_newtons,
-                        loadcell_device.measurements[ch].raw_adc & 0xFFFFFF,
-                        loadcell_device.measurements[ch].normalized);
+        ESP_LOGI(TAG, "  Ch%d: %.2f N (raw=%06lx)",
+                ch + 1,
+                force_n,
+                (unsigned long)(frame->raw[ch] & 0xFFFFFF));
 #endif
-            }
+    }
 
 #if OUTPUT_FORMAT == OUTPUT_FORMAT_CSV
-            printf(",%.4f\n", total_force);
+    printf(",%.3f,%.1f,%.1f,%u\n", total_force, frame->plate.cop_x_um / 1000.0f, frame->plate.cop_y_um / 1000.0f,
+           frame->flags);
 #else
-            ESP_LOGI(TAG, "  Total GRF: %.2f N", total_force);
+    ESP_LOGI(TAG, "  Total GRF: %.2f N%s", total_force, frame->flags ? " (flagged)" : "");
+    ESP_LOGI(TAG, "  Plate: Fz %.2f N, COP (%.1f, %.1f) mm%s", frame->plate.fz_mn / 1000.0f,
+             frame->plate.cop_x_um / 1000.0f, frame->plate.cop_y_um / 1000.0f,
+             frame->plate.cop_valid ? "" : " (below threshold)");
 #endif
-        }
+}
 #endif
+
+/**
+ * Output task - drains the frame ring for BLE and logging, off the acquisition task
+ *
+ * Each consumer has its own cursor: a slow BLE link or console only loses
+ * frames for itself, never stalls the scan.
+ */
+static void output_task(void *arg)
+{
+    frame_ring_reader_t ble_reader;
+    frame_ring_reader_t log_reader;
+    loadcell_frame_t frame;
+
+    frame_ring_reader_init(&ble_reader, &frame_ring);
+    frame_ring_reader_init(&log_reader, &frame_ring);
+    ESP_LOGI(TAG, "Output task started");
+
+    while (1) {
+#if OUTPUT_FORMAT == OUTPUT_FORMAT_BLE
+        /* BLE streaming mode: Send a notification every BLE_NOTIFY_DIVIDER frames */
+        while (frame_ring_read(&ble_reader, &frame)) {
+            if (frame.seq % BLE_NOTIFY_DIVIDER == 0 && ble_force_is_connected()) {
+                ble_force_notify(&frame);
+            }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(MEASUREMENT_INTERVAL_MS));
+        /* Log status periodically with the measured frame rate and schedule misses */
+        while (frame_ring_read(&log_reader, &frame)) {
+            if ((frame.seq + 1) % STATUS_LOG_FRAMES != 0) {
+                continue;
+            }
+            uint32_t timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+            float rate_hz = measured_rate_hz(frame.seq + 1);
+            acquisition_stats_t stats;
+            acquisition_get_stats(&acquisition, &stats);
+            if (ble_force_is_connected()) {
+                ESP_LOGI(TAG, "[%lu ms] BLE streaming active (%.1f Hz measured, %lu late, %lu overruns, %lu dropped)",
+                         timestamp_ms, rate_hz, stats.late_frames, stats.overruns, ble_reader.dropped);
+            } else {
+                ESP_LOGI(TAG, "[%lu ms] Waiting for BLE connection... (%.1f Hz, %lu late, %lu overruns)",
+                         timestamp_ms, rate_hz, stats.late_frames, stats.overruns);
+            }
+        }
+#else
+        /* Log measurements periodically */
+        while (frame_ring_read(&log_reader, &frame)) {
+            if ((frame.seq + 1) % STATUS_LOG_FRAMES == 0) {
+                print_frame(&frame, log_reader.dropped);
+            }
+        }
+#endif
+        vTaskDelay(pdMS_TO_TICKS(OUTPUT_PERIOD_MS));
     }
 }
 
@@ -204,7 +267,15 @@ void app_main(void)
     }
 
     ESP_LOGI(TAG, "");
-BLE Force Streaming */
+
+    /* Initialize loadcell driver (CS hardwired to GND) */
+    ret = loadcell_init(&loadcell_device, SPI2_HOST, -1, DRDY_PIN, PGA_GAIN, DATA_RATE);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize loadcell driver: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    /* Initialize BLE Force Streaming */
     ret = ble_force_init("ZPlate");
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize BLE: %s", esp_err_to_name(ret));
@@ -214,42 +285,63 @@ BLE Force Streaming */
     ESP_LOGI(TAG, "Waiting for BLE connection...");
 
     /* Initialize UART command interface */
-    uart_cmd_init(&loadcell_device);
-
-    /* Start measurement task */
-    xTaskCreate(measurement_task, "measurement", 4096, NULL, 5, NULL);
+    frame_ring_init(&frame_ring);
+    force_plate_init(&force_plate, loadcell_device.num_channels);
+    const float cell_x[4] = { -PLATE_HALF_WIDTH_M, PLATE_HALF_WIDTH_M, -PLATE_HALF_WIDTH_M, PLATE_HALF_WIDTH_M };
+    const float cell_y[4] = { PLATE_HALF_LENGTH_M, PLATE_HALF_LENGTH_M, -PLATE_HALF_LENGTH_M, -PLATE_HALF_LENGTH_M };
+    force_plate_set_geometry(&force_plate, cell_x, cell_y,
+                             loadcell_device.num_channels < 4 ? loadcell_device.num_channels : 4);
+    uart_cmd_init(&loadcell_device, &acquisition, &frame_ring, &force_plate);
+
+    /* Spend the frame period's spare conversions on oversampling (none at 1 kHz with 4 channels) */
+    loadcell_set_oversampling(&loadcell_device, loadcell_plan_oversampling(&loadcell_device, FRAME_RATE_HZ));
+
+    /* Start timer-paced acquisition */
+    acquisition_config_t acq_cfg = {
+        .loadcell = &loadcell_device,
+        .frame_rate_hz = FRAME_RATE_HZ,
+        .on_frame = on_frame,
+    };
+    ret = acquisition_init(&acquisition, &acq_cfg);
+    if (ret == ESP_OK) {
+        ret = acquisition_start(&acquisition, ACQUISITION_PRIORITY);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start acquisition: %s", esp_err_to_name(ret));
+        return;
+    }
 
-    /* Start UART command task */
+    /* Start output and UART command tasks */
+    xTaskCreate(output_task, "output", 4096, NULL, OUTPUT_PRIORITY, NULL);
     xTaskCreate(uart_cmd_task, "uart_cmd", 4096, NULL, 4, NULL);
 
-    ESP_LOGI(TAG, "All tasks started. Ready for BLE streaming!");
+    /* Real scan timing of the configured filter/data rate */
+    ads1261_timing_plan_t timing = {0};
+    loadcell_get_timing(&loadcell_device, &timing);
+
+    ESP_LOGI(TAG, "All tasks started. Ready for BLE streaming and commands!");
     ESP_LOGI(TAG, "");
     ESP_LOGI(TAG, "BLE Configuration:");
     ESP_LOGI(TAG, "  - Device Name: ZPlate");
     ESP_LOGI(TAG, "  - Service UUID: 0x1815");
     ESP_LOGI(TAG, "  - Characteristic UUID: 0x2A58");
-    ESP_LOGI(TAG, "  - Packet Size: 10 bytes (time counter + 4x int16)");
+    ESP_LOGI(TAG, "  - Packet Size: 20 bytes (time counter + 4x int16 + Fz, Mx, My, COPx, COPy)");
     ESP_LOGI(TAG, "  - Time Counter: 16-bit ms (elapsed time, 0-65.5s)");
-    ESP_LOGI(TAG, "  - Notification Rate: ~100 Hz (configurable)");
+    ESP_LOGI(TAG, "  - Notification Rate: %.0f Hz (every %d frames)", FRAME_RATE_HZ / BLE_NOTIFY_DIVIDER,
+             BLE_NOTIFY_DIVIDER);
     ESP_LOGI(TAG, "  - Force Resolution: 0.1 N");
     ESP_LOGI(TAG, "  - Force Range: ±3276 N (±327 kg)");
-    ESP_LOGI(TAG, "  - Future: 8-channel support (18 bytes total)");
     ESP_LOGI(TAG, "  - PGA Gain: 128x");
-    ESP_LOGI(TAG, "  - Data Rate: 40 kSPS system (~1000-1200 Hz per channel)");
-    ESP_LOGI(TAG, "  - Sample Interval: %d ms", MEASUREMENT_INTERVAL_MS);
+    ESP_LOGI(TAG, "  - Data Rate: %.0f SPS, %lu us settle per channel switch",
+             ads1261_datarate_sps(timing.datarate), (unsigned long)timing.settle_us);
+    ESP_LOGI(TAG, "  - Scan capacity: %.0f Hz per channel (%u channels on %u ADC, back-to-back)",
+             timing.channel_rate_hz, loadcell_device.num_channels, loadcell_device.num_adcs);
+    ESP_LOGI(TAG, "  - Oversampling: %u conversions per channel per frame (CIC/FIR decimated)",
+             timing.conversions);
+    ESP_LOGI(TAG, "  - Frame Rate: %.0f Hz, gptimer deadlines every %lu us",
+             FRAME_RATE_HZ, (unsigned long)acquisition.period_us);
     ESP_LOGI(TAG, "");
     ESP_LOGI(TAG, "Initial State: UNCALIBRATED (perform tare first)");
     ESP_LOGI(TAG, "");
-
-    /* Initialize UART command interface */
-    uart_cmd_init(&loadcell_device);
-
-    /* Start measurement task */
-    xTaskCreate(measurement_task, "measurement", 4096, NULL, 5, NULL);
-
-    /* Start UART command task */
-    xTaskCreate(uart_cmd_task, "uart_cmd", 4096, NULL, 4, NULL);
-
-    ESP_LOGI(TAG, "All tasks started. Ready for commands!");
 }
 
@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <math.h>
 #include "esp_log.h"
 #include "uart_cmd.h"
@@ -14,8 +15,12 @@
 #define MAX_ARGS 10
 
 static loadcell_t *g_device = NULL;
+static acquisition_t *g_acq = NULL;
+static const frame_ring_t *g_frames = NULL;
+static force_plate_t *g_plate = NULL;
 static char cmd_buffer[CMD_BUFFER_SIZE] = {0};
 static uint16_t cmd_index = 0;
+static bool s_job_pending = false;     /* A job started here has not been reported yet */
 
 /* ============================================================================
  * Command Handlers
@@ -44,12 +49,44 @@ static void cmd_status(int argc, char *argv[])
         "CALIBRATED"
     };
 
-    for (int i = 0; i < 4; i++) {
-        printf("Channel %d: %s\n", i + 1, states[g_device->channels[i].calib_state]);
+    for (int i = 0; i < g_device->num_channels; i++) {
+        printf("Channel %d: %s\n", i + 1, states[loadcell_get_calib_state(g_device, i)]);
     }
     printf("=======================\n\n");
 }
 
+/* Newest frame from the acquisition task; the bus belongs to it while it runs */
+static bool latest_frame(loadcell_frame_t *frame)
+{
+    if (!g_frames || !frame_ring_latest(g_frames, frame)) {
+        printf("No frame acquired yet\n");
+        return false;
+    }
+    return true;
+}
+
+static void print_frame_flags(uint8_t flags)
+{
+    if (flags) {
+        printf("Flags:%s%s%s%s\n",
+               (flags & FRAME_FLAG_LATE) ? " LATE" : "",
+               (flags & FRAME_FLAG_GAP) ? " GAP" : "",
+               (flags & FRAME_FLAG_CLIPPED) ? " CLIPPED" : "",
+               (flags & FRAME_FLAG_UNCALIBRATED) ? " UNCALIBRATED" : "");
+    }
+}
+
+static void print_plate(const force_plate_output_t *plate)
+{
+    printf("Plate: Fz=%.2f N  Mx=%.3f N·m  My=%.3f N·m", plate->fz_mn / 1000.0f, plate->mx_mnm / 1000.0f,
+           plate->my_mnm / 1000.0f);
+    if (plate->cop_valid) {
+        printf("  COP=(%.1f, %.1f) mm\n", plate->cop_x_um / 1000.0f, plate->cop_y_um / 1000.0f);
+    } else {
+        printf("  COP=- (Fz below threshold)\n");
+    }
+}
+
 static void cmd_read(int argc, char *argv[])
 {
     if (!g_device) {
@@ -57,13 +94,60 @@ static void cmd_read(int argc, char *argv[])
         return;
     }
 
-    esp_err_t ret = loadcell_read(g_device);
+    loadcell_frame_t frame;
+    if (!latest_frame(&frame)) {
+        return;
+    }
+
+    printf("\n=== Loadcell Measurements (Frame %lu, %lld us) ===\n", (unsigned long)frame.seq,
+           (long long)frame.timestamp_us);
+
+    float total = 0.0f;
+    for (int i = 0; i < frame.num_channels; i++) {
+        loadcell_stats_t stats;
+        loadcell_get_stats(g_device, i, &stats);
+
+        printf("Channel %d: %.3f N\n", i + 1, frame.force_mn[i] / 1000.0f);
+        printf("  Raw ADC: 0x%06lx\n", (unsigned long)(frame.raw[i] & 0xFFFFFF));
+        printf("  Stats: min=%.2f, max=%.2f, avg=%.2f (n=%lu)\n",
+               stats.min_force, stats.max_force, stats.avg_force, stats.sample_count);
+
+        total += frame.force_mn[i] / 1000.0f;
+    }
+
+    printf("Total GRF: %.2f N\n", total);
+    print_plate(&frame.plate);
+    print_frame_flags(frame.flags);
+    printf("========================================\n\n");
+}
+
+/* Start a calibration job on one channel (1-based) or all (0); the acquisition task runs it */
+static void start_job(loadcell_job_kind_t kind, int channel, float force, uint32_t frames)
+{
+    uint8_t target = channel == 0 ? LOADCELL_ALL_CHANNELS : (uint8_t)(channel - 1);
+    esp_err_t ret = loadcell_start_job(g_device, kind, target, force, frames);
+    if (ret == ESP_ERR_INVALID_STATE) {
+        printf("Cannot start: a job is running ('job cancel' stops it) or a channel needs a tare first\n");
+        return;
+    }
+    if (ret == ESP_ERR_NO_MEM) {
+        printf("All %d points used: run 'calfit', or 'tare' to start over\n", LOADCELL_CAL_MAX_POINTS - 1);
+        return;
+    }
     if (ret != ESP_OK) {
-        printf("Failed to read loadcells\n");
+        printf("Cannot start %s job: %s\n", loadcell_job_kind_name(kind), esp_err_to_name(ret));
         return;
     }
 
-    loadcell_print_measurements(g_device);
+    s_job_pending = true;
+    const char *what = kind == LOADCELL_JOB_TARE ? "Tare" :
+                       kind == LOADCELL_JOB_SPAN ? "Span calibration" : "Calibration point";
+    if (channel == 0) {
+        printf("%s of all channels over %lu frames started; 'job' shows progress\n", what, (unsigned long)frames);
+    } else {
+        printf("%s of channel %d over %lu frames started; 'job' shows progress\n", what, channel,
+               (unsigned long)frames);
+    }
 }
 
 static void cmd_tare(int argc, char *argv[])
@@ -74,42 +158,27 @@ static void cmd_tare(int argc, char *argv[])
     }
 
     if (argc < 2) {
-        printf("Usage: tare <channel> [samples]\n");
-        printf("  channel: 1-4 (or 0 for all)\n");
-        printf("  samples: number of samples to average (default: 200)\n");
+        printf("Usage: tare <channel> [frames]\n");
+        printf("  channel: 1-%u (or 0 for all, from the same frames)\n", g_device->num_channels);
+        printf("  frames: number of frames to average (default: %d, at most %d)\n", LOADCELL_JOB_FRAMES,
+               LOADCELL_JOB_MAX_FRAMES);
         return;
     }
 
     int channel = atoi(argv[1]);
-    uint32_t samples = (argc > 2) ? atoi(argv[2]) : 200;
+    uint32_t frames = (argc > 2) ? atoi(argv[2]) : LOADCELL_JOB_FRAMES;
 
-    if (channel < 0 || channel > 4) {
+    if (channel < 0 || channel > g_device->num_channels) {
         printf("Invalid channel: %d\n", channel);
         return;
     }
 
-    if (samples == 0) {
-        samples = 200;
+    if (frames == 0) {
+        frames = LOADCELL_JOB_FRAMES;
     }
 
-    if (channel == 0) {
-        /* Tare all channels */
-        for (int i = 0; i < 4; i++) {
-            printf("Taring channel %d...\n", i + 1);
-            esp_err_t ret = loadcell_tare(g_device, i, samples);
-            if (ret != ESP_OK) {
-                printf("Failed to tare channel %d\n", i + 1);
-            }
-        }
-    } else {
-        printf("Taring channel %d with %lu samples...\n", channel, samples);
-        esp_err_t ret = loadcell_tare(g_device, channel - 1, samples);
-        if (ret == ESP_OK) {
-            printf("Tare successful!\n");
-        } else {
-            printf("Tare failed!\n");
-        }
-    }
+    printf("Make sure the plate is unloaded!\n");
+    start_job(LOADCELL_JOB_TARE, channel, 0.0f, frames);
 }
 
 static void cmd_calibrate(int argc, char *argv[])
@@ -120,10 +189,11 @@ static void cmd_calibrate(int argc, char *argv[])
     }
 
     if (argc < 3) {
-        printf("Usage: cal <channel> <known_force_N> [samples]\n");
-        printf("  channel: 1-4\n");
+        printf("Usage: cal <channel> <known_force_N> [frames]\n");
+        printf("  channel: 1-%u (or 0 for all, each carrying the known force)\n", g_device->num_channels);
         printf("  known_force_N: reference force in Newtons\n");
-        printf("  samples: number of samples to average (default: 200)\n");
+        printf("  frames: number of frames to average (default: %d, at most %d)\n", LOADCELL_JOB_FRAMES,
+               LOADCELL_JOB_MAX_FRAMES);
         printf("\nExample: cal 1 100.5\n");
         printf("  Calibrate channel 1 with 100.5 N reference weight\n");
         return;
@@ -131,9 +201,9 @@ static void cmd_calibrate(int argc, char *argv[])
 
     int channel = atoi(argv[1]);
     float force = atof(argv[2]);
-    uint32_t samples = (argc > 3) ? atoi(argv[3]) : 200;
+    uint32_t frames = (argc > 3) ? atoi(argv[3]) : LOADCELL_JOB_FRAMES;
 
-    if (channel < 1 || channel > 4) {
+    if (channel < 0 || channel > g_device->num_channels) {
         printf("Invalid channel: %d\n", channel);
         return;
     }
@@ -143,19 +213,418 @@ static void cmd_calibrate(int argc, char *argv[])
         return;
     }
 
-    if (samples == 0) {
-        samples = 200;
+    if (frames == 0) {
+        frames = LOADCELL_JOB_FRAMES;
+    }
+
+    printf("Make sure the known weight (%.2f N) is applied to the loadcell!\n", force);
+    start_job(LOADCELL_JOB_SPAN, channel, force, frames);
+}
+
+/* Per-channel averages and noise of the last finished job */
+static void print_job_results(void)
+{
+    for (int ch = 0; ch < g_device->num_channels; ch++) {
+        loadcell_job_result_t r;
+        esp_err_t ret = loadcell_get_job_result(g_device, ch, &r);
+        if (ret == ESP_ERR_NOT_FOUND) {
+            continue;
+        }
+        printf("Channel %d: mean %ld, noise %.1f codes RMS", ch + 1, (long)r.mean, r.sd);
+        if (r.sd_mn > 0.0f) {
+            printf(" (%.3f N)", r.sd_mn / 1000.0f);
+        }
+        printf(", range %ld..%ld, %lu spike(s) replaced%s%s\n", (long)r.min, (long)r.max,
+               (unsigned long)r.replaced, ret == ESP_OK ? "" : " - NOT APPLIED: ",
+               ret == ESP_OK ? "" : esp_err_to_name(ret));
+    }
+}
+
+static void cmd_job(int argc, char *argv[])
+{
+    if (!g_device) {
+        printf("Device not initialized\n");
+        return;
+    }
+    if (argc >= 2) {
+        if (strcmp(argv[1], "cancel") != 0) {
+            printf("Usage: job [cancel]\n");
+            printf("  Shows the progress of a tare/cal job, or the noise each channel saw once it finished\n");
+            return;
+        }
+        if (loadcell_cancel_job(g_device) != ESP_OK) {
+            printf("No job running\n");
+        } else {
+            printf("Cancelling at the next frame\n");
+        }
+        return;
+    }
+
+    uint32_t progress, frames;
+    loadcell_job_state_t state = loadcell_get_job(g_device, &progress, &frames);
+    if (state == LOADCELL_JOB_IDLE) {
+        printf("No calibration job since start-up\n");
+        return;
+    }
+    printf("\n=== %s job: %s (%lu/%lu frames) ===\n", loadcell_job_kind_name(g_device->job.kind),
+           loadcell_job_state_name(state), (unsigned long)progress, (unsigned long)frames);
+    if (state == LOADCELL_JOB_DONE || state == LOADCELL_JOB_FAILED) {
+        print_job_results();
+    }
+    printf("\n");
+}
+
+static void cmd_cal_point(int argc, char *argv[])
+{
+    if (!g_device) {
+        printf("Device not initialized\n");
+        return;
+    }
+
+    if (argc < 3) {
+        printf("Usage: calpt <channel> <known_force_N> [frames]\n");
+        printf("  Records one known load for a multi-point calibration (after tare).\n");
+        printf("  channel: 1-%u (or 0 for all, each carrying the known force)\n", g_device->num_channels);
+        printf("  Up to %d loads; apply them with 'calfit'.\n", LOADCELL_CAL_MAX_POINTS - 1);
+        return;
+    }
+
+    int channel = atoi(argv[1]);
+    float force = atof(argv[2]);
+    uint32_t frames = (argc > 3) ? atoi(argv[3]) : LOADCELL_JOB_FRAMES;
+
+    if (channel < 0 || channel > g_device->num_channels) {
+        printf("Invalid channel: %d\n", channel);
+        return;
+    }
+
+    if (frames == 0) {
+        frames = LOADCELL_JOB_FRAMES;
+    }
+
+    printf("Recording %.2f N (over %lu frames)...\n", force, (unsigned long)frames);
+    start_job(LOADCELL_JOB_POINT, channel, force, frames);
+}
+
+typedef struct {
+    uint8_t channel;
+    loadcell_fit_t fit;
+} cal_fit_req_t;
+
+/* Swap in the channel's table between two frames */
+static esp_err_t cal_fit_request(loadcell_t *loadcell, void *arg)
+{
+    const cal_fit_req_t *req = (const cal_fit_req_t *)arg;
+    return loadcell_build_lut(loadcell, req->channel, req->fit);
+}
+
+static void cmd_cal_fit(int argc, char *argv[])
+{
+    if (!g_device) {
+        printf("Device not initialized\n");
+        return;
+    }
+
+    if (argc < 2) {
+        printf("Usage: calfit <channel> [pwl|poly2|poly3]\n");
+        printf("  pwl:   straight lines between the points (default)\n");
+        printf("  poly2: least-squares quadratic (2+ loads)\n");
+        printf("  poly3: least-squares cubic (3+ loads)\n");
+        return;
+    }
+
+    int channel = atoi(argv[1]);
+    loadcell_fit_t fit = LOADCELL_FIT_PIECEWISE;
+
+    if (channel < 1 || channel > g_device->num_channels) {
+        printf("Invalid channel: %d\n", channel);
+        return;
+    }
+
+    if (argc > 2) {
+        if (strcmp(argv[2], "poly2") == 0) {
+            fit = LOADCELL_FIT_POLY2;
+        } else if (strcmp(argv[2], "poly3") == 0) {
+            fit = LOADCELL_FIT_POLY3;
+        } else if (strcmp(argv[2], "pwl") != 0) {
+            printf("Unknown fit: %s\n", argv[2]);
+            return;
+        }
+    }
+
+    cal_fit_req_t req = { .channel = (uint8_t)(channel - 1), .fit = fit };
+    esp_err_t ret = acquisition_call(g_acq, cal_fit_request, &req);
+    if (ret == ESP_OK) {
+        printf("Channel %d now uses the %s calibration\n", channel, loadcell_fit_name(fit));
+    } else {
+        printf("Fit failed: %s\n", esp_err_to_name(ret));
+    }
+}
+
+/* Report a failed matrix update: a bad value, or another update in the way */
+static void print_plate_error(esp_err_t ret, const char *invalid)
+{
+    if (ret == ESP_ERR_INVALID_ARG) {
+        printf("%s\n", invalid);
+    } else if (ret != ESP_OK) {
+        printf("Matrix not updated: %s\n", esp_err_to_name(ret));
+    }
+}
+
+static void cmd_plate(int argc, char *argv[])
+{
+    if (!g_device || !g_plate) {
+        printf("Device not initialized\n");
+        return;
+    }
+
+    if (argc >= 4 && strcmp(argv[1], "geom") == 0) {
+        /* Corner cells front-left, front-right, rear-left, rear-right */
+        float hx = atof(argv[2]) / 1000.0f;
+        float hy = atof(argv[3]) / 1000.0f;
+        const float x[4] = { -hx, hx, -hx, hx };
+        const float y[4] = { hy, hy, -hy, -hy };
+        uint8_t cells = g_device->num_channels < 4 ? g_device->num_channels : 4;
+        print_plate_error(force_plate_set_geometry(g_plate, x, y, cells), "Invalid geometry");
+    } else if (argc >= 5 && strcmp(argv[1], "coef") == 0) {
+        force_plate_axis_t axis = FORCE_PLATE_OUTPUTS;
+        for (int a = 0; a < FORCE_PLATE_OUTPUTS; a++) {
+            if (strcasecmp(argv[2], force_plate_axis_name(a)) == 0) {
+                axis = a;
+            }
+        }
+        int channel = atoi(argv[3]);
+        print_plate_error(axis == FORCE_PLATE_OUTPUTS || channel < 1 ? ESP_ERR_INVALID_ARG :
+                          force_plate_set_coef(g_plate, axis, channel - 1, atof(argv[4])), "Invalid coefficient");
+    } else if (argc >= 3 && strcmp(argv[1], "minfz") == 0) {
+        print_plate_error(force_plate_set_min_fz(g_plate, atof(argv[2])), "Invalid threshold");
+    } else if (argc > 1) {
+        printf("Usage: plate                           - show matrix and latest outputs\n");
+        printf("       plate geom <half_x_mm> <half_y_mm> - ideal matrix, corner cells FL FR RL RR\n");
+        printf("       plate coef <fz|mx|my> <ch> <value> - set one coefficient (gain, or metres)\n");
+        printf("       plate minfz <N>                    - Fz below which no COP is reported\n");
+        return;
+    }
+
+    force_plate_matrix_t m;
+    bank_pair_read(&g_plate->pair, g_plate->banks, sizeof(m), &m);
+    printf("\n=== Plate Matrix (x right, y front, metres) ===\n");
+    printf("      ");
+    for (int ch = 0; ch < m.num_channels; ch++) {
+        printf("     Ch%-3d", ch + 1);
+    }
+    printf("\n");
+    for (int a = 0; a < FORCE_PLATE_OUTPUTS; a++) {
+        printf("  %-4s", force_plate_axis_name(a));
+        for (int ch = 0; ch < m.num_channels; ch++) {
+            printf(" %9.5f", m.coef[a][ch] / (float)(1L << FORCE_PLATE_Q_BITS));
+        }
+        printf("\n");
     }
+    printf("  COP threshold: %.1f N\n", m.min_fz_mn / 1000.0f);
 
-    printf("Calibrating channel %d with %.2f N (using %lu samples)...\n", channel, force, samples);
-    printf("Make sure the known weight is applied to the loadcell!\n");
+    loadcell_frame_t frame;
+    if (latest_frame(&frame)) {
+        print_plate(&frame.plate);
+    }
+    printf("\n");
+}
+
+static void print_filters(void)
+{
+    printf("\n=== Force Filters (%.1f Hz frames) ===\n", g_device->frame_rate_hz);
+    for (int ch = 0; ch < g_device->num_channels; ch++) {
+        loadcell_filter_chain_t chain;
+        loadcell_filter_get_chain(&g_device->channels[ch].filter, &chain);
+        printf("Channel %d:%s\n", ch + 1, chain.num_sections ? "" : " off");
+        for (int i = 0; i < chain.num_sections; i++) {
+            const loadcell_biquad_t *s = &chain.sections[i];
+            float c[5];
+            loadcell_biquad_get_coefs(s, c);
+            if (s->type == LOADCELL_FILTER_CUSTOM) {
+                printf("  %d. %-5s", i + 1, loadcell_filter_type_name(s->type));
+            } else {
+                printf("  %d. %-5s %7.2f Hz Q %5.2f", i + 1, loadcell_filter_type_name(s->type), s->freq_hz, s->q);
+            }
+            printf("  b %.8f %.8f %.8f  a %.8f %.8f\n", c[0], c[1], c[2], c[3], c[4]);
+        }
+    }
+    printf("\n");
+}
+
+static void cmd_filter(int argc, char *argv[])
+{
+    if (!g_device) {
+        printf("Device not initialized\n");
+        return;
+    }
+    if (argc == 1) {
+        print_filters();
+        return;
+    }
+
+    int channel = atoi(argv[1]);
+    uint8_t target = channel == 0 ? LOADCELL_ALL_CHANNELS : (uint8_t)(channel - 1);
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+    if (channel < 0 || channel > g_device->num_channels || argc < 3) {
+        /* Usage below */
+    } else if (strcmp(argv[2], "clear") == 0) {
+        ret = loadcell_clear_filters(g_device, target);
+    } else if (argc >= 8 && strcmp(argv[2], "coef") == 0) {
+        float coef[5];
+        for (int i = 0; i < 5; i++) {
+            coef[i] = atof(argv[3 + i]);
+        }
+        ret = loadcell_add_filter_coefs(g_device, target, coef);
+    } else if (argc >= 4) {
+        for (loadcell_filter_type_t type = 0; type < LOADCELL_FILTER_CUSTOM; type++) {
+            if (strcmp(argv[2], loadcell_filter_type_name(type)) == 0) {
+                float q = type == LOADCELL_FILTER_NOTCH ? LOADCELL_FILTER_NOTCH_Q : LOADCELL_FILTER_BUTTERWORTH_Q;
+                if (argc >= 5) {
+                    q = atof(argv[4]);
+                }
+                ret = loadcell_add_filter(g_device, target, type, atof(argv[3]), q);
+            }
+        }
+    }
 
-    esp_err_t ret = loadcell_calibrate(g_device, channel - 1, force, samples);
     if (ret == ESP_OK) {
-        printf("Calibration successful!\n");
+        print_filters();
+        return;
+    }
+    if (ret == ESP_ERR_NO_MEM) {
+        printf("Chain full: %d sections per channel ('filter <ch> clear' first)\n", LOADCELL_FILTER_MAX_SECTIONS);
+    } else if (ret == ESP_ERR_INVALID_STATE) {
+        printf("Frame rate not set yet\n");
+    } else if (ret == ESP_ERR_TIMEOUT) {
+        printf("Chain busy, not updated\n");
     } else {
-        printf("Calibration failed!\n");
+        printf("Usage: filter                                 - show every channel's chain\n");
+        printf("       filter <ch> lp|hp <freq_hz> [q]        - add a low-/high-pass (Q %.3f)\n",
+               LOADCELL_FILTER_BUTTERWORTH_Q);
+        printf("       filter <ch> notch <freq_hz> [q]        - add a notch, e.g. 50 or 60 Hz (Q %.1f)\n",
+               LOADCELL_FILTER_NOTCH_Q);
+        printf("       filter <ch> coef <b0> <b1> <b2> <a1> <a2> - add raw coefficients (a0 = 1)\n");
+        printf("       filter <ch> clear                      - remove all sections\n");
+        printf("  ch: 1-based, or 0 for all; frequencies below %.1f Hz, up to %d sections\n",
+               g_device->frame_rate_hz / 2, LOADCELL_FILTER_MAX_SECTIONS);
+    }
+}
+
+static void print_despike(void)
+{
+    printf("\n=== Spike Filters ===\n");
+    for (int ch = 0; ch < g_device->num_channels; ch++) {
+        const loadcell_despike_t *d = &g_device->channels[ch].despike;
+        loadcell_despike_mode_t mode;
+        uint8_t window;
+        float k;
+        loadcell_despike_get_config(d, &mode, &window, &k);
+        printf("Channel %d: %-6s", ch + 1, loadcell_despike_mode_name(mode));
+        if (mode == LOADCELL_DESPIKE_MEDIAN) {
+            printf(" window %2u", window);
+        } else if (mode == LOADCELL_DESPIKE_HAMPEL) {
+            printf(" window %2u  k %.2f  replaced %lu", window, k, (unsigned long)loadcell_despike_replaced(d));
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+static void cmd_despike(int argc, char *argv[])
+{
+    if (!g_device) {
+        printf("Device not initialized\n");
+        return;
     }
+    if (argc == 1) {
+        print_despike();
+        return;
+    }
+
+    int channel = atoi(argv[1]);
+    uint8_t target = channel == 0 ? LOADCELL_ALL_CHANNELS : (uint8_t)(channel - 1);
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+    if (channel >= 0 && channel <= g_device->num_channels && argc >= 3) {
+        uint8_t window = argc >= 4 ? (uint8_t)atoi(argv[3]) : LOADCELL_DESPIKE_WINDOW;
+        float k = argc >= 5 ? atof(argv[4]) : LOADCELL_DESPIKE_K;
+        for (loadcell_despike_mode_t mode = LOADCELL_DESPIKE_OFF; mode <= LOADCELL_DESPIKE_HAMPEL; mode++) {
+            if (strcmp(argv[2], loadcell_despike_mode_name(mode)) == 0) {
+                ret = loadcell_set_despike(g_device, target, mode, window, k);
+            }
+        }
+    }
+
+    if (ret == ESP_OK) {
+        print_despike();
+        return;
+    }
+    printf("Usage: despike                             - show every channel's spike filter\n");
+    printf("       despike <ch> hampel [window] [k]    - replace samples k sigma from the median (%d, %.1f)\n",
+           LOADCELL_DESPIKE_WINDOW, LOADCELL_DESPIKE_K);
+    printf("       despike <ch> median [window]        - running median, delays by half the window\n");
+    printf("       despike <ch> off\n");
+    printf("  ch: 1-based, or 0 for all; odd window 3..%d frames\n", LOADCELL_MEDIAN_MAX_WINDOW);
+}
+
+static void cmd_align(int argc, char *argv[])
+{
+    if (!g_device) {
+        printf("Device not initialized\n");
+        return;
+    }
+    if (argc >= 2) {
+        esp_err_t ret = ESP_ERR_INVALID_ARG;
+        for (loadcell_align_mode_t mode = LOADCELL_ALIGN_OFF; mode <= LOADCELL_ALIGN_CUBIC; mode++) {
+            if (strcmp(argv[1], loadcell_align_mode_name(mode)) == 0) {
+                ret = loadcell_set_alignment(g_device, mode);
+            }
+        }
+        if (ret != ESP_OK) {
+            printf("Usage: align [off|linear|cubic]\n");
+            printf("  linear: channels interpolated to the first conversion of each scan\n");
+            printf("  cubic:  Catmull-Rom to the first conversion of the previous scan (one frame later)\n");
+            return;
+        }
+    }
+    printf("Channel alignment: %s\n", loadcell_align_mode_name(loadcell_get_alignment(g_device)));
+}
+
+static void cmd_zero(int argc, char *argv[])
+{
+    if (!g_device) {
+        printf("Device not initialized\n");
+        return;
+    }
+    if (argc >= 2) {
+        int32_t band_mn = strcmp(argv[1], "off") == 0 ? 0 : (int32_t)lroundf(atof(argv[1]) * 1000.0f);
+        int32_t limit_mn = argc >= 3 ? (int32_t)lroundf(atof(argv[2]) * 1000.0f) : LOADCELL_ZERO_LIMIT_MN;
+        if ((band_mn == 0 && strcmp(argv[1], "off") != 0) ||
+            loadcell_set_zero_tracking(g_device, band_mn, limit_mn) != ESP_OK) {
+            printf("Usage: zero [off | <band_N> [limit_N]]\n");
+            printf("  Tracks each calibrated channel's zero while the total stays within band_N\n");
+            printf("  (default %.1f N), up to limit_N per channel between tares (default %.1f N)\n",
+                   LOADCELL_ZERO_BAND_MN / 1000.0f, LOADCELL_ZERO_LIMIT_MN / 1000.0f);
+            return;
+        }
+    }
+
+    int32_t band_mn = atomic_load(&g_device->zero_band_mn);
+    printf("\n=== Zero Tracking: %s ===\n", band_mn ? "on" : "off");
+    if (band_mn) {
+        printf("Band %.3f N, limit %.3f N, %lu frames per correction, %lu corrections\n", band_mn / 1000.0f,
+               atomic_load(&g_device->zero_limit_mn) / 1000.0f, (unsigned long)g_device->zero_block_frames,
+               (unsigned long)g_device->zero_updates);
+    }
+    for (int ch = 0; ch < g_device->num_channels; ch++) {
+        loadcell_cal_set_t cal;
+        loadcell_get_cal_set(g_device, ch, &cal);
+        printf("Channel %d: offset %ld, tracked %.3f N%s\n", ch + 1, (long)cal.offset_raw,
+               cal.zero_tracked_mn / 1000.0f, cal.calib_state == CALIB_STATE_CALIBRATED ? "" : " (not calibrated)");
+    }
+    printf("\n");
 }
 
 static void cmd_stats(int argc, char *argv[])
@@ -167,15 +636,19 @@ static void cmd_stats(int argc, char *argv[])
 
     printf("\n=== Channel Statistics ===\n");
 
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < g_device->num_channels; i++) {
         loadcell_stats_t stats;
         loadcell_get_stats(g_device, i, &stats);
 
         printf("Channel %d:\n", i + 1);
         printf("  Min:   %.2f N\n", stats.min_force);
         printf("  Max:   %.2f N\n", stats.max_force);
-        printf("  Avg:   %.2f N\n", stats.avg_force);
+        printf("  Avg:   %.3f N (std %.3f N, p-p %.3f N)\n", stats.avg_force, stats.std_force, stats.peak_to_peak);
         printf("  Count: %lu\n", stats.sample_count);
+        if (stats.window_count) {
+            printf("  Last %lu: avg %.3f N, std %.3f N, min %.3f N, max %.3f N\n", stats.window_count,
+                   stats.window_avg, stats.window_std, stats.window_min, stats.window_max);
+        }
     }
 
     printf("===========================\n\n");
@@ -190,19 +663,19 @@ static void cmd_reset_stats(int argc, char *argv[])
 
     if (argc < 2) {
         printf("Usage: rst_stats <channel>\n");
-        printf("  channel: 1-4 (or 0 for all)\n");
+        printf("  channel: 1-%u (or 0 for all)\n", g_device->num_channels);
         return;
     }
 
     int channel = atoi(argv[1]);
 
-    if (channel < 0 || channel > 4) {
+    if (channel < 0 || channel > g_device->num_channels) {
         printf("Invalid channel: %d\n", channel);
         return;
     }
 
     if (channel == 0) {
-        loadcell_reset_stats(g_device, 4);
+        loadcell_reset_stats(g_device, LOADCELL_ALL_CHANNELS);
         printf("Statistics reset for all channels\n");
     } else {
         loadcell_reset_stats(g_device, channel - 1);
@@ -217,18 +690,23 @@ static void cmd_raw(int argc, char *argv[])
         return;
     }
 
-    printf("\n=== Raw ADC Values ===\n");
+    loadcell_frame_t frame;
+    if (!latest_frame(&frame)) {
+        return;
+    }
 
-    for (int i = 0; i < 4; i++) {
-        loadcell_measurement_t m;
-        loadcell_get_measurement(g_device, i, &m);
+    printf("\n=== Raw ADC Values (Frame %lu) ===\n", (unsigned long)frame.seq);
 
+    for (int i = 0; i < frame.num_channels; i++) {
+        loadcell_cal_set_t cal;
+        loadcell_get_cal_set(g_device, i, &cal);
         printf("Channel %d:\n", i + 1);
-        printf("  Raw (24-bit): 0x%06lx (%ld)\n", m.raw_adc & 0xFFFFFF, m.raw_adc);
-        printf("  Normalized:  %.8f\n", m.normalized);
-        printf("  Offset:      %ld\n", g_device->channels[i].offset_raw);
-        printf("  Scale:       %.6f\n", g_device->channels[i].scale_factor);
+        printf("  Raw (24-bit): 0x%06lx (%ld)\n", (unsigned long)(frame.raw[i] & 0xFFFFFF), (long)frame.raw[i]);
+        printf("  Force:       %ld mN\n", (long)frame.force_mn[i]);
+        printf("  Offset:      %ld\n", (long)cal.offset_raw);
+        printf("  Scale:       %.6e N/count\n", cal.scale_factor);
     }
+    print_frame_flags(frame.flags);
 
     printf("======================\n\n");
 }
@@ -243,6 +721,12 @@ static void cmd_info(int argc, char *argv[])
     loadcell_print_calib_info(g_device);
 }
 
+/* The register dump and test read share the bus with the scan: between frames only */
+static esp_err_t diag_request(loadcell_t *loadcell, void *arg)
+{
+    return loadcell_diagnostic(loadcell);
+}
+
 static void cmd_diag(int argc, char *argv[])
 {
     if (!g_device) {
@@ -251,15 +735,34 @@ static void cmd_diag(int argc, char *argv[])
     }
 
     printf("\n=== ADS1261 Diagnostic ===\n");
-    esp_err_t ret = loadcell_diagnostic(g_device);
+    esp_err_t ret = acquisition_call(g_acq, diag_request, NULL);
     if (ret == ESP_OK) {
         printf("Diagnostic completed successfully.\n");
+    } else if (ret == ESP_ERR_TIMEOUT || ret == ESP_ERR_NO_MEM) {
+        printf("Diagnostic not run: %s\n", esp_err_to_name(ret));
     } else {
         printf("Diagnostic completed with errors.\n");
     }
     printf("=========================\n");
 }
 
+/* OFCAL/FSCAL of a channel change while no scan uses them */
+static esp_err_t reset_calib_request(loadcell_t *loadcell, void *arg)
+{
+    int channel = *(const int *)arg;
+    if (channel != 0) {
+        return loadcell_reset_calibration(loadcell, (uint8_t)(channel - 1));
+    }
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < loadcell->num_channels; i++) {
+        esp_err_t ch_ret = loadcell_reset_calibration(loadcell, i);
+        if (ret == ESP_OK) {
+            ret = ch_ret;
+        }
+    }
+    return ret;
+}
+
 static void cmd_reset_calib(int argc, char *argv[])
 {
     if (!g_device) {
@@ -269,28 +772,61 @@ static void cmd_reset_calib(int argc, char *argv[])
 
     if (argc < 2) {
         printf("Usage: rst_calib <channel>\n");
-        printf("  channel: 1-4 (or 0 for all)\n");
+        printf("  channel: 1-%u (or 0 for all)\n", g_device->num_channels);
         return;
     }
 
     int channel = atoi(argv[1]);
 
-    if (channel < 0 || channel > 4) {
+    if (channel < 0 || channel > g_device->num_channels) {
         printf("Invalid channel: %d\n", channel);
         return;
     }
 
-    if (channel == 0) {
-        for (int i = 0; i < 4; i++) {
-            loadcell_reset_calibration(g_device, i);
-        }
+    esp_err_t ret = acquisition_call(g_acq, reset_calib_request, &channel);
+    if (ret != ESP_OK) {
+        printf("Reset failed: %s\n", esp_err_to_name(ret));
+    } else if (channel == 0) {
         printf("Calibration reset for all channels\n");
     } else {
-        loadcell_reset_calibration(g_device, channel - 1);
         printf("Calibration reset for channel %d\n", channel);
     }
 }
 
+static void print_timing(const char *label, const ads1261_timing_plan_t *t)
+{
+    printf("%s: %s, %.1f SPS, delay %lu us -> settle %lu us, step %lu us (%u conv), %.1f Hz per channel\n",
+           label, ads1261_filter_name(t->filter), ads1261_datarate_sps(t->datarate), (unsigned long)ads1261_start_delay_us(t->delay),
+           (unsigned long)t->settle_us, (unsigned long)t->step_us, t->conversions, t->channel_rate_hz);
+}
+
+static void cmd_timing(int argc, char *argv[])
+{
+    if (!g_device) {
+        printf("Device not initialized\n");
+        return;
+    }
+
+    ads1261_timing_plan_t timing;
+    if (loadcell_get_timing(g_device, &timing) == ESP_OK) {
+        print_timing("Current", &timing);
+    }
+
+    if (argc >= 2) {
+        float target = atof(argv[1]);
+        if (target <= 0.0f) {
+            printf("Invalid rate: %s\n", argv[1]);
+            return;
+        }
+        esp_err_t ret = loadcell_plan_timing(g_device, target, &timing);
+        if (ret == ESP_ERR_INVALID_ARG) {
+            printf("Planning failed\n");
+            return;
+        }
+        print_timing(timing.meets_target ? "Plan" : "Target not reachable, fastest", &timing);
+    }
+}
+
 /* ============================================================================
  * Command Table
  * ============================================================================ */
@@ -304,15 +840,24 @@ typedef struct {
 static const cmd_entry_t commands[] = {
     {"help",        cmd_help,         "Show this help message"},
     {"status",      cmd_status,       "Show current status"},
-    {"read",        cmd_read,         "Read all channels once"},
-    {"tare",        cmd_tare,         "Tare (zero) calibration - usage: tare <ch> [samples]"},
-    {"cal",         cmd_calibrate,    "Full-scale calibration - usage: cal <ch> <force_N> [samples]"},
+    {"read",        cmd_read,         "Show the latest frame"},
+    {"tare",        cmd_tare,         "Tare (zero) calibration - usage: tare <ch> [frames]"},
+    {"cal",         cmd_calibrate,    "Full-scale calibration - usage: cal <ch> <force_N> [frames]"},
+    {"job",         cmd_job,          "Tare/cal progress and noise - usage: job [cancel]"},
+    {"calpt",       cmd_cal_point,    "Multi-point calibration load - usage: calpt <ch> <force_N> [frames]"},
+    {"calfit",      cmd_cal_fit,      "Apply multi-point calibration - usage: calfit <ch> [pwl|poly2|poly3]"},
+    {"zero",        cmd_zero,         "Zero tracking - usage: zero [off | <band_N> [limit_N]]"},
+    {"plate",       cmd_plate,        "Plate matrix and Fz/COP - usage: plate [geom|coef|minfz ...]"},
+    {"filter",      cmd_filter,       "Force filters - usage: filter [<ch> lp|hp|notch|coef|clear ...]"},
+    {"align",       cmd_align,        "Align channels to one instant - usage: align [off|linear|cubic]"},
+    {"despike",     cmd_despike,      "Spike filters - usage: despike [<ch> hampel|median|off [window] [k]]"},
     {"stats",       cmd_stats,        "Show channel statistics"},
     {"raw",         cmd_raw,          "Show raw ADC values"},
     {"info",        cmd_info,         "Show calibration info"},
     {"diag",        cmd_diag,         "Hardware diagnostic - check pin connections"},
     {"rst_stats",   cmd_reset_stats,  "Reset statistics - usage: rst_stats <ch>"},
     {"rst_calib",   cmd_reset_calib,  "Reset calibration - usage: rst_calib <ch>"},
+    {"timing",      cmd_timing,       "Scan timing / plan for a rate - usage: timing [rate_hz]"},
     {NULL, NULL, NULL}
 };
 
@@ -361,9 +906,12 @@ static void parse_and_execute(char *line)
  * UART Interface
  * ============================================================================ */
 
-esp_err_t uart_cmd_init(loadcell_t *device)
+esp_err_t uart_cmd_init(loadcell_t *device, acquisition_t *acq, const frame_ring_t *frames, force_plate_t *plate)
 {
     g_device = device;
+    g_acq = acq;
+    g_frames = frames;
+    g_plate = plate;
     cmd_index = 0;
 
     printf("\n");
@@ -375,8 +923,29 @@ esp_err_t uart_cmd_init(loadcell_t *device)
     return ESP_OK;
 }
 
+/* Print the outcome of a job started from the console once it finishes */
+static void report_job(void)
+{
+    if (!s_job_pending || !g_device) {
+        return;
+    }
+    loadcell_job_state_t state = loadcell_get_job(g_device, NULL, NULL);
+    if (state == LOADCELL_JOB_RUNNING) {
+        return;
+    }
+    s_job_pending = false;
+    printf("\n%s job %s\n", loadcell_job_kind_name(g_device->job.kind), loadcell_job_state_name(state));
+    if (state == LOADCELL_JOB_DONE || state == LOADCELL_JOB_FAILED) {
+        print_job_results();
+    }
+    printf("> ");
+    fflush(stdout);
+}
+
 esp_err_t uart_cmd_process(void)
 {
+    report_job();
+
     /* Check for incoming data */
     int c = getchar();
     if (c == EOF || c == 0) {
@@ -432,21 +1001,31 @@ void uart_cmd_print_help(void)
 
     printf("\n");
     printf("CALIBRATION WORKFLOW:\n");
-    printf("  1. tare 1 500     - Zero calibration (channel 1, 500 samples)\n");
-    printf("  2. cal 1 100.5    - Span calibration (channel 1, 100.5 N reference)\n");
+    printf("  1. tare 0 500     - Zero calibration (all channels, 500 frames, runs in the background)\n");
+    printf("  2. cal 1 100.5    - Span calibration (channel 1, 100.5 N reference) once the tare is reported\n");
     printf("  3. read           - Verify calibration\n");
+    printf("  Non-linear cells: after tare, 'calpt 1 <force>' per known load, then 'calfit 1 poly2'\n");
     printf("\nCALIBRATION COMMANDS:\n");
-    printf("  tare <ch> [samples]       - Tare calibration (ch: 1-4 or 0 for all)\n");
-    printf("  cal <ch> <force> [samples] - Full-scale calibration\n");
-    printf("  rst_calib <ch>            - Reset calibration (ch: 1-4 or 0 for all)\n");
+    printf("  tare <ch> [frames]        - Tare calibration (ch: 1-based, or 0 for all)\n");
+    printf("  cal <ch> <force> [frames] - Full-scale calibration\n");
+    printf("  job [cancel]              - Progress of a tare/cal, then each channel's mean and noise\n");
+    printf("  calpt <ch> <force> [frames] - Record a load for multi-point calibration\n");
+    printf("  calfit <ch> [pwl|poly2|poly3] - Fit the recorded loads and apply them\n");
+    printf("  rst_calib <ch>            - Reset calibration (ch: 1-based, or 0 for all)\n");
+    printf("  zero [off|<band_N>]       - Track the zero while the plate is unloaded\n");
     printf("\nMEASUREMENT COMMANDS:\n");
-    printf("  read              - Read all channels once\n");
+    printf("  read              - Show the latest frame\n");
     printf("  status            - Show device status\n");
     printf("  stats             - Show channel statistics\n");
-    printf("  raw               - Show raw ADC values\n");
+    printf("  raw               - Show raw ADC values of the latest frame\n");
+    printf("  plate [...]       - Plate matrix, Fz/Mx/My and COP (plate help for setup)\n");
+    printf("  filter [...]      - Per-channel low-pass/notch/high-pass on the forces (filter help)\n");
+    printf("  despike [...]     - Per-channel median/Hampel spike rejection (despike help)\n");
+    printf("  align [mode]      - Interpolate each frame's channels to one instant (off/linear/cubic)\n");
     printf("  info              - Show calibration info\n");
     printf("\nUTILITY COMMANDS:\n");
-    printf("  rst_stats <ch>    - Reset statistics (ch: 1-4 or 0 for all)\n");
+    printf("  rst_stats <ch>    - Reset statistics (ch: 1-based, or 0 for all)\n");
+    printf("  timing [rate_hz]  - Scan timing, or plan filter/data rate for a per-channel rate\n");
     printf("  help              - Show this message\n");
     printf("\n");
 }
@@ -15,6 +15,8 @@
 
 #include "esp_err.h"
 #include "loadcell.h"
+#include "acquisition.h"
+#include "frame_ring.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,9 +26,12 @@ extern "C" {
  * Initialize UART command interface
  * 
  * @param[in] device Loadcell device handle
+ * @param[in] acq    Acquisition engine that owns the ADCs (commands that use the bus run through its mailbox)
+ * @param[in] frames Ring the acquisition task publishes to (read and raw show its newest frame)
+ * @param[in] plate  Plate calibration matrix the acquisition task applies
  * @return ESP_OK on success
  */
-esp_err_t uart_cmd_init(loadcell_t *device);
+esp_err_t uart_cmd_init(loadcell_t *device, acquisition_t *acq, const frame_ring_t *frames, force_plate_t *plate);
 
 /**
  * Process incoming UART command